@@ -24,6 +24,7 @@
 
 #define GLM_FORCE_RADIANS
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <iterator>
@@ -58,12 +59,14 @@
 #include <pgm_base.h>
 #include <project.h>
 #include <settings/settings_manager.h>
+#include <thread_pool.h>
 
 
 #define MASK_3D_CACHE "3D_CACHE"
 
 static std::mutex mutex3D_cache;
 static std::mutex mutex3D_cacheManager;
+static std::mutex mutex3D_cacheWrite;
 
 
 static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB )
@@ -137,6 +140,8 @@ public:
     void SetSHA1( const unsigned char* aSHA1Sum );
     const wxString GetCacheBaseName();
 
+    std::mutex    mutex;        // guards the members below while the entry is in use
+    bool          loaded;       // the file was looked at (it may have failed to load)
     wxDateTime    modTime;      // file modification time
     unsigned char sha1sum[20];
     std::string   pluginInfo;   // PluginName:Version string
@@ -147,6 +152,7 @@ public:
 
 S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
+    loaded = false;
     sceneData = NULL;
     renderData = NULL;
     memset( sha1sum, 0, 20 );
@@ -217,57 +223,77 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
         return NULL;
     }
 
-    // check cache if file is already loaded
-    std::lock_guard<std::mutex> lock( mutex3D_cache );
+    // find or create the cache entry; only the lookup is done under the cache lock so that
+    // different models load in parallel
+    S3D_CACHE_ENTRY* ep;
 
-    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
+    {
+        std::lock_guard<std::mutex> lock( mutex3D_cache );
+
+        std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
+        mi = m_CacheMap.find( full3Dpath );
+
+        if( mi != m_CacheMap.end() )
+        {
+            ep = mi->second;
+        }
+        else
+        {
+            ep = new S3D_CACHE_ENTRY;
+            m_CacheList.push_back( ep );
+            m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >( full3Dpath, ep ) );
+        }
+    }
+
+    // the threads asking for the same model wait here for the first one to load it
+    std::lock_guard<std::mutex> lock( ep->mutex );
+
+    if( aCachePtr )
+        *aCachePtr = ep;
 
-    if( mi != m_CacheMap.end() )
+    // a new cache entry: read its cache file or load the model
+    if( !ep->loaded )
     {
-        wxFileName fname( full3Dpath );
+        ep->loaded = true;
+        return checkCache( full3Dpath, ep );
+    }
 
-        if( fname.FileExists() )    // Only check if file exists. If not, it will
-        {                           // use the same model in cache.
-            bool reload = false;
-            wxDateTime fmdate = fname.GetModificationTime();
+    wxFileName fname( full3Dpath );
 
-            if( fmdate != mi->second->modTime )
+    if( fname.FileExists() )    // Only check if file exists. If not, it will
+    {                           // use the same model in cache.
+        bool reload = false;
+        wxDateTime fmdate = fname.GetModificationTime();
+
+        if( fmdate != ep->modTime )
+        {
+            unsigned char hashSum[20];
+            getSHA1( full3Dpath, hashSum );
+            ep->modTime = fmdate;
+
+            if( !isSHA1Same( hashSum, ep->sha1sum ) )
             {
-                unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
-                mi->second->modTime = fmdate;
-
-                if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
-                {
-                    mi->second->SetSHA1( hashSum );
-                    reload = true;
-                }
+                ep->SetSHA1( hashSum );
+                reload = true;
             }
+        }
 
-            if( reload )
+        if( reload )
+        {
+            if( NULL != ep->sceneData )
             {
-                if( NULL != mi->second->sceneData )
-                {
-                    S3D::DestroyNode( mi->second->sceneData );
-                    mi->second->sceneData = NULL;
-                }
-
-                if( NULL != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
-
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
+                S3D::DestroyNode( ep->sceneData );
+                ep->sceneData = NULL;
             }
-        }
 
-        if( NULL != aCachePtr )
-            *aCachePtr = mi->second;
+            if( NULL != ep->renderData )
+                S3D::Destroy3DModel( &ep->renderData );
 
-        return mi->second->sceneData;
+            ep->sceneData = m_Plugins->Load3DModel( full3Dpath, ep->pluginInfo );
+        }
     }
 
-    // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    return ep->sceneData;
 }
 
 
@@ -277,75 +303,34 @@ SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem )
 {
-    if( aCachePtr )
-        *aCachePtr = NULL;
-
     unsigned char sha1sum[20];
+    wxFileName fname( aFileName );
+    aCacheItem->modTime = fname.GetModificationTime();
 
     if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
     {
         // just in case we can't get a hash digest (for example, on access issues)
-        // or we do not have a configured cache file directory, we create an
-        // entry to prevent further attempts at loading the file
-        S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-        m_CacheList.push_back( ep );
-        wxFileName fname( aFileName );
-        ep->modTime = fname.GetModificationTime();
-
-        if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-            ( aFileName, ep ) ).second == false )
-        {
-            wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                        __FILE__, __FUNCTION__, __LINE__, aFileName );
-
-            m_CacheList.pop_back();
-            delete ep;
-        }
-        else
-        {
-            if( aCachePtr )
-                *aCachePtr = ep;
-
-        }
-
-        return NULL;
-    }
-
-    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-    m_CacheList.push_back( ep );
-    wxFileName fname( aFileName );
-    ep->modTime = fname.GetModificationTime();
-
-    if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-                               ( aFileName, ep ) ).second == false )
-    {
-        wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                    __FILE__, __FUNCTION__, __LINE__, aFileName );
-
-        m_CacheList.pop_back();
-        delete ep;
+        // or we do not have a configured cache file directory, the entry is left
+        // empty to prevent further attempts at loading the file
         return NULL;
     }
 
-    if( aCachePtr )
-        *aCachePtr = ep;
+    aCacheItem->SetSHA1( sha1sum );
 
-    ep->SetSHA1( sha1sum );
-
-    wxString bname = ep->GetCacheBaseName();
+    wxString bname = aCacheItem->GetCacheBaseName();
     wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
 
-    if( wxFileName::FileExists( cachename ) && loadCacheData( ep ) )
-        return ep->sceneData;
+    if( wxFileName::FileExists( cachename ) && loadCacheData( aCacheItem ) )
+        return aCacheItem->sceneData;
 
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+    aCacheItem->sceneData = m_Plugins->Load3DModel( aFileName, aCacheItem->pluginInfo );
 
-    if( NULL != ep->sceneData )
-        saveCacheData( ep );
+    if( NULL != aCacheItem->sceneData )
+        saveCacheData( aCacheItem );
 
-    return ep->sceneData;
+    return aCacheItem->sceneData;
 }
 
 
@@ -495,6 +480,9 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
         }
     }
 
+    // writing renumbers the node names from counters shared by all the scene graphs
+    std::lock_guard<std::mutex> lock( mutex3D_cacheWrite );
+
     return S3D::WriteCache( fname.ToUTF8(), true, (SGNODE*)aCacheItem->sceneData,
         aCacheItem->pluginInfo.c_str() );
 }
@@ -668,16 +656,45 @@ S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
         return NULL;
     }
 
+    // the scene data may have been reloaded since by another thread
+    std::lock_guard<std::mutex> lock( cp->mutex );
+
     if( cp->renderData )
         return cp->renderData;
 
-    S3DMODEL* mp = S3D::GetModel( sp );
+    S3DMODEL* mp = S3D::GetModel( cp->sceneData );
     cp->renderData = mp;
 
     return mp;
 }
 
 
+void S3D_CACHE::LoadModels( const std::vector<wxString>& aModelFileNames )
+{
+    std::vector<wxString> files;
+
+    for( const wxString& file : aModelFileNames )
+    {
+        if( !file.empty() )
+            files.push_back( file );
+    }
+
+    std::sort( files.begin(), files.end() );
+    files.erase( std::unique( files.begin(), files.end() ), files.end() );
+
+    // the names resolving to the same file meet on its cache entry
+    TASK_GROUP tasks;
+
+    tasks.ParallelFor( files.size(),
+                       [&]( size_t ii )
+                       {
+                           GetModel( files[ii] );
+                       } );
+
+    tasks.Wait();
+}
+
+
 S3D_CACHE* PROJECT::Get3DCacheManager( bool aUpdateProjDir )
 {
     std::lock_guard<std::mutex> lock( mutex3D_cacheManager );
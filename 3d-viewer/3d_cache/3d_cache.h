@@ -34,6 +34,7 @@
 #include "kicad_string.h"
 #include <list>
 #include <map>
+#include <vector>
 #include "plugins/3dapi/c3dmodel.h"
 #include <project.h>
 #include <wx/string.h>
@@ -68,18 +69,18 @@ private:
     wxString            m_CacheDir;
     wxString            m_ConfigDir;       /// base configuration path for 3D items
 
-    /** Find or create cache entry for file name
+    /** Fill a new cache entry for file name
      *
-     * Searches the cache list for the given filename and retrieves
-     * the cache data; a cache entry is created if one does not
-     * already exist.
+     * Hashes the given file and loads its scene data, from the cache
+     * file with the same hash if there is one, otherwise through the
+     * plugins.  The caller holds the entry's lock.
      *
-     * @param[in]   aFileName   file name (full or partial path)
-     * @param[out]  aCachePtr   optional return address for cache entry pointer
+     * @param[in]   aFileName   file name (full path)
+     * @param[in]   aCacheItem  the cache entry to fill
      * @return      SCENEGRAPH object associated with file name
      * @retval      NULL    on error
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
 
     /**
      * Function getSHA1
@@ -183,6 +184,17 @@ public:
      * @return is a pointer to the render data or NULL if not available
      */
     S3DMODEL* GetModel( const wxString& aModelFileName );
+
+    /**
+     * Function LoadModels
+     * loads the render data of several models at once, in parallel, so
+     * that GetModel() finds them in the cache.  A model listed several
+     * times, or under several names of the same file, is loaded once.
+     * The cache must not be flushed meanwhile.
+     *
+     * @param aModelFileNames is the list of partial or full paths to the models
+     */
+    void LoadModels( const std::vector<wxString>& aModelFileNames );
 };
 
 #endif  // CACHE_3D_H
@@ -22,6 +22,7 @@
  */
 
 
+#include <mutex>
 #include <utility>
 #include <iostream>
 #include <sstream>
@@ -232,6 +233,7 @@ void S3D_PLUGIN_MANAGER::loadPlugins( void )
             } while( 0 );
 #endif
             m_Plugins.push_back( pp );
+            m_Locks[pp].m_Reentrant = pp->IsReentrant();
             int nf = pp->GetNFilters();
 
             #ifdef DEBUG
@@ -494,12 +496,22 @@ SCENEGRAPH* S3D_PLUGIN_MANAGER::Load3DModel( const wxString& aFileName, std::str
 
     while( sL != items.second )
     {
+        PLUGIN_LOCK&                 pluginLock = m_Locks.at( sL->second );
+        std::unique_lock<std::mutex> lock( pluginLock.m_Mutex );
+
+        // CanRender() reopens a closed plugin, so it always runs under the lock
         if( sL->second->CanRender() )
         {
+            if( pluginLock.m_Reentrant )
+                lock.unlock();
+
             SCENEGRAPH* sp = sL->second->Load( aFileName.ToUTF8() );
 
             if( NULL != sp )
             {
+                if( !lock.owns_lock() )
+                    lock.lock();
+
                 sL->second->GetPluginInfo( aPluginInfo );
                 return sp;
             }
@@ -528,6 +540,7 @@ void S3D_PLUGIN_MANAGER::ClosePlugins( void )
 
     while( sP != eP )
     {
+        std::lock_guard<std::mutex> lock( m_Locks.at( *sP ).m_Mutex );
         (*sP)->Close();
         ++sP;
     }
@@ -559,7 +572,11 @@ bool S3D_PLUGIN_MANAGER::CheckTag( const char* aTag )
     while( pS != pE )
     {
         ptag.clear();
-        (*pS)->GetPluginInfo( ptag );
+
+        {
+            std::lock_guard<std::mutex> lock( m_Locks.at( *pS ).m_Mutex );
+            (*pS)->GetPluginInfo( ptag );
+        }
 
         // if the plugin name matches then the version
         // must also match
@@ -31,6 +31,7 @@
 
 #include <map>
 #include <list>
+#include <mutex>
 #include <string>
 #include <wx/string.h>
 
@@ -50,6 +51,16 @@ private:
     /// list of file filters
     std::list< wxString > m_FileFilters;
 
+    /// a plugin's lock, held for every call to the plugin but the Load() of a reentrant one
+    struct PLUGIN_LOCK
+    {
+        std::mutex m_Mutex;
+        bool       m_Reentrant = false;
+    };
+
+    /// the lock of each plugin; the map itself is only changed by loadPlugins()
+    std::map< KICAD_PLUGIN_LDR_3D*, PLUGIN_LOCK > m_Locks;
+
     /// load plugins
     void loadPlugins( void );
 
@@ -82,13 +93,20 @@ public:
      */
     std::list< wxString > const* GetFileFilters( void ) const;
 
+    /**
+     * Function Load3DModel
+     * loads a model with the first plugin of its extension which succeeds.  Models are
+     * loaded by several threads at once, except by the plugins which are not reentrant,
+     * which only ever load one at a time.
+     */
     SCENEGRAPH* Load3DModel( const wxString& aFileName, std::string& aPluginInfo );
 
     /**
      * Function ClosePlugins
      * iterates through all discovered plugins and closes them to
      * reclaim memory. The individual plugins will be automatically
-     * reloaded as calls are made to load specific models.
+     * reloaded as calls are made to load specific models.  It must not
+     * be called while models are being loaded.
      */
     void ClosePlugins( void );
 
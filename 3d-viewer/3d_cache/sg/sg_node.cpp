@@ -25,6 +25,7 @@
 #include <cmath>
 #include <cstring>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <wx/log.h>
 
@@ -47,6 +48,9 @@ static const std::string node_names[S3D::SGTYPE_END + 1] = {
 
 static unsigned int node_counts[S3D::SGTYPE_END] = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
 
+// Models may be read and written by several threads at once
+static std::mutex mutex_node_counts;
+
 
 char const* S3D::GetNodeTypeName( S3D::SGTYPES aType )
 {
@@ -62,8 +66,12 @@ static void getNodeName( S3D::SGTYPES nodeType, std::string& aName )
         return;
     }
 
-    unsigned int seqNum = node_counts[nodeType];
-    ++node_counts[nodeType];
+    unsigned int seqNum;
+
+    {
+        std::lock_guard<std::mutex> lock( mutex_node_counts );
+        seqNum = node_counts[nodeType]++;
+    }
 
     std::ostringstream ostr;
     ostr << node_names[nodeType] << "_" << seqNum;
@@ -303,6 +311,8 @@ void SGNODE::DisassociateWrapper( SGNODE** aWrapperRef )
 
 void SGNODE::ResetNodeIndex( void )
 {
+    std::lock_guard<std::mutex> lock( mutex_node_counts );
+
     for( int i = 0; i < (int)S3D::SGTYPE_END; ++i )
         node_counts[i] = 1;
 
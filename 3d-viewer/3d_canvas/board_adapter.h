@@ -112,6 +112,13 @@ class BOARD_ADAPTER
      */
     bool ShouldModuleBeDisplayed( MODULE_ATTR_T aModuleAttributs ) const;
 
+    /**
+     * @brief Load3DModels - Load the 3D models of the board's modules into the
+     * cache, in parallel, before the renderers ask for them one by one
+     * @param aDisplayedOnly: skip the modules hidden by ShouldModuleBeDisplayed
+     */
+    void Load3DModels( bool aDisplayedOnly ) const;
+
     /**
      * @brief SetBoard - Set current board to be rendered
      * @param aBoard: board to process
@@ -52,11 +52,10 @@
 #include <trigo.h>
 #include <utility>
 #include <vector>
-#include <thread>
 #include <algorithm>
-#include <atomic>
 
 #include <profile.h>
+#include <thread_pool.h>
 
 void BOARD_ADAPTER::destroyLayers()
 {
@@ -183,6 +182,11 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
     layer_id.clear();
     layer_id.reserve( m_copperLayersCount );
 
+    // The containers and polygons of the layers of layer_id, for the tasks which must not
+    // look them up in the maps while others are inserted
+    std::vector< CBVHCONTAINER2D* > layerContainers;
+    std::vector< SHAPE_POLY_SET* >  layerPolys;
+
     for( unsigned i = 0; i < arrayDim( cu_seq ); ++i )
         cu_seq[i] = ToLAYER_ID( B_Cu - i );
 
@@ -197,12 +201,18 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
 
         CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
         m_layers_container2D[curr_layer_id] = layerContainer;
+        layerContainers.push_back( layerContainer );
 
         if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
                 && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
         {
             SHAPE_POLY_SET* layerPoly    = new SHAPE_POLY_SET;
             m_layers_poly[curr_layer_id] = layerPoly;
+            layerPolys.push_back( layerPoly );
+        }
+        else
+        {
+            layerPolys.push_back( nullptr );
         }
     }
 
@@ -214,391 +224,263 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
     if( aStatusTextReporter )
         aStatusTextReporter->Report( _( "Create tracks and vias" ) );
 
-    // Create tracks as objects and add it to container
-    // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
+    const bool createPolys = GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
+                                && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY );
+
+    // The holes of the blind and buried vias of each layer, moved into the maps of the
+    // layers once the layer tasks are done
+    struct VIA_HOLES
     {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
+        CBVHCONTAINER2D* m_container = nullptr;
+        SHAPE_POLY_SET*  m_outerPoly = nullptr;
+        SHAPE_POLY_SET*  m_innerPoly = nullptr;
+    };
 
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
+    std::vector<VIA_HOLES> layerViaHoles( layer_id.size() );
 
-        // ADD TRACKS
-        unsigned int nTracks = trackList.size();
+    // A task creates the through holes, which are common to all the layers, and a task per
+    // copper layer the items of the layer: no two tasks add to the same container or polygon
+    // /////////////////////////////////////////////////////////////////////////
+    TASK_GROUP layerTasks;
 
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
+    layerTasks.Run( [&]()
+    {
+        // Add through hole vias, once for all the layers
+        for( const TRACK* track : trackList )
         {
-            const TRACK *track = trackList[trackIdx];
+            if( track->Type() != PCB_VIA_T || layer_id.empty()
+                    || !track->IsOnLayer( layer_id[0] ) )
+                continue;
+
+            const VIA* via = static_cast<const VIA*>( track );
 
-            // NOTE: Vias can be on multiple layers
-            if( !track->IsOnLayer( curr_layer_id ) )
+            if( via->GetViaType() != VIATYPE::THROUGH )
                 continue;
 
-            // Add object item to layer container
-            layerContainer->Add( createNewTrack( track, 0.0f ) );
-        }
-    }
+            const float holediameter      = via->GetDrillValue() * BiuTo3Dunits();
+            const float thickness         = GetCopperThickness3DU();
+            const float hole_inner_radius = ( holediameter / 2.0f );
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T03: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+            const SFVEC2F via_center(
+                    via->GetStart().x * m_biuTo3Dunits, -via->GetStart().y * m_biuTo3Dunits );
 
-    // Create VIAS and THTs objects and add it to holes containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
-    {
-        // ADD TRACKS
-        unsigned int nTracks = trackList.size();
+            // Add through hole object
+            m_through_holes_outer.Add( new CFILLEDCIRCLE2D( via_center,
+                                                            hole_inner_radius + thickness,
+                                                            *track ) );
 
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-        {
-            const TRACK *track = trackList[trackIdx];
+            m_through_holes_vias_outer.Add( new CFILLEDCIRCLE2D( via_center,
+                                                                 hole_inner_radius + thickness,
+                                                                 *track ) );
 
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
+            m_through_holes_inner.Add( new CFILLEDCIRCLE2D( via_center,
+                                                            hole_inner_radius,
+                                                            *track ) );
 
-            // ADD VIAS and THT
-            if( track->Type() == PCB_VIA_T )
-            {
-                const VIA*    via               = static_cast<const VIA*>( track );
-                const VIATYPE viatype           = via->GetViaType();
-                const float   holediameter      = via->GetDrillValue() * BiuTo3Dunits();
-                const float   thickness         = GetCopperThickness3DU();
-                const float   hole_inner_radius = ( holediameter / 2.0f );
+            // Add through hole contourns
+            const int holediameterBIU   = via->GetDrillValue();
+            const int hole_outer_radius = ( holediameterBIU / 2 ) + GetCopperThicknessBIU();
 
-                const SFVEC2F via_center(
-                        via->GetStart().x * m_biuTo3Dunits, -via->GetStart().y * m_biuTo3Dunits );
+            TransformCircleToPolygon( m_through_outer_holes_poly, via->GetStart(),
+                    hole_outer_radius, ARC_HIGH_DEF );
 
-                if( viatype != VIATYPE::THROUGH )
-                {
+            TransformCircleToPolygon( m_through_inner_holes_poly, via->GetStart(),
+                    holediameterBIU / 2, ARC_HIGH_DEF );
 
-                    // Add hole objects
-                    // /////////////////////////////////////////////////////////
+            // Add samething for vias only
+            TransformCircleToPolygon( m_through_outer_holes_vias_poly, via->GetStart(),
+                    hole_outer_radius, ARC_HIGH_DEF );
+        }
 
-                    CBVHCONTAINER2D *layerHoleContainer = NULL;
+        // Add holes of modules, and their contours (pads can be Circle or Segment holes)
+        for( MODULE* module : m_board->Modules() )
+        {
+            for( D_PAD* pad : module->Pads() )
+            {
+                const wxSize padHole = pad->GetDrillSize();
 
-                    // Check if the layer is already created
-                    if( m_layers_holes2D.find( curr_layer_id ) == m_layers_holes2D.end() )
-                    {
-                        // not found, create a new container
-                        layerHoleContainer = new CBVHCONTAINER2D;
-                        m_layers_holes2D[curr_layer_id] = layerHoleContainer;
-                    }
-                    else
-                    {
-                        // found
-                        layerHoleContainer = m_layers_holes2D[curr_layer_id];
-                    }
+                if( !padHole.x )    // Not drilled pad like SMD pad
+                    continue;
 
-                    // Add a hole for this layer
-                    layerHoleContainer->Add( new CFILLEDCIRCLE2D( via_center,
-                                                                  hole_inner_radius + thickness,
-                                                                  *track ) );
-                }
-                else if( curr_layer_id == layer_id[0] ) // it only adds once the THT holes
-                {
-                    // Add through hole object
-                    // /////////////////////////////////////////////////////////
-                    m_through_holes_outer.Add( new CFILLEDCIRCLE2D( via_center,
-                                                                    hole_inner_radius + thickness,
-                                                                    *track ) );
+                m_stats_nr_holes++;
+                m_stats_hole_med_diameter += ( ( pad->GetDrillSize().x +
+                                                 pad->GetDrillSize().y ) / 2.0f ) * m_biuTo3Dunits;
 
-                    m_through_holes_vias_outer.Add(
-                                new CFILLEDCIRCLE2D( via_center,
-                                                     hole_inner_radius + thickness,
-                                                     *track ) );
+                // The hole in the body is inflated by copper thickness,
+                // if not plated, no copper
+                if( pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED )
+                {
+                    m_through_holes_outer.Add( createNewPadDrill( pad, GetCopperThicknessBIU() ) );
+                    m_through_holes_inner.Add( createNewPadDrill( pad, 0 ) );
 
-                    m_through_holes_inner.Add( new CFILLEDCIRCLE2D( via_center,
-                                                                    hole_inner_radius,
-                                                                    *track ) );
+                    pad->BuildPadDrillShapePolygon( m_through_outer_holes_poly,
+                                                    GetCopperThicknessBIU() );
+                    pad->BuildPadDrillShapePolygon( m_through_inner_holes_poly, 0 );
+                }
+                else
+                {
+                    m_through_holes_outer.Add( createNewPadDrill( pad, 0 ) );
+                    m_through_holes_inner.Add( createNewPadDrill( pad, 0 ) );
 
-                    //m_through_holes_vias_inner.Add( new CFILLEDCIRCLE2D( via_center,
-                    //                                                     hole_inner_radius,
-                    //                                                     *track ) );
+                    pad->BuildPadDrillShapePolygon( m_through_outer_holes_poly_NPTH,
+                                                    GetCopperThicknessBIU() );
                 }
             }
         }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T04: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Create VIAS and THTs objects and add it to holes containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
-    {
-        // ADD TRACKS
-        const unsigned int nTracks = trackList.size();
 
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-        {
-            const TRACK *track = trackList[trackIdx];
+        if( m_stats_nr_holes )
+            m_stats_hole_med_diameter /= (float)m_stats_nr_holes;
 
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
+        // This will make a union of all added contourns
+        m_through_inner_holes_poly.BatchUnion( SHAPE_POLY_SET::PM_FAST, PoolParallelFor );
+        m_through_outer_holes_poly.BatchUnion( SHAPE_POLY_SET::PM_FAST, PoolParallelFor );
+        m_through_outer_holes_poly_NPTH.BatchUnion( SHAPE_POLY_SET::PM_FAST, PoolParallelFor );
+        m_through_outer_holes_vias_poly.BatchUnion( SHAPE_POLY_SET::PM_FAST, PoolParallelFor );
+        //m_through_inner_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST ); // Not in use
+    } );
 
-            // ADD VIAS and THT
-            if( track->Type() == PCB_VIA_T )
+    layerTasks.ParallelFor( layer_id.size(),
+            [&]( size_t aLayerIdx )
             {
-                const VIA *via = static_cast< const VIA*>( track );
-                const VIATYPE viatype = via->GetViaType();
+                const PCB_LAYER_ID curr_layer_id  = layer_id[aLayerIdx];
+                CBVHCONTAINER2D*   layerContainer = layerContainers[aLayerIdx];
+                SHAPE_POLY_SET*    layerPoly      = layerPolys[aLayerIdx];
+                VIA_HOLES&         viaHoles       = layerViaHoles[aLayerIdx];
 
-                if( viatype != VIATYPE::THROUGH )
+                // Create tracks as objects and add it to container
+                for( const TRACK* track : trackList )
                 {
+                    // NOTE: Vias can be on multiple layers
+                    if( !track->IsOnLayer( curr_layer_id ) )
+                        continue;
 
-                    // Add VIA hole contourns
-                    // /////////////////////////////////////////////////////////
+                    // Add object item to layer container
+                    layerContainer->Add( createNewTrack( track, 0.0f ) );
 
-                    // Add outer holes of VIAs
-                    SHAPE_POLY_SET *layerOuterHolesPoly = NULL;
-                    SHAPE_POLY_SET *layerInnerHolesPoly = NULL;
+                    // Add the track contour
+                    if( layerPoly )
+                        track->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
 
-                    // Check if the layer is already created
-                    if( m_layers_outer_holes_poly.find( curr_layer_id ) ==
-                        m_layers_outer_holes_poly.end() )
-                    {
-                        // not found, create a new container
-                        layerOuterHolesPoly = new SHAPE_POLY_SET;
-                        m_layers_outer_holes_poly[curr_layer_id] = layerOuterHolesPoly;
+                    if( track->Type() != PCB_VIA_T )
+                        continue;
 
-                        wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) ==
-                                  m_layers_inner_holes_poly.end() );
+                    const VIA* via = static_cast<const VIA*>( track );
 
-                        layerInnerHolesPoly = new SHAPE_POLY_SET;
-                        m_layers_inner_holes_poly[curr_layer_id] = layerInnerHolesPoly;
-                    }
-                    else
-                    {
-                        // found
-                        layerOuterHolesPoly = m_layers_outer_holes_poly[curr_layer_id];
-
-                        wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) !=
-                                  m_layers_inner_holes_poly.end() );
+                    if( via->GetViaType() == VIATYPE::THROUGH )
+                        continue;
 
-                        layerInnerHolesPoly = m_layers_inner_holes_poly[curr_layer_id];
+                    // Add hole objects and contourns of the blind and buried VIAs
+                    if( !viaHoles.m_container )
+                    {
+                        viaHoles.m_container = new CBVHCONTAINER2D;
+                        viaHoles.m_outerPoly = new SHAPE_POLY_SET;
+                        viaHoles.m_innerPoly = new SHAPE_POLY_SET;
                     }
 
-                    const int holediameter = via->GetDrillValue();
-                    const int hole_outer_radius = (holediameter / 2) + GetCopperThicknessBIU();
+                    const float   holediameter      = via->GetDrillValue() * BiuTo3Dunits();
+                    const float   thickness         = GetCopperThickness3DU();
+                    const float   hole_inner_radius = ( holediameter / 2.0f );
 
-                    TransformCircleToPolygon( *layerOuterHolesPoly, via->GetStart(),
-                            hole_outer_radius, ARC_HIGH_DEF );
+                    const SFVEC2F via_center( via->GetStart().x * m_biuTo3Dunits,
+                                             -via->GetStart().y * m_biuTo3Dunits );
 
-                    TransformCircleToPolygon( *layerInnerHolesPoly, via->GetStart(),
-                            holediameter / 2, ARC_HIGH_DEF );
-                }
-                else if( curr_layer_id == layer_id[0] ) // it only adds once the THT holes
-                {
-                    const int holediameter = via->GetDrillValue();
-                    const int hole_outer_radius = (holediameter / 2)+ GetCopperThicknessBIU();
-
-                    // Add through hole contourns
-                    // /////////////////////////////////////////////////////////
-                    TransformCircleToPolygon( m_through_outer_holes_poly, via->GetStart(),
-                            hole_outer_radius, ARC_HIGH_DEF );
-
-                    TransformCircleToPolygon( m_through_inner_holes_poly, via->GetStart(),
-                            holediameter / 2, ARC_HIGH_DEF );
+                    viaHoles.m_container->Add( new CFILLEDCIRCLE2D( via_center,
+                                                                    hole_inner_radius + thickness,
+                                                                    *track ) );
 
-                    // Add samething for vias only
+                    const int holediameterBIU   = via->GetDrillValue();
+                    const int hole_outer_radius = ( holediameterBIU / 2 ) + GetCopperThicknessBIU();
 
-                    TransformCircleToPolygon( m_through_outer_holes_vias_poly, via->GetStart(),
+                    TransformCircleToPolygon( *viaHoles.m_outerPoly, via->GetStart(),
                             hole_outer_radius, ARC_HIGH_DEF );
 
-                    //TransformCircleToPolygon( m_through_inner_holes_vias_poly,
-                    //                          via->GetStart(),
-                    //                          holediameter / 2,
-                    //                          GetNrSegmentsCircle( holediameter ) );
+                    TransformCircleToPolygon( *viaHoles.m_innerPoly, via->GetStart(),
+                            holediameterBIU / 2, ARC_HIGH_DEF );
                 }
-            }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T05: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Creates outline contours of the tracks and add it to the poly of the layer
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        for( PCB_LAYER_ID curr_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD TRACKS
-            unsigned int nTracks = trackList.size();
-
-            for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-            {
-                const TRACK *track = trackList[trackIdx];
-
-                if( !track->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                // Add the track contour
-                track->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
-            }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T06: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
 
-    // Add holes of modules
-    // /////////////////////////////////////////////////////////////////////////
-    for( MODULE* module : m_board->Modules() )
-    {
-        for( D_PAD* pad : module->Pads() )
-        {
-            const wxSize padHole = pad->GetDrillSize();
+                // Add modules PADs objects and poly contourns
+                for( MODULE* module : m_board->Modules() )
+                {
+                    // Note: NPTH pads are not drawn on copper layers when the pad
+                    // has same shape as its hole
+                    AddPadsShapesWithClearanceToContainer( module,
+                                                           layerContainer,
+                                                           curr_layer_id,
+                                                           0,
+                                                           true );
 
-            if( !padHole.x )    // Not drilled pad like SMD pad
-                continue;
+                    if( layerPoly )
+                    {
+                        transformPadsShapesWithClearanceToPolygon( module->Pads(),
+                                                                   curr_layer_id,
+                                                                   *layerPoly,
+                                                                   0,
+                                                                   true );
+
+                        // Micro-wave modules may have items on copper layers
+                        transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id,
+                                                                *layerPoly );
+                    }
+                }
 
-            // The hole in the body is inflated by copper thickness,
-            // if not plated, no copper
-            const int inflate = (pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED) ?
-                                GetCopperThicknessBIU() : 0;
+                // Add graphic segments on copper layers, the texts are added afterwards
+                for( BOARD_ITEM* item : m_board->Drawings() )
+                {
+                    if( item->Type() != PCB_LINE_T || !item->IsOnLayer( curr_layer_id ) )
+                        continue;
 
-            m_stats_nr_holes++;
-            m_stats_hole_med_diameter += ( ( pad->GetDrillSize().x +
-                                             pad->GetDrillSize().y ) / 2.0f ) * m_biuTo3Dunits;
+                    AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
+                                                      layerContainer,
+                                                      curr_layer_id,
+                                                      0 );
 
-            m_through_holes_outer.Add( createNewPadDrill( pad, inflate ) );
-            m_through_holes_inner.Add( createNewPadDrill( pad,       0 ) );
-        }
-    }
-    if( m_stats_nr_holes )
-        m_stats_hole_med_diameter /= (float)m_stats_nr_holes;
+                    if( layerPoly )
+                        ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *layerPoly,
+                                                                                       0 );
+                }
+            } );
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T07: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+    layerTasks.Wait();
 
-    // Add contours of the pad holes (pads can be Circle or Segment holes)
-    // /////////////////////////////////////////////////////////////////////////
-    for( MODULE* module : m_board->Modules() )
+    for( size_t i = 0; i < layer_id.size(); ++i )
     {
-        for( D_PAD* pad : module->Pads() )
+        if( layerViaHoles[i].m_container )
         {
-            const wxSize padHole = pad->GetDrillSize();
-
-            if( !padHole.x ) // Not drilled pad like SMD pad
-                continue;
-
-            // The hole in the body is inflated by copper thickness.
-            const int inflate = GetCopperThicknessBIU();
-
-            if( pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED )
-            {
-                pad->BuildPadDrillShapePolygon( m_through_outer_holes_poly, inflate );
-                pad->BuildPadDrillShapePolygon( m_through_inner_holes_poly, 0 );
-            }
-            else
-            {
-                // If not plated, no copper.
-                pad->BuildPadDrillShapePolygon( m_through_outer_holes_poly_NPTH, inflate );
-            }
+            m_layers_holes2D[layer_id[i]]           = layerViaHoles[i].m_container;
+            m_layers_outer_holes_poly[layer_id[i]] = layerViaHoles[i].m_outerPoly;
+            m_layers_inner_holes_poly[layer_id[i]] = layerViaHoles[i].m_innerPoly;
         }
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T08: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
+    printf( "T03: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
     start_Time = GetRunningMicroSecs();
 #endif
 
-    // Add modules PADs objects to containers
+    // Add texts on copper layers.  They are stroked by the BASIC_GAL shared by all the
+    // texts, which cannot be used by several threads.
     // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
+    for( size_t i = 0; i < layer_id.size(); ++i )
     {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
+        const PCB_LAYER_ID curr_layer_id  = layer_id[i];
+        CBVHCONTAINER2D*   layerContainer = layerContainers[i];
+        SHAPE_POLY_SET*    layerPoly      = layerPolys[i];
 
-        // ADD PADS
         for( MODULE* module : m_board->Modules() )
         {
-            // Note: NPTH pads are not drawn on copper layers when the pad
-            // has same shape as its hole
-            AddPadsShapesWithClearanceToContainer( module,
-                                                   layerContainer,
-                                                   curr_layer_id,
-                                                   0,
-                                                   true );
-
             // Micro-wave modules may have items on copper layers
             AddGraphicsShapesWithClearanceToContainer( module,
                                                        layerContainer,
                                                        curr_layer_id,
                                                        0 );
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T09: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Add modules PADs poly contourns
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        for( PCB_LAYER_ID curr_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD PADS
-            for( auto module : m_board->Modules() )
-            {
-                // Construct polys
-                // /////////////////////////////////////////////////////////////
 
-                // Note: NPTH pads are not drawn on copper layers when the pad
-                // has same shape as its hole
-                transformPadsShapesWithClearanceToPolygon( module->Pads(),
-                                                           curr_layer_id,
-                                                           *layerPoly,
-                                                           0,
-                                                           true );
-
-                // Micro-wave modules may have items on copper layers
+            if( layerPoly )
                 module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id,
                                                                        *layerPoly,
                                                                        0 );
-
-                transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
-            }
         }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T10: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Add graphic item on copper layers to object containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
-    {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
 
-        // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-        for( auto item : m_board->Drawings() )
+        for( BOARD_ITEM* item : m_board->Drawings() )
         {
             if( !item->IsOnLayer( curr_layer_id ) )
                 continue;
@@ -606,19 +488,17 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
             switch( item->Type() )
             {
             case PCB_LINE_T:
-            {
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            }
-            break;
+                break;
 
             case PCB_TEXT_T:
                 AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
                                                   layerContainer,
                                                   curr_layer_id,
                                                   0 );
+
+                if( layerPoly )
+                    ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly,
+                                                                                   0 );
             break;
 
             case PCB_DIMENSION_T:
@@ -638,197 +518,75 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T11: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
+    printf( "T04: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
     start_Time = GetRunningMicroSecs();
 #endif
 
-    // Add graphic item on copper layers to poly contourns
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+    if( aStatusTextReporter )
     {
-        for( PCB_LAYER_ID cur_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( cur_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[cur_layer_id];
-
-            // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-            for( BOARD_ITEM* item : m_board->Drawings() )
-            {
-                if( !item->IsOnLayer( cur_layer_id ) )
-                    continue;
-
-                switch( item->Type() )
-                {
-                case PCB_LINE_T:
-                    ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
-                    break;
-
-                case PCB_TEXT_T:
-                    ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0 );
-                    break;
-
-                default:
-                    wxLogTrace( m_logTrace, wxT( "createLayers: item type: %d not implemented" ),
-                                item->Type() );
-                    break;
-                }
-            }
-        }
+        if( GetFlag( FL_ZONE ) )
+            aStatusTextReporter->Report( _( "Create zones" ) );
+        else
+            aStatusTextReporter->Report( _( "Simplifying copper layers polygons" ) );
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T12: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+    // Add zones objects, and simplify the polygons of each layer
+    // /////////////////////////////////////////////////////////////////////////
+    TASK_GROUP zoneTasks;
 
     if( GetFlag( FL_ZONE ) )
     {
-        if( aStatusTextReporter )
-            aStatusTextReporter->Report( _( "Create zones" ) );
-
-        // Add zones objects
-        // /////////////////////////////////////////////////////////////////////
-        std::atomic<size_t> nextZone( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
-
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t areaId = nextZone.fetch_add( 1 );
-                            areaId < static_cast<size_t>( m_board->GetAreaCount() );
-                            areaId = nextZone.fetch_add( 1 ) )
+        zoneTasks.ParallelFor( m_board->GetAreaCount(),
+                [&]( size_t areaId )
                 {
                     const ZONE_CONTAINER* zone = m_board->GetArea( areaId );
 
-                    if( zone == nullptr )
-                        break;
-
                     auto layerContainer = m_layers_container2D.find( zone->GetLayer() );
 
                     if( layerContainer != m_layers_container2D.end() )
                         AddSolidAreasShapesToContainer( zone, layerContainer->second,
                                                         zone->GetLayer() );
-                }
-
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "fill zones T13: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    if( GetFlag( FL_ZONE ) && GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        // ADD COPPER ZONES
-        for( ZONE_CONTAINER* zone : m_board->Zones() )
-        {
-            if( zone == nullptr )
-                break;
-
-            auto layerContainer = m_layers_poly.find( zone->GetLayer() );
-
-            if( layerContainer != m_layers_poly.end() )
-                zone->TransformSolidAreasShapesToPolygonSet( *layerContainer->second );
-        }
+                } );
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T14: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+    zoneTasks.ParallelFor( layer_id.size(),
+            [&]( size_t aLayerIdx )
+            {
+                SHAPE_POLY_SET* layerPoly = layerPolys[aLayerIdx];
 
-    // Simplify layer polygons
-    // /////////////////////////////////////////////////////////////////////////
+                if( layerPoly )
+                {
+                    // ADD COPPER ZONES
+                    if( GetFlag( FL_ZONE ) )
+                    {
+                        for( ZONE_CONTAINER* zone : m_board->Zones() )
+                        {
+                            if( zone->GetLayer() == layer_id[aLayerIdx] )
+                                zone->TransformSolidAreasShapesToPolygonSet( *layerPoly );
+                        }
+                    }
 
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Simplifying copper layers polygons" ) );
+                    // This will make a union of all added contours
+                    layerPoly->BatchUnion( SHAPE_POLY_SET::PM_FAST, PoolParallelFor );
+                }
 
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        std::atomic<size_t> nextItem( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
+                // Simplify holes polygon contours
+                VIA_HOLES& viaHoles = layerViaHoles[aLayerIdx];
 
-        size_t parallelThreadCount = std::min<size_t>(
-                std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-                layer_id.size() );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&nextItem, &threadsFinished, &layer_id, this]()
-            {
-                for( size_t i = nextItem.fetch_add( 1 );
-                            i < layer_id.size();
-                            i = nextItem.fetch_add( 1 ) )
+                if( viaHoles.m_container )
                 {
-                    auto layerPoly = m_layers_poly.find( layer_id[i] );
-
-                    if( layerPoly != m_layers_poly.end() )
-                        // This will make a union of all added contours
-                        layerPoly->second->Simplify( SHAPE_POLY_SET::PM_FAST );
+                    viaHoles.m_outerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
+                    viaHoles.m_innerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
                 }
-
-                threadsFinished++;
             } );
 
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T15: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Simplify holes polygon contours
-    // /////////////////////////////////////////////////////////////////////////
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Simplify holes contours" ) );
-
-    for( PCB_LAYER_ID layer : layer_id )
-    {
-        if( m_layers_outer_holes_poly.find( layer ) != m_layers_outer_holes_poly.end() )
-        {
-            // found
-            SHAPE_POLY_SET *polyLayer = m_layers_outer_holes_poly[layer];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
-
-            wxASSERT( m_layers_inner_holes_poly.find( layer ) != m_layers_inner_holes_poly.end() );
-
-            polyLayer = m_layers_inner_holes_poly[layer];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
-        }
-    }
+    zoneTasks.Wait();
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T16: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
+    printf( "T05: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
 #endif
     // End Build Copper layers
 
-
-    // This will make a union of all added contourns
-    m_through_inner_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly_NPTH.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    //m_through_inner_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST ); // Not in use
-
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_endCopperLayersTime = GetRunningMicroSecs();
 #endif
@@ -901,6 +901,12 @@ void C3D_RENDER_OGL_LEGACY::load_3D_models( REPORTER *aStatusTextReporter )
        (!m_boardAdapter.GetFlag( FL_MODULE_ATTRIBUTES_VIRTUAL )) )
         return;
 
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report( _( "Loading 3D models" ) );
+
+    // Load the models in parallel, the loop below then finds them in the cache
+    m_boardAdapter.Load3DModels( false );
+
     // Go for all modules
     for( auto module : m_boardAdapter.GetBoard()->Modules() )
     {
@@ -28,6 +28,7 @@
  */
 
 #include "cbvh_pbrt.h"
+#include "../raypacket_kernels.h"
 #include <wx/debug.h>
 
 
@@ -45,48 +46,16 @@ struct StackNode
 };
 
 
-static inline unsigned int getFirstHit( const RAYPACKET &aRayPacket,
-                                        const CBBOX &aBBox,
-                                        unsigned int ia,
-                                        HITINFO_PACKET *aHitInfoPacket )
-{
-    float hitT;
-
-    if( aBBox.Intersect( aRayPacket.m_ray[ia], &hitT ) )
-        if( hitT < aHitInfoPacket[ia].m_HitInfo.m_tHit )
-            return ia;
-
-    if( !aRayPacket.m_Frustum.Intersect( aBBox ) )
-        return RAYPACKET_RAYS_PER_PACKET;
-
-    for( unsigned int i = ia + 1; i < RAYPACKET_RAYS_PER_PACKET; ++i )
-    {
-        if( aBBox.Intersect( aRayPacket.m_ray[i], &hitT ) )
-            if( hitT < aHitInfoPacket[i].m_HitInfo.m_tHit )
-                return i;
-    }
-
-    return RAYPACKET_RAYS_PER_PACKET;
-}
-
-
 #ifdef BVH_RANGED_TRAVERSAL
 
-static inline unsigned int getLastHit( const RAYPACKET &aRayPacket,
-                                       const CBBOX &aBBox,
-                                       unsigned int ia,
-                                       HITINFO_PACKET *aHitInfoPacket )
+static inline unsigned int firstRay( uint64_t aRays )
 {
-    for( unsigned int ie = (RAYPACKET_RAYS_PER_PACKET - 1); ie > ia; --ie )
-    {
-        float hitT;
+    unsigned int i = 0;
 
-        if( aBBox.Intersect( aRayPacket.m_ray[ie], &hitT ) )
-            if( hitT < aHitInfoPacket[ie].m_HitInfo.m_tHit )
-                return ie + 1;
-    }
+    while( !( aRays & ( (uint64_t) 1 << i ) ) )
+        ++i;
 
-    return ia + 1;
+    return i;
 }
 
 
@@ -94,6 +63,8 @@ static inline unsigned int getLastHit( const RAYPACKET &aRayPacket,
 // http://cseweb.ucsd.edu/~ravir/whitted.pdf
 
 // Ranged Traversal
+// The boxes and the primitives are tested against all the alive rays of the packet at once,
+// see raypacket_kernels.h.
 bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
                            HITINFO_PACKET *aHitInfoPacket ) const
 {
@@ -107,16 +78,25 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
     int todoOffset = 0, nodeNum = 0;
     StackNode todo[MAX_TODOS];
 
+    // The nearest hits so far, packed for the kernels
+    float tHit[RAYPACKET_RAYS_PER_PACKET];
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+
     unsigned int ia = 0;
 
     while( true )
     {
         const LinearBVHNode *curCell = &m_nodes[nodeNum];
 
-        ia = getFirstHit( aRayPacket, curCell->bounds, ia, aHitInfoPacket );
+        const uint64_t rays = RAYPACKET_IntersectBBox( aRayPacket.m_soa, curCell->bounds, tHit,
+                                                       ~(uint64_t) 0 << ia );
 
-        if( ia < RAYPACKET_RAYS_PER_PACKET )
+        if( rays )
         {
+            ia = firstRay( rays );
+
             if( curCell->nPrimitives == 0 )
             {
                 StackNode &node = todo[todoOffset++];
@@ -127,26 +107,23 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
             }
             else
             {
-                const unsigned int ie = getLastHit( aRayPacket,
-                                                    curCell->bounds,
-                                                    ia,
-                                                    aHitInfoPacket );
-
+                // The primitives are inside the node's box, so only the rays entering it
+                // can hit them
                 for( int j = 0; j < curCell->nPrimitives; ++j )
                 {
                     const COBJECT *obj = m_primitives[curCell->primitivesOffset + j];
 
                     if( aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
                     {
-                        for( unsigned int i = ia; i < ie; ++i )
-                        {
-                            const bool hitted = obj->Intersect( aRayPacket.m_ray[i],
-                                                                aHitInfoPacket[i].m_HitInfo );
+                        const uint64_t hits = obj->IntersectPacket( aRayPacket, rays, tHit,
+                                                                    aHitInfoPacket );
 
-                            if( hitted )
+                        for( unsigned int i = ia; hits && i < RAYPACKET_RAYS_PER_PACKET; ++i )
+                        {
+                            if( hits & ( (uint64_t) 1 << i ) )
                             {
-                                anyHitted |= hitted;
-                                aHitInfoPacket[i].m_hitresult |= hitted;
+                                anyHitted = true;
+                                aHitInfoPacket[i].m_hitresult = true;
                                 aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
                             }
                         }
@@ -1256,6 +1256,13 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models()
 {
+    // Offscreen renders may be made without any 3D model
+    if( !m_boardAdapter.Get3DCacheManager() )
+        return;
+
+    // Load the models in parallel, the loop below then finds them in the cache
+    m_boardAdapter.Load3DModels( true );
+
     // Go for all modules
     for( auto module : m_boardAdapter.GetBoard()->Modules() )
     {
@@ -32,7 +32,8 @@
 #include <atomic>
 #include <chrono>
 #include <climits>
-#include <thread>
+
+#include <wx/image.h>
 
 #include "c3d_render_raytracing.h"
 #include "mortoncodes.h"
@@ -41,6 +42,7 @@
 #include "3d_math.h"
 #include "../common_ogl/ogl_utils.h"
 #include <profile.h>        // To use GetRunningMicroSecs or another profiling utility
+#include <thread_pool.h>
 
 // This should be used in future for the function
 // convertLinearToSRGB
@@ -166,6 +168,7 @@ bool C3D_RENDER_RAYTRACING::Redraw(
         // revert to preview mode the first time the Redraw is called
         m_oldWindowsSize = m_windowSize;
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
     std::unique_ptr<BUSY_INDICATOR> busy = CreateBusyIndicator();
@@ -192,6 +195,7 @@ bool C3D_RENDER_RAYTRACING::Redraw(
         requestRedraw = true;
 
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
 
@@ -299,6 +303,96 @@ bool C3D_RENDER_RAYTRACING::Redraw(
 }
 
 
+bool C3D_RENDER_RAYTRACING::RenderOffscreen( const wxSize &aSize, wxImage &aImage,
+                                             REPORTER *aStatusTextReporter,
+                                             REPORTER *aWarningTextReporter,
+                                             const wxString &aPngFileName )
+{
+    // The PBO is replaced by a buffer in memory, and the window by aSize
+    m_windowSize = aSize;
+    m_camera.SetCurWindowSize( aSize );
+
+    if( m_reloadRequested )
+    {
+        if( aStatusTextReporter )
+            aStatusTextReporter->Report( _( "Loading..." ) );
+
+        reload( aStatusTextReporter, aWarningTextReporter );
+    }
+
+    initialize_block_positions();
+
+    std::vector<GLubyte> buffer( m_realBufferSize.x * m_realBufferSize.y * 4, 0 );
+
+    aImage.Create( aSize.x, aSize.y, false );
+
+    auto lastSaveTime = std::chrono::steady_clock::now();
+
+    m_rt_render_state = RT_RENDER_STATE_MAX;
+
+    do
+    {
+        render( buffer.data(), aStatusTextReporter );
+
+        // The tracing stops about every 150 ms to report its progress, which is also when
+        // the partial image can be written
+        if( !aPngFileName.IsEmpty() && m_rt_render_state != RT_RENDER_STATE_FINISH
+                && std::chrono::steady_clock::now() - lastSaveTime > std::chrono::seconds( 1 ) )
+        {
+            copy_buffer_to_image( buffer.data(), aImage );
+            aImage.SaveFile( aPngFileName, wxBITMAP_TYPE_PNG );
+            lastSaveTime = std::chrono::steady_clock::now();
+        }
+    } while( m_rt_render_state != RT_RENDER_STATE_FINISH );
+
+    copy_buffer_to_image( buffer.data(), aImage );
+
+    // The next Redraw() must size the blocks and the PBO again for the window
+    m_oldWindowsSize = wxSize( 0, 0 );
+
+    if( !aPngFileName.IsEmpty() )
+        return aImage.SaveFile( aPngFileName, wxBITMAP_TYPE_PNG );
+
+    return true;
+}
+
+
+void C3D_RENDER_RAYTRACING::copy_buffer_to_image( const GLubyte *aBuffer,
+                                                  wxImage &aImage ) const
+{
+    unsigned char *ptrImage = aImage.GetData();
+
+    for( int y = 0; y < m_windowSize.y; ++y )
+    {
+        // The buffer rows go upwards, as the OpenGL ones, and the image rows downwards
+        unsigned char *ptr = &ptrImage[ ( m_windowSize.y - 1 - y ) * m_windowSize.x * 3 ];
+        const int yBuffer = y - (int)m_yoffset;
+
+        // Around the blocks, the background is drawn as OGL_DrawBackground does it
+        const float posYfactor = (float)y / (float)m_windowSize.y;
+        const SFVEC3F bgColor = (SFVEC3F)m_boardAdapter.m_BgColorTop * posYfactor +
+                                (SFVEC3F)m_boardAdapter.m_BgColorBot * ( 1.0f - posYfactor );
+
+        GLubyte bgPixel[4];
+        rt_final_color( bgPixel, bgColor, false );
+
+        for( int x = 0; x < m_windowSize.x; ++x, ptr += 3 )
+        {
+            const int xBuffer = x - (int)m_xoffset;
+            const GLubyte *pixel = bgPixel;
+
+            if( ( yBuffer >= 0 ) && ( yBuffer < (int)m_realBufferSize.y ) &&
+                ( xBuffer >= 0 ) && ( xBuffer < (int)m_realBufferSize.x ) )
+                pixel = &aBuffer[ ( yBuffer * m_realBufferSize.x + xBuffer ) * 4 ];
+
+            ptr[0] = pixel[0];
+            ptr[1] = pixel[1];
+            ptr[2] = pixel[2];
+        }
+    }
+}
+
+
 void C3D_RENDER_RAYTRACING::render( GLubyte *ptrPBO , REPORTER *aStatusTextReporter )
 {
     if( (m_rt_render_state == RT_RENDER_STATE_FINISH) ||
@@ -367,22 +461,13 @@ void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte *ptrPBO ,
     m_isPreview = false;
 
     auto startTime = std::chrono::steady_clock::now();
-    bool breakLoop = false;
 
     std::atomic<size_t> numBlocksRendered( 0 );
-    std::atomic<size_t> currentBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
 
-    size_t parallelThreadCount = std::min<size_t>(
-            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-            m_blockPositions.size() );
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-    {
-        std::thread t = std::thread( [&]()
-        {
-            for( size_t iBlock = currentBlock.fetch_add( 1 );
-                        iBlock < m_blockPositions.size() && !breakLoop;
-                        iBlock = currentBlock.fetch_add( 1 ) )
+    TASK_GROUP renderTasks;
+
+    renderTasks.ParallelFor( m_blockPositions.size(),
+            [&]( size_t iBlock )
             {
                 if( !m_blockPositionsWasProcessed[iBlock] )
                 {
@@ -394,18 +479,11 @@ void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte *ptrPBO ,
                     // to display the progress
                     if( std::chrono::duration_cast<std::chrono::milliseconds>(
                             std::chrono::steady_clock::now() - startTime ).count() > 150 )
-                        breakLoop = true;
+                        renderTasks.Cancel();
                 }
-            }
-
-            threadsFinished++;
-        } );
-
-        t.detach();
-    }
+            } );
 
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    renderTasks.Wait();
 
     m_nrBlocksRenderProgress += numBlocksRendered;
 
@@ -461,7 +539,7 @@ SFVEC3F ConvertSRGBToLinear( const SFVEC3F &aSRGBcolor )
 #endif
 
 void C3D_RENDER_RAYTRACING::rt_final_color( GLubyte *ptrPBO, const SFVEC3F &rgbColor,
-                                            bool applyColorSpaceConversion )
+                                            bool applyColorSpaceConversion ) const
 {
 
     SFVEC3F color = rgbColor;
@@ -916,17 +994,10 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_shade( GLubyte *ptrPBO,
         if( aStatusTextReporter )
             aStatusTextReporter->Report( _("Rendering: Post processing shader") );
 
-        std::atomic<size_t> nextBlock( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
+        TASK_GROUP shadeTasks;
 
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t y = nextBlock.fetch_add( 1 );
-                            y < m_realBufferSize.y;
-                            y = nextBlock.fetch_add( 1 ) )
+        shadeTasks.ParallelFor( m_realBufferSize.y,
+                [&]( size_t y )
                 {
                     SFVEC3F *ptr = &m_shaderBuffer[ y * m_realBufferSize.x ];
 
@@ -935,16 +1006,9 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_shade( GLubyte *ptrPBO,
                         *ptr = m_postshader_ssao.Shade( SFVEC2I( x, y ) );
                         ptr++;
                     }
-                }
-
-                threadsFinished++;
-            } );
+                } );
 
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        shadeTasks.Wait();
 
         // Set next state
         m_rt_render_state = RT_RENDER_STATE_POST_PROCESS_BLUR_AND_FINISH;
@@ -965,17 +1029,10 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_blur_finish( GLubyte *ptrPBO,
     if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
     {
         // Now blurs the shader result and compute the final color
-        std::atomic<size_t> nextBlock( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
+        TASK_GROUP blurTasks;
 
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t y = nextBlock.fetch_add( 1 );
-                            y < m_realBufferSize.y;
-                            y = nextBlock.fetch_add( 1 ) )
+        blurTasks.ParallelFor( m_realBufferSize.y,
+                [&]( size_t y )
                 {
                     GLubyte *ptr = &ptrPBO[ y * m_realBufferSize.x * 4 ];
 
@@ -1055,16 +1112,9 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_blur_finish( GLubyte *ptrPBO,
 
                         ptr += 4;
                     }
-                }
-
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
+                } );
 
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        blurTasks.Wait();
 
 
         // Debug code
@@ -1080,19 +1130,10 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
 {
     m_isPreview = true;
 
-    std::atomic<size_t> nextBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
+    TASK_GROUP previewTasks;
 
-    size_t parallelThreadCount = std::min<size_t>(
-            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-            m_blockPositions.size() );
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-    {
-        std::thread t = std::thread( [&]()
-        {
-            for( size_t iBlock = nextBlock.fetch_add( 1 );
-                        iBlock < m_blockPositionsFast.size();
-                        iBlock = nextBlock.fetch_add( 1 ) )
+    previewTasks.ParallelFor( m_blockPositionsFast.size(),
+            [&]( size_t iBlock )
             {
                 const SFVEC2UI &windowPosUI = m_blockPositionsFast[ iBlock ];
                 const SFVEC2I windowsPos = SFVEC2I( windowPosUI.x + m_xoffset,
@@ -1693,16 +1734,9 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
                         SetPixel( ptr + 12, BlendColor( cRBC, BlendColor( cRB , cC ) ) );
                     }
                 }
-            }
-
-            threadsFinished++;
-        } );
-
-        t.detach();
-    }
+            } );
 
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    previewTasks.Wait();
 }
 
 
@@ -2147,6 +2181,4 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     // Create m_shader buffer
     delete[] m_shaderBuffer;
     m_shaderBuffer = new SFVEC3F[m_realBufferSize.x * m_realBufferSize.y];
-
-    opengl_init_pbo();
 }
@@ -41,6 +41,8 @@
 
 #include <map>
 
+class wxImage;
+
 /// Vector of materials
 typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
 
@@ -70,6 +72,22 @@ public:
 
     int GetWaitForEditingTimeOut() override;
 
+    /**
+     * @brief RenderOffscreen - Render the board into an image, without OpenGL
+     * The blocks are traced by all the cores, as for the display, until the image is done.
+     * @param aSize: the size of the image
+     * @param aImage: the image to render into
+     * @param aStatusTextReporter: reports the progress, or NULL
+     * @param aWarningTextReporter: reports the warnings of the board loading, or NULL
+     * @param aPngFileName: if not empty, the PNG file written with the partial image about
+     * every second while tracing, and with the final image
+     * @return false if the PNG file could not be written
+     */
+    bool RenderOffscreen( const wxSize &aSize, wxImage &aImage,
+                          REPORTER *aStatusTextReporter = NULL,
+                          REPORTER *aWarningTextReporter = NULL,
+                          const wxString &aPngFileName = wxEmptyString );
+
 private:
     bool initializeOpenGL();
     void initializeNewWindowSize();
@@ -82,7 +100,9 @@ private:
     void rt_render_post_process_shade( GLubyte *ptrPBO , REPORTER *aStatusTextReporter );
     void rt_render_post_process_blur_finish( GLubyte *ptrPBO , REPORTER *aStatusTextReporter );
     void rt_render_trace_block( GLubyte *ptrPBO , signed int iBlock );
-    void rt_final_color( GLubyte *ptrPBO, const SFVEC3F &rgbColor, bool applyColorSpaceConversion );
+    void rt_final_color( GLubyte *ptrPBO, const SFVEC3F &rgbColor,
+                         bool applyColorSpaceConversion ) const;
+    void copy_buffer_to_image( const GLubyte *aBuffer, wxImage &aImage ) const;
 
     void rt_shades_packet( const SFVEC3F *bgColorY,
                            const RAY *aRayPkt,
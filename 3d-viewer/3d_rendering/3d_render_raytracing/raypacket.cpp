@@ -29,6 +29,7 @@
 
 #include "raypacket.h"
 #include "../3d_fastmath.h"
+#include <cmath>
 #include <wx/debug.h>
 
 
@@ -42,6 +43,25 @@ static void RAYPACKET_GenerateFrustum( CFRUSTUM *m_Frustum, RAY *m_ray )
 }
 
 
+static void RAYPACKET_InitSoA( RAYPACKET_SOA *m_soa, const RAY *m_ray )
+{
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            float invDir = m_ray[i].m_InvDir[axis];
+
+            if( std::isinf( invDir ) )
+                invDir = std::copysign( 1e30f, invDir );
+
+            m_soa->m_Origin[axis][i] = m_ray[i].m_Origin[axis];
+            m_soa->m_Dir[axis][i]    = m_ray[i].m_Dir[axis];
+            m_soa->m_InvDir[axis][i] = invDir;
+        }
+    }
+}
+
+
 RAYPACKET::RAYPACKET( const CCAMERA &aCamera, const SFVEC2I &aWindowsPosition )
 {
     unsigned int i = 0;
@@ -66,6 +86,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera, const SFVEC2I &aWindowsPosition )
     wxASSERT( i == RAYPACKET_RAYS_PER_PACKET );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    RAYPACKET_InitSoA( &m_soa, m_ray );
 }
 
 
@@ -75,6 +96,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera,
     RAYPACKET_InitRays( aCamera, aWindowsPosition, m_ray );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    RAYPACKET_InitSoA( &m_soa, m_ray );
 }
 
 
@@ -88,6 +110,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera,
                                            m_ray );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    RAYPACKET_InitSoA( &m_soa, m_ray );
 }
 
 
@@ -119,6 +142,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera,
     wxASSERT( i == RAYPACKET_RAYS_PER_PACKET );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    RAYPACKET_InitSoA( &m_soa, m_ray );
 }
 
 
@@ -148,6 +172,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera,
     wxASSERT( i == RAYPACKET_RAYS_PER_PACKET );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    RAYPACKET_InitSoA( &m_soa, m_ray );
 }
 
 
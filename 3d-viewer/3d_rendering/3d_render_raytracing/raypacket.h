@@ -40,10 +40,23 @@
 #define RAYPACKET_RAYS_PER_PACKET (RAYPACKET_DIM * RAYPACKET_DIM)
 
 
+/// The rays of a packet with one array per coordinate, as read by the SIMD kernels
+struct RAYPACKET_SOA
+{
+    float m_Origin[3][RAYPACKET_RAYS_PER_PACKET];
+    float m_Dir[3][RAYPACKET_RAYS_PER_PACKET];
+
+    /// The infinite components are replaced by large finite ones, so that a ray lying in
+    /// the plane of a box face never produces a NaN in the slab test
+    float m_InvDir[3][RAYPACKET_RAYS_PER_PACKET];
+};
+
+
 struct RAYPACKET
 {
-    CFRUSTUM    m_Frustum;
-    RAY         m_ray[RAYPACKET_RAYS_PER_PACKET];
+    CFRUSTUM      m_Frustum;
+    RAY           m_ray[RAYPACKET_RAYS_PER_PACKET];
+    RAYPACKET_SOA m_soa;
 
     RAYPACKET( const CCAMERA &aCamera,
                const SFVEC2I &aWindowsPosition );
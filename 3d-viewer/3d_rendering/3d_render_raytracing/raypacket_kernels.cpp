@@ -0,0 +1,465 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  raypacket_kernels.cpp
+ * @brief Scalar, SSE2 and AVX versions of the ray packet tests.  The SSE2 kernels are
+ * built on the x86 targets having SSE2, the AVX ones are compiled for AVX on their own
+ * and only run after checking the processor.
+ */
+
+#include "raypacket_kernels.h"
+
+#include <algorithm>
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __SSE2__ ) \
+        || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define RAYPACKET_HAVE_SSE2
+
+#if defined( __GNUC__ ) || defined( _MSC_VER )
+#define RAYPACKET_HAVE_AVX
+#endif
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined( RAYPACKET_HAVE_AVX ) && defined( __GNUC__ )
+#define RAYPACKET_AVX_FUNCTION __attribute__( ( target( "avx" ) ) )
+#else
+#define RAYPACKET_AVX_FUNCTION
+#endif
+
+
+/// Tolerance of the triangle kernels, so that they select the rays grazing an edge and
+/// leave the decision to the scalar test
+#define TRIANGLE_EPSILON 1e-5f
+
+
+typedef uint64_t ( *INTERSECT_BBOX_FUNC )( const RAYPACKET_SOA&, const CBBOX&, const float*,
+                                           uint64_t );
+
+typedef uint64_t ( *INTERSECT_TRIANGLE_FUNC )( const RAYPACKET_SOA&, const RAYPACKET_TRIANGLE&,
+                                               const float*, uint64_t );
+
+
+static uint64_t intersectBBoxScalar( const RAYPACKET_SOA &aPacket,
+                                     const CBBOX &aBBox,
+                                     const float *aTHit,
+                                     uint64_t aRayMask )
+{
+    uint64_t result = 0;
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        if( !( aRayMask & ( (uint64_t) 1 << i ) ) )
+            continue;
+
+        float tmin = 0.0f;
+        float tmax = aTHit[i];
+
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            const float org = aPacket.m_Origin[axis][i];
+            const float inv = aPacket.m_InvDir[axis][i];
+            const float t1 = ( aBBox.Min()[axis] - org ) * inv;
+            const float t2 = ( aBBox.Max()[axis] - org ) * inv;
+
+            tmin = std::max( tmin, std::min( t1, t2 ) );
+            tmax = std::min( tmax, std::max( t1, t2 ) );
+        }
+
+        if( tmin <= tmax )
+            result |= (uint64_t) 1 << i;
+    }
+
+    return result;
+}
+
+
+static uint64_t intersectTriangleScalar( const RAYPACKET_SOA &aPacket,
+                                         const RAYPACKET_TRIANGLE &aTri,
+                                         const float *aTHit,
+                                         uint64_t aRayMask )
+{
+    uint64_t result = 0;
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        if( !( aRayMask & ( (uint64_t) 1 << i ) ) )
+            continue;
+
+        const float dk  = aPacket.m_Dir[aTri.k][i];
+        const float dku = aPacket.m_Dir[aTri.ku][i];
+        const float dkv = aPacket.m_Dir[aTri.kv][i];
+        const float ok  = aPacket.m_Origin[aTri.k][i];
+        const float oku = aPacket.m_Origin[aTri.ku][i];
+        const float okv = aPacket.m_Origin[aTri.kv][i];
+
+        const float lnd = 1.0f / ( dk + aTri.nu * dku + aTri.nv * dkv );
+        const float t = ( aTri.nd - ok - aTri.nu * oku - aTri.nv * okv ) * lnd;
+
+        if( !( ( aTHit[i] > t ) && ( t > 0.0f ) ) )
+            continue;
+
+        const float hu = oku + t * dku - aTri.aku;
+        const float hv = okv + t * dkv - aTri.akv;
+        const float beta = hv * aTri.bnu + hu * aTri.bnv;
+        const float gamma = hu * aTri.cnu + hv * aTri.cnv;
+
+        if( beta < -TRIANGLE_EPSILON || gamma < -TRIANGLE_EPSILON
+                || beta + gamma > 1.0f + TRIANGLE_EPSILON )
+            continue;
+
+        const float dn = aPacket.m_Dir[0][i] * aTri.n.x + aPacket.m_Dir[1][i] * aTri.n.y
+                         + aPacket.m_Dir[2][i] * aTri.n.z;
+
+        if( dn > TRIANGLE_EPSILON )
+            continue;
+
+        result |= (uint64_t) 1 << i;
+    }
+
+    return result;
+}
+
+
+#ifdef RAYPACKET_HAVE_SSE2
+
+static uint64_t intersectBBoxSse2( const RAYPACKET_SOA &aPacket,
+                                   const CBBOX &aBBox,
+                                   const float *aTHit,
+                                   uint64_t aRayMask )
+{
+    const __m128 bmin[3] = { _mm_set1_ps( aBBox.Min().x ),
+                             _mm_set1_ps( aBBox.Min().y ),
+                             _mm_set1_ps( aBBox.Min().z ) };
+    const __m128 bmax[3] = { _mm_set1_ps( aBBox.Max().x ),
+                             _mm_set1_ps( aBBox.Max().y ),
+                             _mm_set1_ps( aBBox.Max().z ) };
+
+    uint64_t result = 0;
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; i += 4 )
+    {
+        if( !( ( aRayMask >> i ) & 0xF ) )
+            continue;
+
+        __m128 tmin = _mm_setzero_ps();
+        __m128 tmax = _mm_loadu_ps( aTHit + i );
+
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            const __m128 org = _mm_loadu_ps( &aPacket.m_Origin[axis][i] );
+            const __m128 inv = _mm_loadu_ps( &aPacket.m_InvDir[axis][i] );
+            const __m128 t1 = _mm_mul_ps( _mm_sub_ps( bmin[axis], org ), inv );
+            const __m128 t2 = _mm_mul_ps( _mm_sub_ps( bmax[axis], org ), inv );
+
+            // _mm_min_ps( a, b ) and _mm_max_ps( a, b ) return b when a lane is NaN, as
+            // std::min( b, a ) and std::max( b, a ) do: with the operands swapped, a NaN slab
+            // (0 * inf) gives the same result as the scalar kernel
+            tmin = _mm_max_ps( _mm_min_ps( t2, t1 ), tmin );
+            tmax = _mm_min_ps( _mm_max_ps( t2, t1 ), tmax );
+        }
+
+        result |= (uint64_t) _mm_movemask_ps( _mm_cmple_ps( tmin, tmax ) ) << i;
+    }
+
+    return result & aRayMask;
+}
+
+
+static uint64_t intersectTriangleSse2( const RAYPACKET_SOA &aPacket,
+                                       const RAYPACKET_TRIANGLE &aTri,
+                                       const float *aTHit,
+                                       uint64_t aRayMask )
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps( 1.0f );
+    const __m128 eps = _mm_set1_ps( TRIANGLE_EPSILON );
+    const __m128 minusEps = _mm_set1_ps( -TRIANGLE_EPSILON );
+    const __m128 onePlusEps = _mm_set1_ps( 1.0f + TRIANGLE_EPSILON );
+    const __m128 nu = _mm_set1_ps( aTri.nu );
+    const __m128 nv = _mm_set1_ps( aTri.nv );
+    const __m128 nd = _mm_set1_ps( aTri.nd );
+    const __m128 aku = _mm_set1_ps( aTri.aku );
+    const __m128 akv = _mm_set1_ps( aTri.akv );
+    const __m128 bnu = _mm_set1_ps( aTri.bnu );
+    const __m128 bnv = _mm_set1_ps( aTri.bnv );
+    const __m128 cnu = _mm_set1_ps( aTri.cnu );
+    const __m128 cnv = _mm_set1_ps( aTri.cnv );
+    const __m128 nx = _mm_set1_ps( aTri.n.x );
+    const __m128 ny = _mm_set1_ps( aTri.n.y );
+    const __m128 nz = _mm_set1_ps( aTri.n.z );
+
+    uint64_t result = 0;
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; i += 4 )
+    {
+        if( !( ( aRayMask >> i ) & 0xF ) )
+            continue;
+
+        const __m128 dk  = _mm_loadu_ps( &aPacket.m_Dir[aTri.k][i] );
+        const __m128 dku = _mm_loadu_ps( &aPacket.m_Dir[aTri.ku][i] );
+        const __m128 dkv = _mm_loadu_ps( &aPacket.m_Dir[aTri.kv][i] );
+        const __m128 ok  = _mm_loadu_ps( &aPacket.m_Origin[aTri.k][i] );
+        const __m128 oku = _mm_loadu_ps( &aPacket.m_Origin[aTri.ku][i] );
+        const __m128 okv = _mm_loadu_ps( &aPacket.m_Origin[aTri.kv][i] );
+
+        const __m128 lnd = _mm_div_ps( one, _mm_add_ps( _mm_add_ps( dk, _mm_mul_ps( nu, dku ) ),
+                                                        _mm_mul_ps( nv, dkv ) ) );
+        const __m128 t = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( _mm_sub_ps( nd, ok ),
+                                                             _mm_mul_ps( nu, oku ) ),
+                                                 _mm_mul_ps( nv, okv ) ),
+                                     lnd );
+
+        __m128 hit = _mm_and_ps( _mm_cmpgt_ps( _mm_loadu_ps( aTHit + i ), t ),
+                                 _mm_cmpgt_ps( t, zero ) );
+
+        const __m128 hu = _mm_sub_ps( _mm_add_ps( oku, _mm_mul_ps( t, dku ) ), aku );
+        const __m128 hv = _mm_sub_ps( _mm_add_ps( okv, _mm_mul_ps( t, dkv ) ), akv );
+        const __m128 beta = _mm_add_ps( _mm_mul_ps( hv, bnu ), _mm_mul_ps( hu, bnv ) );
+        const __m128 gamma = _mm_add_ps( _mm_mul_ps( hu, cnu ), _mm_mul_ps( hv, cnv ) );
+
+        hit = _mm_and_ps( hit, _mm_cmpge_ps( beta, minusEps ) );
+        hit = _mm_and_ps( hit, _mm_cmpge_ps( gamma, minusEps ) );
+        hit = _mm_and_ps( hit, _mm_cmple_ps( _mm_add_ps( beta, gamma ), onePlusEps ) );
+
+        const __m128 dn = _mm_add_ps(
+                _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( &aPacket.m_Dir[0][i] ), nx ),
+                            _mm_mul_ps( _mm_loadu_ps( &aPacket.m_Dir[1][i] ), ny ) ),
+                _mm_mul_ps( _mm_loadu_ps( &aPacket.m_Dir[2][i] ), nz ) );
+
+        hit = _mm_and_ps( hit, _mm_cmple_ps( dn, eps ) );
+
+        result |= (uint64_t) _mm_movemask_ps( hit ) << i;
+    }
+
+    return result & aRayMask;
+}
+
+#endif // RAYPACKET_HAVE_SSE2
+
+
+#ifdef RAYPACKET_HAVE_AVX
+
+RAYPACKET_AVX_FUNCTION
+static uint64_t intersectBBoxAvx( const RAYPACKET_SOA &aPacket,
+                                  const CBBOX &aBBox,
+                                  const float *aTHit,
+                                  uint64_t aRayMask )
+{
+    const __m256 bmin[3] = { _mm256_set1_ps( aBBox.Min().x ),
+                             _mm256_set1_ps( aBBox.Min().y ),
+                             _mm256_set1_ps( aBBox.Min().z ) };
+    const __m256 bmax[3] = { _mm256_set1_ps( aBBox.Max().x ),
+                             _mm256_set1_ps( aBBox.Max().y ),
+                             _mm256_set1_ps( aBBox.Max().z ) };
+
+    uint64_t result = 0;
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; i += 8 )
+    {
+        if( !( ( aRayMask >> i ) & 0xFF ) )
+            continue;
+
+        __m256 tmin = _mm256_setzero_ps();
+        __m256 tmax = _mm256_loadu_ps( aTHit + i );
+
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            const __m256 org = _mm256_loadu_ps( &aPacket.m_Origin[axis][i] );
+            const __m256 inv = _mm256_loadu_ps( &aPacket.m_InvDir[axis][i] );
+            const __m256 t1 = _mm256_mul_ps( _mm256_sub_ps( bmin[axis], org ), inv );
+            const __m256 t2 = _mm256_mul_ps( _mm256_sub_ps( bmax[axis], org ), inv );
+
+            // Operands swapped to match the scalar kernel, as in intersectBBoxSse2()
+            tmin = _mm256_max_ps( _mm256_min_ps( t2, t1 ), tmin );
+            tmax = _mm256_min_ps( _mm256_max_ps( t2, t1 ), tmax );
+        }
+
+        result |= (uint64_t) _mm256_movemask_ps( _mm256_cmp_ps( tmin, tmax, _CMP_LE_OQ ) ) << i;
+    }
+
+    return result & aRayMask;
+}
+
+
+RAYPACKET_AVX_FUNCTION
+static uint64_t intersectTriangleAvx( const RAYPACKET_SOA &aPacket,
+                                      const RAYPACKET_TRIANGLE &aTri,
+                                      const float *aTHit,
+                                      uint64_t aRayMask )
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps( 1.0f );
+    const __m256 eps = _mm256_set1_ps( TRIANGLE_EPSILON );
+    const __m256 minusEps = _mm256_set1_ps( -TRIANGLE_EPSILON );
+    const __m256 onePlusEps = _mm256_set1_ps( 1.0f + TRIANGLE_EPSILON );
+    const __m256 nu = _mm256_set1_ps( aTri.nu );
+    const __m256 nv = _mm256_set1_ps( aTri.nv );
+    const __m256 nd = _mm256_set1_ps( aTri.nd );
+    const __m256 aku = _mm256_set1_ps( aTri.aku );
+    const __m256 akv = _mm256_set1_ps( aTri.akv );
+    const __m256 bnu = _mm256_set1_ps( aTri.bnu );
+    const __m256 bnv = _mm256_set1_ps( aTri.bnv );
+    const __m256 cnu = _mm256_set1_ps( aTri.cnu );
+    const __m256 cnv = _mm256_set1_ps( aTri.cnv );
+    const __m256 nx = _mm256_set1_ps( aTri.n.x );
+    const __m256 ny = _mm256_set1_ps( aTri.n.y );
+    const __m256 nz = _mm256_set1_ps( aTri.n.z );
+
+    uint64_t result = 0;
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; i += 8 )
+    {
+        if( !( ( aRayMask >> i ) & 0xFF ) )
+            continue;
+
+        const __m256 dk  = _mm256_loadu_ps( &aPacket.m_Dir[aTri.k][i] );
+        const __m256 dku = _mm256_loadu_ps( &aPacket.m_Dir[aTri.ku][i] );
+        const __m256 dkv = _mm256_loadu_ps( &aPacket.m_Dir[aTri.kv][i] );
+        const __m256 ok  = _mm256_loadu_ps( &aPacket.m_Origin[aTri.k][i] );
+        const __m256 oku = _mm256_loadu_ps( &aPacket.m_Origin[aTri.ku][i] );
+        const __m256 okv = _mm256_loadu_ps( &aPacket.m_Origin[aTri.kv][i] );
+
+        const __m256 lnd = _mm256_div_ps( one,
+                                          _mm256_add_ps( _mm256_add_ps( dk,
+                                                                        _mm256_mul_ps( nu, dku ) ),
+                                                         _mm256_mul_ps( nv, dkv ) ) );
+        const __m256 t = _mm256_mul_ps( _mm256_sub_ps( _mm256_sub_ps( _mm256_sub_ps( nd, ok ),
+                                                                      _mm256_mul_ps( nu, oku ) ),
+                                                       _mm256_mul_ps( nv, okv ) ),
+                                        lnd );
+
+        __m256 hit = _mm256_and_ps( _mm256_cmp_ps( _mm256_loadu_ps( aTHit + i ), t, _CMP_GT_OQ ),
+                                    _mm256_cmp_ps( t, zero, _CMP_GT_OQ ) );
+
+        const __m256 hu = _mm256_sub_ps( _mm256_add_ps( oku, _mm256_mul_ps( t, dku ) ), aku );
+        const __m256 hv = _mm256_sub_ps( _mm256_add_ps( okv, _mm256_mul_ps( t, dkv ) ), akv );
+        const __m256 beta = _mm256_add_ps( _mm256_mul_ps( hv, bnu ), _mm256_mul_ps( hu, bnv ) );
+        const __m256 gamma = _mm256_add_ps( _mm256_mul_ps( hu, cnu ), _mm256_mul_ps( hv, cnv ) );
+
+        hit = _mm256_and_ps( hit, _mm256_cmp_ps( beta, minusEps, _CMP_GE_OQ ) );
+        hit = _mm256_and_ps( hit, _mm256_cmp_ps( gamma, minusEps, _CMP_GE_OQ ) );
+        hit = _mm256_and_ps( hit, _mm256_cmp_ps( _mm256_add_ps( beta, gamma ), onePlusEps,
+                                                 _CMP_LE_OQ ) );
+
+        const __m256 dn = _mm256_add_ps(
+                _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( &aPacket.m_Dir[0][i] ), nx ),
+                               _mm256_mul_ps( _mm256_loadu_ps( &aPacket.m_Dir[1][i] ), ny ) ),
+                _mm256_mul_ps( _mm256_loadu_ps( &aPacket.m_Dir[2][i] ), nz ) );
+
+        hit = _mm256_and_ps( hit, _mm256_cmp_ps( dn, eps, _CMP_LE_OQ ) );
+
+        result |= (uint64_t) _mm256_movemask_ps( hit ) << i;
+    }
+
+    return result & aRayMask;
+}
+
+
+static bool cpuHasAvx()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid( info, 1 );
+
+    const bool osxsave = ( info[2] & ( 1 << 27 ) ) != 0;
+    const bool avx = ( info[2] & ( 1 << 28 ) ) != 0;
+
+    // The OS must also save the AVX registers on context switches
+    return osxsave && avx && ( _xgetbv( 0 ) & 6 ) == 6;
+#else
+    return __builtin_cpu_supports( "avx" );
+#endif
+}
+
+#endif // RAYPACKET_HAVE_AVX
+
+
+struct KERNEL_TABLE
+{
+    RAYPACKET_KERNELS       m_kernels;
+    INTERSECT_BBOX_FUNC     m_intersectBBox;
+    INTERSECT_TRIANGLE_FUNC m_intersectTriangle;
+};
+
+
+static KERNEL_TABLE makeKernelTable( RAYPACKET_KERNELS aKernels )
+{
+#ifdef RAYPACKET_HAVE_AVX
+    if( aKernels == RAYPACKET_KERNELS::AVX && cpuHasAvx() )
+        return { RAYPACKET_KERNELS::AVX, intersectBBoxAvx, intersectTriangleAvx };
+#endif
+
+#ifdef RAYPACKET_HAVE_SSE2
+    if( aKernels != RAYPACKET_KERNELS::SCALAR )
+        return { RAYPACKET_KERNELS::SSE2, intersectBBoxSse2, intersectTriangleSse2 };
+#endif
+
+    return { RAYPACKET_KERNELS::SCALAR, intersectBBoxScalar, intersectTriangleScalar };
+}
+
+
+static KERNEL_TABLE& kernelTable()
+{
+    static KERNEL_TABLE table = makeKernelTable( RAYPACKET_KERNELS::AVX );
+
+    return table;
+}
+
+
+RAYPACKET_KERNELS RAYPACKET_GetKernels()
+{
+    return kernelTable().m_kernels;
+}
+
+
+RAYPACKET_KERNELS RAYPACKET_SetKernels( RAYPACKET_KERNELS aKernels )
+{
+    kernelTable() = makeKernelTable( aKernels );
+
+    return kernelTable().m_kernels;
+}
+
+
+uint64_t RAYPACKET_IntersectBBox( const RAYPACKET_SOA &aPacket,
+                                  const CBBOX &aBBox,
+                                  const float *aTHit,
+                                  uint64_t aRayMask )
+{
+    return kernelTable().m_intersectBBox( aPacket, aBBox, aTHit, aRayMask );
+}
+
+
+uint64_t RAYPACKET_IntersectTriangle( const RAYPACKET_SOA &aPacket,
+                                      const RAYPACKET_TRIANGLE &aTriangle,
+                                      const float *aTHit,
+                                      uint64_t aRayMask )
+{
+    return kernelTable().m_intersectTriangle( aPacket, aTriangle, aTHit, aRayMask );
+}
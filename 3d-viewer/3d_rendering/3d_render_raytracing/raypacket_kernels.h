@@ -0,0 +1,109 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  raypacket_kernels.h
+ * @brief Tests all the rays of a packet at once against a box or a triangle, with SSE or
+ * AVX kernels when the processor has them and plain code otherwise.
+ *
+ * The rays to test, and the rays found, are given as masks with bit i for the ray i of
+ * the packet.
+ */
+
+#ifndef _RAYPACKET_KERNELS_H_
+#define _RAYPACKET_KERNELS_H_
+
+#include <cstdint>
+
+#include "raypacket.h"
+#include "shapes3D/cbbox.h"
+
+static_assert( RAYPACKET_RAYS_PER_PACKET <= 64, "the ray masks are 64 bit wide" );
+
+
+enum class RAYPACKET_KERNELS
+{
+    SCALAR,
+    SSE2,
+    AVX
+};
+
+
+/// The constants of the triangle test of CTRIANGLE, which projects the triangle on the
+/// plane of the axes ku and kv
+struct RAYPACKET_TRIANGLE
+{
+    unsigned int k, ku, kv;
+    float        nu, nv, nd;
+    float        aku, akv;      ///< coordinates of the first vertex on ku and kv
+    float        bnu, bnv;
+    float        cnu, cnv;
+    SFVEC3F      n;             ///< face normal
+};
+
+
+/**
+ * @brief RAYPACKET_GetKernels
+ * @return the kernels in use: the widest ones the processor runs, unless
+ * RAYPACKET_SetKernels() asked for others
+ */
+RAYPACKET_KERNELS RAYPACKET_GetKernels();
+
+/**
+ * @brief RAYPACKET_SetKernels - Select the kernels, to compare them.  Not to be called
+ * while rendering.
+ * @param aKernels: the kernels to use, replaced by narrower ones if the processor
+ * does not run them
+ * @return the kernels selected
+ */
+RAYPACKET_KERNELS RAYPACKET_SetKernels( RAYPACKET_KERNELS aKernels );
+
+/**
+ * @brief RAYPACKET_IntersectBBox - Slab test of the rays against a box
+ * @param aPacket: the rays
+ * @param aBBox: the box
+ * @param aTHit: the distance of the nearest hit of each ray so far
+ * @param aRayMask: the rays to test
+ * @return the rays of aRayMask entering the box before their nearest hit, or starting
+ * inside it
+ */
+uint64_t RAYPACKET_IntersectBBox( const RAYPACKET_SOA &aPacket,
+                                  const CBBOX &aBBox,
+                                  const float *aTHit,
+                                  uint64_t aRayMask );
+
+/**
+ * @brief RAYPACKET_IntersectTriangle - Selects the rays which may hit a triangle
+ * @param aPacket: the rays
+ * @param aTriangle: the triangle
+ * @param aTHit: the distance of the nearest hit of each ray so far
+ * @param aRayMask: the rays to test
+ * @return the rays of aRayMask hitting the front face of the triangle before their
+ * nearest hit, and the ones grazing its edges; the scalar test decides for these.
+ */
+uint64_t RAYPACKET_IntersectTriangle( const RAYPACKET_SOA &aPacket,
+                                      const RAYPACKET_TRIANGLE &aTriangle,
+                                      const float *aTHit,
+                                      uint64_t aRayMask );
+
+#endif // _RAYPACKET_KERNELS_H_
@@ -46,6 +46,8 @@ public:
     void SetColor( SFVEC3F aObjColor ) { m_diffusecolor = aObjColor; }
 
     // Imported from COBJECT
+    // The ray packets are only tested against the bounding box at once (the default
+    // IntersectPacket), as their 2D objects (polygons, CSG items...) have no packet test
     bool Intersect( const RAY &aRay, HITINFO &aHitInfo ) const override;
     bool IntersectP(const RAY &aRay , float aMaxDistance ) const override;
     bool Intersects( const CBBOX &aBBox ) const override;
@@ -28,6 +28,7 @@
  */
 
 #include "cobject.h"
+#include "../raypacket_kernels.h"
 #include <cstdio>
 #include <map>
 
@@ -44,6 +45,30 @@ COBJECT::COBJECT( OBJECT3D_TYPE aObjType )
 }
 
 
+uint64_t COBJECT::IntersectPacket( const RAYPACKET &aRayPacket,
+                                   uint64_t aRayMask,
+                                   float *aTHit,
+                                   HITINFO_PACKET *aHitInfoPacket ) const
+{
+    const uint64_t candidates = RAYPACKET_IntersectBBox( aRayPacket.m_soa, m_bbox, aTHit,
+                                                         aRayMask );
+    uint64_t hits = 0;
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        const uint64_t ray = (uint64_t) 1 << i;
+
+        if( ( candidates & ray ) && Intersect( aRayPacket.m_ray[i], aHitInfoPacket[i].m_HitInfo ) )
+        {
+            aTHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+            hits |= ray;
+        }
+    }
+
+    return hits;
+}
+
+
 /*
  * Lookup table for OBJECT2D_TYPE printed names
  */
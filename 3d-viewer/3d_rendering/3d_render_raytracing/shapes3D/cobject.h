@@ -30,6 +30,8 @@
 #ifndef _COBJECT_H_
 #define _COBJECT_H_
 
+#include <cstdint>
+
 #include "cbbox.h"
 #include "../hitinfo.h"
 #include "../cmaterial.h"
@@ -91,6 +93,20 @@ public:
      */
     virtual bool IntersectP( const RAY &aRay, float aMaxDistance ) const = 0;
 
+    /** Function IntersectPacket
+     * @brief Intersects the rays of a packet as Intersect() does for each of them.  By
+     * default the rays are first tested against the bounding box, all at once.
+     * @param aRayPacket
+     * @param aRayMask - the rays to test, bit i for the ray i of the packet
+     * @param aTHit - the distance of the nearest hit of each ray, updated with the hits
+     * @param aHitInfoPacket - the hit information of each ray, updated with the hits
+     * @return the mask of the rays hitting the object
+     */
+    virtual uint64_t IntersectPacket( const RAYPACKET &aRayPacket,
+                                      uint64_t aRayMask,
+                                      float *aTHit,
+                                      HITINFO_PACKET *aHitInfoPacket ) const;
+
     const CBBOX &GetBBox() const { return m_bbox; }
 
     const SFVEC3F &GetCentroid() const { return m_centroid; }
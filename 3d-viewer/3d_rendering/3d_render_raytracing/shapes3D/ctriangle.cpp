@@ -32,6 +32,7 @@
 
 
 #include "ctriangle.h"
+#include "../raypacket_kernels.h"
 
 
 void CTRIANGLE::pre_calc_const()
@@ -308,6 +309,48 @@ bool CTRIANGLE::IntersectP( const RAY &aRay,
 }
 
 
+uint64_t CTRIANGLE::IntersectPacket( const RAYPACKET &aRayPacket,
+                                     uint64_t aRayMask,
+                                     float *aTHit,
+                                     HITINFO_PACKET *aHitInfoPacket ) const
+{
+    RAYPACKET_TRIANGLE triangle;
+
+    triangle.k = m_k;
+    triangle.ku = s_modulo[m_k + 1];
+    triangle.kv = s_modulo[m_k + 2];
+    triangle.nu = m_nu;
+    triangle.nv = m_nv;
+    triangle.nd = m_nd;
+    triangle.aku = m_vertex[0][triangle.ku];
+    triangle.akv = m_vertex[0][triangle.kv];
+    triangle.bnu = m_bnu;
+    triangle.bnv = m_bnv;
+    triangle.cnu = m_cnu;
+    triangle.cnv = m_cnv;
+    triangle.n = m_n;
+
+    // The kernel selects the rays, the scalar test decides and fills the hit information
+    const uint64_t candidates = RAYPACKET_IntersectTriangle( aRayPacket.m_soa, triangle, aTHit,
+                                                             aRayMask );
+    uint64_t hits = 0;
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        const uint64_t ray = (uint64_t) 1 << i;
+
+        if( ( candidates & ray )
+                && CTRIANGLE::Intersect( aRayPacket.m_ray[i], aHitInfoPacket[i].m_HitInfo ) )
+        {
+            aTHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+            hits |= ray;
+        }
+    }
+
+    return hits;
+}
+
+
 bool CTRIANGLE::Intersects( const CBBOX &aBBox ) const
 {
     //!TODO: improove
@@ -66,6 +66,8 @@ public:
     // Imported from COBJECT
     bool Intersect( const RAY &aRay, HITINFO &aHitInfo ) const override;
     bool IntersectP(const RAY &aRay , float aMaxDistance ) const override;
+    uint64_t IntersectPacket( const RAYPACKET &aRayPacket, uint64_t aRayMask, float *aTHit,
+                              HITINFO_PACKET *aHitInfoPacket ) const override;
     bool Intersects( const CBBOX &aBBox ) const override;
     SFVEC3F GetDiffuseColor( const HITINFO &aHitInfo ) const override;
 
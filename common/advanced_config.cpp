@@ -74,6 +74,12 @@ static const wxChar UsePadProperty[] = wxT( "UsePadProperty" );
  */
 static const wxChar RealtimeConnectivity[] = wxT( "RealtimeConnectivity" );
 
+/**
+ * Rebuild only the part of the connectivity affected by an edit rather than all of it.  Setting
+ * this to off makes every real-time update recalculate the whole schematic.
+ */
+static const wxChar IncrementalConnectivity[] = wxT( "IncrementalConnectivity" );
+
 /**
  * Configure the coroutine stack size in bytes.  This should be allocated in multiples of
  * the system page size (n*4096 is generally safe)
@@ -159,6 +165,7 @@ ADVANCED_CFG::ADVANCED_CFG()
     // then the values will remain as set here.
     m_EnableUsePadProperty = false;
     m_realTimeConnectivity = true;
+    m_incrementalConnectivity = true;
     m_coroutineStackSize = AC_STACK::default_stack;
 
     loadFromConfigFile();
@@ -199,6 +206,9 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::RealtimeConnectivity,
                                                 &m_realTimeConnectivity, false ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IncrementalConnectivity,
+                                                &m_incrementalConnectivity, true ) );
+
     configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::CoroutineStackSize,
                                                &m_coroutineStackSize, AC_STACK::default_stack,
                                                AC_STACK::min_stack, AC_STACK::max_stack ) );
@@ -44,6 +44,8 @@ KIGFX::GAL_DISPLAY_OPTIONS basic_displayOptions;
 // the basic GAL doesn't get an external display option object
 BASIC_GAL basic_gal( basic_displayOptions );
 
+std::recursive_mutex basic_gal_mutex;
+
 const VECTOR2D BASIC_GAL::transform( const VECTOR2D& aPoint ) const
 {
     VECTOR2D point = aPoint + m_transform.m_moveOffset - m_transform.m_rotCenter;
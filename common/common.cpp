@@ -44,6 +44,16 @@ using KIGFX::COLOR4D;
 // Create only once, as seeding is *very* expensive
 static boost::uuids::random_generator randomGenerator;
 
+// The generator is not thread safe, and items are created from worker threads when loading
+static std::mutex randomGeneratorMutex;
+
+
+static boost::uuids::uuid newRandomUuid()
+{
+    std::lock_guard<std::mutex> lock( randomGeneratorMutex );
+    return randomGenerator();
+}
+
 // These don't have the same performance penalty, but might as well be consistent
 static boost::uuids::string_generator stringGenerator;
 static boost::uuids::nil_generator nilGenerator;
@@ -53,7 +63,7 @@ KIID niluuid( 0 );
 
 
 KIID::KIID() :
-        m_uuid( randomGenerator() ),
+        m_uuid( newRandomUuid() ),
         m_cached_timestamp( 0 )
 {
 #if defined(EESCHEMA)
@@ -109,7 +119,7 @@ KIID::KIID( const wxString& aString ) :
         {
             // Failed to parse string representation; best we can do is assign a new
             // random one.
-            m_uuid = randomGenerator();
+            m_uuid = newRandomUuid();
         }
     }
 }
@@ -941,18 +951,18 @@ static void ConvertFileTimeToWx( wxDateTime *dt, const FILETIME &ft )
 
 
 /**
- * TimestampDir
+ * timestampDirEntries
  *
  * This routine offers SIGNIFICANT performance benefits over using wxWidgets to gather
  * timestamps from matching files in a directory.
  * @param aDirPath the directory to search
  * @param aFilespec a (wildcarded) file spec to match against
- * @return a hash of the last-mod-dates of all matching files in the directory
+ * @param aFunc is called with the native name and the last-mod-date of each matching file
  */
-long long TimestampDir( const wxString& aDirPath, const wxString& aFilespec )
+template <typename FUNC>
+static void timestampDirEntries( const wxString& aDirPath, const wxString& aFilespec,
+                                 FUNC aFunc )
 {
-    long long timestamp = 0;
-
 #if defined( __WIN32__ )
     // Win32 version.
     // Save time by not searching for each path twice: once in wxDir.GetNext() and once in
@@ -972,7 +982,7 @@ long long TimestampDir( const wxString& aDirPath, const wxString& aFilespec )
         do
         {
             ConvertFileTimeToWx( &lastModDate, findData.ftLastWriteTime );
-            timestamp += lastModDate.GetValue().GetValue();
+            aFunc( findData.cFileName, lastModDate.GetValue().GetValue() );
         }
         while ( FindNextFile( fileHandle, &findData ) != 0 );
     }
@@ -1023,18 +1033,54 @@ long long TimestampDir( const wxString& aDirPath, const wxString& aFilespec )
                 }
 
                 if( S_ISREG( entry_stat.st_mode ) )    // wxFileExists()
-                    timestamp += entry_stat.st_mtime * 1000;
+                    aFunc( dir_entry->d_name, (long long) entry_stat.st_mtime * 1000 );
             }
             else
             {
                 // if we couldn't lstat the file itself all we can do is use the name
-                timestamp += (signed) std::hash<std::string>{}( std::string( dir_entry->d_name ) );
+                aFunc( dir_entry->d_name,
+                       (signed) std::hash<std::string>{}( std::string( dir_entry->d_name ) ) );
             }
         }
 
         closedir( dir );
     }
 #endif
+}
+
+
+long long TimestampDir( const wxString& aDirPath, const wxString& aFilespec )
+{
+    long long timestamp = 0;
+
+    timestampDirEntries( aDirPath, aFilespec,
+            [&]( const void*, long long aTimestamp )
+            {
+                timestamp += aTimestamp;
+            } );
 
     return timestamp;
 }
+
+
+std::map<wxString, long long> TimestampDirFiles( const wxString& aDirPath,
+                                                 const wxString& aFilespec )
+{
+    std::map<wxString, long long> timestamps;
+
+#if defined( __WIN32__ )
+    timestampDirEntries( aDirPath, aFilespec,
+            [&]( const TCHAR* aName, long long aTimestamp )
+            {
+                timestamps[wxString( aName )] = aTimestamp;
+            } );
+#else
+    timestampDirEntries( aDirPath, aFilespec,
+            [&]( const char* aName, long long aTimestamp )
+            {
+                timestamps[wxString( aName, *wxConvFileName )] = aTimestamp;
+            } );
+#endif
+
+    return timestamps;
+}
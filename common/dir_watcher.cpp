@@ -0,0 +1,285 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <common.h>
+#include <dir_watcher.h>
+
+#if defined( __linux__ )
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <sys/vfs.h>
+
+#include <wx/filefn.h>
+
+
+static const uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE
+                                   | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF
+                                   | IN_ONLYDIR;
+
+// The events after which the changes of a directory are unknown
+static const uint32_t LOST_MASK = IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT | IN_IGNORED;
+
+
+/**
+ * The network file systems only notify the changes made by this machine, so their
+ * directories are polled.
+ */
+static bool isNetworkFileSystem( const wxString& aDirPath )
+{
+    struct statfs fs;
+
+    if( statfs( aDirPath.fn_str(), &fs ) != 0 )
+        return false;
+
+    switch( static_cast<uint32_t>( fs.f_type ) )
+    {
+    case 0x6969:        // NFS
+    case 0x517B:        // SMB
+    case 0xFF534D42:    // CIFS
+    case 0xFE534D42:    // SMB2
+    case 0x65735546:    // FUSE (sshfs and the like)
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
+/**
+ * The inotify instance of all the watchers, as the instances per user are few.  The events
+ * are read by whichever watcher takes its changes, and handed to the watchers of their
+ * directory.
+ */
+class INOTIFY_QUEUE
+{
+public:
+    static INOTIFY_QUEUE& Get()
+    {
+        // Never destroyed, as the watchers may outlive the static objects
+        static INOTIFY_QUEUE* queue = new INOTIFY_QUEUE;
+
+        return *queue;
+    }
+
+    ///> Returns the watch descriptor of aWatcher's directory, or -1 if it cannot be watched
+    int Add( DIR_WATCHER* aWatcher )
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        if( m_fd < 0 )
+            return -1;
+
+        // Don't hand the pending events of the directory to the new watcher
+        dispatch();
+
+        int watch = inotify_add_watch( m_fd, aWatcher->m_dirPath.fn_str(), WATCH_MASK );
+
+        if( watch >= 0 )
+            m_watchers[watch].push_back( aWatcher );
+
+        return watch;
+    }
+
+    void Remove( DIR_WATCHER* aWatcher )
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        auto it = m_watchers.find( aWatcher->m_watch );
+
+        if( it == m_watchers.end() )
+            return;
+
+        std::vector<DIR_WATCHER*>& watchers = it->second;
+
+        watchers.erase( std::remove( watchers.begin(), watchers.end(), aWatcher ),
+                        watchers.end() );
+
+        if( watchers.empty() )
+        {
+            inotify_rm_watch( m_fd, it->first );
+            m_watchers.erase( it );
+        }
+    }
+
+    bool Take( DIR_WATCHER* aWatcher, std::set<wxString>& aChanged )
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        dispatch();
+
+        if( aWatcher->m_lost )
+            return false;
+
+        aChanged.insert( aWatcher->m_changed.begin(), aWatcher->m_changed.end() );
+        aWatcher->m_changed.clear();
+        return true;
+    }
+
+private:
+    INOTIFY_QUEUE() :
+            m_fd( inotify_init1( IN_NONBLOCK | IN_CLOEXEC ) )
+    {
+    }
+
+    ///> Reads the pending events, without waiting; m_lock must be held
+    void dispatch()
+    {
+        alignas( inotify_event ) char buffer[4096];
+
+        for( ;; )
+        {
+            ssize_t length = read( m_fd, buffer, sizeof( buffer ) );
+
+            if( length < 0 && errno == EINTR )
+                continue;
+
+            if( length <= 0 )       // EAGAIN: no more events
+                break;
+
+            for( const char* ptr = buffer; ptr < buffer + length; )
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>( ptr );
+                ptr += sizeof( inotify_event ) + event->len;
+
+                if( event->mask & IN_Q_OVERFLOW )
+                {
+                    for( std::pair<const int, std::vector<DIR_WATCHER*>>& watch : m_watchers )
+                    {
+                        for( DIR_WATCHER* watcher : watch.second )
+                            watcher->m_lost = true;
+                    }
+
+                    continue;
+                }
+
+                auto it = m_watchers.find( event->wd );
+
+                if( it == m_watchers.end() )
+                    continue;
+
+                if( event->mask & LOST_MASK )
+                {
+                    for( DIR_WATCHER* watcher : it->second )
+                        watcher->m_lost = true;
+
+                    // The kernel dropped the watch
+                    if( event->mask & IN_IGNORED )
+                        m_watchers.erase( it );
+
+                    continue;
+                }
+
+                if( event->len == 0 || ( event->mask & IN_ISDIR ) )
+                    continue;
+
+                wxString name( event->name, *wxConvFileName );
+
+                for( DIR_WATCHER* watcher : it->second )
+                {
+                    if( wxMatchWild( watcher->m_fileSpec, name, true ) )
+                        watcher->m_changed.insert( name );
+                }
+            }
+        }
+    }
+
+    std::mutex                                m_lock;
+    int                                       m_fd;
+    std::map<int, std::vector<DIR_WATCHER*>>  m_watchers;   ///< the watchers per watch descriptor
+};
+#endif
+
+
+DIR_WATCHER::DIR_WATCHER( const wxString& aDirPath, const wxString& aFileSpec,
+                          std::chrono::milliseconds aPollInterval ) :
+        m_dirPath( aDirPath ),
+        m_fileSpec( aFileSpec ),
+        m_watch( -1 ),
+        m_lost( false ),
+        m_pollInterval( aPollInterval )
+{
+#if defined( __linux__ )
+    if( !isNetworkFileSystem( m_dirPath ) )
+        m_watch = INOTIFY_QUEUE::Get().Add( this );
+#endif
+
+    if( m_watch < 0 )
+    {
+        m_timestamps = TimestampDirFiles( m_dirPath, m_fileSpec );
+        m_lastPoll = std::chrono::steady_clock::now();
+    }
+}
+
+
+DIR_WATCHER::~DIR_WATCHER()
+{
+#if defined( __linux__ )
+    if( m_watch >= 0 )
+        INOTIFY_QUEUE::Get().Remove( this );
+#endif
+}
+
+
+bool DIR_WATCHER::TakeChanges( std::set<wxString>& aChanged )
+{
+#if defined( __linux__ )
+    if( m_watch >= 0 )
+        return INOTIFY_QUEUE::Get().Take( this, aChanged );
+#endif
+
+    std::lock_guard<std::mutex> lock( m_pollLock );
+
+    // Reading a network directory is slow: the changes wait for the next poll
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if( now - m_lastPoll < m_pollInterval )
+        return true;
+
+    m_lastPoll = now;
+
+    std::map<wxString, long long> timestamps = TimestampDirFiles( m_dirPath, m_fileSpec );
+
+    for( const std::pair<const wxString, long long>& file : timestamps )
+    {
+        auto it = m_timestamps.find( file.first );
+
+        if( it == m_timestamps.end() || it->second != file.second )
+            aChanged.insert( file.first );
+    }
+
+    for( const std::pair<const wxString, long long>& file : m_timestamps )
+    {
+        if( !timestamps.count( file.first ) )
+            aChanged.insert( file.first );
+    }
+
+    m_timestamps = std::move( timestamps );
+    return true;
+}
@@ -657,7 +657,7 @@ L_read:
                     case 'x':   // 1 or 2 byte hex escape sequence
                         for( i=0; i<2; ++i )
                         {
-                            if( !isxdigit( head[i] ) )
+                            if( head + i >= limit || !isxdigit( head[i] ) )
                                 break;
                             tbuf[i] = head[i];
                         }
@@ -673,7 +673,7 @@ L_read:
                         --head;
                         for( i=0; i<3; ++i )
                         {
-                            if( head[i] < '0' || head[i] > '7' )
+                            if( head + i >= limit || head[i] < '0' || head[i] > '7' )
                                 break;
                             tbuf[i] = head[i];
                         }
@@ -808,6 +808,77 @@ exit:   // single point of exit, no returns elsewhere please.
 }
 
 
+void DSNLEXER::skipSexpression()
+{
+    wxASSERT( !specctraMode );
+
+    const char* cur = next;
+    int         depth = 1;
+
+    for( ;; )
+    {
+        if( cur >= limit )
+        {
+            if( readLine() == 0 )
+            {
+                curTok = DSN_EOF;
+                wxString errtxt( _( "Unexpected end of file" ) );
+                THROW_PARSE_ERROR( errtxt, CurSource(), CurLine(), CurLineNumber(), CurOffset() );
+            }
+
+            cur = start;
+
+            // Lines whose first non-blank character is '#' are comments, as in NextTok()
+            const char* head = cur;
+
+            while( head<limit && isSpace( *head ) )
+                ++head;
+
+            if( head<limit && *head=='#' )
+            {
+                cur = limit;
+                continue;
+            }
+        }
+
+        if( *cur == '(' )
+        {
+            ++depth;
+        }
+        else if( *cur == ')' )
+        {
+            if( --depth == 0 )
+                break;
+        }
+        else if( *cur == stringDelimiter && ( cur == start || isSep( cur[-1] ) ) )
+        {
+            // A quoted string, which may contain parentheses.  As in NextTok(), only a
+            // delimiter at the start of a token opens a string.
+            for( ++cur; cur<limit && *cur != stringDelimiter; ++cur )
+            {
+                if( *cur == '\\' )
+                    ++cur;
+            }
+
+            if( cur >= limit )
+            {
+                curOffset = cur - start;
+                wxString errtxt( _( "Un-terminated delimited string" ) );
+                THROW_PARSE_ERROR( errtxt, CurSource(), CurLine(), CurLineNumber(), CurOffset() );
+            }
+        }
+
+        ++cur;
+    }
+
+    prevTok   = curTok;
+    curTok    = DSN_RIGHT;
+    curText   = *cur;
+    curOffset = cur - start;
+    next      = cur + 1;
+}
+
+
 wxArrayString* DSNLEXER::ReadCommentLines()
 {
     wxArrayString*  ret = 0;
@@ -0,0 +1,250 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+
+#include <lib_info_index.h>
+#include <richio.h>
+
+/*
+ * The index file holds, in the byte order of the machine which wrote it:
+ *
+ *   the magic "KILIBIDX", a byte order mark, the format version and the library count;
+ *   then per library: its nickname, content hash and item count, followed by its items;
+ *   and per item: its name, description, keywords, count and unique count.
+ *
+ * The strings are a byte count followed by the UTF-8 bytes, the counts are 32 bit and the
+ * hashes 64 bit wide.
+ */
+
+static const char     INDEX_MAGIC[8] = { 'K', 'I', 'L', 'I', 'B', 'I', 'D', 'X' };
+static const uint32_t INDEX_BYTE_ORDER = 0x01020304;
+static const uint32_t INDEX_VERSION = 1;
+
+// The size of an item of empty strings, to reject item counts the file cannot hold
+static const size_t   MIN_ITEM_SIZE = 5 * sizeof( uint32_t );
+
+
+/**
+ * Reads the values of an index from a buffer, and fails on reaching its end.
+ */
+class LIB_INDEX_READER
+{
+public:
+    LIB_INDEX_READER( const char* aData, size_t aSize ) :
+            m_data( aData ),
+            m_size( aSize ),
+            m_pos( 0 )
+    {
+    }
+
+    template <typename T>
+    bool Read( T& aValue )
+    {
+        if( m_size - m_pos < sizeof( T ) )
+            return false;
+
+        memcpy( &aValue, m_data + m_pos, sizeof( T ) );
+        m_pos += sizeof( T );
+        return true;
+    }
+
+    bool ReadString( wxString& aString )
+    {
+        uint32_t length;
+
+        if( !Read( length ) || m_size - m_pos < length )
+            return false;
+
+        aString = wxString::FromUTF8( m_data + m_pos, length );
+        m_pos += length;
+        return true;
+    }
+
+    size_t Remaining() const
+    {
+        return m_size - m_pos;
+    }
+
+private:
+    const char* m_data;
+    size_t      m_size;
+    size_t      m_pos;
+};
+
+
+template <typename T>
+static void writeValue( std::string& aBuffer, const T& aValue )
+{
+    aBuffer.append( reinterpret_cast<const char*>( &aValue ), sizeof( T ) );
+}
+
+
+static void writeString( std::string& aBuffer, const wxString& aString )
+{
+    const wxScopedCharBuffer utf8 = aString.utf8_str();
+
+    writeValue( aBuffer, (uint32_t) utf8.length() );
+    aBuffer.append( utf8.data(), utf8.length() );
+}
+
+
+bool LIB_INFO_INDEX::Read( const wxString& aFileName )
+{
+    m_libraries.clear();
+
+    if( !wxFileExists( aFileName ) )
+        return false;
+
+    try
+    {
+        MMAP_LINE_READER file( aFileName );
+        LIB_INDEX_READER     reader( file.Data(), file.Size() );
+
+        char     magic[sizeof( INDEX_MAGIC )];
+        uint32_t byteOrder;
+        uint32_t version;
+        uint32_t libraryCount;
+
+        if( !reader.Read( magic ) || memcmp( magic, INDEX_MAGIC, sizeof( INDEX_MAGIC ) ) != 0
+                || !reader.Read( byteOrder ) || byteOrder != INDEX_BYTE_ORDER
+                || !reader.Read( version ) || version != INDEX_VERSION
+                || !reader.Read( libraryCount ) )
+        {
+            return false;
+        }
+
+        for( uint32_t ii = 0; ii < libraryCount; ++ii )
+        {
+            wxString nickname;
+            LIBRARY  library;
+            int64_t  hash;
+            uint32_t itemCount;
+
+            if( !reader.ReadString( nickname ) || !reader.Read( hash ) || !reader.Read( itemCount )
+                    || itemCount > reader.Remaining() / MIN_ITEM_SIZE )
+            {
+                m_libraries.clear();
+                return false;
+            }
+
+            library.m_Hash = hash;
+            library.m_Items.resize( itemCount );
+
+            for( ITEM& item : library.m_Items )
+            {
+                uint32_t count;
+                uint32_t uniqueCount;
+
+                if( !reader.ReadString( item.m_Name ) || !reader.ReadString( item.m_Description )
+                        || !reader.ReadString( item.m_Keywords )
+                        || !reader.Read( count ) || !reader.Read( uniqueCount ) )
+                {
+                    m_libraries.clear();
+                    return false;
+                }
+
+                item.m_Count = count;
+                item.m_UniqueCount = uniqueCount;
+            }
+
+            m_libraries[nickname] = std::move( library );
+        }
+
+        if( reader.Remaining() )
+        {
+            m_libraries.clear();
+            return false;
+        }
+    }
+    catch( const IO_ERROR& )
+    {
+        m_libraries.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool LIB_INFO_INDEX::Write( const wxString& aFileName ) const
+{
+    std::string buffer;
+
+    buffer.append( INDEX_MAGIC, sizeof( INDEX_MAGIC ) );
+    writeValue( buffer, INDEX_BYTE_ORDER );
+    writeValue( buffer, INDEX_VERSION );
+    writeValue( buffer, (uint32_t) m_libraries.size() );
+
+    for( const std::pair<const wxString, LIBRARY>& library : m_libraries )
+    {
+        writeString( buffer, library.first );
+        writeValue( buffer, (int64_t) library.second.m_Hash );
+        writeValue( buffer, (uint32_t) library.second.m_Items.size() );
+
+        for( const ITEM& item : library.second.m_Items )
+        {
+            writeString( buffer, item.m_Name );
+            writeString( buffer, item.m_Description );
+            writeString( buffer, item.m_Keywords );
+            writeValue( buffer, (uint32_t) item.m_Count );
+            writeValue( buffer, (uint32_t) item.m_UniqueCount );
+        }
+    }
+
+    const wxString tempFileName = aFileName + ".tmp";
+
+    bool written;
+
+    {
+        wxFFile file( tempFileName, "wb" );
+
+        written = file.IsOpened() && file.Write( buffer.data(), buffer.size() ) == buffer.size()
+                  && file.Close();
+    }
+
+    if( !written )
+    {
+        wxRemoveFile( tempFileName );
+        return false;
+    }
+
+    return wxRenameFile( tempFileName, aFileName, true );
+}
+
+
+const LIB_INFO_INDEX::LIBRARY* LIB_INFO_INDEX::FindLibrary( const wxString& aNickname,
+                                                            long long aHash ) const
+{
+    auto it = m_libraries.find( aNickname );
+
+    if( it == m_libraries.end() || it->second.m_Hash != aHash )
+        return nullptr;
+
+    return &it->second;
+}
@@ -31,6 +31,7 @@
 
 #include <fctsys.h>
 #include <base_struct.h>
+#include <kicad_string.h>
 #include <ws_painter.h>
 #include <ws_draw_item.h>
 #include <ws_data_model.h>
@@ -758,7 +759,8 @@ double PAGE_LAYOUT_READER_PARSER::parseDouble()
     if( token != T_NUMBER )
         Expecting( T_NUMBER );
 
-    double val = strtod( CurText(), NULL );
+    double val = 0.0;
+    ParseDoubleNoLocale( CurText(), &val );
 
     return val;
 }
@@ -36,6 +36,7 @@
 #include <plotter.h>
 #include <macros.h>
 #include <kicad_string.h>
+#include <richio.h>
 #include <convert_basic_shapes_to_polygon.h>
 #include <math/util.h>      // for KiROUND
 
@@ -46,8 +47,6 @@
 
 GERBER_PLOTTER::GERBER_PLOTTER()
 {
-    workFile  = NULL;
-    finalFile = NULL;
     m_currentApertureIdx = -1;
     m_apertureAttribute = 0;
 
@@ -102,16 +101,16 @@ void GERBER_PLOTTER::SetGerberCoordinatesFormat( int aResolution, bool aUseInche
 void GERBER_PLOTTER::emitDcode( const DPOINT& pt, int dcode )
 {
 
-    fprintf( outputFile, "X%dY%dD%02d*\n", KiROUND( pt.x ), KiROUND( pt.y ), dcode );
+    StrPrintf( &m_body, "X%dY%dD%02d*\n", KiROUND( pt.x ), KiROUND( pt.y ), dcode );
 }
 
 void GERBER_PLOTTER::ClearAllAttributes()
 {
     // Remove all attributes from object attributes dictionary (TO. and TA commands)
     if( m_useX2format )
-        fputs( "%TD*%\n", outputFile );
+        m_body += "%TD*%\n";
     else
-        fputs( "G04 #@! TD*\n", outputFile );
+        m_body += "G04 #@! TD*\n";
 
     m_objectAttributesDictionnary.clear();
 }
@@ -125,9 +124,9 @@ void GERBER_PLOTTER::clearNetAttribute()
 
     // Remove all net attributes from object attributes dictionary
     if( m_useX2format )
-        fputs( "%TD*%\n", outputFile );
+        m_body += "%TD*%\n";
     else
-        fputs( "G04 #@! TD*\n", outputFile );
+        m_body += "G04 #@! TD*\n";
 
     m_objectAttributesDictionnary.clear();
 }
@@ -171,12 +170,12 @@ void GERBER_PLOTTER::formatNetAttribute( GBR_NETLIST_METADATA* aData )
         clearNetAttribute();
 
     if( !short_attribute_string.empty() )
-        fputs( short_attribute_string.c_str(), outputFile );
+        m_body += short_attribute_string;
 
     if( m_useX2format && !aData->m_ExtraData.IsEmpty() )
     {
         std::string extra_data = TO_UTF8( aData->m_ExtraData );
-        fputs( extra_data.c_str(), outputFile );
+        m_body += extra_data;
     }
 }
 
@@ -185,18 +184,13 @@ bool GERBER_PLOTTER::StartPlot()
 {
     wxASSERT( outputFile );
 
-    finalFile = outputFile;     // the actual gerber file will be created later
-
-    // Create a temporary filename to store gerber file
-    // note tmpfile() does not work under Vista and W7 in user mode
-    m_workFilename = filename + wxT(".tmp");
-    workFile   = wxFopen( m_workFilename, wxT( "wt" ));
-    outputFile = workFile;
-    wxASSERT( outputFile );
-
     if( outputFile == NULL )
         return false;
 
+    // The header is written to the file right away, and the plot commands are held in
+    // m_body until the aperture list which follows the header is known
+    m_body.clear();
+
     for( unsigned ii = 0; ii < m_headerExtraLines.GetCount(); ii++ )
     {
         if( ! m_headerExtraLines[ii].IsEmpty() )
@@ -246,37 +240,19 @@ bool GERBER_PLOTTER::StartPlot()
 
 bool GERBER_PLOTTER::EndPlot()
 {
-    char     line[1024];
-    wxString msg;
-
     wxASSERT( outputFile );
 
-    /* Outfile is actually a temporary file i.e. workFile */
-    fputs( "M02*\n", outputFile );
-    fflush( outputFile );
+    // Placement of apertures in RS274X: the header ends with the "G04 APERTURE LIST*" line
+    writeApertureList();
+    fputs( "G04 APERTURE END LIST*\n", outputFile );
 
-    fclose( workFile );
-    workFile   = wxFopen( m_workFilename, wxT( "rt" ));
-    wxASSERT( workFile );
-    outputFile = finalFile;
-
-    // Placement of apertures in RS274X
-    while( fgets( line, 1024, workFile ) )
-    {
-        fputs( line, outputFile );
-
-        char* substr = strtok( line, "\n\r" );
+    fwrite( m_body.data(), 1, m_body.size(), outputFile );
+    fputs( "M02*\n", outputFile );
 
-        if( substr && strcmp( substr, "G04 APERTURE LIST*" ) == 0 )
-        {
-            writeApertureList();
-            fputs( "G04 APERTURE END LIST*\n", outputFile );
-        }
-    }
+    m_body.clear();
+    m_body.shrink_to_fit();
 
-    fclose( workFile );
-    fclose( finalFile );
-    ::wxRemoveFile( m_workFilename );
+    fclose( outputFile );
     outputFile = 0;
 
     return true;
@@ -310,30 +286,37 @@ void GERBER_PLOTTER::SetCurrentLineWidth( int width, void* aData )
 }
 
 
+std::size_t GERBER_PLOTTER::APERTURE_KEY_HASH::operator()( const APERTURE_KEY& aKey ) const
+{
+    std::size_t seed = std::hash<int>()( aKey.m_Size.x );
+
+    // Same mixing as boost::hash_combine
+    for( int value : { aKey.m_Size.y, (int) aKey.m_Type, aKey.m_ApertureAttribute } )
+        seed ^= std::hash<int>()( value ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+
+    return seed;
+}
+
+
 int GERBER_PLOTTER::GetOrCreateAperture( const wxSize& aSize,
                         APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
 {
-    int last_D_code = 9;
-
     // Search an existing aperture
-    for( int idx = 0; idx < (int)m_apertures.size(); ++idx )
-    {
-        APERTURE* tool = &m_apertures[idx];
-        last_D_code = tool->m_DCode;
+    const APERTURE_KEY key = { aType, aSize, aApertureAttribute };
+    auto               it = m_apertureIndex.find( key );
 
-        if( (tool->m_Type == aType) && (tool->m_Size == aSize) &&
-            (tool->m_ApertureAttribute == aApertureAttribute) )
-            return idx;
-    }
+    if( it != m_apertureIndex.end() )
+        return it->second;
 
     // Allocate a new aperture
     APERTURE new_tool;
     new_tool.m_Size  = aSize;
     new_tool.m_Type  = aType;
-    new_tool.m_DCode = last_D_code + 1;
+    new_tool.m_DCode = m_apertures.empty() ? 10 : m_apertures.back().m_DCode + 1;
     new_tool.m_ApertureAttribute = aApertureAttribute;
 
     m_apertures.push_back( new_tool );
+    m_apertureIndex[key] = m_apertures.size() - 1;
 
     return m_apertures.size() - 1;
 }
@@ -354,7 +337,7 @@ void GERBER_PLOTTER::selectAperture( const wxSize&           aSize,
     {
         // Pick an existing aperture or create a new one
         m_currentApertureIdx = GetOrCreateAperture( aSize, aType, aApertureAttribute );
-        fprintf( outputFile, "D%d*\n", m_apertures[m_currentApertureIdx].m_DCode );
+        StrPrintf( &m_body, "D%d*\n", m_apertures[m_currentApertureIdx].m_DCode );
     }
 }
 
@@ -542,18 +525,18 @@ void GERBER_PLOTTER::plotArc( const wxPoint& aCenter, double aStAngle, double aE
     DPOINT devEnd = userToDeviceCoordinates( end );
     DPOINT devCenter = userToDeviceCoordinates( aCenter ) - userToDeviceCoordinates( start );
 
-    fprintf( outputFile, "G75*\n" );        // Multiquadrant (360 degrees) mode
+    m_body += "G75*\n";        // Multiquadrant (360 degrees) mode
 
     if( aStAngle < aEndAngle )
-        fprintf( outputFile, "G03*\n" );    // Active circular interpolation, CCW
+        m_body += "G03*\n";    // Active circular interpolation, CCW
     else
-        fprintf( outputFile, "G02*\n" );    // Active circular interpolation, CW
+        m_body += "G02*\n";    // Active circular interpolation, CW
 
-    fprintf( outputFile, "X%dY%dI%dJ%dD01*\n",
+    StrPrintf( &m_body, "X%dY%dI%dJ%dD01*\n",
              KiROUND( devEnd.x ), KiROUND( devEnd.y ),
              KiROUND( devCenter.x ), KiROUND( devCenter.y ) );
 
-    fprintf( outputFile, "G01*\n" ); // Back to linear interpol (perhaps useless here).
+    m_body += "G01*\n"; // Back to linear interpol (perhaps useless here).
 }
 
 
@@ -573,7 +556,7 @@ void GERBER_PLOTTER::PlotGerberRegion( const std::vector< wxPoint >& aCornerList
 
         if( !attrib.empty() )
         {
-            fputs( attrib.c_str(), outputFile );
+            m_body += attrib;
             clearTA_AperFunction = true;
         }
     }
@@ -585,11 +568,11 @@ void GERBER_PLOTTER::PlotGerberRegion( const std::vector< wxPoint >& aCornerList
     {
         if( m_useX2format )
         {
-            fputs( "%TD.AperFunction*%\n", outputFile );
+            m_body += "%TD.AperFunction*%\n";
         }
         else
         {
-            fputs( "G04 #@! TD.AperFunction*\n", outputFile );
+            m_body += "G04 #@! TD.AperFunction*\n";
         }
     }
 }
@@ -610,10 +593,10 @@ void GERBER_PLOTTER::PlotPoly( const std::vector< wxPoint >& aCornerList,
 
     if( aFill )
     {
-        fputs( "G36*\n", outputFile );
+        m_body += "G36*\n";
 
         MoveTo( aCornerList[0] );
-        fputs( "G01*\n", outputFile );      // Set linear interpolation.
+        m_body += "G01*\n";      // Set linear interpolation.
 
         for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
             LineTo( aCornerList[ii] );
@@ -622,7 +605,7 @@ void GERBER_PLOTTER::PlotPoly( const std::vector< wxPoint >& aCornerList,
         if( aCornerList[0] != aCornerList[aCornerList.size()-1] )
             FinishTo( aCornerList[0] );
 
-        fputs( "G37*\n", outputFile );
+        m_body += "G37*\n";
     }
 
     if( aWidth > 0 )    // Draw the polyline/polygon outline
@@ -929,7 +912,7 @@ void GERBER_PLOTTER::FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aS
 
             if( !attrib.empty() )
             {
-                fputs( attrib.c_str(), outputFile );
+                m_body += attrib;
                 clearTA_AperFunction = true;
             }
         }
@@ -942,11 +925,11 @@ void GERBER_PLOTTER::FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aS
         {
             if( m_useX2format )
             {
-                fputs( "%TD.AperFunction*%\n", outputFile );
+                m_body += "%TD.AperFunction*%\n";
             }
             else
             {
-                fputs( "G04 #@! TD.AperFunction*\n", outputFile );
+                m_body += "G04 #@! TD.AperFunction*\n";
             }
         }
     }
@@ -1039,8 +1022,8 @@ void GERBER_PLOTTER::plotRoundRectAsRegion( const wxPoint& aRectCenter, const wx
         rr_edge.m_center += aRectCenter;
     }
 
-    fputs( "G36*\n", outputFile );      // Start region
-    fputs( "G01*\n", outputFile );      // Set linear interpolation.
+    m_body += "G36*\n";      // Start region
+    m_body += "G01*\n";      // Set linear interpolation.
     MoveTo( rr_outline[0].m_start );    // Start point of region
 
     for( RR_EDGE& rr_edge: rr_outline )
@@ -1055,7 +1038,7 @@ void GERBER_PLOTTER::plotRoundRectAsRegion( const wxPoint& aRectCenter, const wx
             LineTo( rr_edge.m_end );
     }
 
-    fputs( "G37*\n", outputFile );      // Close region
+    m_body += "G37*\n";      // Close region
 }
 
 
@@ -1199,7 +1182,7 @@ void GERBER_PLOTTER::Text( const wxPoint& aPos, const COLOR4D aColor,
 void GERBER_PLOTTER::SetLayerPolarity( bool aPositive )
 {
     if( aPositive )
-        fprintf( outputFile, "%%LPD*%%\n" );
+        m_body += "%LPD*%\n";
     else
-        fprintf( outputFile, "%%LPC*%%\n" );
+        m_body += "%LPC*%\n";
 }
@@ -28,6 +28,15 @@
 
 #include <richio.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 // Fall back to getc() when getc_unlocked() is not available on the target platform.
 #if !defined( HAVE_FGETC_NOLOCK )
@@ -278,6 +287,173 @@ char* STRING_LINE_READER::ReadLine()
 }
 
 
+const char* STRING_LINE_READER::ReadLineNoCopy( unsigned* aLength )
+{
+    size_t  nlOffset = m_lines.find( '\n', m_ndx );
+
+    if( nlOffset == std::string::npos )
+        m_length = m_lines.length() - m_ndx;
+    else
+        m_length = nlOffset - m_ndx + 1;     // include the newline, so +1
+
+    if( m_length >= m_maxLineLength )
+        THROW_IO_ERROR( _("Line length exceeded") );
+
+    const char* line = m_lines.data() + m_ndx;
+
+    m_ndx += m_length;
+    ++m_lineNum;      // this gets incremented even if no bytes were read
+
+    *aLength = m_length;
+    return m_length ? line : NULL;
+}
+
+
+MMAP_LINE_READER::MMAP_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber, unsigned aMaxLineLength ) :
+    LINE_READER( aMaxLineLength ), m_data( NULL ), m_size( 0 ), m_ndx( 0 )
+{
+    m_source  = aFileName;
+    m_lineNum = aStartingLineNumber;
+
+    bool ok = false;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW( aFileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+
+    if( file != INVALID_HANDLE_VALUE )
+    {
+        LARGE_INTEGER size;
+
+        if( GetFileSizeEx( file, &size ) )
+        {
+            m_size = (size_t) size.QuadPart;
+            ok = true;
+
+            // Mapping an empty file is an error on Windows, so just leave m_data NULL
+            if( m_size )
+            {
+                HANDLE mapping = CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+
+                if( mapping )
+                {
+                    // The view keeps the mapping and the file alive after the handles close
+                    m_data = (const char*) MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+                    CloseHandle( mapping );
+                }
+
+                ok = ( m_data != NULL );
+            }
+        }
+
+        CloseHandle( file );
+    }
+#else
+    int fd = open( aFileName.fn_str(), O_RDONLY );
+
+    if( fd >= 0 )
+    {
+        struct stat st;
+
+        if( fstat( fd, &st ) == 0 )
+        {
+            m_size = (size_t) st.st_size;
+            ok = true;
+
+            // mmap() of zero bytes fails, so just leave m_data NULL
+            if( m_size )
+            {
+                void* addr = mmap( NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+                if( addr != MAP_FAILED )
+                {
+                    madvise( addr, m_size, MADV_SEQUENTIAL );
+                    m_data = (const char*) addr;
+                }
+
+                ok = ( m_data != NULL );
+            }
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        close( fd );
+    }
+#endif
+
+    if( !ok )
+    {
+        wxString msg = wxString::Format(
+            _( "Unable to open filename \"%s\" for reading" ), aFileName.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+}
+
+
+MMAP_LINE_READER::~MMAP_LINE_READER()
+{
+    if( m_data )
+    {
+#ifdef _WIN32
+        UnmapViewOfFile( m_data );
+#else
+        munmap( (void*) m_data, m_size );
+#endif
+    }
+}
+
+
+size_t MMAP_LINE_READER::nextLine()
+{
+    size_t      offset = m_ndx;
+    const char* nl = m_data ? (const char*) memchr( m_data + offset, '\n', m_size - offset )
+                            : NULL;
+
+    if( nl )
+        m_length = nl - ( m_data + offset ) + 1;     // include the newline, so +1
+    else
+        m_length = m_size - offset;
+
+    if( m_length >= m_maxLineLength )
+        THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+    m_ndx += m_length;
+
+    // m_lineNum is incremented even if there was no line read, because this
+    // leads to better error reporting when we hit an end of file.
+    ++m_lineNum;
+
+    return offset;
+}
+
+
+char* MMAP_LINE_READER::ReadLine()
+{
+    size_t offset = nextLine();
+
+    if( m_length )
+    {
+        if( m_length+1 > m_capacity )   // +1 for terminating nul
+            expandCapacity( m_length+1 );
+
+        memcpy( m_line, m_data + offset, m_length );
+    }
+
+    m_line[m_length] = 0;
+
+    return m_length ? m_line : NULL;
+}
+
+
+const char* MMAP_LINE_READER::ReadLineNoCopy( unsigned* aLength )
+{
+    size_t offset = nextLine();
+
+    *aLength = m_length;
+    return m_length ? m_data + offset : NULL;
+}
+
+
 INPUTSTREAM_LINE_READER::INPUTSTREAM_LINE_READER( wxInputStream* aStream, const wxString& aSource ) :
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     m_stream( aStream )
@@ -31,6 +31,13 @@
 #include <richio.h>                        // StrPrintf
 #include <kicad_string.h>
 
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <locale>
+#include <sstream>
+
 
 /**
  * Illegal file name characters used to insure file names will be valid on all supported
@@ -736,3 +743,215 @@ bool ReplaceIllegalFileNameChars( wxString& aName, int aReplaceChar )
 
     return changed;
 }
+
+
+/**
+ * White space as understood by strtod() in the "C" locale.
+ */
+static inline bool isCSpace( char c )
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+
+/**
+ * @return the value of \a c as a digit in \a aBase (10 or 16), or -1 if it is not one.
+ */
+static inline int digitValue( char c, int aBase )
+{
+    if( c >= '0' && c <= '9' )
+        return c - '0';
+
+    if( aBase == 16 )
+    {
+        if( c >= 'a' && c <= 'f' )
+            return c - 'a' + 10;
+
+        if( c >= 'A' && c <= 'F' )
+            return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+
+const char* ParseDoubleNoLocale( const char* aText, double* aValue )
+{
+    // Powers of ten which are exactly representable in a double.
+    static const double exactPow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char* p = aText;
+
+    while( isCSpace( *p ) )
+        ++p;
+
+    const char* numStart = p;
+    bool        negative = false;
+
+    if( *p == '-' || *p == '+' )
+        negative = ( *p++ == '-' );
+
+    uint64_t mantissa = 0;
+    int      sigDigits = 0;         // significant digits folded into mantissa
+    int      exponent = 0;          // decimal exponent applied to mantissa
+    bool     anyDigits = false;
+    bool     truncated = false;     // more than 19 significant digits were seen
+
+    for( ; *p >= '0' && *p <= '9'; ++p )
+    {
+        anyDigits = true;
+
+        if( sigDigits < 19 )
+        {
+            mantissa = mantissa * 10 + ( *p - '0' );
+
+            if( mantissa )
+                ++sigDigits;
+        }
+        else
+        {
+            ++exponent;
+            truncated |= ( *p != '0' );
+        }
+    }
+
+    if( *p == '.' )
+    {
+        for( ++p; *p >= '0' && *p <= '9'; ++p )
+        {
+            anyDigits = true;
+
+            if( sigDigits < 19 )
+            {
+                mantissa = mantissa * 10 + ( *p - '0' );
+                --exponent;
+
+                if( mantissa )
+                    ++sigDigits;
+            }
+            else
+            {
+                truncated |= ( *p != '0' );
+            }
+        }
+    }
+
+    if( !anyDigits )
+        return aText;
+
+    if( *p == 'e' || *p == 'E' )
+    {
+        const char* e = p + 1;
+        bool        expNegative = false;
+
+        if( *e == '-' || *e == '+' )
+            expNegative = ( *e++ == '-' );
+
+        if( *e >= '0' && *e <= '9' )
+        {
+            int expValue = 0;
+
+            for( ; *e >= '0' && *e <= '9'; ++e )
+            {
+                if( expValue < 100000 )
+                    expValue = expValue * 10 + ( *e - '0' );
+            }
+
+            exponent += expNegative ? -expValue : expValue;
+            p = e;
+        }
+    }
+
+    double value;
+
+    if( mantissa == 0 )
+    {
+        value = 0.0;
+    }
+    else if( !truncated && mantissa <= ( UINT64_C( 1 ) << 53 ) && exponent >= -22
+             && exponent <= 22 )
+    {
+        // Both the mantissa and the power of ten are exact, so a single IEEE multiply or
+        // divide gives the correctly rounded result.
+        value = static_cast<double>( mantissa );
+
+        if( exponent < 0 )
+            value /= exactPow10[-exponent];
+        else
+            value *= exactPow10[exponent];
+    }
+    else
+    {
+        // Rare: long mantissa or huge exponent.  Hand the span to the classic locale so the
+        // result is still correctly rounded and independent of the global locale.
+        std::istringstream stream( std::string( numStart, p ) );
+        stream.imbue( std::locale::classic() );
+        stream >> value;
+
+        if( stream.fail() )
+        {
+            // The span is a valid number, so it is out of range.  Whatever the stream left in
+            // value, return what strtod() does: HUGE_VAL for an overflow, and the denormal or
+            // zero nearest to an underflow.
+            int magnitude = exponent + sigDigits - 1;
+
+            if( magnitude >= 0 )
+                value = HUGE_VAL;
+            else if( !std::isfinite( value ) || std::fabs( value ) >= DBL_MIN )
+                value = 0.0;
+
+            value = std::copysign( value, negative ? -1.0 : 1.0 );
+        }
+
+        *aValue = value;
+        return p;
+    }
+
+    *aValue = negative ? -value : value;
+    return p;
+}
+
+
+const char* ParseLongNoLocale( const char* aText, long* aValue, int aBase )
+{
+    const char* p = aText;
+
+    while( isCSpace( *p ) )
+        ++p;
+
+    bool negative = false;
+
+    if( *p == '-' || *p == '+' )
+        negative = ( *p++ == '-' );
+
+    if( aBase == 16 && p[0] == '0' && ( p[1] == 'x' || p[1] == 'X' )
+            && digitValue( p[2], 16 ) >= 0 )
+    {
+        p += 2;
+    }
+
+    const char*   digitsStart = p;
+    unsigned long value = 0;
+    bool          overflow = false;
+
+    for( int digit; ( digit = digitValue( *p, aBase ) ) >= 0; ++p )
+    {
+        if( value > ( ULONG_MAX - digit ) / aBase )
+            overflow = true;
+        else
+            value = value * aBase + digit;
+    }
+
+    if( p == digitsStart )
+        return aText;
+
+    if( negative )
+        *aValue = ( overflow || value > (unsigned long) LONG_MAX + 1 ) ? LONG_MIN : -(long) value;
+    else
+        *aValue = ( overflow || value > (unsigned long) LONG_MAX ) ? LONG_MAX : (long) value;
+
+    return p;
+}
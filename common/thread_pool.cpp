@@ -0,0 +1,337 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <thread_pool.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include <widgets/progress_reporter.h>
+
+
+// Index of the pool worker running the current thread, or -1 for the other threads
+static thread_local int s_workerIndex = -1;
+
+
+THREAD_POOL::THREAD_POOL( size_t aThreadCount ) :
+        m_pendingTasks( 0 ),
+        m_nextQueue( 0 ),
+        m_stop( false )
+{
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        m_queues.emplace_back( new TASK_QUEUE );
+
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        m_workers.emplace_back( &THREAD_POOL::workerLoop, this, ii );
+}
+
+
+THREAD_POOL::~THREAD_POOL()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_sleepMutex );
+        m_stop = true;
+    }
+
+    m_wakeUp.notify_all();
+
+    for( std::thread& worker : m_workers )
+        worker.join();
+}
+
+
+THREAD_POOL& THREAD_POOL::GetInstance()
+{
+    static THREAD_POOL pool( std::max<size_t>( std::thread::hardware_concurrency(), 1 ) );
+
+    return pool;
+}
+
+
+void THREAD_POOL::submit( TASK aTask )
+{
+    size_t queue = s_workerIndex >= 0 ? (size_t) s_workerIndex
+                                      : m_nextQueue++ % m_queues.size();
+
+    {
+        std::lock_guard<std::mutex> lock( m_queues[queue]->m_mutex );
+        m_queues[queue]->m_tasks.push_back( std::move( aTask ) );
+    }
+
+    m_pendingTasks++;
+
+    // Taking the lock orders the count update before the check of a worker going to sleep
+    {
+        std::lock_guard<std::mutex> lock( m_sleepMutex );
+    }
+
+    m_wakeUp.notify_one();
+}
+
+
+bool THREAD_POOL::takeTask( TASK& aTask )
+{
+    if( m_pendingTasks == 0 )
+        return false;
+
+    size_t count = m_queues.size();
+    size_t first = s_workerIndex >= 0 ? (size_t) s_workerIndex : m_nextQueue % count;
+
+    for( size_t ii = 0; ii < count; ++ii )
+    {
+        TASK_QUEUE& queue = *m_queues[( first + ii ) % count];
+        std::lock_guard<std::mutex> lock( queue.m_mutex );
+
+        if( queue.m_tasks.empty() )
+            continue;
+
+        // The own deque is used as a stack, which keeps nested tasks on the same thread;
+        // the others are robbed of their oldest task, usually the largest piece of work.
+        if( ii == 0 && s_workerIndex >= 0 )
+        {
+            aTask = std::move( queue.m_tasks.back() );
+            queue.m_tasks.pop_back();
+        }
+        else
+        {
+            aTask = std::move( queue.m_tasks.front() );
+            queue.m_tasks.pop_front();
+        }
+
+        m_pendingTasks--;
+        return true;
+    }
+
+    return false;
+}
+
+
+bool THREAD_POOL::runPendingTask()
+{
+    TASK task;
+
+    if( !takeTask( task ) )
+        return false;
+
+    task();
+    return true;
+}
+
+
+void THREAD_POOL::workerLoop( size_t aIndex )
+{
+    s_workerIndex = (int) aIndex;
+
+    while( true )
+    {
+        if( runPendingTask() )
+            continue;
+
+        std::unique_lock<std::mutex> lock( m_sleepMutex );
+
+        m_wakeUp.wait( lock, [&]() { return m_stop || m_pendingTasks > 0; } );
+
+        if( m_stop )
+            return;
+    }
+}
+
+
+TASK_GROUP::TASK_GROUP( PROGRESS_REPORTER* aReporter, bool aCanCancel ) :
+        m_pool( THREAD_POOL::GetInstance() ),
+        m_reporter( aReporter ),
+        m_canCancel( aCanCancel ),
+        m_cancelled( false ),
+        m_pending( 0 )
+{
+}
+
+
+TASK_GROUP::~TASK_GROUP()
+{
+    Cancel();
+
+    try
+    {
+        Wait();
+    }
+    catch( ... )
+    {
+        // The exception was not wanted if nobody waited for it
+    }
+}
+
+
+void TASK_GROUP::Run( std::function<void()> aTask )
+{
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_pending++;
+    }
+
+    m_pool.submit( [this, aTask]()
+                   {
+                       if( !m_cancelled )
+                       {
+                           try
+                           {
+                               aTask();
+                           }
+                           catch( ... )
+                           {
+                               std::lock_guard<std::mutex> lock( m_mutex );
+
+                               if( !m_exception )
+                                   m_exception = std::current_exception();
+
+                               m_cancelled = true;
+                           }
+                       }
+
+                       taskDone();
+                   } );
+}
+
+
+void TASK_GROUP::ParallelFor( size_t aCount, std::function<void( size_t )> aFunc,
+                              size_t aGrainSize )
+{
+    aGrainSize = std::max<size_t>( aGrainSize, 1 );
+
+    size_t grains = ( aCount + aGrainSize - 1 ) / aGrainSize;
+    size_t tasks = std::min( grains, m_pool.GetThreadCount() );
+
+    if( tasks == 0 )
+        return;
+
+    // The tasks share a cursor rather than owning fixed ranges, so they finish together
+    // however uneven the calls are.
+    auto next = std::make_shared<std::atomic<size_t>>( 0 );
+    auto func = std::make_shared<std::function<void( size_t )>>( std::move( aFunc ) );
+
+    auto task = [this, next, func, aCount, aGrainSize]()
+                {
+                    for( size_t first = next->fetch_add( aGrainSize ); first < aCount;
+                         first = next->fetch_add( aGrainSize ) )
+                    {
+                        size_t last = std::min( first + aGrainSize, aCount );
+
+                        for( size_t ii = first; ii < last && !m_cancelled; ++ii )
+                            ( *func )( ii );
+                    }
+                };
+
+    if( grains == 1 )
+    {
+        try
+        {
+            task();
+        }
+        catch( ... )
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+
+            if( !m_exception )
+                m_exception = std::current_exception();
+
+            m_cancelled = true;
+        }
+
+        return;
+    }
+
+    for( size_t ii = 0; ii < tasks; ++ii )
+        Run( task );
+}
+
+
+bool TASK_GROUP::Wait()
+{
+    if( m_reporter )
+    {
+        // The main thread keeps the UI alive rather than running tasks
+        std::unique_lock<std::mutex> lock( m_mutex );
+
+        while( !m_done.wait_for( lock, std::chrono::milliseconds( 100 ),
+                                 [&]() { return m_pending == 0; } ) )
+        {
+            lock.unlock();
+
+            if( !m_reporter->KeepRefreshing() && m_canCancel )
+                Cancel();
+
+            lock.lock();
+        }
+    }
+    else
+    {
+        while( true )
+        {
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+
+                if( m_pending == 0 )
+                    break;
+            }
+
+            // Help with whatever is pending, this group's tasks or not, and only sleep when
+            // the last tasks of the group are running elsewhere.
+            if( !m_pool.runPendingTask() )
+            {
+                std::unique_lock<std::mutex> lock( m_mutex );
+                m_done.wait_for( lock, std::chrono::milliseconds( 1 ),
+                                 [&]() { return m_pending == 0; } );
+            }
+        }
+    }
+
+    std::exception_ptr exception;
+
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        std::swap( exception, m_exception );
+    }
+
+    if( exception )
+        std::rethrow_exception( exception );
+
+    return !m_cancelled;
+}
+
+
+void TASK_GROUP::taskDone()
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    if( --m_pending == 0 )
+        m_done.notify_all();
+}
+
+
+void PoolParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc )
+{
+    TASK_GROUP group( nullptr, false );
+
+    group.ParallelFor( aCount, aFunc );
+    group.Wait();
+}
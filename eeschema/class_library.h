@@ -31,6 +31,7 @@
 #ifndef CLASS_LIBRARY_H
 #define CLASS_LIBRARY_H
 
+#include <atomic>
 #include <map>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <wx/filename.h>
@@ -190,7 +191,7 @@ class PART_LIBS : public PART_LIBS_BASE, public PROJECT::_ELEM
 public:
     KICAD_T Type() override { return PART_LIBS_T; }
 
-    static int s_modify_generation;         ///< helper for GetModifyHash()
+    static std::atomic<int> s_modify_generation;    ///< helper for GetModifyHash()
 
     PART_LIBS()
     {
@@ -19,12 +19,11 @@
  */
 
 #include <list>
-#include <thread>
 #include <algorithm>
-#include <future>
 #include <vector>
 #include <unordered_map>
 #include <profile.h>
+#include <thread_pool.h>
 
 #include <common.h>
 #include <erc.h>
@@ -355,6 +354,11 @@ void CONNECTION_GRAPH::Reset()
     m_net_name_to_subgraphs_map.clear();
     m_local_label_cache.clear();
     m_global_label_cache.clear();
+    m_sheets.clear();
+    m_item_subgraphs.clear();
+    m_subgraph_owners.clear();
+    m_subgraph_keys.clear();
+    m_key_to_subgraphs.clear();
     m_last_net_code = 1;
     m_last_bus_code = 1;
     m_last_subgraph_code = 1;
@@ -364,45 +368,59 @@ void CONNECTION_GRAPH::Reset()
 void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnconditional )
 {
     PROF_COUNTER recalc_time;
-    PROF_COUNTER update_items;
 
-    if( aUnconditional )
-        Reset();
-
-    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    if( aUnconditional || !ADVANCED_CFG::GetCfg().m_incrementalConnectivity
+            || !updateIncrementally( aSheetList ) )
     {
-        std::vector<SCH_ITEM*> items;
+        PROF_COUNTER update_items;
 
-        for( auto item : sheet.LastScreen()->Items() )
+        Reset();
+
+        for( const SCH_SHEET_PATH& sheet : aSheetList )
         {
-            if( item->IsConnectable() && ( aUnconditional || item->IsConnectivityDirty() ) )
-                items.push_back( item );
+            std::vector<SCH_ITEM*> items;
+
+            for( auto item : sheet.LastScreen()->Items() )
+            {
+                if( item->IsConnectable() )
+                    items.push_back( item );
+            }
+
+            updateItemConnectivity( sheet, items );
+
+            // UpdateDanglingState() also adds connected items for SCH_TEXT
+            sheet.LastScreen()->TestDanglingEnds( &sheet );
+
+            m_sheets.emplace_back( sheet.PathAsString() + sheet.PathHumanReadable(),
+                                   sheet.LastScreen() );
         }
 
-        updateItemConnectivity( sheet, items );
+        update_items.Stop();
+        wxLogTrace( "CONN_PROFILE", "UpdateItemConnectivity() %0.4f ms", update_items.msecs() );
 
-        // UpdateDanglingState() also adds connected items for SCH_TEXT
-        sheet.LastScreen()->TestDanglingEnds( &sheet );
-    }
+        PROF_COUNTER build_graph;
 
-    update_items.Stop();
-    wxLogTrace( "CONN_PROFILE", "UpdateItemConnectivity() %0.4f ms", update_items.msecs() );
+        buildConnectionGraph();
 
-    PROF_COUNTER build_graph;
+        std::vector<std::vector<wxString>> keys;
 
-    buildConnectionGraph();
+        for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
+            keys.push_back( subgraphKeys( subgraph ) );
 
-    build_graph.Stop();
-    wxLogTrace( "CONN_PROFILE", "BuildConnectionGraph() %0.4f ms", build_graph.msecs() );
+        indexSubgraphs( m_subgraphs, std::move( keys ) );
+
+        build_graph.Stop();
+        wxLogTrace( "CONN_PROFILE", "BuildConnectionGraph() %0.4f ms", build_graph.msecs() );
+    }
 
     recalc_time.Stop();
     wxLogTrace( "CONN_PROFILE", "Recalculate time %0.4f ms", recalc_time.msecs() );
 
 #ifndef DEBUG
-    // Pressure relief valve for release builds
+    // Pressure relief valve for release builds, for the real-time updates only
     const double max_recalc_time_msecs = 250.;
 
-    if( m_allowRealTime && ADVANCED_CFG::GetCfg().m_realTimeConnectivity &&
+    if( !aUnconditional && m_allowRealTime && ADVANCED_CFG::GetCfg().m_realTimeConnectivity &&
         recalc_time.msecs() > max_recalc_time_msecs )
     {
         m_allowRealTime = false;
@@ -411,6 +429,254 @@ void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnco
 }
 
 
+bool CONNECTION_GRAPH::updateIncrementally( const SCH_SHEET_LIST& aSheetList )
+{
+    // A changed hierarchy renames nets everywhere below the change
+    if( aSheetList.size() != m_sheets.size() )
+        return false;
+
+    std::unordered_map<SCH_SCREEN*, std::vector<const SCH_SHEET_PATH*>> screen_sheets;
+
+    for( size_t ii = 0; ii < aSheetList.size(); ++ii )
+    {
+        const SCH_SHEET_PATH& sheet = aSheetList[ii];
+
+        if( m_sheets[ii].second != sheet.LastScreen()
+                || m_sheets[ii].first != sheet.PathAsString() + sheet.PathHumanReadable() )
+        {
+            return false;
+        }
+
+        screen_sheets[ sheet.LastScreen() ].push_back( &sheet );
+    }
+
+    // Bus aliases are replaced rather than edited, so comparing the pointers is enough
+    std::unordered_set<wxString> alias_names;
+
+    for( const auto& it : screen_sheets )
+    {
+        for( const auto& alias : it.first->GetBusAliases() )
+        {
+            auto cached = m_bus_alias_cache.find( alias->GetName() );
+
+            if( cached == m_bus_alias_cache.end() || cached->second != alias )
+                return false;
+
+            alias_names.insert( alias->GetName() );
+        }
+    }
+
+    if( alias_names.size() != m_bus_alias_cache.size() )
+        return false;
+
+    // Find the changed items: the dirty and new ones, and the ones gone from the screens
+
+    std::unordered_map<SCH_ITEM*, SCH_SCREEN*> live_items;
+    std::vector<SCH_ITEM*>                     changed_items;
+    size_t                                     known_items = 0;
+
+    for( const auto& it : screen_sheets )
+    {
+        for( SCH_ITEM* item : it.first->Items() )
+        {
+            if( !item->IsConnectable() )
+                continue;
+
+            live_items[ item ] = it.first;
+
+            if( m_item_subgraphs.count( item ) )
+                known_items++;
+
+            if( item->IsConnectivityDirty() || !m_item_subgraphs.count( item ) )
+                changed_items.push_back( item );
+        }
+    }
+
+    std::unordered_set<SCH_ITEM*>            affected_items;
+    std::unordered_set<CONNECTION_SUBGRAPH*> affected_subgraphs;
+    std::vector<SCH_ITEM*>                   item_queue;
+    std::vector<CONNECTION_SUBGRAPH*>        subgraph_queue;
+
+    auto add_item = [&]( SCH_ITEM* aItem )
+                    {
+                        if( affected_items.insert( aItem ).second )
+                            item_queue.push_back( aItem );
+                    };
+
+    auto add_subgraph = [&]( CONNECTION_SUBGRAPH* aSubgraph )
+                        {
+                            if( affected_subgraphs.insert( aSubgraph ).second )
+                                subgraph_queue.push_back( aSubgraph );
+                        };
+
+    if( known_items < m_item_subgraphs.size() )
+    {
+        for( const auto& it : m_item_subgraphs )
+        {
+            if( !live_items.count( it.first ) )
+                add_item( it.first );
+        }
+    }
+
+    for( SCH_ITEM* item : changed_items )
+    {
+        add_item( item );
+
+        // The items the changed one may now touch
+        EDA_RECT               area = item->GetBoundingBox();
+        std::vector<wxPoint>   points;
+
+        item->GetConnectionPoints( points );
+
+        for( const wxPoint& point : points )
+            area.Merge( point );
+
+        area.Inflate( 1 );
+
+        for( SCH_ITEM* neighbor : live_items.at( item )->Items().Overlapping( area ) )
+        {
+            if( neighbor->IsConnectable() )
+                add_item( neighbor );
+        }
+    }
+
+    if( affected_items.empty() )
+        return true;
+
+    // An affected item takes all its subgraphs, and an affected subgraph all its items and the
+    // subgraphs sharing a key with it.  Growing a large part of the graph this way means that
+    // rebuilding it all costs about the same.
+
+    const size_t max_affected_items = live_items.size() / 2;
+
+    auto expand = [&]() -> bool
+                  {
+                      while( !item_queue.empty() || !subgraph_queue.empty() )
+                      {
+                          if( affected_items.size() > max_affected_items )
+                              return false;
+
+                          if( !item_queue.empty() )
+                          {
+                              SCH_ITEM* item = item_queue.back();
+                              item_queue.pop_back();
+
+                              auto it = m_item_subgraphs.find( item );
+
+                              if( it != m_item_subgraphs.end() )
+                              {
+                                  for( CONNECTION_SUBGRAPH* subgraph : it->second )
+                                      add_subgraph( subgraph );
+                              }
+
+                              continue;
+                          }
+
+                          CONNECTION_SUBGRAPH* subgraph = subgraph_queue.back();
+                          subgraph_queue.pop_back();
+
+                          for( SCH_ITEM* owner : m_subgraph_owners.at( subgraph ) )
+                              add_item( owner );
+
+                          for( const wxString& key : m_subgraph_keys.at( subgraph ) )
+                          {
+                              for( CONNECTION_SUBGRAPH* other : m_key_to_subgraphs.at( key ) )
+                                  add_subgraph( other );
+                          }
+                      }
+
+                      return true;
+                  };
+
+    while( true )
+    {
+        if( !expand() )
+            return false;
+
+        CONNECTION_GRAPH partial( m_frame );
+
+        // The net and bus codes are shared, so that names keep their code
+        std::swap( partial.m_net_name_to_code_map, m_net_name_to_code_map );
+        std::swap( partial.m_bus_name_to_code_map, m_bus_name_to_code_map );
+        partial.m_last_net_code = m_last_net_code;
+        partial.m_last_bus_code = m_last_bus_code;
+        partial.m_last_subgraph_code = m_last_subgraph_code;
+
+        std::unordered_map<SCH_SCREEN*, std::vector<SCH_ITEM*>> screen_items;
+
+        for( SCH_ITEM* item : affected_items )
+        {
+            auto it = live_items.find( item );
+
+            if( it != live_items.end() )
+                screen_items[ it->second ].push_back( item );
+        }
+
+        for( const SCH_SHEET_PATH& sheet : aSheetList )
+        {
+            auto it = screen_items.find( sheet.LastScreen() );
+
+            if( it == screen_items.end() )
+                continue;
+
+            partial.updateItemConnectivity( sheet, it->second );
+            sheet.LastScreen()->TestDanglingEnds( &sheet );
+        }
+
+        partial.buildConnectionGraph();
+
+        std::swap( partial.m_net_name_to_code_map, m_net_name_to_code_map );
+        std::swap( partial.m_bus_name_to_code_map, m_bus_name_to_code_map );
+        m_last_net_code = partial.m_last_net_code;
+        m_last_bus_code = partial.m_last_bus_code;
+        m_last_subgraph_code = partial.m_last_subgraph_code;
+
+        // The rebuilt subgraphs may have picked up names or links of subgraphs left out, which
+        // must then be rebuilt with them.
+        std::vector<std::vector<wxString>> keys;
+        bool                               complete = true;
+
+        for( CONNECTION_SUBGRAPH* subgraph : partial.m_subgraphs )
+        {
+            keys.push_back( partial.subgraphKeys( subgraph ) );
+
+            for( const wxString& key : keys.back() )
+            {
+                auto it = m_key_to_subgraphs.find( key );
+
+                if( it == m_key_to_subgraphs.end() )
+                    continue;
+
+                for( CONNECTION_SUBGRAPH* other : it->second )
+                {
+                    if( !affected_subgraphs.count( other ) )
+                    {
+                        add_subgraph( other );
+                        complete = false;
+                    }
+                }
+            }
+        }
+
+        if( !complete )
+            continue;
+
+        wxLogTrace( "CONN_PROFILE", "Incremental update of %lu items, %lu subgraphs",
+                    (unsigned long) affected_items.size(),
+                    (unsigned long) affected_subgraphs.size() );
+
+        removeSubgraphs( affected_subgraphs );
+
+        for( SCH_ITEM* item : affected_items )
+            m_item_subgraphs.erase( item );
+
+        merge( partial, std::move( keys ) );
+
+        return true;
+    }
+}
+
+
 void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
                                                const std::vector<SCH_ITEM*>& aItemList )
 {
@@ -422,6 +688,9 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
         item->GetConnectionPoints( points );
         item->ConnectedItems( aSheet ).clear();
 
+        // Known from now on, even if it ends up in no subgraph
+        m_item_subgraphs.emplace( item, std::vector<CONNECTION_SUBGRAPH*>() );
+
         if( item->Type() == SCH_SHEET_T )
         {
             for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( item )->GetPins() )
@@ -717,12 +986,6 @@ void CONNECTION_GRAPH::buildConnectionGraph()
 
     // Resolve drivers for subgraphs and propagate connectivity info
 
-    // We don't want to spin up a new thread for fewer than 8 nets (overhead costs)
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-            ( m_subgraphs.size() + 3 ) / 4 );
-
-    std::atomic<size_t> nextSubgraph( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
     std::vector<CONNECTION_SUBGRAPH*> dirty_graphs;
 
     std::copy_if( m_subgraphs.begin(), m_subgraphs.end(), std::back_inserter( dirty_graphs ),
@@ -731,106 +994,95 @@ void CONNECTION_GRAPH::buildConnectionGraph()
                       return candidate->m_dirty;
                   } );
 
-    auto update_lambda = [&nextSubgraph, &dirty_graphs]() -> size_t
+    auto update_lambda = [&dirty_graphs]( size_t subgraphId )
     {
-        for( size_t subgraphId = nextSubgraph++; subgraphId < dirty_graphs.size(); subgraphId = nextSubgraph++ )
-        {
-            auto subgraph = dirty_graphs[subgraphId];
+        auto subgraph = dirty_graphs[subgraphId];
 
-            if( !subgraph->m_dirty )
-                continue;
+        if( !subgraph->m_dirty )
+            return;
 
-            // Special processing for some items
-            for( auto item : subgraph->m_items )
+        // Special processing for some items
+        for( auto item : subgraph->m_items )
+        {
+            switch( item->Type() )
             {
-                switch( item->Type() )
-                {
-                case SCH_NO_CONNECT_T:
-                    subgraph->m_no_connect = item;
-                    break;
+            case SCH_NO_CONNECT_T:
+                subgraph->m_no_connect = item;
+                break;
 
-                case SCH_BUS_WIRE_ENTRY_T:
-                    subgraph->m_bus_entry = item;
-                    break;
+            case SCH_BUS_WIRE_ENTRY_T:
+                subgraph->m_bus_entry = item;
+                break;
 
-                case SCH_PIN_T:
-                {
-                    auto pin = static_cast<SCH_PIN*>( item );
+            case SCH_PIN_T:
+            {
+                auto pin = static_cast<SCH_PIN*>( item );
 
-                    if( pin->GetType() == ELECTRICAL_PINTYPE::PT_NC )
-                        subgraph->m_no_connect = item;
+                if( pin->GetType() == ELECTRICAL_PINTYPE::PT_NC )
+                    subgraph->m_no_connect = item;
 
-                    break;
-                }
+                break;
+            }
 
-                default:
-                    break;
-                }
+            default:
+                break;
             }
+        }
 
-            if( !subgraph->ResolveDrivers() )
+        if( !subgraph->ResolveDrivers() )
+        {
+            subgraph->m_dirty = false;
+        }
+        else
+        {
+            // Now the subgraph has only one driver
+            SCH_ITEM* driver = subgraph->m_driver;
+            SCH_SHEET_PATH sheet = subgraph->m_sheet;
+            SCH_CONNECTION* connection = driver->Connection( sheet );
+
+            // TODO(JE) This should live in SCH_CONNECTION probably
+            switch( driver->Type() )
             {
-                subgraph->m_dirty = false;
+            case SCH_LABEL_T:
+            case SCH_GLOBAL_LABEL_T:
+            case SCH_HIER_LABEL_T:
+            {
+                auto text = static_cast<SCH_TEXT*>( driver );
+                connection->ConfigureFromLabel( text->GetText() );
+                break;
             }
-            else
+            case SCH_SHEET_PIN_T:
             {
-                // Now the subgraph has only one driver
-                SCH_ITEM* driver = subgraph->m_driver;
-                SCH_SHEET_PATH sheet = subgraph->m_sheet;
-                SCH_CONNECTION* connection = driver->Connection( sheet );
-
-                // TODO(JE) This should live in SCH_CONNECTION probably
-                switch( driver->Type() )
-                {
-                case SCH_LABEL_T:
-                case SCH_GLOBAL_LABEL_T:
-                case SCH_HIER_LABEL_T:
-                {
-                    auto text = static_cast<SCH_TEXT*>( driver );
-                    connection->ConfigureFromLabel( text->GetText() );
-                    break;
-                }
-                case SCH_SHEET_PIN_T:
-                {
-                    auto pin = static_cast<SCH_SHEET_PIN*>( driver );
-                    connection->ConfigureFromLabel( pin->GetText() );
-                    break;
-                }
-                case SCH_PIN_T:
-                {
-                    auto pin = static_cast<SCH_PIN*>( driver );
-                    // NOTE(JE) GetDefaultNetName is not thread-safe.
-                    connection->ConfigureFromLabel( pin->GetDefaultNetName( sheet ) );
+                auto pin = static_cast<SCH_SHEET_PIN*>( driver );
+                connection->ConfigureFromLabel( pin->GetText() );
+                break;
+            }
+            case SCH_PIN_T:
+            {
+                auto pin = static_cast<SCH_PIN*>( driver );
+                // NOTE(JE) GetDefaultNetName is not thread-safe.
+                connection->ConfigureFromLabel( pin->GetDefaultNetName( sheet ) );
 
-                    break;
-                }
-                default:
-                    wxLogTrace( "CONN", "Driver type unsupported: %s",
-                            driver->GetSelectMenuText( EDA_UNITS::MILLIMETRES ) );
-                    break;
-                }
+                break;
+            }
+            default:
+                wxLogTrace( "CONN", "Driver type unsupported: %s",
+                        driver->GetSelectMenuText( EDA_UNITS::MILLIMETRES ) );
+                break;
+            }
 
-                connection->SetDriver( driver );
-                connection->ClearDirty();
+            connection->SetDriver( driver );
+            connection->ClearDirty();
 
-                subgraph->m_dirty = false;
-            }
+            subgraph->m_dirty = false;
         }
-
-        return 1;
     };
 
-    if( parallelThreadCount == 1 )
-        update_lambda();
-    else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
+    TASK_GROUP updateTasks;
 
-        // Finalize the threads
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
-    }
+    // We don't want to hand out fewer than 4 subgraphs at a time (overhead costs)
+    updateTasks.ParallelFor( dirty_graphs.size(), update_lambda, 4 );
+    updateTasks.Wait();
 
     // Now discard any non-driven subgraphs from further consideration
 
@@ -1378,6 +1630,24 @@ void CONNECTION_GRAPH::buildConnectionGraph()
         m_net_code_to_subgraphs_map[ key ].push_back( subgraph );
     }
 
+    // The name caches still list the subgraphs absorbed since, which are about to be deleted
+    auto absorbing = []( auto aSubgraph )
+                     {
+                         while( aSubgraph->m_absorbed )
+                             aSubgraph = aSubgraph->m_absorbed_by;
+
+                         return aSubgraph;
+                     };
+
+    for( auto& it : m_net_name_to_subgraphs_map )
+        std::transform( it.second.begin(), it.second.end(), it.second.begin(), absorbing );
+
+    for( auto& it : m_local_label_cache )
+        std::transform( it.second.begin(), it.second.end(), it.second.begin(), absorbing );
+
+    for( auto& it : m_global_label_cache )
+        std::transform( it.second.begin(), it.second.end(), it.second.begin(), absorbing );
+
     // Clean up and deallocate stale subgraphs
     m_subgraphs.erase( std::remove_if( m_subgraphs.begin(), m_subgraphs.end(),
             [&]( const CONNECTION_SUBGRAPH* sg )
@@ -1396,6 +1666,231 @@ void CONNECTION_GRAPH::buildConnectionGraph()
 }
 
 
+std::vector<wxString> CONNECTION_GRAPH::subgraphKeys( CONNECTION_SUBGRAPH* aSubgraph )
+{
+    std::vector<wxString> keys;
+    wxString              sheet = aSubgraph->m_sheet.PathAsString();
+
+    // Net names are compared in full across the schematic, and without their sheet path
+    // between subgraphs of the same sheet (label merging, bus members)
+    auto add_connection = [&]( const SCH_CONNECTION* aConnection )
+                          {
+                              std::vector<const SCH_CONNECTION*> stack = { aConnection };
+
+                              while( !stack.empty() )
+                              {
+                                  const SCH_CONNECTION* conn = stack.back();
+                                  stack.pop_back();
+
+                                  keys.push_back( "N|" + conn->Name() );
+                                  keys.push_back( "S|" + sheet + "|" + conn->Name( true ) );
+
+                                  for( const auto& member : conn->Members() )
+                                      stack.push_back( member.get() );
+                              }
+                          };
+
+    if( aSubgraph->m_driver_connection )
+        add_connection( aSubgraph->m_driver_connection );
+
+    for( SCH_ITEM* driver : aSubgraph->m_drivers )
+    {
+        keys.push_back( "N|" + aSubgraph->GetNameForDriver( driver ) );
+
+        if( auto conn = getDefaultConnection( driver, aSubgraph->m_sheet ) )
+            add_connection( conn.get() );
+
+        switch( driver->Type() )
+        {
+        case SCH_LABEL_T:
+        case SCH_GLOBAL_LABEL_T:
+        case SCH_HIER_LABEL_T:
+        case SCH_SHEET_PIN_T:
+            keys.push_back( "S|" + sheet + "|" + static_cast<SCH_TEXT*>( driver )->GetShownText() );
+            break;
+
+        case SCH_PIN_T:
+            keys.push_back( "S|" + sheet + "|" + static_cast<SCH_PIN*>( driver )->GetName() );
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    // A sheet pin and a hierarchical label are linked by the path of the subsheet and their text
+    for( SCH_SHEET_PIN* pin : aSubgraph->m_hier_pins )
+    {
+        SCH_SHEET_PATH path = aSubgraph->m_sheet;
+        path.push_back( pin->GetParent() );
+
+        keys.push_back( "H|" + path.PathAsString() + "|" + pin->GetShownText() );
+    }
+
+    for( SCH_HIERLABEL* label : aSubgraph->m_hier_ports )
+        keys.push_back( "H|" + sheet + "|" + label->GetShownText() );
+
+    std::sort( keys.begin(), keys.end() );
+    keys.erase( std::unique( keys.begin(), keys.end() ), keys.end() );
+
+    return keys;
+}
+
+
+void CONNECTION_GRAPH::indexSubgraphs( const std::vector<CONNECTION_SUBGRAPH*>& aSubgraphs,
+                                       std::vector<std::vector<wxString>>&& aKeys )
+{
+    wxASSERT( aSubgraphs.size() == aKeys.size() );
+
+    for( size_t ii = 0; ii < aSubgraphs.size(); ++ii )
+    {
+        CONNECTION_SUBGRAPH*   subgraph = aSubgraphs[ii];
+        std::vector<SCH_ITEM*> owners;
+
+        for( SCH_ITEM* item : subgraph->m_items )
+        {
+            if( item->Type() == SCH_PIN_T )
+                owners.push_back( static_cast<SCH_PIN*>( item )->GetParentComponent() );
+            else if( item->Type() == SCH_SHEET_PIN_T )
+                owners.push_back( static_cast<SCH_SHEET_PIN*>( item )->GetParent() );
+            else
+                owners.push_back( item );
+        }
+
+        std::sort( owners.begin(), owners.end() );
+        owners.erase( std::unique( owners.begin(), owners.end() ), owners.end() );
+
+        for( SCH_ITEM* owner : owners )
+            m_item_subgraphs[ owner ].push_back( subgraph );
+
+        for( const wxString& key : aKeys[ii] )
+            m_key_to_subgraphs[ key ].insert( subgraph );
+
+        m_subgraph_owners[ subgraph ] = std::move( owners );
+        m_subgraph_keys[ subgraph ] = std::move( aKeys[ii] );
+    }
+}
+
+
+void CONNECTION_GRAPH::removeSubgraphs( const std::unordered_set<CONNECTION_SUBGRAPH*>& aSubgraphs )
+{
+    auto removed = [&]( const CONNECTION_SUBGRAPH* aSubgraph )
+                   {
+                       return aSubgraphs.count( const_cast<CONNECTION_SUBGRAPH*>( aSubgraph ) ) > 0;
+                   };
+
+    // Erases the removed subgraphs from each vector of a cache, and the emptied vectors
+    auto clean = [&]( auto& aCache )
+                 {
+                     for( auto it = aCache.begin(); it != aCache.end(); )
+                     {
+                         auto& vec = it->second;
+                         vec.erase( std::remove_if( vec.begin(), vec.end(), removed ), vec.end() );
+
+                         if( vec.empty() )
+                             it = aCache.erase( it );
+                         else
+                             ++it;
+                     }
+                 };
+
+    clean( m_sheet_to_subgraphs_map );
+    clean( m_net_name_to_subgraphs_map );
+    clean( m_local_label_cache );
+    clean( m_global_label_cache );
+    clean( m_net_code_to_subgraphs_map );
+
+    m_driver_subgraphs.erase( std::remove_if( m_driver_subgraphs.begin(),
+                                              m_driver_subgraphs.end(), removed ),
+                              m_driver_subgraphs.end() );
+
+    m_subgraphs.erase( std::remove_if( m_subgraphs.begin(), m_subgraphs.end(), removed ),
+                       m_subgraphs.end() );
+
+    // The items may be gone already: they are only compared, never dereferenced
+    std::unordered_set<SCH_ITEM*> items;
+
+    for( CONNECTION_SUBGRAPH* subgraph : aSubgraphs )
+        items.insert( subgraph->m_items.begin(), subgraph->m_items.end() );
+
+    for( SCH_ITEM* item : items )
+        m_items.erase( item );
+
+    m_invisible_power_pins.erase( std::remove_if( m_invisible_power_pins.begin(),
+                                                  m_invisible_power_pins.end(),
+                                                  [&]( const auto& aEntry )
+                                                  {
+                                                      return items.count( aEntry.second ) > 0;
+                                                  } ),
+                                  m_invisible_power_pins.end() );
+
+    for( CONNECTION_SUBGRAPH* subgraph : aSubgraphs )
+    {
+        for( const wxString& key : m_subgraph_keys.at( subgraph ) )
+        {
+            auto it = m_key_to_subgraphs.find( key );
+            it->second.erase( subgraph );
+
+            if( it->second.empty() )
+                m_key_to_subgraphs.erase( it );
+        }
+
+        for( SCH_ITEM* owner : m_subgraph_owners.at( subgraph ) )
+        {
+            auto it = m_item_subgraphs.find( owner );
+
+            if( it != m_item_subgraphs.end() )
+            {
+                auto& vec = it->second;
+                vec.erase( std::remove( vec.begin(), vec.end(), subgraph ), vec.end() );
+            }
+        }
+
+        m_subgraph_keys.erase( subgraph );
+        m_subgraph_owners.erase( subgraph );
+
+        delete subgraph;
+    }
+}
+
+
+void CONNECTION_GRAPH::merge( CONNECTION_GRAPH& aOther, std::vector<std::vector<wxString>>&& aKeys )
+{
+    m_items.insert( aOther.m_items.begin(), aOther.m_items.end() );
+
+    m_driver_subgraphs.insert( m_driver_subgraphs.end(), aOther.m_driver_subgraphs.begin(),
+                               aOther.m_driver_subgraphs.end() );
+
+    m_invisible_power_pins.insert( m_invisible_power_pins.end(),
+                                   aOther.m_invisible_power_pins.begin(),
+                                   aOther.m_invisible_power_pins.end() );
+
+    auto append = [&]( auto& aCache, const auto& aOtherCache )
+                  {
+                      for( const auto& it : aOtherCache )
+                      {
+                          auto& vec = aCache[ it.first ];
+                          vec.insert( vec.end(), it.second.begin(), it.second.end() );
+                      }
+                  };
+
+    append( m_sheet_to_subgraphs_map, aOther.m_sheet_to_subgraphs_map );
+    append( m_net_name_to_subgraphs_map, aOther.m_net_name_to_subgraphs_map );
+    append( m_local_label_cache, aOther.m_local_label_cache );
+    append( m_global_label_cache, aOther.m_global_label_cache );
+    append( m_net_code_to_subgraphs_map, aOther.m_net_code_to_subgraphs_map );
+
+    for( const auto& it : aOther.m_item_subgraphs )
+        m_item_subgraphs.emplace( it.first, std::vector<CONNECTION_SUBGRAPH*>() );
+
+    m_subgraphs.insert( m_subgraphs.end(), aOther.m_subgraphs.begin(), aOther.m_subgraphs.end() );
+    indexSubgraphs( aOther.m_subgraphs, std::move( aKeys ) );
+
+    // The subgraphs belong to this graph now
+    aOther.m_subgraphs.clear();
+}
+
+
 int CONNECTION_GRAPH::assignNewNetCode( SCH_CONNECTION& aConnection )
 {
     int code;
@@ -22,6 +22,8 @@
 #define _CONNECTION_GRAPH_H
 
 #include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <common.h>
@@ -39,6 +41,7 @@
 class SCH_EDIT_FRAME;
 class SCH_HIERLABEL;
 class SCH_PIN;
+class SCH_SCREEN;
 class SCH_SHEET_PIN;
 
 
@@ -227,6 +230,11 @@ public:
     /**
      * Updates the connection graph for the given list of sheets.
      *
+     * Unless aUnconditional is set, only the subgraphs affected by the items changed since the
+     * last update are rebuilt: the subgraphs holding these items or touching them, and every
+     * subgraph linked to those through a net name, a bus member or a hierarchical pin.  Net
+     * codes are kept for the names which already had one.
+     *
      * @param aSheetList is the list of possibly modified sheets
      * @param aUnconditional is true if an unconditional full recalculation should be done
      */
@@ -295,6 +303,21 @@ private:
 
     NET_MAP m_net_code_to_subgraphs_map;
 
+    // The sheet paths (as path and name) and their screens the graph was built for
+    std::vector<std::pair<wxString, SCH_SCREEN*>> m_sheets;
+
+    // The subgraphs holding each item given to updateItemConnectivity(), which is the owner of
+    // its pins for a component or a sheet.  The pointers may be stale, never dereference them.
+    std::unordered_map<SCH_ITEM*, std::vector<CONNECTION_SUBGRAPH*>> m_item_subgraphs;
+
+    // The owners (see above) of the items of each subgraph
+    std::unordered_map<CONNECTION_SUBGRAPH*, std::vector<SCH_ITEM*>> m_subgraph_owners;
+
+    // The names and hierarchical links through which each subgraph can affect others
+    std::unordered_map<CONNECTION_SUBGRAPH*, std::vector<wxString>> m_subgraph_keys;
+
+    std::unordered_map<wxString, std::unordered_set<CONNECTION_SUBGRAPH*>> m_key_to_subgraphs;
+
     int m_last_net_code;
 
     int m_last_bus_code;
@@ -351,6 +374,43 @@ private:
      */
     void buildConnectionGraph();
 
+    /**
+     * Rebuilds the subgraphs affected by the items changed since the last update, in a
+     * separate graph which is then merged into this one.
+     *
+     * The affected subgraphs are found from the keys computed by subgraphKeys().  When the
+     * rebuilt subgraphs end up with keys of subgraphs left out, those are added and the
+     * rebuild is done again.
+     *
+     * @return false if the whole graph must be recalculated instead, because the hierarchy or
+     *         the bus aliases changed, or because most of the graph is affected
+     */
+    bool updateIncrementally( const SCH_SHEET_LIST& aSheetList );
+
+    /**
+     * Returns the keys through which a subgraph interacts with the other ones: its net and
+     * bus member names, the names of each of its drivers, and its hierarchical pins and ports.
+     * Two subgraphs which can affect each other's connection share at least one key.
+     */
+    std::vector<wxString> subgraphKeys( CONNECTION_SUBGRAPH* aSubgraph );
+
+    /**
+     * Records the owners and keys of the given (final) subgraphs.
+     */
+    void indexSubgraphs( const std::vector<CONNECTION_SUBGRAPH*>& aSubgraphs,
+                         std::vector<std::vector<wxString>>&& aKeys );
+
+    /**
+     * Removes the given subgraphs and their items from every cache, and deletes them.
+     */
+    void removeSubgraphs( const std::unordered_set<CONNECTION_SUBGRAPH*>& aSubgraphs );
+
+    /**
+     * Moves the subgraphs and caches of aOther, which was built over items not in this graph,
+     * into this graph.
+     */
+    void merge( CONNECTION_GRAPH& aOther, std::vector<std::vector<wxString>>&& aKeys );
+
     /**
      * Helper to assign a new net code to a connection
      *
@@ -451,6 +451,9 @@ void SCH_COMPONENT::ResolveAll(
 
 void SCH_COMPONENT::UpdatePins()
 {
+    // The connection graph must forget the pins about to be deleted
+    SetConnectivityDirty();
+
     m_pins.clear();
     m_pinMap.clear();
 
@@ -652,6 +655,9 @@ void SCH_COMPONENT::SetRef( const SCH_SHEET_PATH* sheet, const wxString& ref )
 
     rf->SetText( ref );  // for drawing.
 
+    // The reference is part of the default net names of the pins
+    SetConnectivityDirty();
+
     // Reinit the m_prefix member if needed
     wxString prefix = ref;
 
@@ -720,6 +726,9 @@ void SCH_COMPONENT::SetUnitSelection( const SCH_SHEET_PATH* aSheet, int aUnitSel
 
     if( notInArray )
         AddHierarchicalReference( path, m_prefix, aUnitSelection );
+
+    // The unit decides which pins are used
+    SetConnectivityDirty();
 }
 
 
@@ -1016,6 +1025,7 @@ void SCH_COMPONENT::ClearAnnotation( SCH_SHEET_PATH* aSheetPath )
     // But this call cannot made here.
     m_Fields[REFERENCE].SetText( defRef ); //for drawing.
 
+    SetConnectivityDirty();
     SetModified();
 }
 
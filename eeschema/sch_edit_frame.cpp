@@ -599,7 +599,7 @@ void SCH_EDIT_FRAME::OnModify()
     GetScreen()->SetSave();
 
     if( ADVANCED_CFG::GetCfg().m_realTimeConnectivity && CONNECTION_GRAPH::m_allowRealTime )
-        RecalculateConnections( NO_CLEANUP );
+        RecalculateConnections( NO_CLEANUP, true );
 
     GetCanvas()->Refresh();
 }
@@ -998,7 +998,7 @@ void SCH_EDIT_FRAME::AddItemToScreenAndUndoList( SCH_ITEM* aItem, bool aUndoAppe
 
         // Update connectivity info for new item
         if( !aItem->IsMoving() )
-            RecalculateConnections( LOCAL_CLEANUP );
+            RecalculateConnections( LOCAL_CLEANUP, true );
     }
 
     aItem->ClearFlags( IS_NEW );
@@ -1068,7 +1068,7 @@ int SCH_EDIT_FRAME::GetSeverity( int aErrorCode ) const
 }
 
 
-void SCH_EDIT_FRAME::RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags )
+void SCH_EDIT_FRAME::RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags, bool aIncremental )
 {
     SCH_SHEET_LIST list( g_RootSheet );
     PROF_COUNTER   timer;
@@ -1087,7 +1087,7 @@ void SCH_EDIT_FRAME::RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags )
     timer.Stop();
     wxLogTrace( "CONN_PROFILE", "SchematicCleanUp() %0.4f ms", timer.msecs() );
 
-    g_ConnectionGraph->Recalculate( list, true );
+    g_ConnectionGraph->Recalculate( list, !aIncremental );
 }
 
 
@@ -1025,8 +1025,11 @@ public:
 
     /**
      * Generates the connection data for the entire schematic hierarchy.
+     *
+     * @param aIncremental is true to only update the connections affected by the items
+     *                     changed since the last update, for the real-time updates
      */
-    void RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags );
+    void RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags, bool aIncremental = false );
 
     /**
      * Allows Eeschema to install its preferences panels into the preferences dialog.
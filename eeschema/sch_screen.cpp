@@ -66,6 +66,7 @@
 #include <algorithm>
 #include <future>
 #include <array>
+#include <unordered_map>
 
 // TODO(JE) Debugging only
 #include <profile.h>
@@ -775,14 +776,81 @@ void SCH_SCREEN::GetHierarchicalItems( EDA_ITEMS& aItems )
 bool SCH_SCREEN::TestDanglingEnds( const SCH_SHEET_PATH* aPath )
 {
     std::vector< DANGLING_END_ITEM > endPoints;
+    std::vector< std::pair<size_t, size_t> > itemEndRanges;
     bool hasStateChanged = false;
 
     for( SCH_ITEM* item : Items() )
+    {
+        size_t first = endPoints.size();
         item->GetEndPoints( endPoints );
+        itemEndRanges.emplace_back( first, endPoints.size() );
+    }
+
+    // An item only compares its own end points with the end points at the same positions and
+    // with the wires and buses going through them, so these are all it is given.  They are
+    // handed over in their order in endPoints, which some items depend on.
+    std::unordered_map< wxPoint, std::vector<size_t> > endsByPosition;
+    RTree<size_t, int, 2, double> segments;
+
+    auto isSegmentStart = [&]( size_t aIndex )
+                          {
+                              return ( endPoints[aIndex].GetType() == WIRE_START_END
+                                       || endPoints[aIndex].GetType() == BUS_START_END )
+                                     && aIndex + 1 < endPoints.size();
+                          };
+
+    for( size_t ii = 0; ii < endPoints.size(); ++ii )
+    {
+        endsByPosition[ endPoints[ii].GetPosition() ].push_back( ii );
+
+        // Wires and buses store their start and their end one after the other
+        if( isSegmentStart( ii ) )
+        {
+            const wxPoint& start = endPoints[ii].GetPosition();
+            const wxPoint& end = endPoints[ii + 1].GetPosition();
+            const int mmin[2] = { std::min( start.x, end.x ), std::min( start.y, end.y ) };
+            const int mmax[2] = { std::max( start.x, end.x ), std::max( start.y, end.y ) };
+
+            segments.Insert( mmin, mmax, ii );
+        }
+    }
+
+    std::vector<size_t>            candidates;
+    std::vector<DANGLING_END_ITEM> nearEnds;
+    size_t                         itemIndex = 0;
 
     for( SCH_ITEM* item : Items() )
     {
-        if( item->UpdateDanglingState( endPoints, aPath ) )
+        const std::pair<size_t, size_t>& range = itemEndRanges[ itemIndex++ ];
+
+        candidates.clear();
+
+        for( size_t ii = range.first; ii < range.second; ++ii )
+        {
+            const wxPoint& pos = endPoints[ii].GetPosition();
+            const int      pt[2] = { pos.x, pos.y };
+
+            for( size_t index : endsByPosition[ pos ] )
+                candidates.push_back( index );
+
+            segments.Search( pt, pt,
+                             [&]( const size_t& aStart )
+                             {
+                                 candidates.push_back( aStart );
+                                 candidates.push_back( aStart + 1 );
+                                 return true;
+                             } );
+        }
+
+        std::sort( candidates.begin(), candidates.end() );
+        candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+
+        nearEnds.clear();
+
+        for( size_t index : candidates )
+            nearEnds.push_back( endPoints[index] );
+
+        if( item->UpdateDanglingState( nearEnds, aPath ) )
             hasStateChanged = true;
     }
 
@@ -24,6 +24,8 @@
  * @brief Schematic and symbol library s-expression file format parser implementations.
  */
 
+#include <cmath>
+
 // For some reason wxWidgets is built with wxUSE_BASE64 unset so expose the wxWidgets
 // base64 code.
 #define wxUSE_BASE64 1
@@ -360,25 +362,25 @@ LIB_ITEM* SCH_SEXPR_PARSER::ParseDrawItem()
 
 double SCH_SEXPR_PARSER::parseDouble()
 {
-    char* tmp;
-
-    errno = 0;
+    double fval = 0.0;
 
-    double fval = strtod( CurText(), &tmp );
+    // Don't use strtod(): it honours the global C locale and would require a LOCALE_IO
+    // guard, which serializes loading across threads.
+    const char* tmp = ParseDoubleNoLocale( CurText(), &fval );
 
-    if( errno )
+    if( CurText() == tmp )
     {
         wxString error;
-        error.Printf( _( "Invalid floating point number in\nfile: \"%s\"\nline: %d\noffset: %d" ),
+        error.Printf( _( "Missing floating point number in\nfile: \"%s\"\nline: %d\noffset: %d" ),
                       CurSource().c_str(), CurLineNumber(), CurOffset() );
 
         THROW_IO_ERROR( error );
     }
 
-    if( CurText() == tmp )
+    if( !std::isfinite( fval ) )
     {
         wxString error;
-        error.Printf( _( "Missing floating point number in\nfile: \"%s\"\nline: %d\noffset: %d" ),
+        error.Printf( _( "Invalid floating point number in\nfile: \"%s\"\nline: %d\noffset: %d" ),
                       CurSource().c_str(), CurLineNumber(), CurOffset() );
 
         THROW_IO_ERROR( error );
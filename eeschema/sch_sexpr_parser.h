@@ -32,6 +32,7 @@
 #define __SCH_SEXPR_PARSER_H__
 
 #include <convert_to_biu.h>                      // IU_PER_MM
+#include <kicad_string.h>                        // ParseLongNoLocale
 #include <math/util.h>                           // KiROUND, Clamp
 
 #include <class_library.h>
@@ -109,12 +110,17 @@ class SCH_SEXPR_PARSER : public SCHEMATIC_LEXER
     inline long parseHex()
     {
         NextTok();
-        return strtol( CurText(), NULL, 16 );
+
+        long val = 0;
+        ParseLongNoLocale( CurText(), &val, 16 );
+        return val;
     }
 
     inline int parseInt()
     {
-        return (int)strtol( CurText(), NULL, 10 );
+        long val = 0;
+        ParseLongNoLocale( CurText(), &val, 10 );
+        return (int) val;
     }
 
     inline int parseInt( const char* aExpected )
@@ -20,20 +20,20 @@
  */
 
 #include <wx/tokenzr.h>
-#include <wx/progdlg.h>
 
+#include <common.h>
 #include <eda_pattern_match.h>
 #include <symbol_lib_table.h>
 #include <class_libentry.h>
 #include <generate_alias_info.h>
+#include <thread_pool.h>
+#include <widgets/progress_reporter.h>
 
 #include <symbol_tree_model_adapter.h>
 
 
 bool SYMBOL_TREE_MODEL_ADAPTER::m_show_progress = true;
 
-#define PROGRESS_INTERVAL_MILLIS 66
-
 
 SYMBOL_TREE_MODEL_ADAPTER::PTR SYMBOL_TREE_MODEL_ADAPTER::Create( EDA_BASE_FRAME* aParent,
                                                                   LIB_TABLE* aLibs )
@@ -55,34 +55,80 @@ SYMBOL_TREE_MODEL_ADAPTER::~SYMBOL_TREE_MODEL_ADAPTER()
 void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNicknames,
                                               wxWindow* aParent )
 {
-    wxProgressDialog* prg = nullptr;
-    wxLongLong        nextUpdate = wxGetUTCTimeMillis() + (PROGRESS_INTERVAL_MILLIS / 2);
+    std::unique_ptr<WX_PROGRESS_REPORTER> progressReporter;
 
     if( m_show_progress )
     {
-        prg = new wxProgressDialog( _( "Loading Symbol Libraries" ), wxEmptyString,
-                                    aNicknames.size(), aParent );
+        progressReporter = std::make_unique<WX_PROGRESS_REPORTER>( aParent,
+                                                    _( "Loading Symbol Libraries" ), 1, false );
+        progressReporter->SetMaxProgress( (int) aNicknames.size() );
     }
 
-    unsigned int ii = 0;
+    bool onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
+
+    struct LOADED_LIBRARY
+    {
+        bool                   m_Found;
+        std::vector<LIB_PART*> m_Symbols;
+        wxString               m_Error;
+    };
+
+    std::vector<LOADED_LIBRARY> libraries( aNicknames.size() );
+
+    // Look the rows up, which creates their plugins, before loading them: the loaders then
+    // only read the table, and each one works with the plugin of its own row.
+    for( size_t ii = 0; ii < aNicknames.size(); ++ii )
+        libraries[ii].m_Found = m_libs->FindRow( aNicknames[ii] ) != nullptr;
+
+    {
+        // The locale is global: switch it once for all the loaders
+        LOCALE_IO  toggle;
+        TASK_GROUP loadTasks( progressReporter.get(), false );
+
+        loadTasks.ParallelFor( aNicknames.size(),
+                [&]( size_t ii )
+                {
+                    if( progressReporter )
+                    {
+                        progressReporter->Report( wxString::Format( _( "Loading library \"%s\"" ),
+                                                                    aNicknames[ii] ) );
+                    }
+
+                    try
+                    {
+                        if( libraries[ii].m_Found )
+                        {
+                            m_libs->LoadSymbolLib( libraries[ii].m_Symbols, aNicknames[ii],
+                                                   onlyPowerSymbols );
+                        }
+                    }
+                    catch( const IO_ERROR& ioe )
+                    {
+                        libraries[ii].m_Symbols.clear();
+                        libraries[ii].m_Error = ioe.What();
+                    }
+
+                    if( progressReporter )
+                        progressReporter->AdvanceProgress();
+                } );
+
+        loadTasks.Wait();
+    }
 
-    for( const auto& nickname : aNicknames )
+    // Add the libraries in the order of aNicknames, however the loaders finished
+    for( size_t ii = 0; ii < aNicknames.size(); ++ii )
     {
-        if( prg && wxGetUTCTimeMillis() > nextUpdate )
-        {
-            prg->Update( ii, wxString::Format( _( "Loading library \"%s\"" ), nickname ) );
-            nextUpdate = wxGetUTCTimeMillis() + PROGRESS_INTERVAL_MILLIS;
-        }
-
-        AddLibrary( nickname );
-        ii++;
+        if( !libraries[ii].m_Error.IsEmpty() )
+            logLoadError( aNicknames[ii], libraries[ii].m_Error );
+        else
+            addSymbols( aNicknames[ii], libraries[ii].m_Symbols );
     }
 
     m_tree.AssignIntrinsicRanks();
 
-    if( prg )
+    if( progressReporter )
     {
-        prg->Destroy();
+        progressReporter.reset();
         m_show_progress = false;
     }
 }
@@ -90,9 +136,8 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNick
 
 void SYMBOL_TREE_MODEL_ADAPTER::AddLibrary( wxString const& aLibNickname )
 {
-    bool                        onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
-    std::vector<LIB_PART*>      symbols;
-    std::vector<LIB_TREE_ITEM*> comp_list;
+    bool                   onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
+    std::vector<LIB_PART*> symbols;
 
     try
     {
@@ -100,20 +145,34 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibrary( wxString const& aLibNickname )
     }
     catch( const IO_ERROR& ioe )
     {
-        wxLogError( wxString::Format( _( "Error loading symbol library %s.\n\n%s" ),
-                                      aLibNickname,
-                                      ioe.What() ) );
+        logLoadError( aLibNickname, ioe.What() );
         return;
     }
 
-    if( symbols.size() > 0 )
+    addSymbols( aLibNickname, symbols );
+}
+
+
+void SYMBOL_TREE_MODEL_ADAPTER::addSymbols( const wxString& aLibNickname,
+                                            const std::vector<LIB_PART*>& aSymbols )
+{
+    if( aSymbols.size() > 0 )
     {
-        comp_list.assign( symbols.begin(), symbols.end() );
+        std::vector<LIB_TREE_ITEM*> comp_list( aSymbols.begin(), aSymbols.end() );
         DoAddLibrary( aLibNickname, m_libs->GetDescription( aLibNickname ), comp_list, false );
     }
 }
 
 
+void SYMBOL_TREE_MODEL_ADAPTER::logLoadError( const wxString& aLibNickname,
+                                              const wxString& aError )
+{
+    wxLogError( wxString::Format( _( "Error loading symbol library %s.\n\n%s" ),
+                                  aLibNickname,
+                                  aError ) );
+}
+
+
 wxString SYMBOL_TREE_MODEL_ADAPTER::GenerateInfo( LIB_ID const& aLibId, int aUnit )
 {
     return GenerateAliasInfo( m_libs, aLibId, aUnit );
@@ -24,6 +24,7 @@
 
 #include <lib_tree_model_adapter.h>
 
+class LIB_PART;
 class LIB_TABLE;
 class SYMBOL_LIB_TABLE;
 
@@ -44,6 +45,7 @@ public:
 
     /**
      * Add all the libraries in a SYMBOL_LIB_TABLE to the model.
+     * The libraries are loaded by the thread pool and added in the order of aNicknames.
      * Displays a progress dialog attached to the parent frame the first time it is run.
      *
      * @param aNicknames is the list of library nicknames
@@ -62,6 +64,11 @@ protected:
     SYMBOL_TREE_MODEL_ADAPTER( EDA_BASE_FRAME* aParent, LIB_TABLE* aLibs );
 
 private:
+    ///> Adds the symbols loaded from the library aLibNickname to the tree
+    void addSymbols( const wxString& aLibNickname, const std::vector<LIB_PART*>& aSymbols );
+
+    void logLoadError( const wxString& aLibNickname, const wxString& aError );
+
     /**
      * Flag to only show the symbol library table load progress dialog the first time.
      */
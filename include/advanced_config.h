@@ -78,6 +78,11 @@ public:
      */
     bool m_realTimeConnectivity;
 
+    /**
+     * Update only the affected part of the connectivity after an edit
+     */
+    bool m_incrementalConnectivity;
+
     /**
      * Set the stack size for coroutines
      */
@@ -25,6 +25,8 @@
 #ifndef BASIC_GAL_H
 #define BASIC_GAL_H
 
+#include <mutex>
+
 #include <eda_rect.h>
 
 #include <gal/stroke_font.h>
@@ -167,4 +169,8 @@ private:
 
 extern BASIC_GAL basic_gal;
 
+// basic_gal keeps the text attributes and the plotter between its calls: hold this lock
+// while using it, as several threads may plot texts at once
+extern std::recursive_mutex basic_gal_mutex;
+
 #endif      // define BASIC_GAL_H
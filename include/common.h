@@ -32,6 +32,7 @@
 #ifndef INCLUDE__COMMON_H_
 #define INCLUDE__COMMON_H_
 
+#include <map>
 #include <vector>
 #include <functional>
 
@@ -107,6 +108,19 @@ private:
 extern KIID niluuid;
 
 
+/// Required to use KIID as key type in unordered maps
+namespace std
+{
+    template <> struct hash<KIID>
+    {
+        size_t operator()( const KIID& aId ) const
+        {
+            return aId.Hash();
+        }
+    };
+}
+
+
 class KIID_PATH : public std::vector<KIID>
 {
 public:
@@ -424,8 +438,20 @@ private:
 };
 
 
+/**
+ * TimestampDir
+ * @return a hash of the last-mod-dates of all the files of aDirPath matching aFilespec.
+ */
 long long TimestampDir( const wxString& aDirPath, const wxString& aFilespec );
 
+/**
+ * TimestampDirFiles
+ * @return the last-mod-dates of the files of aDirPath matching aFilespec, by file name,
+ *         as TimestampDir() hashes them.
+ */
+std::map<wxString, long long> TimestampDirFiles( const wxString& aDirPath,
+                                                 const wxString& aFilespec );
+
 
 
 
@@ -0,0 +1,95 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DIR_WATCHER_H
+#define DIR_WATCHER_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+
+#include <wx/string.h>
+
+/**
+ * DIR_WATCHER
+ * tells which files of a directory matching a file spec were created, modified or removed
+ * since the previous call, so that a cache of the directory can refresh only those files.
+ *
+ * On Linux the kernel notifies the changes, and a directory without changes costs no file
+ * system access.  Elsewhere, on network file systems (whose remote changes are not notified)
+ * or when the notifications are not available, the watcher compares the timestamps of the
+ * files, as TimestampDirFiles() gives them, with the previous ones.  As that reads the whole
+ * directory, and stats every file in it, a polled directory is read at most once per poll
+ * interval: the changes taken in between are reported on the next poll, not lost.
+ *
+ * The watcher is thread safe, but one cache should take its changes.
+ */
+class DIR_WATCHER
+{
+public:
+    /**
+     * @param aPollInterval is the minimum time between two reads of a polled directory.
+     */
+    DIR_WATCHER( const wxString& aDirPath, const wxString& aFileSpec,
+                 std::chrono::milliseconds aPollInterval = std::chrono::seconds( 2 ) );
+
+    ~DIR_WATCHER();
+
+    DIR_WATCHER( const DIR_WATCHER& ) = delete;
+    DIR_WATCHER& operator=( const DIR_WATCHER& ) = delete;
+
+    /**
+     * Function TakeChanges
+     * adds the names of the files changed since the construction of the watcher, or the
+     * previous call, to aChanged.
+     * @return bool - false if the changes are unknown, because the notifications were lost or
+     *                the directory itself was removed or moved: the whole directory must then
+     *                be read again, with a new watcher.
+     */
+    bool TakeChanges( std::set<wxString>& aChanged );
+
+    ///> Returns true if the changes are notified, false if they are polled
+    bool IsNotified() const
+    {
+        return m_watch >= 0;
+    }
+
+private:
+    friend class INOTIFY_QUEUE;
+
+    wxString                              m_dirPath;
+    wxString                              m_fileSpec;
+
+    int                                   m_watch;      ///< the inotify watch descriptor, or
+                                                        ///< -1 if polled
+    std::set<wxString>                    m_changed;    ///< the changes notified and not taken
+    bool                                  m_lost;       ///< the notifications were lost
+
+    std::mutex                            m_pollLock;   ///< guards the polling state
+    std::map<wxString, long long>         m_timestamps; ///< the file timestamps, if polled
+    std::chrono::milliseconds             m_pollInterval;
+    std::chrono::steady_clock::time_point m_lastPoll;   ///< when m_timestamps were read
+};
+
+#endif  // DIR_WATCHER_H
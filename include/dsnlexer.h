@@ -107,6 +107,7 @@ protected:
 
     int                 curTok;                 ///< the current token obtained on last NextTok()
     std::string         curText;                ///< the text of the current token
+    std::string         curLine;                ///< nul terminated copy of the current line, for CurLine()
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
@@ -118,13 +119,14 @@ protected:
     {
         if( reader )
         {
-            reader->ReadLine();
+            unsigned len = 0;
 
-            unsigned len = reader->Length();
+            // Readers holding the whole file in memory hand out lines in place, which
+            // are not nul terminated.  Others copy into their line buffer, and start may
+            // change since ReadLine() can resize and relocate that buffer.
+            const char* line = reader->ReadLineNoCopy( &len );
 
-            // start may have changed in ReadLine(), which can resize and
-            // relocate reader's line buffer.
-            start = reader->Line();
+            start = line ? line : reader->Line();
 
             next  = start;
             limit = next + len;
@@ -144,6 +146,16 @@ protected:
      */
     int findToken( const std::string& aToken );
 
+    /**
+     * Function skipSexpression
+     * skips the rest of the current list up to and including its closing DSN_RIGHT by
+     * scanning raw bytes, without building any tokens.  This is much faster than calling
+     * NextTok() repeatedly.  Only valid in KiCad (non specctraMode) mode.
+     *
+     * @throw PARSE_ERROR if the file ends before the list is closed.
+     */
+    void skipSexpression();
+
     bool isStringTerminator( char cc )
     {
         if( !space_in_quoted_tokens && cc==' ' )
@@ -516,7 +528,9 @@ public:
      */
     const char* CurLine()
     {
-        return (const char*)(*reader);
+        // The line may not be nul terminated when the reader avoids copying it.
+        curLine.assign( start, limit );
+        return curLine.c_str();
     }
 
     /**
@@ -207,8 +207,13 @@ public:
     {
     }
 
-    virtual void WriteCacheToFile( wxTextFile* aFile ) { };
-    virtual void ReadCacheFromFile( wxTextFile* aFile ) { };
+    /**
+     * Write the index of the footprint libraries to aFilePath, or read it from there.  The
+     * libraries of the index whose contents did not change are not read again by
+     * ReadFootprintFiles().
+     */
+    virtual void WriteCacheToFile( const wxString& aFilePath ) { };
+    virtual void ReadCacheFromFile( const wxString& aFilePath ) { };
 
     /**
      * @return the number of items stored in list
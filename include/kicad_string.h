@@ -108,6 +108,32 @@ char* GetLine( FILE* aFile, char* Line, int* LineNum = NULL, int SizeLine = 255
  */
 char* StrPurge( char* text );
 
+/**
+ * Parse a decimal floating point number from \a aText without consulting the C locale.
+ *
+ * Unlike strtod(), '.' is always the decimal separator so this is safe to use from worker
+ * threads without a #LOCALE_IO guard.  Numbers whose significant digits, read as an integer,
+ * do not exceed 2^53 and whose decimal exponent is within +/-22 (nearly everything found in
+ * KiCad files) are converted exactly with no allocation.
+ *
+ * @param aText is the nul terminated text to parse.  Leading white space is skipped.
+ * @param aValue receives the parsed value.  As with strtod(), too large values become
+ *               +/-HUGE_VAL and too small ones a denormal or zero.
+ * @return a pointer to the first character after the number, or \a aText if no number
+ *         could be parsed, in which case \a aValue is left untouched.
+ */
+const char* ParseDoubleNoLocale( const char* aText, double* aValue );
+
+/**
+ * Parse an integer from \a aText in base 10 or base 16 without consulting the C locale.
+ *
+ * Out of range values saturate to LONG_MIN / LONG_MAX as strtol() does.
+ *
+ * @return a pointer to the first character after the number, or \a aText if no number
+ *         could be parsed, in which case \a aValue is left untouched.
+ */
+const char* ParseLongNoLocale( const char* aText, long* aValue, int aBase = 10 );
+
 /**
  * @return a string giving the current date and time.
  */
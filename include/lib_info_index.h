@@ -0,0 +1,107 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef LIB_INFO_INDEX_H
+#define LIB_INFO_INDEX_H
+
+#include <map>
+#include <vector>
+
+#include <wx/string.h>
+
+/**
+ * LIB_INFO_INDEX
+ * is a compact record of what the libraries of a footprint or symbol library table hold:
+ * the name, description, keywords and two counts of each item, and a content hash per
+ * library.  The choosers can list the libraries from it without enumerating them, and a
+ * library needs to be enumerated again only when its hash changes.
+ *
+ * The index file is binary, memory mapped and decoded in a single pass.  A file of another
+ * version or byte order, or a damaged one, reads as an empty index.
+ */
+class LIB_INFO_INDEX
+{
+public:
+    struct ITEM
+    {
+        wxString m_Name;
+        wxString m_Description;
+        wxString m_Keywords;
+        unsigned m_Count;           ///< the pad count of a footprint, pin count of a symbol
+        unsigned m_UniqueCount;     ///< the unique pad count of a footprint, unit count of a symbol
+    };
+
+    struct LIBRARY
+    {
+        long long         m_Hash;   ///< the content hash of the library when it was indexed
+        std::vector<ITEM> m_Items;
+    };
+
+    /**
+     * Function Read
+     * replaces the index by the one of the file aFileName.
+     * @return bool - false if the file is missing or is not a valid index, which leaves the
+     *                index empty.
+     */
+    bool Read( const wxString& aFileName );
+
+    /**
+     * Function Write
+     * writes the index to aFileName, through a temporary file so that a reader never sees
+     * a partly written index.
+     * @return bool - false if the file could not be written.
+     */
+    bool Write( const wxString& aFileName ) const;
+
+    /**
+     * Function FindLibrary
+     * @return const LIBRARY* - the library aNickname if it was indexed with the content hash
+     *                          aHash, else nullptr.
+     */
+    const LIBRARY* FindLibrary( const wxString& aNickname, long long aHash ) const;
+
+    void SetLibrary( const wxString& aNickname, LIBRARY aLibrary )
+    {
+        m_libraries[aNickname] = std::move( aLibrary );
+    }
+
+    void RemoveLibrary( const wxString& aNickname )
+    {
+        m_libraries.erase( aNickname );
+    }
+
+    const std::map<wxString, LIBRARY>& GetLibraries() const
+    {
+        return m_libraries;
+    }
+
+    void Clear()
+    {
+        m_libraries.clear();
+    }
+
+private:
+    std::map<wxString, LIBRARY> m_libraries;
+};
+
+#endif  // LIB_INFO_INDEX_H
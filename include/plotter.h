@@ -32,6 +32,7 @@
 #ifndef PLOT_COMMON_H_
 #define PLOT_COMMON_H_
 
+#include <unordered_map>
 #include <vector>
 #include <math/box2.h>
 #include <gr_text.h>
@@ -1403,18 +1404,40 @@ protected:
     // The last aperture attribute generated (only one aperture attribute can be set)
     int           m_apertureAttribute;
 
-    FILE* workFile;
-    FILE* finalFile;
-    wxString m_workFilename;
+    // The plot commands written after the aperture list: this list is known only at the
+    // end of the plot, so they are held here until EndPlot() writes the list and them
+    std::string m_body;
 
     /**
      * Generate the table of D codes
      */
     void writeApertureList();
 
+    // What an aperture is looked for with in GetOrCreateAperture()
+    struct APERTURE_KEY
+    {
+        APERTURE::APERTURE_TYPE m_Type;
+        wxSize                  m_Size;
+        int                     m_ApertureAttribute;
+
+        bool operator==( const APERTURE_KEY& aOther ) const
+        {
+            return m_Type == aOther.m_Type && m_Size == aOther.m_Size
+                   && m_ApertureAttribute == aOther.m_ApertureAttribute;
+        }
+    };
+
+    struct APERTURE_KEY_HASH
+    {
+        std::size_t operator()( const APERTURE_KEY& aKey ) const;
+    };
+
     std::vector<APERTURE> m_apertures;  // The list of available apertures
     int m_currentApertureIdx;   // The index of the current aperture in m_apertures
 
+    // The index in m_apertures of each aperture
+    std::unordered_map<APERTURE_KEY, int, APERTURE_KEY_HASH> m_apertureIndex;
+
     bool     m_gerberUnitInch;  // true if the gerber units are inches, false for mm
     int      m_gerberUnitFmt;   // number of digits in mantissa.
                                 // usually 6 in Inches and 5 or 6  in mm
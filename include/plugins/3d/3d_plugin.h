@@ -39,7 +39,7 @@
 // Note: the plugin class name must match the name expected by the loader
 #define KICAD_PLUGIN_CLASS "PLUGIN_3D"
 #define MAJOR 1
-#define MINOR 0
+#define MINOR 1
 #define REVISION 0
 #define PATCH 0
 
@@ -121,6 +121,16 @@ KICAD_PLUGIN_EXPORT char const* GetFileFilter( int aIndex );
  */
 KICAD_PLUGIN_EXPORT bool CanRender( void );
 
+/**
+ * Function IsReentrant
+ * is optional; plugins without it are only ever called one thread at a time.
+ *
+ * @return true if Load() may run on several threads at once, that is
+ * the plugin keeps no unguarded global state (e.g. it only switches the
+ * locale of the calling thread)
+ */
+KICAD_PLUGIN_EXPORT bool IsReentrant( void );
+
 /**
  * reads a model file and creates a generic display structure
  *
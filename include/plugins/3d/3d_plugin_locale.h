@@ -0,0 +1,95 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_plugin_locale.h
+ * switches the numeric locale of the thread loading a model.
+ */
+
+#ifndef PLUGIN_3D_LOCALE_H
+#define PLUGIN_3D_LOCALE_H
+
+#include <locale.h>
+#include <string>
+
+#if defined( __APPLE__ )
+#include <xlocale.h>
+#endif
+
+
+/**
+ * THREAD_C_LOCALE
+ * sets the "C" numeric locale of the calling thread while in scope, so that a model is read
+ * with '.' as the decimal separator without changing the locale of the other threads: the
+ * UI, or the models loaded at the same time by other threads.
+ */
+class THREAD_C_LOCALE
+{
+public:
+    THREAD_C_LOCALE()
+    {
+#ifdef _WIN32
+        m_perThread = _configthreadlocale( _ENABLE_PER_THREAD_LOCALE );
+        m_locale = setlocale( LC_NUMERIC, nullptr );
+        setlocale( LC_NUMERIC, "C" );
+#else
+        // newlocale() takes over the base locale on success only
+        locale_t base = duplocale( uselocale( (locale_t) 0 ) );
+
+        m_cLocale = base ? newlocale( LC_NUMERIC_MASK, "C", base ) : (locale_t) 0;
+
+        if( m_cLocale )
+            m_previous = uselocale( m_cLocale );
+        else if( base )
+            freelocale( base );
+#endif
+    }
+
+    ~THREAD_C_LOCALE()
+    {
+#ifdef _WIN32
+        setlocale( LC_NUMERIC, m_locale.c_str() );
+        _configthreadlocale( m_perThread );
+#else
+        if( m_cLocale )
+        {
+            uselocale( m_previous );
+            freelocale( m_cLocale );
+        }
+#endif
+    }
+
+    THREAD_C_LOCALE( const THREAD_C_LOCALE& ) = delete;
+    THREAD_C_LOCALE& operator=( const THREAD_C_LOCALE& ) = delete;
+
+private:
+#ifdef _WIN32
+    int         m_perThread;    // the per-thread locale setting to restore
+    std::string m_locale;       // the thread's numeric locale to restore
+#else
+    locale_t    m_cLocale;      // the thread's locale while in scope
+    locale_t    m_previous = (locale_t) 0;
+#endif
+};
+
+#endif  // PLUGIN_3D_LOCALE_H
@@ -120,6 +120,36 @@ public:
      */
     virtual char* ReadLine() = 0;
 
+    /**
+     * Function ReadLineNoCopy
+     * reads a line of text like ReadLine(), but readers holding the whole source in
+     * memory may return a pointer directly into it rather than copying the line into
+     * the line buffer.  The returned line is therefore NOT nul terminated, use
+     * @a aLength instead.  The pointer is valid until the reader is destroyed.
+     *
+     * @param aLength is set to the number of bytes in the line, including any
+     *  trailing newline.
+     * @return const char* - The beginning of the line, or NULL if EOF.
+     * @throw IO_ERROR when a line is too long.
+     */
+    virtual const char* ReadLineNoCopy( unsigned* aLength )
+    {
+        const char* line = ReadLine();
+        *aLength = m_length;
+        return line;
+    }
+
+    /**
+     * Function HoldsWholeSource
+     * @return true if the lines returned by ReadLineNoCopy() are consecutive in memory
+     *  and remain valid for the life of the reader, so a run of lines can be handed
+     *  to another parser without copying.
+     */
+    virtual bool HoldsWholeSource() const
+    {
+        return false;
+    }
+
     /**
      * Function GetSource
      * returns the name of the source of the lines in an abstract sense.
@@ -280,6 +310,87 @@ public:
     STRING_LINE_READER( const STRING_LINE_READER& aStartingPoint );
 
     char* ReadLine() override;
+
+    const char* ReadLineNoCopy( unsigned* aLength ) override;
+
+    bool HoldsWholeSource() const override
+    {
+        return true;
+    }
+};
+
+
+/**
+ * MMAP_LINE_READER
+ * is a LINE_READER that memory maps an entire file.  ReadLineNoCopy() hands out lines
+ * straight from the mapping, so a DSNLEXER can tokenize the file without copying each
+ * line.  ReadLine() still copies into the nul terminated line buffer for callers which
+ * need a C string.
+ * <p>
+ * Unlike FILE_LINE_READER, the file is read in binary mode so lines may end with "\r\n".
+ */
+class MMAP_LINE_READER : public LINE_READER
+{
+protected:
+    const char* m_data;     ///< start of the mapped file, NULL if empty.
+    size_t      m_size;     ///< size of the mapped file in bytes.
+    size_t      m_ndx;      ///< offset of the next line in the mapping.
+
+    /**
+     * Function nextLine
+     * finds the extent of the next line in the mapping and advances past it.
+     * @return the offset of the line within the mapping.
+     */
+    size_t nextLine();
+
+public:
+
+    /**
+     * Constructor MMAP_LINE_READER
+     * maps @a aFileName into memory for reading.  The mapping is released by the
+     * destructor.
+     *
+     * @param aFileName is the name of the file to map and to use for error reporting purposes.
+     * @param aStartingLineNumber is the initial line number to report on error.
+     * @param aMaxLineLength is the maximum allowed line length.
+     *
+     * @throw IO_ERROR if @a aFileName cannot be opened or mapped.
+     */
+    MMAP_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber = 0,
+            unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX );
+
+    ~MMAP_LINE_READER();
+
+    char* ReadLine() override;
+
+    const char* ReadLineNoCopy( unsigned* aLength ) override;
+
+    bool HoldsWholeSource() const override
+    {
+        return true;
+    }
+
+    /**
+     * Function Rewind
+     * goes back to the start of the file and resets the line number back to zero.
+     */
+    void Rewind()
+    {
+        m_ndx = 0;
+        m_lineNum = 0;
+    }
+
+    ///> Returns the start of the mapped file, NULL if it is empty, for the binary readers
+    const char* Data() const
+    {
+        return m_data;
+    }
+
+    size_t Size() const
+    {
+        return m_size;
+    }
 };
 
 
@@ -0,0 +1,188 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class PROGRESS_REPORTER;
+
+
+/**
+ * THREAD_POOL
+ * is the process-wide set of worker threads running the tasks of every TASK_GROUP.
+ *
+ * Each worker owns a task deque.  A task submitted by a worker goes to the back of the
+ * worker's own deque, which is also where the worker takes its next task from, while idle
+ * workers steal from the front of the other deques.  Tasks submitted by other threads are
+ * spread over the deques.  A thread waiting for a TASK_GROUP runs pending tasks rather than
+ * blocking, so nested parallel sections share the pool's threads instead of adding more.
+ */
+class THREAD_POOL
+{
+public:
+    ~THREAD_POOL();
+
+    /**
+     * Returns the pool, starting its threads on first use.
+     */
+    static THREAD_POOL& GetInstance();
+
+    /**
+     * Returns the number of worker threads.
+     */
+    size_t GetThreadCount() const { return m_workers.size(); }
+
+private:
+    friend class TASK_GROUP;
+
+    typedef std::function<void()> TASK;
+
+    struct TASK_QUEUE
+    {
+        std::mutex       m_mutex;
+        std::deque<TASK> m_tasks;
+    };
+
+    THREAD_POOL( size_t aThreadCount );
+
+    /**
+     * Queues aTask for execution by any thread of the pool.
+     */
+    void submit( TASK aTask );
+
+    /**
+     * Takes a pending task: first from the back of the calling worker's own deque, then
+     * from the front of the others.
+     * @return false if no task is pending.
+     */
+    bool takeTask( TASK& aTask );
+
+    /**
+     * Runs one pending task in the calling thread.
+     * @return false if no task was pending.
+     */
+    bool runPendingTask();
+
+    void workerLoop( size_t aIndex );
+
+    std::vector<std::unique_ptr<TASK_QUEUE>> m_queues;
+    std::vector<std::thread>                 m_workers;
+
+    std::atomic<size_t>                      m_pendingTasks;
+    std::atomic<size_t>                      m_nextQueue;    ///< for tasks from non-workers
+
+    std::mutex                               m_sleepMutex;
+    std::condition_variable                  m_wakeUp;
+    bool                                     m_stop;         ///< guarded by m_sleepMutex
+};
+
+
+/**
+ * TASK_GROUP
+ * is a set of tasks run by the THREAD_POOL which can be waited for and cancelled together.
+ *
+ * Tasks not started yet when the group is cancelled are skipped; running tasks can poll
+ * IsCancelled() to stop early.  The first exception thrown by a task cancels the group and
+ * is rethrown by Wait().
+ *
+ * When given a PROGRESS_REPORTER, Wait() must be called from the main thread: it refreshes
+ * the reporter while the tasks run, and cancels the group if the user asked to.
+ */
+class TASK_GROUP
+{
+public:
+    /**
+     * @param aReporter is refreshed by Wait(), or nullptr
+     * @param aCanCancel is false if the reporter's Cancel button must be ignored, for the
+     *                   work which cannot be left half done
+     */
+    TASK_GROUP( PROGRESS_REPORTER* aReporter = nullptr, bool aCanCancel = true );
+
+    /**
+     * Cancels the tasks not started yet and waits for the running ones.
+     */
+    ~TASK_GROUP();
+
+    TASK_GROUP( const TASK_GROUP& ) = delete;
+    TASK_GROUP& operator=( const TASK_GROUP& ) = delete;
+
+    /**
+     * Queues aTask in the pool.
+     */
+    void Run( std::function<void()> aTask );
+
+    /**
+     * Queues the calls aFunc( 0 ) to aFunc( aCount - 1 ) in the pool.  The calls are handed out
+     * in index order, aGrainSize indices at a time, to as many threads as are useful.  A single
+     * grain is run at once in the calling thread.
+     */
+    void ParallelFor( size_t aCount, std::function<void( size_t )> aFunc,
+                      size_t aGrainSize = 1 );
+
+    /**
+     * Waits until every task of the group has run or been skipped.
+     * @return false if the group was cancelled.
+     */
+    bool Wait();
+
+    /**
+     * Skips the tasks of the group which have not started yet.
+     */
+    void Cancel() { m_cancelled = true; }
+
+    bool IsCancelled() const { return m_cancelled; }
+
+private:
+    void taskDone();
+
+    THREAD_POOL&            m_pool;
+    PROGRESS_REPORTER*      m_reporter;
+    bool                    m_canCancel;
+
+    std::atomic<bool>       m_cancelled;
+    size_t                  m_pending;      ///< guarded by m_mutex
+    std::exception_ptr      m_exception;    ///< guarded by m_mutex
+
+    std::mutex              m_mutex;
+    std::condition_variable m_done;
+};
+
+
+/**
+ * Runs aFunc( 0 ) to aFunc( aCount - 1 ) in the pool and returns when they are all done,
+ * rethrowing the first exception.  This is the SHAPE_POLY_SET::PARALLEL_FOR of the code
+ * calling the libraries which cannot use the pool themselves.
+ */
+void PoolParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc );
+
+#endif  // THREAD_POOL_H
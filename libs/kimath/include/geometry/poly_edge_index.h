@@ -0,0 +1,103 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __POLY_EDGE_INDEX_H
+#define __POLY_EDGE_INDEX_H
+
+#include <cstdint>
+#include <vector>
+
+#include <geometry/seg.h>
+#include <math/box2.h>
+#include <math/vector2d.h>
+
+class SHAPE_LINE_CHAIN;
+
+/**
+ * POLY_EDGE_INDEX
+ *
+ * Indexes the edges of a contour by horizontal bands of its bounding box, so that the point
+ * and edge queries only visit the edges crossing the bands around the query instead of the
+ * whole contour.  The index keeps a copy of the edges: it does not follow the changes of
+ * the contour it was built from.
+ *
+ * The queries give the same answers as the SHAPE_LINE_CHAIN methods of the same name.
+ */
+class POLY_EDGE_INDEX
+{
+public:
+    POLY_EDGE_INDEX( const SHAPE_LINE_CHAIN& aContour );
+
+    ///> Returns the bounding box of the contour
+    const BOX2I& BBox() const
+    {
+        return m_bbox;
+    }
+
+    ///> Same as SHAPE_LINE_CHAIN::PointInside( aP, aAccuracy )
+    bool PointInside( const VECTOR2I& aP, int aAccuracy = 0 ) const;
+
+    ///> Same as SHAPE_LINE_CHAIN::PointOnEdge( aP, aAccuracy )
+    bool PointOnEdge( const VECTOR2I& aP, int aAccuracy = 0 ) const;
+
+    /**
+     * Function NearestEdge
+     * finds the edge nearest to aP, as SHAPE_POLY_SET::CollideEdge() does.
+     * @param aP is the point to test.
+     * @param aDistance [in/out] is the greatest distance of the edge to aP, replaced by the
+     *                  distance of the edge found.
+     * @return int - the index of the edge, the last one in the contour if several of them are
+     *               as near, or -1 if no edge is within aDistance.
+     */
+    int NearestEdge( const VECTOR2I& aP, int& aDistance ) const;
+
+    ///> Returns true if an edge passes strictly closer than aDistance to aP
+    bool EdgeNear( const VECTOR2I& aP, int aDistance ) const;
+
+    /**
+     * Function Collide
+     * @return bool - true if an edge crosses aSeg, touching it by an end excepted, when
+     *                aClearance is 0, or passes strictly closer than aClearance to aSeg.
+     */
+    bool Collide( const SEG& aSeg, int aClearance = 0 ) const;
+
+private:
+    ///> Returns the band of the ordinate y, clamped to the bands of the index
+    int band( int y ) const;
+
+    ///> Calls aFunc( edge index ) for the edges crossing the bands of [aMinY, aMaxY], until it
+    ///> returns true; an edge may be visited once per band
+    template <class FUNC>
+    bool visitEdges( int64_t aMinY, int64_t aMaxY, FUNC aFunc ) const;
+
+    std::vector<SEG> m_edges;
+    BOX2I            m_bbox;
+    bool             m_closed;
+    int              m_pointCount;
+
+    int              m_bandCount;
+    std::vector<int> m_bandStart;   ///< first entry of each band in m_bandEdges
+    std::vector<int> m_bandEdges;   ///< the edges crossing each band, band after band
+};
+
+#endif
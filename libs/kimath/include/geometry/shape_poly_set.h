@@ -28,6 +28,7 @@
 
 #include <cstdio>
 #include <deque>                        // for deque
+#include <functional>
 #include <iosfwd>                       // for string, stringstream
 #include <memory>
 #include <set>                          // for set
@@ -43,6 +44,8 @@
 #include <math/vector2d.h>              // for VECTOR2I
 #include <md5_hash.h>
 
+class POLY_EDGE_INDEX;
+
 
 /**
  * SHAPE_POLY_SET
@@ -240,7 +243,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             const T& Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].CPoint(
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CPoint(
                         m_currentVertex );
             }
 
@@ -363,7 +366,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             T Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].Segment( m_currentSegment );
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CSegment( m_currentSegment );
             }
 
             T operator*()
@@ -580,6 +583,7 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aIndex-th outline in the set
         SHAPE_LINE_CHAIN& Outline( int aIndex )
         {
+            invalidateCache( aIndex );
             return m_polys[aIndex][0];
         }
 
@@ -602,12 +606,14 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aHole-th hole in the aIndex-th outline
         SHAPE_LINE_CHAIN& Hole( int aOutline, int aHole )
         {
+            invalidateCache( aOutline );
             return m_polys[aOutline][aHole + 1];
         }
 
         ///> Returns the aIndex-th subpolygon in the set
         POLYGON& Polygon( int aIndex )
         {
+            invalidateCache( aIndex );
             return m_polys[aIndex];
         }
 
@@ -925,6 +931,22 @@ class SHAPE_POLY_SET : public SHAPE
         ///> For aFastMode meaning, see function booleanOp
         void Simplify( POLYGON_MODE aFastMode );
 
+        ///> Calls aFunc( 0 ) to aFunc( aCount - 1 ), possibly in parallel, and returns when
+        ///> all the calls are done
+        typedef std::function<void( size_t aCount, const std::function<void( size_t )>& aFunc )>
+                PARALLEL_FOR;
+
+        /**
+         * Function BatchUnion
+         * Same as Simplify(), for the sets of many small polygons such as the knockouts of a
+         * zone fill: the polygons are sorted along X into tiles, each tile is simplified, then
+         * the neighbour tiles are merged two by two.  The tiles, and the merges of each round,
+         * run in parallel.  Small sets are simplified in one go.
+         * @param aFastMode - see function booleanOp
+         * @param aParallelFor - runs the tiles and the merges; threads of their own if empty
+         */
+        void BatchUnion( POLYGON_MODE aFastMode, const PARALLEL_FOR& aParallelFor = nullptr );
+
         /**
          * Function NormalizeAreaOutlines
          * Convert a self-intersecting polygon to one (or more) non self-intersecting polygon(s)
@@ -1032,9 +1054,29 @@ class SHAPE_POLY_SET : public SHAPE
         /**
          * Constructs BBoxCaches for Contains(), below.  These caches MUST be built before a
          * group of calls to Contains().  They are NOT kept up-to-date by editing actions.
+         * EnableAccelerationCache() makes them useless.
          */
         void BuildBBoxCaches();
 
+        /**
+         * Function EnableAccelerationCache
+         * keeps an index of the edges of each contour, with its bounding box, for Contains(),
+         * Collide(), CollideEdge() and PointOnEdge(), and the triangulation of each polygon for
+         * CacheTriangulation().  A polygon is indexed again, or triangulated again, only if
+         * it was changed since, and IsTriangulationUpToDate() needs no checksum.
+         *
+         * The changes are the ones of the methods of the set, and of the references given by
+         * Outline(), Hole() and Polygon(): such a reference must not be kept across a query.
+         * With the cache, Collide() uses the exact clearance instead of inflated polygons.
+         * @param aEnable true to keep the cache, false to free it.
+         */
+        void EnableAccelerationCache( bool aEnable = true );
+
+        bool IsAccelerationCacheEnabled() const
+        {
+            return m_accel != nullptr;
+        }
+
         /**
          * Returns true if a given subpolygon contains the point aP
          *
@@ -1042,7 +1084,8 @@ class SHAPE_POLY_SET : public SHAPE
          * @param aSubpolyIndex is the subpolygon to check, or -1 to check all
          * @param aUseBBoxCaches gives faster performance when multiple calls are made with no
          *                       editing in between, but the caller MUST cache the bbox caches
-         *                       before calling (via BuildBBoxCaches(), above)
+         *                       before calling (via BuildBBoxCaches(), above).  Not needed
+         *                       with EnableAccelerationCache().
          * @return true if the polygon contains the point
          */
         bool Contains( const VECTOR2I& aP, int aSubpolyIndex = -1, int aAccuracy = 0,
@@ -1298,10 +1341,25 @@ class SHAPE_POLY_SET : public SHAPE
 
         MD5_HASH checksum() const;
 
+        struct ACCEL_CACHE;
+
+        ///> Marks the cached data of the aPolygon-th polygon, or of all of them for -1, as
+        ///> outdated
+        void invalidateCache( int aPolygon = -1 );
+
+        ///> Returns the edge index of each contour of the aPolygon-th polygon, indexing the
+        ///> polygons changed first.  Only with the acceleration cache.
+        const std::vector<POLY_EDGE_INDEX>& edgeIndex( int aPolygon ) const;
+
+        ///> CacheTriangulation() with the acceleration cache: the polygons changed only
+        void cacheTriangulationByPolygon();
+
         std::vector<std::unique_ptr<TRIANGULATED_POLYGON>> m_triangulatedPolys;
         bool m_triangulationValid = false;
         MD5_HASH m_hash;
 
+        std::unique_ptr<ACCEL_CACHE> m_accel;
+
 };
 
 #endif
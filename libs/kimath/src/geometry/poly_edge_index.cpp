@@ -0,0 +1,266 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include <geometry/poly_edge_index.h>
+#include <geometry/shape_line_chain.h>
+#include <math/util.h>                       // for rescale
+
+using ecoord = VECTOR2I::extended_type;
+
+
+// A few edges per band: a band is then scanned about as fast as a short contour
+static const int EDGES_PER_BAND = 4;
+static const int MAX_BANDS = 4096;
+
+
+POLY_EDGE_INDEX::POLY_EDGE_INDEX( const SHAPE_LINE_CHAIN& aContour ) :
+    m_closed( aContour.IsClosed() ),
+    m_pointCount( aContour.PointCount() )
+{
+    m_bbox.Compute( aContour.CPoints() );
+
+    int segCount = aContour.SegmentCount();
+
+    m_edges.reserve( segCount );
+
+    for( int i = 0; i < segCount; i++ )
+        m_edges.push_back( aContour.CSegment( i ) );
+
+    m_bandCount = std::min( std::max( segCount / EDGES_PER_BAND, 1 ), MAX_BANDS );
+
+    // Two passes: count the edges of each band, then store them
+    std::vector<int> bandSize( m_bandCount, 0 );
+
+    for( const SEG& edge : m_edges )
+    {
+        int last = band( std::max( edge.A.y, edge.B.y ) );
+
+        for( int b = band( std::min( edge.A.y, edge.B.y ) ); b <= last; b++ )
+            bandSize[b]++;
+    }
+
+    m_bandStart.resize( m_bandCount + 1 );
+    m_bandStart[0] = 0;
+
+    for( int b = 0; b < m_bandCount; b++ )
+        m_bandStart[b + 1] = m_bandStart[b] + bandSize[b];
+
+    m_bandEdges.resize( m_bandStart.back() );
+
+    std::vector<int> fill( m_bandStart.begin(), m_bandStart.end() - 1 );
+
+    for( int i = 0; i < (int) m_edges.size(); i++ )
+    {
+        const SEG& edge = m_edges[i];
+        int        last = band( std::max( edge.A.y, edge.B.y ) );
+
+        for( int b = band( std::min( edge.A.y, edge.B.y ) ); b <= last; b++ )
+            m_bandEdges[fill[b]++] = i;
+    }
+}
+
+
+int POLY_EDGE_INDEX::band( int y ) const
+{
+    int64_t b = ( (int64_t) y - m_bbox.GetTop() ) * m_bandCount
+                / ( (int64_t) m_bbox.GetHeight() + 1 );
+
+    return (int) std::min<int64_t>( std::max<int64_t>( b, 0 ), m_bandCount - 1 );
+}
+
+
+template <class FUNC>
+bool POLY_EDGE_INDEX::visitEdges( int64_t aMinY, int64_t aMaxY, FUNC aFunc ) const
+{
+    if( aMaxY < m_bbox.GetTop() || aMinY > m_bbox.GetBottom() )
+        return false;
+
+    int first = band( (int) std::max<int64_t>( aMinY, m_bbox.GetTop() ) );
+    int last = band( (int) std::min<int64_t>( aMaxY, m_bbox.GetBottom() ) );
+
+    for( int i = m_bandStart[first]; i < m_bandStart[last + 1]; i++ )
+    {
+        if( aFunc( m_bandEdges[i] ) )
+            return true;
+    }
+
+    return false;
+}
+
+
+/**
+ * Returns true if aP is inside aBox grown by aMargin on all sides
+ */
+static bool inGrownBox( const BOX2I& aBox, const VECTOR2I& aP, int64_t aMargin )
+{
+    return aP.x >= aBox.GetLeft() - aMargin && aP.x <= aBox.GetRight() + aMargin
+           && aP.y >= aBox.GetTop() - aMargin && aP.y <= aBox.GetBottom() + aMargin;
+}
+
+
+bool POLY_EDGE_INDEX::PointInside( const VECTOR2I& aP, int aAccuracy ) const
+{
+    if( !m_closed || m_pointCount < 3 )
+        return false;
+
+    // Outside of this box the point is neither inside nor near enough to an edge
+    if( !inGrownBox( m_bbox, aP, (int64_t) std::max( aAccuracy, 0 ) + 1 ) )
+        return false;
+
+    bool inside = false;
+
+    // Same crossing test as SHAPE_LINE_CHAIN::PointInside(), for the edges of the band of the
+    // point only: the other ones do not cross the line y = aP.y
+    if( aP.y >= m_bbox.GetTop() && aP.y <= m_bbox.GetBottom() )
+    {
+        int b = band( aP.y );
+
+        for( int i = m_bandStart[b]; i < m_bandStart[b + 1]; i++ )
+        {
+            const SEG&     edge = m_edges[m_bandEdges[i]];
+            const VECTOR2I diff = edge.B - edge.A;
+
+            if( diff.y != 0 )
+            {
+                const int d = rescale( diff.x, ( aP.y - edge.A.y ), diff.y );
+
+                if( ( ( edge.A.y > aP.y ) != ( edge.B.y > aP.y ) ) && ( aP.x - edge.A.x < d ) )
+                    inside = !inside;
+            }
+        }
+    }
+
+    if( aAccuracy == 0 )
+        return inside && !PointOnEdge( aP );
+    else if( aAccuracy == 1 )
+        return inside;
+    else
+        return inside || PointOnEdge( aP, aAccuracy - 1 );
+}
+
+
+bool POLY_EDGE_INDEX::PointOnEdge( const VECTOR2I& aP, int aAccuracy ) const
+{
+    if( m_pointCount == 0 )
+        return false;
+
+    if( m_pointCount == 1 )
+    {
+        VECTOR2I dist = m_bbox.GetOrigin() - aP;
+        return hypot( dist.x, dist.y ) <= aAccuracy + 1;
+    }
+
+    const int range = aAccuracy + 1;
+
+    if( !inGrownBox( m_bbox, aP, range ) )
+        return false;
+
+    return visitEdges( (int64_t) aP.y - range, (int64_t) aP.y + range,
+            [&]( int aEdge )
+            {
+                const SEG& edge = m_edges[aEdge];
+
+                return edge.A == aP || edge.B == aP || edge.Distance( aP ) <= range;
+            } );
+}
+
+
+int POLY_EDGE_INDEX::NearestEdge( const VECTOR2I& aP, int& aDistance ) const
+{
+    if( aDistance < 0 || !inGrownBox( m_bbox, aP, aDistance ) )
+        return -1;
+
+    // The bands visit some edges several times: keep the contour order of
+    // SHAPE_POLY_SET::CollideEdge(), which retains the last edge of the nearest ones
+    std::vector<int> candidates;
+
+    visitEdges( (int64_t) aP.y - aDistance, (int64_t) aP.y + aDistance,
+            [&]( int aEdge )
+            {
+                candidates.push_back( aEdge );
+                return false;
+            } );
+
+    std::sort( candidates.begin(), candidates.end() );
+    candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+
+    int nearest = -1;
+
+    for( int edge : candidates )
+    {
+        int distance = m_edges[edge].Distance( aP );
+
+        if( distance <= aDistance )
+        {
+            aDistance = distance;
+            nearest = edge;
+        }
+    }
+
+    return nearest;
+}
+
+
+bool POLY_EDGE_INDEX::EdgeNear( const VECTOR2I& aP, int aDistance ) const
+{
+    if( aDistance <= 0 || !inGrownBox( m_bbox, aP, aDistance ) )
+        return false;
+
+    const ecoord maxDist = (ecoord) aDistance * aDistance;
+
+    return visitEdges( (int64_t) aP.y - aDistance, (int64_t) aP.y + aDistance,
+            [&]( int aEdge )
+            {
+                return m_edges[aEdge].SquaredDistance( aP ) < maxDist;
+            } );
+}
+
+
+bool POLY_EDGE_INDEX::Collide( const SEG& aSeg, int aClearance ) const
+{
+    const int64_t margin = std::max( aClearance, 0 );
+
+    if( std::max( aSeg.A.x, aSeg.B.x ) < m_bbox.GetLeft() - margin
+            || std::min( aSeg.A.x, aSeg.B.x ) > m_bbox.GetRight() + margin )
+    {
+        return false;
+    }
+
+    const ecoord maxDist = (ecoord) aClearance * aClearance;
+
+    return visitEdges( (int64_t) std::min( aSeg.A.y, aSeg.B.y ) - margin,
+                       (int64_t) std::max( aSeg.A.y, aSeg.B.y ) + margin,
+            [&]( int aEdge )
+            {
+                const SEG& edge = m_edges[aEdge];
+
+                if( aClearance <= 0 )
+                    return (bool) edge.Intersect( aSeg, true );
+
+                return edge.SquaredDistance( aSeg ) < maxDist;
+            } );
+}
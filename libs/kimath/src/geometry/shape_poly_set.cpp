@@ -28,19 +28,24 @@
 
 #include <algorithm>
 #include <assert.h>                          // for assert
+#include <atomic>
 #include <cmath>                             // for sqrt, cos, hypot, isinf
 #include <cstdio>
+#include <exception>
 #include <istream>                           // for operator<<, operator>>
 #include <limits>                            // for numeric_limits
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>                            // for char_traits, operator!=
+#include <thread>
 #include <type_traits>                       // for swap, move
 #include <unordered_set>
 #include <vector>
 
 #include <clipper.hpp>                       // for Clipper, PolyNode, Clipp...
 #include <geometry/geometry_utils.h>
+#include <geometry/poly_edge_index.h>
 #include <geometry/polygon_triangulation.h>
 #include <geometry/seg.h>                    // for SEG, OPT_VECTOR2I
 #include <geometry/shape.h>
@@ -54,6 +59,30 @@
 
 using namespace ClipperLib;
 
+
+/**
+ * The data kept polygon by polygon once EnableAccelerationCache() is called.
+ */
+struct SHAPE_POLY_SET::ACCEL_CACHE
+{
+    ///> The edge index of each contour of each polygon, empty for the polygons changed since
+    ///> they were indexed
+    std::vector<std::vector<POLY_EDGE_INDEX>> m_index;
+
+    ///> True when every polygon is indexed.  The queries are const and may run in parallel:
+    ///> the first one to find it false indexes the polygons under m_indexMutex.
+    std::atomic<bool> m_indexValid{ false };
+    std::mutex        m_indexMutex;
+
+    ///> The polygons changed since they were triangulated
+    std::vector<bool> m_triangulationOutdated;
+
+    ///> The first triangulated polygon of each polygon, and the end of the last one, in
+    ///> m_triangulatedPolys; empty until the polygons are triangulated one by one
+    std::vector<unsigned int> m_triangulationFirst;
+};
+
+
 SHAPE_POLY_SET::SHAPE_POLY_SET() :
     SHAPE( SH_POLY_SET )
 {
@@ -72,6 +101,20 @@ SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther, bool aDeepCopy ) :
         m_hash = aOther.GetHash();
         m_triangulationValid = true;
     }
+
+    if( aOther.m_accel )
+    {
+        EnableAccelerationCache();
+
+        // Keep the triangulation of each polygon, to retriangulate only the ones changed
+        const std::vector<unsigned int>& first = aOther.m_accel->m_triangulationFirst;
+
+        if( m_triangulationValid && first.size() == m_polys.size() + 1 )
+        {
+            m_accel->m_triangulationFirst = first;
+            m_accel->m_triangulationOutdated.assign( m_polys.size(), false );
+        }
+    }
 }
 
 
@@ -143,7 +186,7 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
 
         for( unsigned int polygonIdx = 0; polygonIdx < selectedPolygon; polygonIdx++ )
         {
-            currentPolygon = Polygon( polygonIdx );
+            currentPolygon = CPolygon( polygonIdx );
 
             for( unsigned int contourIdx = 0; contourIdx < currentPolygon.size(); contourIdx++ )
             {
@@ -151,7 +194,7 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
             }
         }
 
-        currentPolygon = Polygon( selectedPolygon );
+        currentPolygon = CPolygon( selectedPolygon );
 
         for( unsigned int contourIdx = 0; contourIdx < selectedContour; contourIdx++ )
         {
@@ -177,6 +220,7 @@ int SHAPE_POLY_SET::NewOutline()
     empty_path.SetClosed( true );
     poly.push_back( empty_path );
     m_polys.push_back( poly );
+    invalidateCache( m_polys.size() - 1 );
     return m_polys.size() - 1;
 }
 
@@ -193,6 +237,7 @@ int SHAPE_POLY_SET::NewHole( int aOutline )
 
     // Add hole to the selected outline
     m_polys[aOutline].push_back( empty_path );
+    invalidateCache( aOutline );
 
     return m_polys.back().size() - 2;
 }
@@ -216,6 +261,7 @@ int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDu
     assert( idx < (int) m_polys[aOutline].size() );
 
     m_polys[aOutline][idx].Append( x, y, aAllowDuplication );
+    invalidateCache( aOutline );
 
     return m_polys[aOutline][idx].PointCount();
 }
@@ -236,7 +282,10 @@ void SHAPE_POLY_SET::InsertVertex( int aGlobalIndex, VECTOR2I aNewVertex )
     {
         // Assure the position to be inserted exists; throw an exception otherwise
         if( GetRelativeIndices( aGlobalIndex, &index ) )
+        {
             m_polys[index.m_polygon][index.m_contour].Insert( index.m_vertex, aNewVertex );
+            invalidateCache( index.m_polygon );
+        }
         else
             throw( std::out_of_range( "aGlobalIndex-th vertex does not exist" ) );
     }
@@ -276,7 +325,7 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon )
 
     for( int index = aFirstPolygon; index < aLastPolygon; index++ )
     {
-        newPolySet.m_polys.push_back( Polygon( index ) );
+        newPolySet.m_polys.push_back( CPolygon( index ) );
     }
 
     return newPolySet;
@@ -415,6 +464,7 @@ int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
     poly.push_back( aOutline );
 
     m_polys.push_back( poly );
+    invalidateCache( m_polys.size() - 1 );
 
     return m_polys.size() - 1;
 }
@@ -434,6 +484,7 @@ int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
     assert( poly.size() );
 
     poly.push_back( aHole );
+    invalidateCache( aOutline );
 
     return poly.size() - 1;
 }
@@ -627,6 +678,8 @@ void SHAPE_POLY_SET::importTree( PolyTree* tree )
             m_polys.push_back( paths );
         }
     }
+
+    invalidateCache();
 }
 
 
@@ -846,6 +899,8 @@ void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode )
     {
         fractureSingle( paths );
     }
+
+    invalidateCache();
 }
 
 
@@ -1032,6 +1087,8 @@ void SHAPE_POLY_SET::Unfracture( POLYGON_MODE aFastMode )
         unfractureSingle( path );
     }
 
+    invalidateCache();
+
     Simplify( aFastMode );    // remove overlapping holes/degeneracy
 }
 
@@ -1044,6 +1101,121 @@ void SHAPE_POLY_SET::Simplify( POLYGON_MODE aFastMode )
 }
 
 
+// Below this many polygons per tile, the merges cost more than the tiles save
+static const size_t BATCH_UNION_MIN_TILE_SIZE = 64;
+static const size_t BATCH_UNION_MAX_TILES = 64;
+
+
+/**
+ * The default PARALLEL_FOR of SHAPE_POLY_SET::BatchUnion(): the calling thread and a thread
+ * per other core take the indexes in turn.  The first exception thrown is rethrown once all
+ * the threads are done.
+ */
+static void threadParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc )
+{
+    std::atomic<size_t> next( 0 );
+    std::exception_ptr  error;
+    std::mutex          errorMutex;
+
+    auto worker = [&]()
+    {
+        for( size_t ii = next++; ii < aCount; ii = next++ )
+        {
+            try
+            {
+                aFunc( ii );
+            }
+            catch( ... )
+            {
+                std::lock_guard<std::mutex> lock( errorMutex );
+
+                if( !error )
+                    error = std::current_exception();
+            }
+        }
+    };
+
+    size_t threadCount = std::min<size_t>( std::max( std::thread::hardware_concurrency(), 1u ),
+                                           aCount );
+    std::vector<std::thread> threads;
+
+    for( size_t ii = 1; ii < threadCount; ii++ )
+        threads.emplace_back( worker );
+
+    worker();
+
+    for( std::thread& thread : threads )
+        thread.join();
+
+    if( error )
+        std::rethrow_exception( error );
+}
+
+
+void SHAPE_POLY_SET::BatchUnion( POLYGON_MODE aFastMode, const PARALLEL_FOR& aParallelFor )
+{
+    size_t tileCount = std::min( m_polys.size() / BATCH_UNION_MIN_TILE_SIZE,
+                                 BATCH_UNION_MAX_TILES );
+
+    if( tileCount < 2 )
+    {
+        Simplify( aFastMode );
+        return;
+    }
+
+    const PARALLEL_FOR& parallelFor = aParallelFor ? aParallelFor
+                                                   : PARALLEL_FOR( threadParallelFor );
+
+    // Sort the polygons by the center of their bounding box, so that the tiles are strips
+    // which only overlap their neighbours
+    std::vector<std::pair<int, size_t>> order;
+    order.reserve( m_polys.size() );
+
+    for( size_t ii = 0; ii < m_polys.size(); ii++ )
+    {
+        int x = m_polys[ii].empty() ? 0 : m_polys[ii][0].BBox().Centre().x;
+        order.emplace_back( x, ii );
+    }
+
+    std::sort( order.begin(), order.end() );
+
+    std::vector<SHAPE_POLY_SET> tiles( tileCount );
+
+    for( size_t ii = 0; ii < order.size(); ii++ )
+    {
+        SHAPE_POLY_SET& tile = tiles[ii * tileCount / order.size()];
+        tile.m_polys.push_back( std::move( m_polys[order[ii].second] ) );
+    }
+
+    parallelFor( tiles.size(),
+            [&]( size_t aTile )
+            {
+                tiles[aTile].Simplify( aFastMode );
+            } );
+
+    // Merge the neighbour tiles two by two, until one is left
+    while( tiles.size() > 1 )
+    {
+        std::vector<SHAPE_POLY_SET> merged( ( tiles.size() + 1 ) / 2 );
+
+        parallelFor( tiles.size() / 2,
+                [&]( size_t aPair )
+                {
+                    merged[aPair].booleanOp( ctUnion, tiles[2 * aPair], tiles[2 * aPair + 1],
+                                             aFastMode );
+                } );
+
+        if( tiles.size() % 2 )
+            merged.back().m_polys.swap( tiles.back().m_polys );
+
+        tiles.swap( merged );
+    }
+
+    m_polys.swap( tiles[0].m_polys );
+    invalidateCache();
+}
+
+
 int SHAPE_POLY_SET::NormalizeAreaOutlines()
 {
     // We are expecting only one main outline, but this main outline can have holes
@@ -1155,6 +1327,7 @@ bool SHAPE_POLY_SET::Parse( std::stringstream& aStream )
         }
 
         m_polys.push_back( paths );
+        invalidateCache( m_polys.size() - 1 );
     }
 
     return true;
@@ -1180,6 +1353,20 @@ const BOX2I SHAPE_POLY_SET::BBox( int aClearance ) const
 
 bool SHAPE_POLY_SET::PointOnEdge( const VECTOR2I& aP ) const
 {
+    if( m_accel )
+    {
+        for( int polygonIdx = 0; polygonIdx < OutlineCount(); polygonIdx++ )
+        {
+            for( const POLY_EDGE_INDEX& contour : edgeIndex( polygonIdx ) )
+            {
+                if( contour.PointOnEdge( aP ) )
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
     // Iterate through all the polygons in the set
     for( const POLYGON& polygon : m_polys )
     {
@@ -1197,6 +1384,24 @@ bool SHAPE_POLY_SET::PointOnEdge( const VECTOR2I& aP ) const
 
 bool SHAPE_POLY_SET::Collide( const SEG& aSeg, int aClearance ) const
 {
+    if( m_accel )
+    {
+        // The segment collides if it starts inside, or if it crosses or passes near an edge;
+        // with the exact clearance, not the inflated polygons below
+        if( Contains( aSeg.A ) )
+            return true;
+
+        for( int polygonIdx = 0; polygonIdx < OutlineCount(); polygonIdx++ )
+        {
+            for( const POLY_EDGE_INDEX& contour : edgeIndex( polygonIdx ) )
+            {
+                if( contour.Collide( aSeg, aClearance ) )
+                    return true;
+            }
+        }
+
+        return false;
+    }
 
     SHAPE_POLY_SET polySet = SHAPE_POLY_SET( *this );
 
@@ -1228,6 +1433,28 @@ bool SHAPE_POLY_SET::Collide( const SEG& aSeg, int aClearance ) const
 
 bool SHAPE_POLY_SET::Collide( const VECTOR2I& aP, int aClearance ) const
 {
+    // Without clearance there is nothing to inflate, and no need of a copy
+    if( aClearance <= 0 )
+        return Contains( aP );
+
+    if( m_accel )
+    {
+        if( Contains( aP ) )
+            return true;
+
+        // The exact clearance, not the inflated polygons below
+        for( int polygonIdx = 0; polygonIdx < OutlineCount(); polygonIdx++ )
+        {
+            for( const POLY_EDGE_INDEX& contour : edgeIndex( polygonIdx ) )
+            {
+                if( contour.EdgeNear( aP, aClearance ) )
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
     SHAPE_POLY_SET polySet = SHAPE_POLY_SET( *this );
 
     // Inflate the polygon if necessary.
@@ -1245,6 +1472,7 @@ bool SHAPE_POLY_SET::Collide( const VECTOR2I& aP, int aClearance ) const
 void SHAPE_POLY_SET::RemoveAllContours()
 {
     m_polys.clear();
+    invalidateCache();
 }
 
 
@@ -1255,6 +1483,7 @@ void SHAPE_POLY_SET::RemoveContour( int aContourIdx, int aPolygonIdx )
         aPolygonIdx += m_polys.size();
 
     m_polys[aPolygonIdx].erase( m_polys[aPolygonIdx].begin() + aContourIdx );
+    invalidateCache( aPolygonIdx );
 }
 
 
@@ -1314,12 +1543,19 @@ int SHAPE_POLY_SET::RemoveNullSegments()
 void SHAPE_POLY_SET::DeletePolygon( int aIdx )
 {
     m_polys.erase( m_polys.begin() + aIdx );
+
+    // The next polygons change of index
+    invalidateCache();
 }
 
 
 void SHAPE_POLY_SET::Append( const SHAPE_POLY_SET& aSet )
 {
     m_polys.insert( m_polys.end(), aSet.m_polys.begin(), aSet.m_polys.end() );
+
+    // The polygons new to the cache are all outdated
+    if( !m_polys.empty() )
+        invalidateCache( m_polys.size() - 1 );
 }
 
 
@@ -1373,6 +1609,31 @@ bool SHAPE_POLY_SET::CollideEdge( const VECTOR2I& aPoint,
     // Shows whether there was a collision
     bool collision = false;
 
+    if( m_accel )
+    {
+        // Same order as the iterator below: the last of the nearest edges is kept
+        for( int polygonIdx = 0; polygonIdx < OutlineCount(); polygonIdx++ )
+        {
+            const std::vector<POLY_EDGE_INDEX>& contours = edgeIndex( polygonIdx );
+
+            for( int contourIdx = 0; contourIdx < (int) contours.size(); contourIdx++ )
+            {
+                int edge = contours[contourIdx].NearestEdge( aPoint, aClearance );
+
+                if( edge >= 0 )
+                {
+                    collision = true;
+
+                    aClosestVertex.m_polygon = polygonIdx;
+                    aClosestVertex.m_contour = contourIdx;
+                    aClosestVertex.m_vertex = edge;
+                }
+            }
+        }
+
+        return collision;
+    }
+
     SEGMENT_ITERATOR iterator;
 
     for( iterator = IterateSegmentsWithHoles(); iterator; iterator++ )
@@ -1401,10 +1662,9 @@ void SHAPE_POLY_SET::BuildBBoxCaches()
 {
     for( int polygonIdx = 0; polygonIdx < OutlineCount(); polygonIdx++ )
     {
-        Outline( polygonIdx ).GenerateBBoxCache();
-
-        for( int holeIdx = 0; holeIdx < HoleCount( polygonIdx ); holeIdx++ )
-            Hole( polygonIdx, holeIdx ).GenerateBBoxCache();
+        // Not Outline() and Hole(): the caches do not change the contours
+        for( SHAPE_LINE_CHAIN& contour : m_polys[polygonIdx] )
+            contour.GenerateBBoxCache();
     }
 }
 
@@ -1445,6 +1705,7 @@ void SHAPE_POLY_SET::RemoveVertex( int aGlobalIndex )
 void SHAPE_POLY_SET::RemoveVertex( VERTEX_INDEX aIndex )
 {
     m_polys[aIndex.m_polygon][aIndex.m_contour].Remove( aIndex.m_vertex );
+    invalidateCache( aIndex.m_polygon );
 }
 
 
@@ -1462,12 +1723,29 @@ void SHAPE_POLY_SET::SetVertex( int aGlobalIndex, const VECTOR2I& aPos )
 void SHAPE_POLY_SET::SetVertex( const VERTEX_INDEX& aIndex, const VECTOR2I& aPos )
 {
     m_polys[aIndex.m_polygon][aIndex.m_contour].SetPoint( aIndex.m_vertex, aPos );
+    invalidateCache( aIndex.m_polygon );
 }
 
 
 bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int aAccuracy,
                                      bool aUseBBoxCaches ) const
 {
+    if( m_accel )
+    {
+        const std::vector<POLY_EDGE_INDEX>& contours = edgeIndex( aSubpolyIndex );
+
+        if( !contours[0].PointInside( aP, aAccuracy ) )
+            return false;
+
+        for( size_t holeIdx = 1; holeIdx < contours.size(); holeIdx++ )
+        {
+            if( contours[holeIdx].PointInside( aP, 1 ) )
+                return false;
+        }
+
+        return true;
+    }
+
     // Check that the point is inside the outline
     if( m_polys[aSubpolyIndex][0].PointInside( aP, aAccuracy ) )
     {
@@ -1496,6 +1774,8 @@ void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
         for( SHAPE_LINE_CHAIN& path : poly )
             path.Move( aVector );
     }
+
+    invalidateCache();
 }
 
 
@@ -1508,6 +1788,8 @@ void SHAPE_POLY_SET::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
             path.Mirror( aX, aY, aRef );
         }
     }
+
+    invalidateCache();
 }
 
 
@@ -1518,6 +1800,8 @@ void SHAPE_POLY_SET::Rotate( double aAngle, const VECTOR2I& aCenter )
         for( SHAPE_LINE_CHAIN& path : poly )
             path.Rotate( aAngle, aCenter );
     }
+
+    invalidateCache();
 }
 
 
@@ -1860,6 +2144,7 @@ SHAPE_POLY_SET &SHAPE_POLY_SET::operator=( const SHAPE_POLY_SET& aOther )
     m_hash = MD5_HASH{};
     m_triangulationValid = false;
     m_triangulatedPolys.clear();
+    invalidateCache();
     return *this;
 }
 
@@ -1877,6 +2162,15 @@ bool SHAPE_POLY_SET::IsTriangulationUpToDate() const
     if( !m_triangulationValid )
         return false;
 
+    // The cache knows the changes: no need to compare the checksums
+    if( m_accel )
+    {
+        const std::vector<bool>& outdated = m_accel->m_triangulationOutdated;
+
+        return m_accel->m_triangulationFirst.size() == m_polys.size() + 1
+               && std::find( outdated.begin(), outdated.end(), true ) == outdated.end();
+    }
+
     if( !m_hash.IsValid() )
         return false;
 
@@ -1886,8 +2180,49 @@ bool SHAPE_POLY_SET::IsTriangulationUpToDate() const
 }
 
 
+/**
+ * Triangulates the polygons of aSet, which is emptied, after the ones of aTriangulated.
+ * @return false if the last polygon triangulated had to be fractured again.
+ */
+static bool triangulate( SHAPE_POLY_SET& aSet,
+        std::vector<std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>>& aTriangulated )
+{
+    bool valid = true;
+
+    if( aSet.HasHoles() )
+        aSet.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    while( aSet.OutlineCount() > 0 )
+    {
+        aTriangulated.push_back( std::make_unique<SHAPE_POLY_SET::TRIANGULATED_POLYGON>() );
+        PolygonTriangulation tess( *aTriangulated.back() );
+
+        // If the tesselation fails, we re-fracture the polygon, which will
+        // first simplify the system before fracturing and removing the holes
+        // This may result in multiple, disjoint polygons.
+        if( !tess.TesselatePolygon( aSet.CPolygon( 0 ).front() ) )
+        {
+            aSet.Fracture( SHAPE_POLY_SET::PM_FAST );
+            valid = false;
+            continue;
+        }
+
+        aSet.DeletePolygon( 0 );
+        valid = true;
+    }
+
+    return valid;
+}
+
+
 void SHAPE_POLY_SET::CacheTriangulation()
 {
+    if( m_accel )
+    {
+        cacheTriangulationByPolygon();
+        return;
+    }
+
     bool recalculate = !m_hash.IsValid();
     MD5_HASH hash;
 
@@ -1910,36 +2245,137 @@ void SHAPE_POLY_SET::CacheTriangulation()
 
     SHAPE_POLY_SET tmpSet = *this;
 
-    if( tmpSet.HasHoles() )
-        tmpSet.Fracture( PM_FAST );
-
     m_triangulatedPolys.clear();
-    m_triangulationValid = true;
+    m_triangulationValid = triangulate( tmpSet, m_triangulatedPolys );
+
+    if( m_triangulationValid )
+        m_hash = checksum();
+}
+
 
-    while( tmpSet.OutlineCount() > 0 )
+void SHAPE_POLY_SET::cacheTriangulationByPolygon()
+{
+    if( IsTriangulationUpToDate() )
+        return;
+
+    ACCEL_CACHE&                                       cache = *m_accel;
+    const std::vector<unsigned int>&                   oldFirst = cache.m_triangulationFirst;
+    std::vector<std::unique_ptr<TRIANGULATED_POLYGON>> triangulated;
+    std::vector<unsigned int>                          first;
+    bool                                               valid = true;
+
+    first.reserve( m_polys.size() + 1 );
+
+    for( size_t polygonIdx = 0; polygonIdx < m_polys.size(); polygonIdx++ )
     {
-        m_triangulatedPolys.push_back( std::make_unique<TRIANGULATED_POLYGON>() );
-        PolygonTriangulation tess( *m_triangulatedPolys.back() );
+        first.push_back( triangulated.size() );
 
-        // If the tesselation fails, we re-fracture the polygon, which will
-        // first simplify the system before fracturing and removing the holes
-        // This may result in multiple, disjoint polygons.
-        if( !tess.TesselatePolygon( tmpSet.Polygon( 0 ).front() ) )
+        // Move the triangulation of the polygons unchanged
+        if( !cache.m_triangulationOutdated[polygonIdx] && polygonIdx + 1 < oldFirst.size()
+                && oldFirst[polygonIdx + 1] <= m_triangulatedPolys.size() )
         {
-            tmpSet.Fracture( PM_FAST );
-            m_triangulationValid = false;
+            for( unsigned int ii = oldFirst[polygonIdx]; ii < oldFirst[polygonIdx + 1]; ii++ )
+                triangulated.push_back( std::move( m_triangulatedPolys[ii] ) );
+
             continue;
         }
 
-        tmpSet.DeletePolygon( 0 );
-        m_triangulationValid = true;
+        // A polygon is simplified with its holes only: unlike CacheTriangulation() without
+        // the cache, overlapping polygons are not merged
+        SHAPE_POLY_SET tmpSet;
+        tmpSet.m_polys.push_back( m_polys[polygonIdx] );
+
+        if( triangulate( tmpSet, triangulated ) )
+            cache.m_triangulationOutdated[polygonIdx] = false;
+        else
+            valid = false;
     }
 
+    first.push_back( triangulated.size() );
+
+    m_triangulatedPolys = std::move( triangulated );
+    cache.m_triangulationFirst = std::move( first );
+    m_triangulationValid = valid;
+
     if( m_triangulationValid )
         m_hash = checksum();
 }
 
 
+void SHAPE_POLY_SET::EnableAccelerationCache( bool aEnable )
+{
+    if( !aEnable )
+    {
+        m_accel.reset();
+        return;
+    }
+
+    if( m_accel )
+        return;
+
+    m_accel = std::make_unique<ACCEL_CACHE>();
+    invalidateCache();
+}
+
+
+void SHAPE_POLY_SET::invalidateCache( int aPolygon )
+{
+    if( !m_accel )
+        return;
+
+    ACCEL_CACHE& cache = *m_accel;
+
+    // New polygons come outdated
+    cache.m_index.resize( m_polys.size() );
+    cache.m_triangulationOutdated.resize( m_polys.size(), true );
+    cache.m_indexValid.store( false, std::memory_order_relaxed );
+
+    if( aPolygon < 0 )
+    {
+        for( std::vector<POLY_EDGE_INDEX>& contours : cache.m_index )
+            contours.clear();
+
+        cache.m_triangulationOutdated.assign( m_polys.size(), true );
+    }
+    else if( aPolygon < (int) m_polys.size() )
+    {
+        cache.m_index[aPolygon].clear();
+        cache.m_triangulationOutdated[aPolygon] = true;
+    }
+}
+
+
+const std::vector<POLY_EDGE_INDEX>& SHAPE_POLY_SET::edgeIndex( int aPolygon ) const
+{
+    ACCEL_CACHE& cache = *m_accel;
+
+    if( !cache.m_indexValid.load( std::memory_order_acquire ) )
+    {
+        std::lock_guard<std::mutex> lock( cache.m_indexMutex );
+
+        if( !cache.m_indexValid.load( std::memory_order_relaxed ) )
+        {
+            for( size_t polygonIdx = 0; polygonIdx < m_polys.size(); polygonIdx++ )
+            {
+                std::vector<POLY_EDGE_INDEX>& contours = cache.m_index[polygonIdx];
+
+                if( !contours.empty() )
+                    continue;
+
+                contours.reserve( m_polys[polygonIdx].size() );
+
+                for( const SHAPE_LINE_CHAIN& contour : m_polys[polygonIdx] )
+                    contours.emplace_back( contour );
+            }
+
+            cache.m_indexValid.store( true, std::memory_order_release );
+        }
+    }
+
+    return cache.m_index[aPolygon];
+}
+
+
 MD5_HASH SHAPE_POLY_SET::checksum() const
 {
     MD5_HASH hash;
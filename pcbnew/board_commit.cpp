@@ -32,6 +32,7 @@
 #include <tools/pcb_tool_base.h>
 #include <tools/pcb_actions.h>
 #include <connectivity/connectivity_data.h>
+#include <drc/drc.h>
 
 #include <functional>
 using namespace std::placeholders;
@@ -92,10 +93,28 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
     std::set<EDA_ITEM*> savedModules;
     SELECTION_TOOL*     selTool = m_toolMgr->GetTool<SELECTION_TOOL>();
     bool                itemsDeselected = false;
+    std::vector<BOARD_ITEM*> drcItems;      // Items added or modified, for live DRC
+    std::set<KIID>           drcRemoved;    // Items removed, for live DRC
+    bool                     drcOutlineChanged = false;
 
     if( Empty() )
         return;
 
+    // Whether an item draws part of the board outlines, for live DRC
+    auto isOnEdgeCuts = []( const BOARD_ITEM* aItem ) -> bool
+    {
+        if( aItem->Type() != PCB_MODULE_T )
+            return aItem->IsOnLayer( Edge_Cuts );
+
+        for( const BOARD_ITEM* item : static_cast<const MODULE*>( aItem )->GraphicalItems() )
+        {
+            if( item->IsOnLayer( Edge_Cuts ) )
+                return true;
+        }
+
+        return false;
+    };
+
     for( COMMIT_LINE& ent : m_changes )
     {
         int changeType = ent.m_type & CHT_TYPE;
@@ -161,6 +180,12 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
 
                     if( !( changeFlags & CHT_DONE ) )
                         board->Add( boardItem );        // handles connectivity
+
+                    if( boardItem->Type() != PCB_MARKER_T )
+                    {
+                        drcItems.push_back( boardItem );
+                        drcOutlineChanged |= isOnEdgeCuts( boardItem );
+                    }
                 }
 
                 view->Add( boardItem );
@@ -178,6 +203,18 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                     itemsDeselected = true;
                 }
 
+                if( boardItem->Type() != PCB_MARKER_T )
+                {
+                    drcRemoved.insert( boardItem->m_Uuid );
+                    drcOutlineChanged |= isOnEdgeCuts( boardItem );
+                }
+
+                if( boardItem->Type() == PCB_MODULE_T )
+                {
+                    for( D_PAD* pad : static_cast<MODULE*>( boardItem )->Pads() )
+                        drcRemoved.insert( pad->m_Uuid );
+                }
+
                 switch( boardItem->Type() )
                 {
                 // Module items
@@ -262,6 +299,11 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
 
                 connectivity->Update( boardItem );
                 view->Update( boardItem );
+                drcItems.push_back( boardItem );
+                drcOutlineChanged |= isOnEdgeCuts( boardItem );
+
+                if( ent.m_copy )
+                    drcOutlineChanged |= isOnEdgeCuts( static_cast<BOARD_ITEM*>( ent.m_copy ) );
 
                 // if no undo entry is needed, the copy would create a memory leak
                 if( !aCreateUndoEntry )
@@ -315,6 +357,12 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
     if( !m_editModules && aCreateUndoEntry )
         frame->SaveCopyInUndoList( undoList, UR_UNSPECIFIED );
 
+    if( !m_editModules && ( !drcItems.empty() || !drcRemoved.empty() ) )
+    {
+        if( DRC* drcTool = m_toolMgr->GetTool<DRC>() )
+            drcTool->TestCommittedItems( drcItems, drcRemoved, drcOutlineChanged );
+    }
+
     m_toolMgr->PostEvent( { TC_MESSAGE, TA_MODEL_CHANGE, AS_GLOBAL } );
 
     if( itemsDeselected )
@@ -374,7 +422,12 @@ void BOARD_COMMIT::Revert()
 
             view->Remove( item );
             connectivity->Remove( item );
-            board->Remove( item );
+
+            if( item->GetParent() && item->GetParent()->Type() == PCB_MODULE_T )
+                static_cast<MODULE*>( item->GetParent() )->Remove( item );
+            else
+                board->Remove( item );
+
             break;
 
         case CHT_REMOVE:
@@ -383,7 +436,12 @@ void BOARD_COMMIT::Revert()
 
             view->Add( item );
             connectivity->Add( item );
-            board->Add( item );
+
+            if( item->GetParent() && item->GetParent()->Type() == PCB_MODULE_T )
+                static_cast<MODULE*>( item->GetParent() )->Add( item );
+            else
+                board->Add( item );
+
             break;
 
         case CHT_MODIFY:
@@ -602,6 +602,9 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
     aBoardItem->SetParent( this );
     aBoardItem->ClearEditFlags();
     m_connectivity->Add( aBoardItem );
+
+    if( aBoardItem->Type() != PCB_NETINFO_T )
+        IndexItem( aBoardItem );
 }
 
 
@@ -680,6 +683,9 @@ void BOARD::Remove( BOARD_ITEM* aBoardItem )
     }
 
     m_connectivity->Remove( aBoardItem );
+
+    if( aBoardItem->Type() != PCB_NETINFO_T )
+        UnindexItem( aBoardItem );
 }
 
 
@@ -693,7 +699,10 @@ void BOARD::DeleteMARKERs()
 {
     // the vector does not know how to delete the MARKER_PCB, it holds pointers
     for( MARKER_PCB* marker : m_markers )
+    {
+        UnindexItem( marker );
         delete marker;
+    }
 
     m_markers.clear();
 }
@@ -703,7 +712,10 @@ void BOARD::DeleteZONEOutlines()
 {
     // the vector does not know how to delete the ZONE Outlines, it holds pointers
     for( ZONE_CONTAINER* zone : m_ZoneDescriptorList )
+    {
+        UnindexItem( zone );
         delete zone;
+    }
 
     m_ZoneDescriptorList.clear();
 }
@@ -714,47 +726,58 @@ BOARD_ITEM* BOARD::GetItem( const KIID& aID )
     if( aID == niluuid )
         return nullptr;
 
-    for( TRACK* track : Tracks() )
-        if( track->m_Uuid == aID )
-            return track;
+    auto it = m_itemByUuid.find( aID );
 
-    for( MODULE* module : Modules() )
-    {
-        if( module->m_Uuid == aID )
-            return module;
+    // An item whose uuid was changed after it was indexed is no longer found by its old one
+    if( it != m_itemByUuid.end() && it->second->m_Uuid == aID )
+        return it->second;
 
-        for( D_PAD* pad : module->Pads() )
-            if( pad->m_Uuid == aID )
-                return pad;
+    // Not found; weak reference has been deleted.
+    if( !g_DeletedItem )
+        g_DeletedItem = new DELETED_BOARD_ITEM();
 
-        if( module->Reference().m_Uuid == aID )
-            return &module->Reference();
+    return g_DeletedItem;
+}
 
-        if( module->Value().m_Uuid == aID )
-            return &module->Value();
 
-        for( BOARD_ITEM* drawing : module->GraphicalItems() )
-            if( drawing->m_Uuid == aID )
-                return drawing;
+void BOARD::IndexItem( BOARD_ITEM* aItem )
+{
+    m_itemByUuid[ aItem->m_Uuid ] = aItem;
+
+    if( aItem->Type() == PCB_MODULE_T )
+    {
+        static_cast<MODULE*>( aItem )->RunOnChildren(
+                [&]( BOARD_ITEM* aChild )
+                {
+                    m_itemByUuid[ aChild->m_Uuid ] = aChild;
+                } );
     }
+}
 
-    for( ZONE_CONTAINER* zone : Zones() )
-        if( zone->m_Uuid == aID )
-            return zone;
 
-    for( BOARD_ITEM* drawing : Drawings() )
-        if( drawing->m_Uuid == aID )
-            return drawing;
+void BOARD::UnindexItem( BOARD_ITEM* aItem )
+{
+    // Copies of an item share its uuid, so only the entry of the item itself is removed
+    auto unindex = [&]( BOARD_ITEM* aIndexed )
+                   {
+                       auto it = m_itemByUuid.find( aIndexed->m_Uuid );
 
-    for( MARKER_PCB* marker : m_markers )
-        if( marker->m_Uuid == aID )
-            return marker;
+                       if( it != m_itemByUuid.end() && it->second == aIndexed )
+                           m_itemByUuid.erase( it );
+                   };
 
-    // Not found; weak reference has been deleted.
-    if( !g_DeletedItem )
-        g_DeletedItem = new DELETED_BOARD_ITEM();
+    unindex( aItem );
 
-    return g_DeletedItem;
+    if( aItem->Type() == PCB_MODULE_T )
+        static_cast<MODULE*>( aItem )->RunOnChildren( unindex );
+}
+
+
+bool BOARD::IsIndexed( const BOARD_ITEM* aItem ) const
+{
+    auto it = m_itemByUuid.find( aItem->m_Uuid );
+
+    return it != m_itemByUuid.end() && it->second == aItem;
 }
 
 
@@ -1615,6 +1638,8 @@ ZONE_CONTAINER* BOARD::InsertArea( int aNetcode, int aAreaIdx, PCB_LAYER_ID aLay
     else
         m_ZoneDescriptorList.push_back( new_area );
 
+    IndexItem( new_area );
+
     new_area->SetHatchStyle( (ZONE_HATCH_STYLE) aHatch );
 
     // Add the first corner to the new zone
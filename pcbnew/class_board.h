@@ -39,6 +39,7 @@
 #include <zone_settings.h>
 
 #include <memory>
+#include <unordered_map>
 
 using std::unique_ptr;
 
@@ -184,6 +185,9 @@ private:
     /// edge zone descriptors, owned by pointer.
     ZONE_CONTAINERS         m_ZoneDescriptorList;
 
+    /// the items returned by GetItem(), reference only
+    std::unordered_map<KIID, BOARD_ITEM*> m_itemByUuid;
+
     LAYER                   m_Layer[PCB_LAYER_ID_COUNT];
 
                                                         // if true m_highLight_NetCode is used
@@ -293,13 +297,36 @@ public:
     void DeleteAllModules()
     {
         for( MODULE* mod : m_modules )
+        {
+            UnindexItem( mod );
             delete mod;
+        }
 
         m_modules.clear();
     }
 
+    /**
+     * Function GetItem
+     * finds a board item, or an item of one of the board's modules, from its uuid.
+     * @return the item, or a DELETED_BOARD_ITEM if no item has this uuid any longer.
+     */
     BOARD_ITEM* GetItem( const KIID& aID );
 
+    /**
+     * Functions IndexItem and UnindexItem
+     * add an item to, or remove it from, the uuid index used by GetItem().  A module is
+     * indexed along with its children.  Add() and Remove() take care of this; they are only
+     * needed by code changing the item containers of the board or of its modules directly.
+     */
+    void IndexItem( BOARD_ITEM* aItem );
+    void UnindexItem( BOARD_ITEM* aItem );
+
+    /**
+     * Function IsIndexed
+     * @return true if aItem is the item GetItem() returns for its uuid.
+     */
+    bool IsIndexed( const BOARD_ITEM* aItem ) const;
+
     /**
      * Function GetConnectivity()
      * returns list of missing connections between components/tracks.
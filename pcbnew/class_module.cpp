@@ -207,6 +207,19 @@ MODULE& MODULE::operator=( const MODULE& aOther )
     *m_Value = *aOther.m_Value;
     m_Value->SetParent( this );
 
+    // The children are replaced by copies, which take over the uuid index of the board
+    if( BOARD* board = indexingBoard() )
+    {
+        for( D_PAD* pad : m_pads )
+            board->UnindexItem( pad );
+
+        for( MODULE_ZONE_CONTAINER* zone : m_fp_zones )
+            board->UnindexItem( zone );
+
+        for( BOARD_ITEM* item : m_drawings )
+            board->UnindexItem( item );
+    }
+
     // Copy auxiliary data: Pads
     m_pads.clear();
 
@@ -335,6 +348,9 @@ void MODULE::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
 
     aBoardItem->ClearEditFlags();
     aBoardItem->SetParent( this );
+
+    if( BOARD* board = indexingBoard() )
+        board->IndexItem( aBoardItem );
 }
 
 
@@ -394,6 +410,19 @@ void MODULE::Remove( BOARD_ITEM* aBoardItem )
         wxFAIL_MSG( msg );
     }
     }
+
+    if( BOARD* board = indexingBoard() )
+        board->UnindexItem( aBoardItem );
+}
+
+
+BOARD* MODULE::indexingBoard() const
+{
+    // Only a module living on its board has its children in the board's uuid index; the
+    // copies held by undo or by commits must not steal their entries.
+    BOARD* board = GetBoard();
+
+    return board && board->IsIndexed( this ) ? board : nullptr;
 }
 
 
@@ -1324,9 +1353,10 @@ BOARD_ITEM* MODULE::DuplicateItem( const BOARD_ITEM* aItem, bool aIncrementPadNu
     case PCB_PAD_T:
     {
         D_PAD* new_pad = new D_PAD( *static_cast<const D_PAD*>( aItem ) );
+        const_cast<KIID&>( new_pad->m_Uuid ) = KIID();
 
         if( aAddToModule )
-            m_pads.push_back( new_pad );
+            Add( new_pad, ADD_MODE::APPEND );
 
         if( aIncrementPadNumbers && !new_pad->IsAperturePad() )
             new_pad->IncrementPadName( true, true );
@@ -1338,9 +1368,10 @@ BOARD_ITEM* MODULE::DuplicateItem( const BOARD_ITEM* aItem, bool aIncrementPadNu
     case PCB_MODULE_ZONE_AREA_T:
     {
         new_zone = new MODULE_ZONE_CONTAINER( *static_cast<const MODULE_ZONE_CONTAINER*>( aItem ) );
+        const_cast<KIID&>( new_zone->m_Uuid ) = KIID();
 
         if( aAddToModule )
-            m_fp_zones.push_back( new_zone );
+            Add( new_zone, ADD_MODE::APPEND );
 
         new_item = new_zone;
         break;
@@ -1349,6 +1380,7 @@ BOARD_ITEM* MODULE::DuplicateItem( const BOARD_ITEM* aItem, bool aIncrementPadNu
     case PCB_MODULE_TEXT_T:
     {
         TEXTE_MODULE* new_text = new TEXTE_MODULE( *static_cast<const TEXTE_MODULE*>( aItem ) );
+        const_cast<KIID&>( new_text->m_Uuid ) = KIID();
 
         if( new_text->GetType() == TEXTE_MODULE::TEXT_is_REFERENCE )
         {
@@ -1372,6 +1404,7 @@ BOARD_ITEM* MODULE::DuplicateItem( const BOARD_ITEM* aItem, bool aIncrementPadNu
     case PCB_MODULE_EDGE_T:
     {
         EDGE_MODULE* new_edge = new EDGE_MODULE( *static_cast<const EDGE_MODULE*>(aItem) );
+        const_cast<KIID&>( new_edge->m_Uuid ) = KIID();
 
         if( aAddToModule )
             Add( new_edge );
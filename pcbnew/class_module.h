@@ -687,6 +687,11 @@ public:
 #endif
 
 private:
+    /**
+     * Returns the board whose uuid index holds this module, or nullptr.
+     */
+    BOARD* indexingBoard() const;
+
     DRAWINGS        m_drawings;         // BOARD_ITEMs for drawings on the board, owned by pointer.
     PADS            m_pads;             // D_PAD items, owned by pointer
     MODULE_ZONE_CONTAINERS m_fp_zones;  // MODULE_ZONE_CONTAINER items, owned by pointer
@@ -52,6 +52,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent, bool aInModule )
 {
     m_CornerSelection = nullptr;                // no corner is selected
     m_IsFilled = false;                         // fill status : true when the zone is filled
+    m_fillInputHash = 0;                        // fill inputs unknown
     m_FillMode = ZONE_FILL_MODE::POLYGONS;
     m_hatchStyle = ZONE_HATCH_STYLE::DIAGONAL_EDGE;
     m_hatchPitch = GetDefaultHatchPitch();
@@ -71,6 +72,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent, bool aInModule )
     m_cornerRadius = 0;
     SetLocalFlags( 0 );                         // flags tempoarry used in zone calculations
     m_Poly = new SHAPE_POLY_SET();              // Outlines
+    m_FilledPolysList.EnableAccelerationCache(); // DRC and 3D viewer test many points
     m_FilledPolysUseThickness = true;           // set the "old" way to build filled polygon areas (before 6.0.x)
     aParent->GetZoneSettings().ExportSetting( *this );
 
@@ -109,6 +111,7 @@ ZONE_CONTAINER& ZONE_CONTAINER::operator=( const ZONE_CONTAINER& aOther )
     m_FilledPolysList.Append( aOther.m_FilledPolysList );
     m_FillSegmList.clear();
     m_FillSegmList = aOther.m_FillSegmList;
+    m_fillInputHash = aOther.m_fillInputHash;
 
     m_HatchFillTypeThickness = aOther.m_HatchFillTypeThickness;
     m_HatchFillTypeGap = aOther.m_HatchFillTypeGap;
@@ -147,6 +150,7 @@ void ZONE_CONTAINER::initDataFromSrcInCopyCtor( const ZONE_CONTAINER& aZone )
     // For corner moving, corner index to drag, or nullptr if no selection
     m_CornerSelection = nullptr;
     m_IsFilled = aZone.m_IsFilled;
+    m_fillInputHash = aZone.m_fillInputHash;
     m_ZoneClearance = aZone.m_ZoneClearance;     // clearance value
     m_ZoneMinThickness = aZone.m_ZoneMinThickness;
     m_FilledPolysUseThickness = aZone.m_FilledPolysUseThickness;
@@ -156,6 +160,7 @@ void ZONE_CONTAINER::initDataFromSrcInCopyCtor( const ZONE_CONTAINER& aZone )
     m_PadConnection = aZone.m_PadConnection;
     m_ThermalReliefGap = aZone.m_ThermalReliefGap;
     m_ThermalReliefCopperBridge = aZone.m_ThermalReliefCopperBridge;
+    m_FilledPolysList.EnableAccelerationCache();
     m_FilledPolysList.Append( aZone.m_FilledPolysList );
     m_FillSegmList = aZone.m_FillSegmList;      // vector <> copy
 
@@ -201,6 +206,7 @@ bool ZONE_CONTAINER::UnFill()
     m_FilledPolysList.RemoveAllContours();
     m_FillSegmList.clear();
     m_IsFilled = false;
+    m_fillInputHash = 0;
 
     return change;
 }
@@ -1282,11 +1288,11 @@ double ZONE_CONTAINER::CalculateFilledArea()
     // each hole it has to compute the total area.
     for( int i = 0; i < m_FilledPolysList.OutlineCount(); i++ )
     {
-        m_area += m_FilledPolysList.Outline( i ).Area();
+        m_area += m_FilledPolysList.COutline( i ).Area();
 
         for( int j = 0; m_FilledPolysList.HoleCount( i ); j++ )
         {
-            m_area -= m_FilledPolysList.Hole( i, j ).Area();
+            m_area -= m_FilledPolysList.CHole( i, j ).Area();
         }
     }
 
@@ -30,6 +30,7 @@
 #define CLASS_ZONE_H_
 
 
+#include <cstdint>
 #include <vector>
 #include <gr_basic.h>
 #include <class_board_item.h>
@@ -719,6 +720,14 @@ public:
      */
     void BuildHashValue() { m_filledPolysHash = m_FilledPolysList.GetHash(); }
 
+    /**
+     * @return the hash of the fill inputs (outline, fill settings and copper items near the
+     * zone) the current filled areas were built from, or 0 if they are unknown.
+     * Used by ZONE_FILLER to skip zones whose fill is still up to date.
+     */
+    uint64_t GetFillInputHash() const { return m_fillInputHash; }
+    void SetFillInputHash( uint64_t aHash ) { m_fillInputHash = aHash; }
+
 
 
 #if defined(DEBUG)
@@ -825,6 +834,8 @@ protected:
     SHAPE_POLY_SET        m_RawPolysList;
     MD5_HASH              m_filledPolysHash;    // A hash value used in zone filling calculations
                                                 // to see if the filled areas are up to date
+    uint64_t              m_fillInputHash;      // Hash of the inputs of the last fill (0 if
+                                                // unknown), saved with the filled areas
 
     ZONE_HATCH_STYLE      m_hatchStyle;     // hatch style, see enum above
     int                   m_hatchPitch;     // for DIAGONAL_EDGE, distance between 2 hatch lines
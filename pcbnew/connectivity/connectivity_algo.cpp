@@ -26,11 +26,10 @@
 #include <widgets/progress_reporter.h>
 #include <geometry/geometry_utils.h>
 #include <board_commit.h>
+#include <thread_pool.h>
 
-#include <thread>
 #include <mutex>
 #include <algorithm>
-#include <future>
 
 #ifdef PROFILE
 #include <profile.h>
@@ -229,48 +228,22 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     if( m_itemList.IsDirty() )
     {
-        size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-                ( dirtyItems.size() + 7 ) / 8 );
+        // Half-built connectivity is of no use, so the search cannot be cancelled
+        TASK_GROUP searchTasks( m_progressReporter, false );
 
-        std::atomic<size_t> nextItem( 0 );
-        std::vector<std::future<size_t>> returns( parallelThreadCount );
-
-        auto conn_lambda = [&nextItem, &dirtyItems]
-                            ( CN_LIST* aItemList, PROGRESS_REPORTER* aReporter) -> size_t
-        {
-            for( size_t i = nextItem++; i < dirtyItems.size(); i = nextItem++ )
-            {
-                CN_VISITOR visitor( dirtyItems[i] );
-                aItemList->FindNearby( dirtyItems[i], visitor );
-
-                if( aReporter )
-                    aReporter->AdvanceProgress();
-            }
-
-            return 1;
-        };
-
-        if( parallelThreadCount <= 1 )
-            conn_lambda( &m_itemList, m_progressReporter );
-        else
-        {
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-                returns[ii] = std::async( std::launch::async, conn_lambda,
-                        &m_itemList, m_progressReporter );
-
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            {
-                // Here we balance returns with a 100ms timeout to allow UI updating
-                std::future_status status;
-                do
+        // We don't want to hand out fewer than 8 items at a time (overhead costs)
+        searchTasks.ParallelFor( dirtyItems.size(),
+                [&]( size_t i )
                 {
+                    CN_VISITOR visitor( dirtyItems[i] );
+                    m_itemList.FindNearby( dirtyItems[i], visitor );
+
                     if( m_progressReporter )
-                        m_progressReporter->KeepRefreshing();
+                        m_progressReporter->AdvanceProgress();
+                },
+                8 );
 
-                    status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-                } while( status != std::future_status::ready );
-            }
-        }
+        searchTasks.Wait();
 
         if( m_progressReporter )
             m_progressReporter->KeepRefreshing();
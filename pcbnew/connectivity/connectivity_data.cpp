@@ -27,13 +27,12 @@
 #include <profile.h>
 #endif
 
-#include <thread>
 #include <algorithm>
-#include <future>
 
 #include <connectivity/connectivity_data.h>
 #include <connectivity/connectivity_algo.h>
 #include <ratsnest_data.h>
+#include <thread_pool.h>
 
 CONNECTIVITY_DATA::CONNECTIVITY_DATA()
 {
@@ -106,32 +105,17 @@ void CONNECTIVITY_DATA::updateRatsnest()
     std::copy_if( m_nets.begin() + 1, m_nets.end(), std::back_inserter( dirty_nets ),
             [] ( RN_NET* aNet ) { return aNet->IsDirty() && aNet->GetNodeCount() > 0; } );
 
-    // We don't want to spin up a new thread for fewer than 8 nets (overhead costs)
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-            ( dirty_nets.size() + 7 ) / 8 );
+    TASK_GROUP updateTasks;
 
-    std::atomic<size_t> nextNet( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
-
-    auto update_lambda = [&nextNet, &dirty_nets]() -> size_t
-    {
-        for( size_t i = nextNet++; i < dirty_nets.size(); i = nextNet++ )
-            dirty_nets[i]->Update();
-
-        return 1;
-    };
-
-    if( parallelThreadCount == 1 )
-        update_lambda();
-    else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
+    // We don't want to hand out fewer than 8 nets at a time (overhead costs)
+    updateTasks.ParallelFor( dirty_nets.size(),
+            [&]( size_t i )
+            {
+                dirty_nets[i]->Update();
+            },
+            8 );
 
-        // Finalize the ratsnest threads
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
-    }
+    updateTasks.Wait();
 
     #ifdef PROFILE
     rnUpdate.Show();
@@ -411,6 +395,34 @@ const std::vector<BOARD_CONNECTED_ITEM*> CONNECTIVITY_DATA::GetNetItems( int aNe
 }
 
 
+const std::vector<BOARD_CONNECTED_ITEM*> CONNECTIVITY_DATA::GetItemsInArea(
+        const EDA_RECT& aArea, LSET aLayers ) const
+{
+    std::set<BOARD_CONNECTED_ITEM*> items;
+    std::vector<BOARD_CONNECTED_ITEM*> rv;
+    LSEQ copperLayers = ( aLayers & LSET::AllCuMask() ).Seq();
+
+    if( copperLayers.empty() )
+        return rv;
+
+    // A zone has an item for each filled polygon, so its parent may come more than once
+    auto visitor = [&items] ( CN_ITEM* aItem ) -> bool
+    {
+        if( aItem->Valid() )
+            items.insert( aItem->Parent() );
+
+        return true;
+    };
+
+    m_connAlgo->ItemList().FindNearby( BOX2I( aArea.GetPosition(), aArea.GetSize() ),
+                                       LAYER_RANGE( copperLayers.front(), copperLayers.back() ),
+                                       visitor );
+
+    std::copy( items.begin(), items.end(), std::back_inserter( rv ) );
+
+    return rv;
+}
+
 bool CONNECTIVITY_DATA::CheckConnectivity( std::vector<CN_DISJOINT_NET_ENTRY>& aReport )
 {
     RecalculateRatsnest();
@@ -225,6 +225,18 @@ public:
     const std::vector<BOARD_CONNECTED_ITEM*> GetNetItems( int aNetCode,
             const KICAD_T aTypes[] ) const;
 
+    /**
+     * Function GetItemsInArea()
+     * Returns the items whose bounding box intersects aArea, on a copper layer range which
+     * overlaps the range between the first and last copper layers of aLayers.  Through items
+     * span every copper layer, so the caller filters the result on the layers it needs.
+     * Copper-less pads are not part of the connectivity, and are never returned.
+     * @param aArea is the area to search.
+     * @param aLayers is the set of layers to search.
+     */
+    const std::vector<BOARD_CONNECTED_ITEM*> GetItemsInArea( const EDA_RECT& aArea,
+            LSET aLayers ) const;
+
     const std::vector<VECTOR2I> NearestUnconnectedTargets( const BOARD_CONNECTED_ITEM* aRef,
             const VECTOR2I& aPos,
             int aMaxCount = -1 );
@@ -435,6 +435,12 @@ public:
         m_index.Query( aItem->BBox(), aItem->Layers(), aFunc );
     }
 
+    template <class T>
+    void FindNearby( const BOX2I& aBounds, const LAYER_RANGE& aLayers, T aFunc )
+    {
+        m_index.Query( aBounds, aLayers, aFunc );
+    }
+
     void SetHasInvalid( bool aInvalid = true )
     {
         m_hasInvalid = aInvalid;
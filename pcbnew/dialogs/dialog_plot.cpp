@@ -813,6 +813,8 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
 
     wxBusyCursor dummy;
 
+    std::vector<PLOT_LAYER_JOB> jobs;
+
     for( LSEQ seq = m_plotOpts.GetLayerSelection().UIOrder();  seq;  ++seq )
     {
         PCB_LAYER_ID layer = *seq;
@@ -838,31 +840,29 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
         wxString fullname = fn.GetFullName();
         jobfile_writer.AddGbrFile( layer, fullname );
 
-        LOCALE_IO toggle;
-
-        PLOTTER*    plotter = StartPlotBoard( board, &m_plotOpts, layer, fn.GetFullPath(), wxEmptyString );
-
-        // Print diags in messages box:
-        wxString msg;
-
-        if( plotter )
-        {
-            PlotOneBoardLayer( board, plotter, layer, m_plotOpts );
-            plotter->EndPlot();
-            delete plotter;
-
-            msg.Printf( _( "Plot file \"%s\" created." ), fn.GetFullPath() );
-            reporter.Report( msg, RPT_SEVERITY_ACTION );
-        }
-        else
-        {
-            msg.Printf( _( "Unable to create file \"%s\"." ), fn.GetFullPath() );
-            reporter.Report( msg, RPT_SEVERITY_ERROR );
-        }
-
-        wxSafeYield();      // displays report message.
+        jobs.push_back( { layer, fn.GetFullPath(), false } );
     }
 
+    PlotBoardLayers( board, &m_plotOpts, jobs,
+            [&]( const PLOT_LAYER_JOB& aJob )
+            {
+                // Print diags in messages box:
+                wxString msg;
+
+                if( aJob.m_Created )
+                {
+                    msg.Printf( _( "Plot file \"%s\" created." ), aJob.m_FullPath );
+                    reporter.Report( msg, RPT_SEVERITY_ACTION );
+                }
+                else
+                {
+                    msg.Printf( _( "Unable to create file \"%s\"." ), aJob.m_FullPath );
+                    reporter.Report( msg, RPT_SEVERITY_ERROR );
+                }
+
+                wxSafeYield();      // displays report message.
+            } );
+
     if( m_plotOpts.GetFormat() == PLOT_FORMAT::GERBER && m_plotOpts.GetCreateGerberJobFile() )
     {
         // Pick the basename from the board file
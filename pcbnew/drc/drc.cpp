@@ -41,6 +41,7 @@
 #include <tool/tool_manager.h>
 #include <tools/pcb_actions.h>
 #include <tools/pcb_tool_base.h>
+#include <tools/selection_tool.h>
 #include <kiface_i.h>
 #include <pcbnew.h>
 #include <drc/drc.h>
@@ -48,12 +49,18 @@
 #include <math/util.h>      // for KiROUND
 
 #include <dialog_drc.h>
-#include <wx/progdlg.h>
+#include <pcbnew_settings.h>
+#include <view/view.h>
+#include <widgets/progress_reporter.h>
 #include <board_commit.h>
 #include <geometry/shape_arc.h>
 #include <drc/drc_item.h>
 #include <drc/courtyard_overlap.h>
+#include <drc/drc_rtree.h>
 #include <tools/zone_filler_tool.h>
+#include <thread_pool.h>
+
+#include <set>
 
 DRC::DRC() :
         PCB_TOOL_BASE( "pcbnew.DRCTool" ),
@@ -72,14 +79,10 @@ DRC::DRC() :
 
     m_drcRun = false;
     m_footprintsTested = false;
+    m_units = EDA_UNITS::MILLIMETRES;
 
-    m_segmAngle  = 0;
-    m_segmLength = 0;
-
-    m_xcliplo = 0;
-    m_ycliplo = 0;
-    m_xcliphi = 0;
-    m_ycliphi = 0;
+    m_liveCacheValid = false;
+    m_livePadClearance = 0;
 }
 
 
@@ -103,6 +106,7 @@ void DRC::Reset( RESET_REASON aReason )
             DestroyDRCDialog( wxID_OK );
 
         m_pcb = m_pcbEditorFrame->GetBoard();
+        m_liveCacheValid = false;
     }
 }
 
@@ -323,6 +327,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
     // be sure m_pcb is the current board, not a old one
     // ( the board can be reloaded )
     m_pcb = m_pcbEditorFrame->GetBoard();
+    m_liveCacheValid = false;
 
     if( aMessages )
     {
@@ -733,51 +738,563 @@ void DRC::testDrilledHoles()
 
 void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
 {
-    wxProgressDialog * progressDialog = NULL;
-    const int delta = 500;  // This is the number of tests between 2 calls to the
-                            // progress bar
-    int count = m_pcb->Tracks().size();
+    std::unique_ptr<WX_PROGRESS_REPORTER> reporter;
+
+    // Only bother the user with a progress bar if there are many tracks
+    if( aShowProgressBar && m_pcb->Tracks().size() > 2000 )
+        reporter = std::make_unique<WX_PROGRESS_REPORTER>( aActiveWindow,
+                                                           _( "Track clearances" ), 1 );
+
+    std::vector<MARKER_PCB*> markers;
+
+    runTrackDrc( true, reporter.get(), markers );
+
+    for( MARKER_PCB* marker : markers )
+        addMarkerToPcb( marker );
+}
+
+
+void DRC::buildTrackDrcIndex( TRACK_DRC_INDEX& aIndex )
+{
+    // Index the items by the area they cover on each copper layer.  The worst-case
+    // clearance of any item is then enough to find everything a track could violate.
+    for( TRACK* track : m_pcb->Tracks() )
+    {
+        aIndex.m_worstClearance = std::max( aIndex.m_worstClearance, track->GetClearance() );
+        aIndex.m_tracks.Insert( track, track->GetBoundingBox(), track->GetLayerSet() );
+    }
+
+    for( MODULE* mod : m_pcb->Modules() )
+    {
+        for( D_PAD* pad : mod->Pads() )
+        {
+            EDA_RECT bbox = pad->GetBoundingBox();
+            LSET     layers = pad->GetLayerSet();
+
+            // A pad's hole is tested against tracks on every layer
+            if( pad->GetDrillSize().x > 0 )
+            {
+                wxSize  drill = pad->GetDrillSize();
+                int     radius = std::max( drill.x, drill.y ) / 2;
+
+                bbox.Merge( EDA_RECT( pad->GetPosition(), wxSize( 0, 0 ) ).Inflate( radius ) );
+                layers = LSET::AllCuMask();
+            }
+
+            aIndex.m_worstClearance = std::max( aIndex.m_worstClearance, pad->GetClearance() );
+            aIndex.m_pads.Insert( pad, bbox, layers );
+        }
+    }
+
+    if( !m_doZonesTest )
+        return;
+
+    for( ZONE_CONTAINER* zone : m_pcb->Zones() )
+    {
+        if( zone->GetFilledPolysList().IsEmpty() || zone->GetIsKeepout() )
+            continue;
+
+        BOX2I bbox = zone->GetFilledPolysList().BBox();
+
+        aIndex.m_worstClearance = std::max( aIndex.m_worstClearance, zone->GetClearance() );
+        aIndex.m_zones.Insert( zone, EDA_RECT( (wxPoint) bbox.GetPosition(),
+                                               wxSize( bbox.GetWidth(), bbox.GetHeight() ) ),
+                               zone->GetLayerSet() );
+    }
+}
+
+
+bool DRC::runTrackDrc( bool aUseIndex, PROGRESS_REPORTER* aReporter,
+                       std::vector<MARKER_PCB*>& aMarkers )
+{
+    TRACK_DRC_INDEX index;
+
+    buildTrackDrcIndex( index );
+
+    const std::vector<TRACK*>& tracks = index.m_tracks.Items();
+
+    if( aReporter )
+    {
+        aReporter->Report( _( "Testing track clearances..." ) );
+        aReporter->SetMaxProgress( tracks.size() );
+    }
+
+    // Each track gets its own list of markers, so the result does not depend on which
+    // thread tested which track
+    std::vector<std::vector<MARKER_PCB*>> trackMarkers( tracks.size() );
+    bool                                  cancelled = false;
+
+    auto testTrack = [&]( size_t i )
+    {
+        TRACK*              refSeg = tracks[i];
+        std::vector<TRACK*> candidateTracks;
+
+        if( aUseIndex )
+        {
+            std::vector<D_PAD*>          candidatePads;
+            std::vector<ZONE_CONTAINER*> candidateZones;
+            EDA_RECT                     area = refSeg->GetBoundingBox();
+
+            area.Inflate( index.m_worstClearance + 1 );
+
+            // Each pair of tracks is only tested once, from the first of the two
+            index.m_tracks.Query( area, refSeg->GetLayerSet(), candidateTracks, (int) i + 1 );
+            index.m_pads.Query( area, refSeg->GetLayerSet(), candidatePads );
+            index.m_zones.Query( area, refSeg->GetLayerSet(), candidateZones );
+
+            doTrackDrc( refSeg, candidateTracks, candidatePads, candidateZones, trackMarkers[i] );
+        }
+        else
+        {
+            candidateTracks.assign( tracks.begin() + i + 1, tracks.end() );
+
+            doTrackDrc( refSeg, candidateTracks, index.m_pads.Items(), index.m_zones.Items(),
+                        trackMarkers[i] );
+        }
+
+        if( aReporter )
+            aReporter->AdvanceProgress();
+    };
+
+    if( aUseIndex )
+    {
+        // Wait() refreshes the reporter, and cancels the tests if the user asks to
+        TASK_GROUP drcTasks( aReporter );
+
+        drcTasks.ParallelFor( tracks.size(), testTrack );
+        cancelled = !drcTasks.Wait();
+    }
+    else
+    {
+        for( size_t i = 0; i < tracks.size(); ++i )
+            testTrack( i );
+    }
+
+    for( std::vector<MARKER_PCB*>& markers : trackMarkers )
+        aMarkers.insert( aMarkers.end(), markers.begin(), markers.end() );
+
+    return !cancelled;
+}
+
+
+/**
+ * @return the area covered by the copper and the hole of aPad
+ */
+static EDA_RECT padDrcBBox( const D_PAD* aPad )
+{
+    EDA_RECT bbox = aPad->GetBoundingBox();
+
+    if( aPad->GetDrillSize().x > 0 )
+    {
+        wxSize drill = aPad->GetDrillSize();
+        int    radius = std::max( drill.x, drill.y ) / 2;
+
+        bbox.Merge( EDA_RECT( aPad->GetPosition(), wxSize( 0, 0 ) ).Inflate( radius ) );
+    }
+
+    return bbox;
+}
+
+
+/**
+ * @return true if the connectivity index covers aPad for the track DRC.  It leaves out the
+ * pads without copper, indexes the SMD, connector and NPTH pads on their first copper layer
+ * only, and indexes every pad by the bounding box of its copper, without its hole.
+ */
+static bool isPadInConnectivity( const D_PAD* aPad )
+{
+    if( !aPad->IsOnCopperLayer() )
+        return false;
+
+    if( aPad->GetAttribute() != PAD_ATTRIB_STANDARD
+            && ( aPad->GetDrillSize().x > 0
+                 || ( aPad->GetLayerSet() & LSET::AllCuMask() ).count() > 1 ) )
+    {
+        return false;
+    }
+
+    return aPad->GetBoundingBox().Contains( padDrcBBox( aPad ) );
+}
+
+
+void DRC::buildLiveCache()
+{
+    m_livePadClearance = 0;
+    m_liveExtraPads.clear();
+
+    for( MODULE* mod : m_pcb->Modules() )
+    {
+        for( D_PAD* pad : mod->Pads() )
+            updateLiveCache( pad );
+    }
+
+    m_board_outlines.RemoveAllContours();
+    m_pcb->GetBoardPolygonOutlines( m_board_outlines );
+
+    m_liveCacheValid = true;
+}
+
+
+void DRC::updateLiveCache( D_PAD* aPad )
+{
+    m_livePadClearance = std::max( m_livePadClearance, aPad->GetClearance() );
+
+    if( isPadInConnectivity( aPad ) )
+        m_liveExtraPads.erase( aPad->m_Uuid );
+    else
+        m_liveExtraPads.insert( aPad->m_Uuid );
+}
+
+
+void DRC::TestCommittedItems( const std::vector<BOARD_ITEM*>& aItems,
+                              const std::set<KIID>& aRemoved, bool aOutlineChanged )
+{
+    if( !m_pcbEditorFrame || !m_pcbEditorFrame->GetSettings()->m_DrcDialog.live_drc )
+        return;
+
+    if( m_pcb != m_pcbEditorFrame->GetBoard() )
+    {
+        m_pcb = m_pcbEditorFrame->GetBoard();
+        m_liveCacheValid = false;
+    }
+
+    if( !m_liveCacheValid )
+    {
+        buildLiveCache();
+    }
+    else if( aOutlineChanged )
+    {
+        m_board_outlines.RemoveAllContours();
+        m_pcb->GetBoardPolygonOutlines( m_board_outlines );
+    }
+
+    for( BOARD_ITEM* item : aItems )
+    {
+        if( item->Type() == PCB_MODULE_T )
+        {
+            for( D_PAD* pad : static_cast<MODULE*>( item )->Pads() )
+                updateLiveCache( pad );
+        }
+        else if( item->Type() == PCB_PAD_T )
+        {
+            updateLiveCache( static_cast<D_PAD*>( item ) );
+        }
+    }
+
+    // The pads the connectivity index misses, without the removed ones
+    std::vector<D_PAD*> extraPads;
+
+    for( auto it = m_liveExtraPads.begin(); it != m_liveExtraPads.end(); )
+    {
+        BOARD_ITEM* item = m_pcb->GetItem( *it );
+
+        if( item->Type() == PCB_PAD_T )
+        {
+            extraPads.push_back( static_cast<D_PAD*>( item ) );
+            ++it;
+        }
+        else
+        {
+            it = m_liveExtraPads.erase( it );
+        }
+    }
 
-    int deltamax = count/delta;
+    // Tracks take their clearance from their netclass; pads and zones may have their own
+    int worstClearance = std::max( m_pcb->GetDesignSettings().GetBiggestClearanceValue(),
+                                   m_livePadClearance );
 
-    if( aShowProgressBar && deltamax > 3 )
+    if( m_doZonesTest )
     {
-        // Do not use wxPD_APP_MODAL style here: it is not necessary and create issues
-        // on OSX
-        progressDialog = new wxProgressDialog( _( "Track clearances" ), wxEmptyString,
-                                               deltamax, aActiveWindow,
-                                               wxPD_AUTO_HIDE | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME );
-        progressDialog->Update( 0, wxEmptyString );
+        for( ZONE_CONTAINER* zone : m_pcb->Zones() )
+            worstClearance = std::max( worstClearance, zone->GetClearance() );
     }
 
-    int ii = 0;
-    count = 0;
+    std::shared_ptr<CONNECTIVITY_DATA> connectivity = m_pcb->GetConnectivity();
 
-    for( auto seg_it = m_pcb->Tracks().begin(); seg_it != m_pcb->Tracks().end(); seg_it++ )
+    auto byId = []( const BOARD_ITEM* aLeft, const BOARD_ITEM* aRight )
     {
-        if( ii++ > delta )
+        return aLeft->m_Uuid < aRight->m_Uuid;
+    };
+
+    // Collect the tracks, pads and zones tracks on aLayers near aBBox are tested against,
+    // sorted by id so that the markers do not depend on the order of the connectivity index
+    auto collect = [&]( const EDA_RECT& aBBox, LSET aLayers, std::vector<TRACK*>& aTracks,
+                        std::vector<D_PAD*>& aPads, std::vector<ZONE_CONTAINER*>& aZones )
+    {
+        EDA_RECT area = aBBox;
+        area.Inflate( worstClearance + 1 );
+
+        aTracks.clear();
+        aPads.clear();
+        aZones.clear();
+
+        for( BOARD_CONNECTED_ITEM* item : connectivity->GetItemsInArea( area, aLayers ) )
         {
-            ii = 0;
-            count++;
+            switch( item->Type() )
+            {
+            case PCB_TRACE_T:
+            case PCB_ARC_T:
+            case PCB_VIA_T:
+                if( ( item->GetLayerSet() & aLayers ).any() )
+                    aTracks.push_back( static_cast<TRACK*>( item ) );
+
+                break;
 
-            if( progressDialog )
+            case PCB_PAD_T:
+                // A pad's hole is tested against tracks on every layer
+                if( static_cast<D_PAD*>( item )->GetDrillSize().x > 0
+                        || ( item->GetLayerSet() & aLayers ).any() )
+                {
+                    aPads.push_back( static_cast<D_PAD*>( item ) );
+                }
+
+                break;
+
+            case PCB_ZONE_AREA_T:
             {
-                if( !progressDialog->Update( count, wxEmptyString ) )
-                    break;  // Aborted by user
-#ifdef __WXMAC__
-                // Work around a dialog z-order issue on OS X
-                if( count == deltamax )
-                    aActiveWindow->Raise();
-#endif
+                ZONE_CONTAINER* zone = static_cast<ZONE_CONTAINER*>( item );
+
+                if( m_doZonesTest && !zone->GetIsKeepout()
+                        && ( zone->GetLayerSet() & aLayers ).any() )
+                {
+                    aZones.push_back( zone );
+                }
+
+                break;
+            }
+
+            default:
+                break;
+            }
+        }
+
+        for( D_PAD* pad : extraPads )
+        {
+            if( ( pad->GetDrillSize().x > 0 || ( pad->GetLayerSet() & aLayers ).any() )
+                    && padDrcBBox( pad ).Intersects( area ) )
+            {
+                aPads.push_back( pad );
+            }
+        }
+
+        std::sort( aTracks.begin(), aTracks.end(), byId );
+        std::sort( aPads.begin(), aPads.end(), byId );
+        aPads.erase( std::unique( aPads.begin(), aPads.end() ), aPads.end() );
+        std::sort( aZones.begin(), aZones.end(), byId );
+    };
+
+    std::set<TRACK*>             retest;
+    std::set<KIID>               touched = aRemoved;
+    std::vector<TRACK*>          candidateTracks;
+    std::vector<D_PAD*>          candidatePads;
+    std::vector<ZONE_CONTAINER*> candidateZones;
+
+    auto addNeighbours = [&]( const EDA_RECT& aBBox, LSET aLayers )
+    {
+        collect( aBBox, aLayers, candidateTracks, candidatePads, candidateZones );
+        retest.insert( candidateTracks.begin(), candidateTracks.end() );
+    };
+
+    // Retest the changed tracks, and the tracks near anything that changed.  Markers against
+    // the old positions of the changed pads and zones are replaced too.
+    for( BOARD_ITEM* item : aItems )
+    {
+        switch( item->Type() )
+        {
+        case PCB_TRACE_T:
+        case PCB_ARC_T:
+        case PCB_VIA_T:
+            if( m_pcb->IsIndexed( item ) )
+            {
+                retest.insert( static_cast<TRACK*>( item ) );
+                addNeighbours( item->GetBoundingBox(), item->GetLayerSet() );
+            }
+
+            break;
+
+        case PCB_PAD_T:
+        {
+            D_PAD* pad = static_cast<D_PAD*>( item );
+
+            addNeighbours( padDrcBBox( pad ),
+                           pad->GetDrillSize().x > 0 ? LSET::AllCuMask() : pad->GetLayerSet() );
+            touched.insert( pad->m_Uuid );
+            break;
+        }
+
+        case PCB_MODULE_T:
+            for( D_PAD* pad : static_cast<MODULE*>( item )->Pads() )
+            {
+                addNeighbours( padDrcBBox( pad ),
+                               pad->GetDrillSize().x > 0 ? LSET::AllCuMask() : pad->GetLayerSet() );
+                touched.insert( pad->m_Uuid );
+            }
+
+            break;
+
+        case PCB_ZONE_AREA_T:
+        {
+            ZONE_CONTAINER* zone = static_cast<ZONE_CONTAINER*>( item );
+
+            if( !m_doZonesTest || zone->GetIsKeepout() )
+                break;
+
+            if( !zone->GetFilledPolysList().IsEmpty() )
+            {
+                BOX2I bbox = zone->GetFilledPolysList().BBox();
+
+                addNeighbours( EDA_RECT( (wxPoint) bbox.GetPosition(),
+                                         wxSize( bbox.GetWidth(), bbox.GetHeight() ) ),
+                               zone->GetLayerSet() );
             }
+
+            touched.insert( zone->m_Uuid );
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    if( retest.empty() && touched.empty() )
+        return;
+
+    for( TRACK* track : retest )
+        touched.insert( track->m_Uuid );
+
+    // Remove the markers the retest replaces: track markers involving a retested item,
+    // and any marker left pointing at a deleted item
+    KIGFX::VIEW*             view = getView();
+    std::vector<MARKER_PCB*> stale;
+
+    for( MARKER_PCB* marker : m_pcb->Markers() )
+    {
+        const RC_ITEM* rcItem = marker->GetRCItem();
+        bool mainTouched = touched.count( rcItem->GetMainItemID() ) > 0;
+        bool auxTouched = touched.count( rcItem->GetAuxItemID() ) > 0;
+
+        if( aRemoved.count( rcItem->GetMainItemID() ) || aRemoved.count( rcItem->GetAuxItemID() ) )
+            stale.push_back( marker );
+        else if( ( mainTouched || auxTouched ) && isTrackDrcCode( rcItem->GetErrorCode() ) )
+            stale.push_back( marker );
+    }
+
+    // The stale markers are deleted as a commit deletes its removed items: out of the
+    // selection first, so that the selection tool keeps no pointer to them
+    SELECTION_TOOL* selTool = m_toolMgr->GetTool<SELECTION_TOOL>();
+    bool            markersDeselected = false;
+
+    for( MARKER_PCB* marker : stale )
+    {
+        if( marker->IsSelected() )
+        {
+            selTool->RemoveItemFromSel( marker, true /* quiet mode */ );
+            markersDeselected = true;
+        }
+
+        view->Remove( marker );
+        m_pcb->Delete( marker );
+    }
+
+    if( markersDeselected )
+        m_toolMgr->PostEvent( EVENTS::UnselectedEvent );
+
+    // Test each retested track against its neighbours, in id order.  A pair of retested
+    // tracks is only tested from the first of the two, as in a full run.
+    std::vector<TRACK*> sortedRetest( retest.begin(), retest.end() );
+
+    std::sort( sortedRetest.begin(), sortedRetest.end(), byId );
+
+    for( TRACK* refSeg : sortedRetest )
+    {
+        std::vector<MARKER_PCB*> markers;
+
+        collect( refSeg->GetBoundingBox(), refSeg->GetLayerSet(), candidateTracks,
+                 candidatePads, candidateZones );
+
+        candidateTracks.erase( std::remove_if( candidateTracks.begin(), candidateTracks.end(),
+                                               [&]( TRACK* aTrack )
+                                               {
+                                                   return aTrack == refSeg
+                                                          || ( retest.count( aTrack )
+                                                               && byId( aTrack, refSeg ) );
+                                               } ),
+                               candidateTracks.end() );
+
+        doTrackDrc( refSeg, candidateTracks, candidatePads, candidateZones, markers );
+
+        for( MARKER_PCB* marker : markers )
+        {
+            m_pcb->Add( marker );
+            view->Add( marker );
         }
+    }
+
+    m_pcbEditorFrame->ResolveDRCExclusions();
+
+    if( m_drcDialog )
+        m_drcDialog->SetMarkersProvider( new BOARD_DRC_ITEMS_PROVIDER( m_pcb ) );
+}
+
+
+bool DRC::isTrackDrcCode( int aErrorCode )
+{
+    switch( aErrorCode )
+    {
+    case DRCE_TRACK_NEAR_THROUGH_HOLE:
+    case DRCE_TRACK_NEAR_PAD:
+    case DRCE_TRACK_NEAR_VIA:
+    case DRCE_VIA_NEAR_VIA:
+    case DRCE_VIA_NEAR_TRACK:
+    case DRCE_TRACK_ENDS:
+    case DRCE_TRACK_SEGMENTS_TOO_CLOSE:
+    case DRCE_TRACKS_CROSSING:
+    case DRCE_VIA_HOLE_BIGGER:
+    case DRCE_MICRO_VIA_INCORRECT_LAYER_PAIR:
+    case DRCE_TOO_SMALL_TRACK_WIDTH:
+    case DRCE_TOO_SMALL_VIA:
+    case DRCE_TOO_SMALL_MICROVIA:
+    case DRCE_TOO_SMALL_VIA_DRILL:
+    case DRCE_TOO_SMALL_MICROVIA_DRILL:
+    case DRCE_MICRO_VIA_NOT_ALLOWED:
+    case DRCE_BURIED_VIA_NOT_ALLOWED:
+    case DRCE_TRACK_NEAR_ZONE:
+    case DRCE_TRACK_NEAR_EDGE:
+        return true;
 
-        // Test new segment against tracks and pads, optionally against copper zones
-        doTrackDrc( *seg_it, seg_it + 1, m_pcb->Tracks().end(), m_doZonesTest );
+    default:
+        return false;
     }
+}
+
+
+int DRC::ToggleLiveDRC( const TOOL_EVENT& aEvent )
+{
+    PCBNEW_SETTINGS* settings = m_pcbEditorFrame->GetSettings();
+
+    settings->m_DrcDialog.live_drc = !settings->m_DrcDialog.live_drc;
+    return 0;
+}
+
+
+void DRC::TestTrackClearances( BOARD* aBoard, EDA_UNITS aUnits, bool aUseIndex,
+                               const DRC_PROVIDER::MARKER_HANDLER& aHandler )
+{
+    m_pcb = aBoard;
+    m_units = aUnits;
+    m_doZonesTest = true;
+    m_liveCacheValid = false;
+
+    m_board_outlines.RemoveAllContours();
+    m_pcb->GetBoardPolygonOutlines( m_board_outlines );
+
+    std::vector<MARKER_PCB*> markers;
+
+    runTrackDrc( aUseIndex, nullptr, markers );
 
-    if( progressDialog )
-        progressDialog->Destroy();
+    for( MARKER_PCB* marker : markers )
+        aHandler( marker );
 }
 
 
@@ -1436,6 +1953,7 @@ void DRC::TestFootprints( NETLIST& aNetlist, BOARD* aPCB, EDA_UNITS aUnits,
 void DRC::setTransitions()
 {
     Go( &DRC::ShowDRCDialog,              PCB_ACTIONS::runDRC.MakeEvent() );
+    Go( &DRC::ToggleLiveDRC,              PCB_ACTIONS::toggleLiveDRC.MakeEvent() );
 }
 
 
@@ -30,7 +30,10 @@
 #include <class_marker_pcb.h>
 #include <geometry/seg.h>
 #include <geometry/shape_poly_set.h>
+#include <drc/drc_provider.h>
+#include <drc/drc_rtree.h>
 #include <memory>
+#include <set>
 #include <vector>
 #include <tools/pcb_tool_base.h>
 
@@ -119,6 +122,7 @@ class NETCLASS;
 class EDA_TEXT;
 class DRAWSEGMENT;
 class NETLIST;
+class PROGRESS_REPORTER;
 class wxWindow;
 class wxString;
 class wxTextCtrl;
@@ -154,28 +158,70 @@ private:
     bool     m_reportAllTrackErrors;    // Report all tracks errors (or only 4 first errors)
     bool     m_testFootprints;          // Test footprints against schematic
 
-    /* In DRC functions, many calculations are using coordinates relative
-     * to the position of the segment under test (segm to segm DRC, segm to pad DRC
-     * Next variables store coordinates relative to the start point of this segment
-     */
-    wxPoint  m_padToTestPos;            // Position of the pad for segm-to-pad and pad-to-pad
-    wxPoint  m_segmEnd;                 // End point of the reference segment (start = (0, 0) )
-
-    /* Some functions are comparing the ref segm to pads or others segments using
-     * coordinates relative to the ref segment considered as the X axis
-     * so we store the ref segment length (the end point relative to these axis)
-     * and the segment orientation (used to rotate other coordinates)
-     */
-    double   m_segmAngle;               // Ref segm orientation in 0.1 degree
-    int      m_segmLength;              // length of the reference segment
-
-    /* variables used in checkLine to test DRC segm to segm:
-     * define the area relative to the ref segment that does not contains any other segment
+    /**
+     * In DRC functions, many calculations are using coordinates relative to the position of
+     * the segment under test (segm to segm DRC, segm to pad DRC).  SEGM_FRAME stores these
+     * coordinates and the helpers using them, so several segments can be tested at once.
      */
-    int      m_xcliplo;
-    int      m_ycliplo;
-    int      m_xcliphi;
-    int      m_ycliphi;
+    struct SEGM_FRAME
+    {
+        SEGM_FRAME() :
+                m_segmAngle( 0 ),
+                m_segmLength( 0 ),
+                m_xcliplo( 0 ),
+                m_ycliplo( 0 ),
+                m_xcliphi( 0 ),
+                m_ycliphi( 0 )
+        {
+        }
+
+        /* Next variables store coordinates relative to the start point of the segment
+         */
+        wxPoint  m_padToTestPos;        // Position of the pad for segm-to-pad and pad-to-pad
+        wxPoint  m_segmEnd;             // End point of the reference segment (start = (0, 0) )
+
+        /* Some functions are comparing the ref segm to pads or others segments using
+         * coordinates relative to the ref segment considered as the X axis
+         * so we store the ref segment length (the end point relative to these axis)
+         * and the segment orientation (used to rotate other coordinates)
+         */
+        double   m_segmAngle;           // Ref segm orientation in 0.1 degree
+        int      m_segmLength;          // length of the reference segment
+
+        /* variables used in checkLine to test DRC segm to segm:
+         * define the area relative to the ref segment that does not contains any other segment
+         */
+        int      m_xcliplo;
+        int      m_ycliplo;
+        int      m_xcliphi;
+        int      m_ycliphi;
+
+        /**
+         * Check the distance from a pad to segment.  This function uses several
+         * frame variables not passed in:
+         *      m_segmLength = length of the segment being tested
+         *      m_segmAngle  = angle of the segment with the X axis;
+         *      m_segmEnd    = end coordinate of the segment
+         *      m_padToTestPos = position of pad relative to the origin of segment
+         * @param aPad Is the pad involved in the check
+         * @param aSegmentWidth width of the segment to test
+         * @param aMinDist Is the minimum clearance needed
+         *
+         * @return true distance >= dist_min,
+         *         false if distance < dist_min
+         */
+        bool checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMinDist );
+
+        /**
+         * Function checkLine
+         * (helper function used in drc calculations to see if one track is in contact with
+         *  another track).
+         * Test if a line intersects a bounding box (a rectangle)
+         * The rectangle is defined by m_xcliplo, m_ycliplo and m_xcliphi, m_ycliphi
+         * return true if the line from aSegStart to aSegEnd is outside the bounding box
+         */
+        bool checkLine( wxPoint aSegStart, wxPoint aSegEnd );
+    };
 
     PCB_EDIT_FRAME*        m_pcbEditorFrame;   // The pcb frame editor which owns the board
     BOARD*                 m_pcb;
@@ -186,6 +232,12 @@ private:
     std::vector<DRC_ITEM*> m_footprints;       // list of footprint warnings
     bool                   m_drcRun;
     bool                   m_footprintsTested;
+    EDA_UNITS              m_units;            // units used without an editor frame
+
+    // The live DRC state of m_pcb, kept between commits, see TestCommittedItems()
+    bool                   m_liveCacheValid;
+    int                    m_livePadClearance; // largest clearance of any pad
+    std::set<KIID>         m_liveExtraPads;    // pads the connectivity index does not cover
 
     ///> Sets up handlers for various events.
     void setTransitions() override;
@@ -195,7 +247,10 @@ private:
      */
     void updatePointers();
 
-    EDA_UNITS userUnits() const { return m_pcbEditorFrame->GetUserUnits(); }
+    EDA_UNITS userUnits() const
+    {
+        return m_pcbEditorFrame ? m_pcbEditorFrame->GetUserUnits() : m_units;
+    }
 
     /**
      * Adds a DRC marker to the PCB through the COMMIT mechanism.
@@ -231,6 +286,59 @@ private:
      */
     void testTracks( wxWindow * aActiveWindow, bool aShowProgressBar );
 
+    /// Spatial indexes of the items tracks are tested against, see buildTrackDrcIndex().
+    struct TRACK_DRC_INDEX
+    {
+        TRACK_DRC_INDEX() :
+                m_worstClearance( 0 )
+        {
+        }
+
+        DRC_RTREE<TRACK*>          m_tracks;
+        DRC_RTREE<D_PAD*>          m_pads;
+        DRC_RTREE<ZONE_CONTAINER*> m_zones;           // empty unless m_doZonesTest is set
+        int                        m_worstClearance;  // largest clearance of any indexed item
+    };
+
+    /**
+     * Index the board's tracks, pads (including their holes) and, if m_doZonesTest is set,
+     * copper zone fills in per-layer R-trees, in board order.
+     */
+    void buildTrackDrcIndex( TRACK_DRC_INDEX& aIndex );
+
+    /**
+     * @return true if aErrorCode is one of the errors reported by doTrackDrc()
+     */
+    static bool isTrackDrcCode( int aErrorCode );
+
+    /**
+     * Build the live DRC state of the board: its outlines, the largest pad clearance, and the
+     * pads whose hole or copper layers the connectivity index misses.
+     */
+    void buildLiveCache();
+
+    /**
+     * Update the live DRC state with an added or modified pad.
+     */
+    void updateLiveCache( D_PAD* aPad );
+
+    /**
+     * Test every track and via against its neighbours, spreading the tracks across the
+     * THREAD_POOL.
+     *
+     * Tracks, pads and copper zones are indexed in per-layer R-trees and each track is only
+     * tested against the items within the worst-case clearance of it.  The markers are
+     * returned in the same order as a serial sweep over the board would produce them.
+     *
+     * @param aUseIndex false to test every track against every other item on one thread,
+     *                  as a reference for the indexed tests
+     * @param aReporter an optional progress reporter, which can cancel the tests
+     * @param aMarkers receives the created markers, owned by the caller
+     * @return false if the tests were cancelled
+     */
+    bool runTrackDrc( bool aUseIndex, PROGRESS_REPORTER* aReporter,
+                      std::vector<MARKER_PCB*>& aMarkers );
+
     void testPad2Pad();
 
     void testDrilledHoles();
@@ -281,14 +389,14 @@ private:
      * Test the current segment.
      *
      * @param aRefSeg The segment to test
-     * @param aStartIt the iterator to the first track to test
-     * @param aEndIt the marker for the iterator end
-     * @param aTestZones true if should do copper zones test. This can be very time consumming
-     * @return bool - true if no problems, else false and m_currentMarker is
-     *          filled in with the problem information.
+     * @param aTracks the tracks to test aRefSeg against
+     * @param aPads the pads to test aRefSeg against
+     * @param aZones the copper zones to test aRefSeg against (can be very time consumming)
+     * @param aMarkers receives a marker for each problem found
      */
-    void doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterator aEndIt,
-                     bool aTestZones );
+    void doTrackDrc( TRACK* aRefSeg, const std::vector<TRACK*>& aTracks,
+                     const std::vector<D_PAD*>& aPads, const std::vector<ZONE_CONTAINER*>& aZones,
+                     std::vector<MARKER_PCB*>& aMarkers );
 
     /**
      * Test for footprint courtyard overlaps.
@@ -305,23 +413,6 @@ private:
     bool checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad );
 
 
-    /**
-     * Check the distance from a pad to segment.  This function uses several
-     * instance variable not passed in:
-     *      m_segmLength = length of the segment being tested
-     *      m_segmAngle  = angle of the segment with the X axis;
-     *      m_segmEnd    = end coordinate of the segment
-     *      m_padToTestPos = position of pad relative to the origin of segment
-     * @param aPad Is the pad involved in the check
-     * @param aSegmentWidth width of the segment to test
-     * @param aMinDist Is the minimum clearance needed
-     *
-     * @return true distance >= dist_min,
-     *         false if distance < dist_min
-     */
-    bool checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMinDist );
-
-
     /**
      * Check the distance from a point to a segment.
      *
@@ -337,16 +428,6 @@ private:
     static bool checkMarginToCircle( wxPoint aCentre, int aRadius, int aLength );
 
 
-    /**
-     * Function checkLine
-     * (helper function used in drc calculations to see if one track is in contact with
-     *  another track).
-     * Test if a line intersects a bounding box (a rectangle)
-     * The rectangle is defined by m_xcliplo, m_ycliplo and m_xcliphi, m_ycliphi
-     * return true if the line from aSegStart to aSegEnd is outside the bounding box
-     */
-    bool checkLine( wxPoint aSegStart, wxPoint aSegEnd );
-
     //-----</single tests>---------------------------------------------
 
 public:
@@ -398,6 +479,38 @@ public:
      */
     void DestroyDRCDialog( int aReason );
 
+    /**
+     * Keep the track clearance markers up to date after an edit, when live DRC is enabled.
+     *
+     * The changed tracks and vias, and the tracks near any changed track, pad, footprint or
+     * zone fill, are retested against their neighbours, found through the connectivity index
+     * which the commit has already updated.  Their old track markers, and any marker
+     * referring to a removed item, are replaced.  Called by BOARD_COMMIT::Push().
+     *
+     * @param aItems the items added or modified by the commit
+     * @param aRemoved the ids of the items removed by the commit
+     * @param aOutlineChanged true if the commit changed an item on Edge_Cuts
+     */
+    void TestCommittedItems( const std::vector<BOARD_ITEM*>& aItems,
+                             const std::set<KIID>& aRemoved, bool aOutlineChanged );
+
+    /**
+     * Toggle the live DRC run after each commit.
+     */
+    int ToggleLiveDRC( const TOOL_EVENT& aEvent );
+
+    /**
+     * Test track and via clearances on a board without an editor frame, e.g. from the qa
+     * tools.  Copper zones are always tested.
+     *
+     * @param aBoard the board to test
+     * @param aUnits the units used in the marker messages
+     * @param aUseIndex false to use the serial, unindexed sweep for comparison
+     * @param aHandler receives each marker, in a deterministic order, and takes ownership
+     */
+    void TestTrackClearances( BOARD* aBoard, EDA_UNITS aUnits, bool aUseIndex,
+                              const DRC_PROVIDER::MARKER_HANDLER& aHandler );
+
     /**
      * Run all the tests specified with a previous call to
      * SetSettings()
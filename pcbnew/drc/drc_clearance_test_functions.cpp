@@ -107,12 +107,13 @@ bool poly2segmentDRC( wxPoint* aTref, int aTrefCount, wxPoint aSegStart, wxPoint
 }
 
 
-void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterator aEndIt,
-                      bool aTestZones )
+void DRC::doTrackDrc( TRACK* aRefSeg, const std::vector<TRACK*>& aTracks,
+                      const std::vector<D_PAD*>& aPads, const std::vector<ZONE_CONTAINER*>& aZones,
+                      std::vector<MARKER_PCB*>& aMarkers )
 {
-    TRACK*    track;
-    wxPoint   delta;           // length on X and Y axis of segments
-    wxPoint   shape_pos;
+    SEGM_FRAME frame;
+    wxPoint    delta;           // length on X and Y axis of segments
+    wxPoint    shape_pos;
 
     NETCLASSPTR netclass = aRefSeg->GetNetClass();
     BOARD_DESIGN_SETTINGS& dsnSettings = m_pcb->GetDesignSettings();
@@ -121,8 +122,8 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
     // coordinates will be made relative to the reference segment origin
     wxPoint origin = aRefSeg->GetStart();
 
-    m_segmEnd   = delta = aRefSeg->GetEnd() - origin;
-    m_segmAngle = 0;
+    frame.m_segmEnd   = delta = aRefSeg->GetEnd() - origin;
+    frame.m_segmAngle = 0;
 
     LSET layerMask = aRefSeg->GetLayerSet();
     int  net_code_ref = aRefSeg->GetNetCode();
@@ -143,28 +144,28 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
         {
             if( refvia->GetWidth() < dsnSettings.m_MicroViasMinSize )
             {
-                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TOO_SMALL_MICROVIA,
-                                                refvia->GetPosition(), refvia ) );
+                aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TOO_SMALL_MICROVIA,
+                                                    refvia->GetPosition(), refvia ) );
             }
 
             if( refvia->GetDrillValue() < dsnSettings.m_MicroViasMinDrill )
             {
-                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TOO_SMALL_MICROVIA_DRILL,
-                                                refvia->GetPosition(), refvia ) );
+                aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TOO_SMALL_MICROVIA_DRILL,
+                                                    refvia->GetPosition(), refvia ) );
             }
         }
         else
         {
             if( refvia->GetWidth() < dsnSettings.m_ViasMinSize )
             {
-                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TOO_SMALL_VIA,
-                                                refvia->GetPosition(), refvia ) );
+                aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TOO_SMALL_VIA,
+                                                    refvia->GetPosition(), refvia ) );
             }
 
             if( refvia->GetDrillValue() < dsnSettings.m_ViasMinDrill )
             {
-                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TOO_SMALL_VIA_DRILL,
-                                                refvia->GetPosition(), refvia ) );
+                aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TOO_SMALL_VIA_DRILL,
+                                                    refvia->GetPosition(), refvia ) );
             }
         }
 
@@ -173,22 +174,22 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
         // and a default via hole can be bigger than some vias sizes
         if( refvia->GetDrillValue() > refvia->GetWidth() )
         {
-            addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_VIA_HOLE_BIGGER,
-                                            refvia->GetPosition(), refvia ) );
+            aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_VIA_HOLE_BIGGER,
+                                                refvia->GetPosition(), refvia ) );
         }
 
         // test if the type of via is allowed due to design rules
         if( refvia->GetViaType() == VIATYPE::MICROVIA && !dsnSettings.m_MicroViasAllowed )
         {
-            addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_MICRO_VIA_NOT_ALLOWED,
-                                            refvia->GetPosition(), refvia ) );
+            aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_MICRO_VIA_NOT_ALLOWED,
+                                                refvia->GetPosition(), refvia ) );
         }
 
         // test if the type of via is allowed due to design rules
         if( refvia->GetViaType() == VIATYPE::BLIND_BURIED && !dsnSettings.m_BlindBuriedViaAllowed )
         {
-            addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_BURIED_VIA_NOT_ALLOWED,
-                                            refvia->GetPosition(), refvia ) );
+            aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_BURIED_VIA_NOT_ALLOWED,
+                                                refvia->GetPosition(), refvia ) );
         }
 
         // For microvias: test if they are blind vias and only between 2 layers
@@ -211,8 +212,9 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
             if( err )
             {
-                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_MICRO_VIA_INCORRECT_LAYER_PAIR,
-                                                refvia->GetPosition(), refvia ) );
+                aMarkers.push_back( new MARKER_PCB( userUnits(),
+                                                    DRCE_MICRO_VIA_INCORRECT_LAYER_PAIR,
+                                                    refvia->GetPosition(), refvia ) );
             }
         }
 
@@ -223,8 +225,8 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
         {
             wxPoint refsegMiddle = ( aRefSeg->GetStart() + aRefSeg->GetEnd() ) / 2;
 
-            addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TOO_SMALL_TRACK_WIDTH,
-                                            refsegMiddle, aRefSeg ) );
+            aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TOO_SMALL_TRACK_WIDTH,
+                                                refsegMiddle, aRefSeg ) );
         }
     }
 
@@ -233,14 +235,14 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
     if( delta.x || delta.y )
     {
         // Compute the segment angle in 0,1 degrees
-        m_segmAngle = ArcTangente( delta.y, delta.x );
+        frame.m_segmAngle = ArcTangente( delta.y, delta.x );
 
         // Compute the segment length: we build an equivalent rotated segment,
         // this segment is horizontal, therefore dx = length
-        RotatePoint( &delta, m_segmAngle );    // delta.x = length, delta.y = 0
+        RotatePoint( &delta, frame.m_segmAngle );    // delta.x = length, delta.y = 0
     }
 
-    m_segmLength = delta.x;
+    frame.m_segmLength = delta.x;
 
     /******************************************/
     /* Phase 1 : test DRC track to pads :     */
@@ -260,63 +262,60 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
     dummypad.SetLayerSet( LSET::AllCuMask() );     // Ensure the hole is on all layers
 
     // Compute the min distance to pads
-    for( MODULE* mod : m_pcb->Modules() )
+    for( D_PAD* pad : aPads )
     {
-        for( D_PAD* pad : mod->Pads() )
-        {
-            SEG padSeg( pad->GetPosition(), pad->GetPosition() );
+        SEG padSeg( pad->GetPosition(), pad->GetPosition() );
 
-            // No problem if pads are on another layer, but if a drill hole exists (a pad on
-            // a single layer can have a hole!) we must test the hole
-            if( !( pad->GetLayerSet() & layerMask ).any() )
-            {
-                // We must test the pad hole. In order to use checkClearanceSegmToPad(), a
-                // pseudo pad is used, with a shape and a size like the hole
-                if( pad->GetDrillSize().x == 0 )
-                    continue;
+        // No problem if pads are on another layer, but if a drill hole exists (a pad on
+        // a single layer can have a hole!) we must test the hole
+        if( !( pad->GetLayerSet() & layerMask ).any() )
+        {
+            // We must test the pad hole. In order to use checkClearanceSegmToPad(), a
+            // pseudo pad is used, with a shape and a size like the hole
+            if( pad->GetDrillSize().x == 0 )
+                continue;
 
-                dummypad.SetSize( pad->GetDrillSize() );
-                dummypad.SetPosition( pad->GetPosition() );
-                dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ?
-                                                                            PAD_SHAPE_OVAL :
-                                                                            PAD_SHAPE_CIRCLE );
-                dummypad.SetOrientation( pad->GetOrientation() );
+            dummypad.SetSize( pad->GetDrillSize() );
+            dummypad.SetPosition( pad->GetPosition() );
+            dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ?
+                                                                        PAD_SHAPE_OVAL :
+                                                                        PAD_SHAPE_CIRCLE );
+            dummypad.SetOrientation( pad->GetOrientation() );
 
-                m_padToTestPos = dummypad.GetPosition() - origin;
+            frame.m_padToTestPos = dummypad.GetPosition() - origin;
 
-                if( !checkClearanceSegmToPad( &dummypad, ref_seg_width, ref_seg_clearance ) )
-                {
-                    addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_THROUGH_HOLE,
+            if( !frame.checkClearanceSegmToPad( &dummypad, ref_seg_width, ref_seg_clearance ) )
+            {
+                aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_THROUGH_HOLE,
                                                     getLocation( aRefSeg, pad, padSeg ),
                                                     aRefSeg, pad ) );
 
-                    if( !m_reportAllTrackErrors )
-                        return;
-                }
-
-                continue;
+                if( !m_reportAllTrackErrors )
+                    return;
             }
 
-            // The pad must be in a net (i.e pt_pad->GetNet() != 0 )
-            // but no problem if the pad netcode is the current netcode (same net)
-            if( pad->GetNetCode()                       // the pad must be connected
-               && net_code_ref == pad->GetNetCode() )   // the pad net is the same as current net -> Ok
-                continue;
+            continue;
+        }
+
+        // The pad must be in a net (i.e pt_pad->GetNet() != 0 )
+        // but no problem if the pad netcode is the current netcode (same net)
+        if( pad->GetNetCode()                       // the pad must be connected
+           && net_code_ref == pad->GetNetCode() )   // the pad net is the same as current net -> Ok
+            continue;
 
-            // DRC for the pad
-            shape_pos = pad->ShapePos();
-            m_padToTestPos = shape_pos - origin;
-            int segToPadClearance = std::max( ref_seg_clearance, pad->GetClearance() );
+        // DRC for the pad
+        shape_pos = pad->ShapePos();
+        frame.m_padToTestPos = shape_pos - origin;
+        int segToPadClearance = std::max( ref_seg_clearance, pad->GetClearance() );
 
-            if( !checkClearanceSegmToPad( pad, ref_seg_width, segToPadClearance ) )
-            {
-                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_PAD,
+        if( !frame.checkClearanceSegmToPad( pad, ref_seg_width, segToPadClearance ) )
+        {
+            aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_PAD,
                                                 getLocation( aRefSeg, pad, padSeg ),
                                                 aRefSeg, pad ) );
 
-                if( !m_reportAllTrackErrors )
-                    return;
-            }
+            if( !m_reportAllTrackErrors )
+                return;
         }
     }
 
@@ -330,9 +329,8 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
     wxPoint segStartPoint;
     wxPoint segEndPoint;
 
-    for( auto it = aStartIt; it != aEndIt; it++ )
+    for( TRACK* track : aTracks )
     {
-        track = *it;
         // No problem if segments have the same net code:
         if( net_code_ref == track->GetNetCode() )
             continue;
@@ -364,8 +362,8 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                 // Test distance between two vias, i.e. two circles, trivial case
                 if( EuclideanNorm( segStartPoint ) < w_dist )
                 {
-                    addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_VIA_NEAR_VIA,
-                                                    aRefSeg->GetPosition(), aRefSeg, track ) );
+                    aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_VIA_NEAR_VIA,
+                                                        aRefSeg->GetPosition(), aRefSeg, track ) );
 
                     if( !m_reportAllTrackErrors )
                         return;
@@ -382,8 +380,8 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
                 if( !checkMarginToCircle( segStartPoint, w_dist, delta.x ) )
                 {
-                    addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_VIA_NEAR_TRACK,
-                                                    aRefSeg->GetPosition(), aRefSeg, track ) );
+                    aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_VIA_NEAR_TRACK,
+                                                        aRefSeg->GetPosition(), aRefSeg, track ) );
 
                     if( !m_reportAllTrackErrors )
                         return;
@@ -399,18 +397,19 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
          */
         segStartPoint = track->GetStart() - origin;
         segEndPoint   = track->GetEnd() - origin;
-        RotatePoint( &segStartPoint, m_segmAngle );
-        RotatePoint( &segEndPoint, m_segmAngle );
+        RotatePoint( &segStartPoint, frame.m_segmAngle );
+        RotatePoint( &segEndPoint, frame.m_segmAngle );
 
         SEG seg( segStartPoint, segEndPoint );
 
         if( track->Type() == PCB_VIA_T )
         {
-            if( checkMarginToCircle( segStartPoint, w_dist, m_segmLength ) )
+            if( checkMarginToCircle( segStartPoint, w_dist, frame.m_segmLength ) )
                 continue;
 
-            addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_VIA,
-                                            getLocation( aRefSeg, track, seg ), aRefSeg, track ) );
+            aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_VIA,
+                                                getLocation( aRefSeg, track, seg ),
+                                                aRefSeg, track ) );
 
             if( !m_reportAllTrackErrors )
                 return;
@@ -429,55 +428,55 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
             if( segStartPoint.x > segEndPoint.x )
                 std::swap( segStartPoint.x, segEndPoint.x );
 
-            if( segStartPoint.x > ( -w_dist ) && segStartPoint.x < ( m_segmLength + w_dist ) )
+            if( segStartPoint.x > ( -w_dist ) && segStartPoint.x < ( frame.m_segmLength + w_dist ) )
             {
                 // the start point is inside the reference range
                 //      X........
                 //    O--REF--+
 
                 // Fine test : we consider the rounded shape of each end of the track segment:
-                if( segStartPoint.x >= 0 && segStartPoint.x <= m_segmLength )
+                if( segStartPoint.x >= 0 && segStartPoint.x <= frame.m_segmLength )
                 {
-                    addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
-                                                    getLocation( aRefSeg, track, seg ),
-                                                    aRefSeg, track ) );
+                    aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
+                                                        getLocation( aRefSeg, track, seg ),
+                                                        aRefSeg, track ) );
 
                     if( !m_reportAllTrackErrors )
                         return;
                 }
 
-                if( !checkMarginToCircle( segStartPoint, w_dist, m_segmLength ) )
+                if( !checkMarginToCircle( segStartPoint, w_dist, frame.m_segmLength ) )
                 {
-                    addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
-                                                    getLocation( aRefSeg, track, seg ),
-                                                    aRefSeg, track ) );
+                    aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
+                                                        getLocation( aRefSeg, track, seg ),
+                                                        aRefSeg, track ) );
 
                     if( !m_reportAllTrackErrors )
                         return;
                 }
             }
 
-            if( segEndPoint.x > ( -w_dist ) && segEndPoint.x < ( m_segmLength + w_dist ) )
+            if( segEndPoint.x > ( -w_dist ) && segEndPoint.x < ( frame.m_segmLength + w_dist ) )
             {
                 // the end point is inside the reference range
                 //  .....X
                 //    O--REF--+
                 // Fine test : we consider the rounded shape of the ends
-                if( segEndPoint.x >= 0 && segEndPoint.x <= m_segmLength )
+                if( segEndPoint.x >= 0 && segEndPoint.x <= frame.m_segmLength )
                 {
-                    addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
-                                                    getLocation( aRefSeg, track, seg ),
-                                                    aRefSeg, track ) );
+                    aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
+                                                        getLocation( aRefSeg, track, seg ),
+                                                        aRefSeg, track ) );
 
                     if( !m_reportAllTrackErrors )
                         return;
                 }
 
-                if( !checkMarginToCircle( segEndPoint, w_dist, m_segmLength ) )
+                if( !checkMarginToCircle( segEndPoint, w_dist, frame.m_segmLength ) )
                 {
-                    addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
-                                                    getLocation( aRefSeg, track, seg ),
-                                                    aRefSeg, track ) );
+                    aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
+                                                        getLocation( aRefSeg, track, seg ),
+                                                        aRefSeg, track ) );
 
                     if( !m_reportAllTrackErrors )
                         return;
@@ -491,9 +490,9 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                 // handled)
                 //  X.............X
                 //    O--REF--+
-                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_SEGMENTS_TOO_CLOSE,
-                                                getLocation( aRefSeg, track, seg ),
-                                                aRefSeg, track ) );
+                aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_SEGMENTS_TOO_CLOSE,
+                                                    getLocation( aRefSeg, track, seg ),
+                                                    aRefSeg, track ) );
 
                 if( !m_reportAllTrackErrors )
                     return;
@@ -501,7 +500,7 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
         }
         else if( segStartPoint.x == segEndPoint.x ) // perpendicular segments
         {
-            if( segStartPoint.x <= -w_dist || segStartPoint.x >= m_segmLength + w_dist )
+            if( segStartPoint.x <= -w_dist || segStartPoint.x >= frame.m_segmLength + w_dist )
                 continue;
 
             // Test if segments are crossing
@@ -510,29 +509,30 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
             if( ( segStartPoint.y < 0 ) && ( segEndPoint.y > 0 ) )
             {
-                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACKS_CROSSING,
-                                                wxPoint( track->GetStart().x, aRefSeg->GetStart().y ),
-                                                aRefSeg, track ) );
+                aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACKS_CROSSING,
+                                                    wxPoint( track->GetStart().x,
+                                                             aRefSeg->GetStart().y ),
+                                                    aRefSeg, track ) );
 
                 if( !m_reportAllTrackErrors )
                     return;
             }
 
             // At this point the drc error is due to an end near a reference segm end
-            if( !checkMarginToCircle( segStartPoint, w_dist, m_segmLength ) )
+            if( !checkMarginToCircle( segStartPoint, w_dist, frame.m_segmLength ) )
             {
-                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
-                                                getLocation( aRefSeg, track, seg ),
-                                                aRefSeg, track ) );
+                aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
+                                                    getLocation( aRefSeg, track, seg ),
+                                                    aRefSeg, track ) );
 
                 if( !m_reportAllTrackErrors )
                     return;
             }
-            if( !checkMarginToCircle( segEndPoint, w_dist, m_segmLength ) )
+            if( !checkMarginToCircle( segEndPoint, w_dist, frame.m_segmLength ) )
             {
-                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
-                                                getLocation( aRefSeg, track, seg ),
-                                                aRefSeg, track ) );
+                aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
+                                                    getLocation( aRefSeg, track, seg ),
+                                                    aRefSeg, track ) );
 
                 if( !m_reportAllTrackErrors )
                     return;
@@ -543,23 +543,23 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
             // calcul de la "surface de securite du segment de reference
             // First rought 'and fast) test : the track segment is like a rectangle
 
-            m_xcliplo = m_ycliplo = -w_dist;
-            m_xcliphi = m_segmLength + w_dist;
-            m_ycliphi = w_dist;
+            frame.m_xcliplo = frame.m_ycliplo = -w_dist;
+            frame.m_xcliphi = frame.m_segmLength + w_dist;
+            frame.m_ycliphi = w_dist;
 
             // A fine test is needed because a serment is not exactly a
             // rectangle, it has rounded ends
-            if( !checkLine( segStartPoint, segEndPoint ) )
+            if( !frame.checkLine( segStartPoint, segEndPoint ) )
             {
                 /* 2eme passe : the track has rounded ends.
                  * we must a fine test for each rounded end and the
                  * rectangular zone
                  */
 
-                m_xcliplo = 0;
-                m_xcliphi = m_segmLength;
+                frame.m_xcliplo = 0;
+                frame.m_xcliphi = frame.m_segmLength;
 
-                if( !checkLine( segStartPoint, segEndPoint ) )
+                if( !frame.checkLine( segStartPoint, segEndPoint ) )
                 {
                     wxPoint failurePoint;
 
@@ -567,14 +567,14 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                                                   track->GetStart(), track->GetEnd(),
                                                   &failurePoint ) )
                     {
-                        addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACKS_CROSSING,
-                                                        failurePoint, aRefSeg, track ) );
+                        aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACKS_CROSSING,
+                                                            failurePoint, aRefSeg, track ) );
                     }
                     else
                     {
-                        addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
-                                                        getLocation( aRefSeg, track, seg ),
-                                                        aRefSeg, track ) );
+                        aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
+                                                            getLocation( aRefSeg, track, seg ),
+                                                            aRefSeg, track ) );
                     }
 
                     if( !m_reportAllTrackErrors )
@@ -604,9 +604,9 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
                     if( !checkMarginToCircle( relStartPos, w_dist, delta.x ) )
                     {
-                        addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
-                                                        getLocation( aRefSeg, track, seg ),
-                                                        aRefSeg, track ) );
+                        aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
+                                                            getLocation( aRefSeg, track, seg ),
+                                                            aRefSeg, track ) );
 
                         if( !m_reportAllTrackErrors )
                             return;
@@ -614,9 +614,9 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
                     if( !checkMarginToCircle( relEndPos, w_dist, delta.x ) )
                     {
-                        addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
-                                                        getLocation( aRefSeg, track, seg ),
-                                                        aRefSeg, track ) );
+                        aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_ENDS,
+                                                            getLocation( aRefSeg, track, seg ),
+                                                            aRefSeg, track ) );
 
                         if( !m_reportAllTrackErrors )
                             return;
@@ -630,11 +630,10 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
     /* Phase 3: test DRC with copper zones */
     /***************************************/
     // Can be *very* time consumming.
-    if( aTestZones )
     {
         SEG refSeg( aRefSeg->GetStart(), aRefSeg->GetEnd() );
 
-        for( ZONE_CONTAINER* zone : m_pcb->Zones() )
+        for( ZONE_CONTAINER* zone : aZones )
         {
             if( zone->GetFilledPolysList().IsEmpty() || zone->GetIsKeepout() )
                 continue;
@@ -656,8 +655,9 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
             #define THRESHOLD_DIST Millimeter2iu( 0.001 )
             if( error > THRESHOLD_DIST )
             {
-                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_ZONE,
-                                                getLocation( aRefSeg, zone ), aRefSeg, zone  ) );
+                aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_ZONE,
+                                                    getLocation( aRefSeg, zone ),
+                                                    aRefSeg, zone  ) );
             }
         }
     }
@@ -701,8 +701,8 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                 // Best-efforts search for edge segment
                 BOARD::IterateForward<BOARD_ITEM*>( m_pcb->Drawings(), inspector, nullptr, types );
 
-                addMarkerToPcb( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_EDGE, (wxPoint) pt,
-                                                aRefSeg, edge ) );
+                aMarkers.push_back( new MARKER_PCB( userUnits(), DRCE_TRACK_NEAR_EDGE, (wxPoint) pt,
+                                                    aRefSeg, edge ) );
             }
         }
     }
@@ -711,6 +711,7 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
 bool DRC::checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad )
 {
+    SEGM_FRAME frame;
     int     dist;
     double pad_angle;
 
@@ -798,13 +799,13 @@ bool DRC::checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad )
         /* One can use checkClearanceSegmToPad to test clearance
          * aRefPad is like a track segment with a null length and a witdth = GetSize().x
          */
-        m_segmLength = 0;
-        m_segmAngle  = 0;
+        frame.m_segmLength = 0;
+        frame.m_segmAngle  = 0;
 
-        m_segmEnd.x = m_segmEnd.y = 0;
+        frame.m_segmEnd.x = frame.m_segmEnd.y = 0;
 
-        m_padToTestPos = relativePadPos;
-        diag = checkClearanceSegmToPad( aPad, aRefPad->GetSize().x, dist_min );
+        frame.m_padToTestPos = relativePadPos;
+        diag = frame.checkClearanceSegmToPad( aPad, aRefPad->GetSize().x, dist_min );
         break;
 
     case PAD_SHAPE_TRAPEZOID:
@@ -956,39 +957,39 @@ bool DRC::checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad )
          * and use checkClearanceSegmToPad function to test aPad to aRefPad clearance
          */
         int segm_width;
-        m_segmAngle = aRefPad->GetOrientation();                // Segment orient.
+        frame.m_segmAngle = aRefPad->GetOrientation();                // Segment orient.
 
         if( aRefPad->GetSize().y < aRefPad->GetSize().x )     // Build an horizontal equiv segment
         {
             segm_width   = aRefPad->GetSize().y;
-            m_segmLength = aRefPad->GetSize().x - aRefPad->GetSize().y;
+            frame.m_segmLength = aRefPad->GetSize().x - aRefPad->GetSize().y;
         }
         else        // Vertical oval: build an horizontal equiv segment and rotate 90.0 deg
         {
             segm_width   = aRefPad->GetSize().x;
-            m_segmLength = aRefPad->GetSize().y - aRefPad->GetSize().x;
-            m_segmAngle += 900;
+            frame.m_segmLength = aRefPad->GetSize().y - aRefPad->GetSize().x;
+            frame.m_segmAngle += 900;
         }
 
         /* the start point must be 0,0 and currently relativePadPos
          * is relative the center of pad coordinate */
         wxPoint segstart;
-        segstart.x = -m_segmLength / 2;                 // Start point coordinate of the horizontal equivalent segment
+        segstart.x = -frame.m_segmLength / 2;                 // Start point coordinate of the horizontal equivalent segment
 
-        RotatePoint( &segstart, m_segmAngle );          // actual start point coordinate of the equivalent segment
+        RotatePoint( &segstart, frame.m_segmAngle );          // actual start point coordinate of the equivalent segment
         // Calculate segment end position relative to the segment origin
-        m_segmEnd.x = -2 * segstart.x;
-        m_segmEnd.y = -2 * segstart.y;
+        frame.m_segmEnd.x = -2 * segstart.x;
+        frame.m_segmEnd.y = -2 * segstart.y;
 
         // Recalculate the equivalent segment angle in 0,1 degrees
-        // to prepare a call to checkClearanceSegmToPad()
-        m_segmAngle = ArcTangente( m_segmEnd.y, m_segmEnd.x );
+        // to prepare a call to frame.checkClearanceSegmToPad()
+        frame.m_segmAngle = ArcTangente( frame.m_segmEnd.y, frame.m_segmEnd.x );
 
         // move pad position relative to the segment origin
-        m_padToTestPos = relativePadPos - segstart;
+        frame.m_padToTestPos = relativePadPos - segstart;
 
         // Use segment to pad check to test the second pad:
-        diag = checkClearanceSegmToPad( aPad, segm_width, dist_min );
+        diag = frame.checkClearanceSegmToPad( aPad, segm_width, dist_min );
         break;
     }
 
@@ -1002,11 +1003,11 @@ bool DRC::checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad )
 
 
 /* test if distance between a segment is > aMinDist
- * segment start point is assumed in (0,0) and  segment start point in m_segmEnd
- * and its orientation is m_segmAngle (m_segmAngle must be already initialized)
+ * segment start point is assumed in (0,0) and  segment start point in frame.m_segmEnd
+ * and its orientation is frame.m_segmAngle (frame.m_segmAngle must be already initialized)
  * and have aSegmentWidth.
  */
-bool DRC::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMinDist )
+bool DRC::SEGM_FRAME::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMinDist )
 {
     // Note:
     // we are using a horizontal segment for test, because we know here
@@ -1370,7 +1371,7 @@ static inline int USCALE( unsigned arg, unsigned num, unsigned den )
  * The rectangle is defined by m_xcliplo, m_ycliplo and m_xcliphi, m_ycliphi
  * return true if the line from aSegStart to aSegEnd is outside the bounding box
  */
-bool DRC::checkLine( wxPoint aSegStart, wxPoint aSegEnd )
+bool DRC::SEGM_FRAME::checkLine( wxPoint aSegStart, wxPoint aSegEnd )
 {
 #define WHEN_OUTSIDE return true
 #define WHEN_INSIDE
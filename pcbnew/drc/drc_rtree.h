@@ -0,0 +1,125 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_RTREE_H_
+#define DRC_RTREE_H_
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <eda_rect.h>
+#include <layers_id_colors_and_visibility.h>
+
+#include <geometry/rtree.h>
+
+
+/**
+ * DRC_RTREE -
+ * Implements one R-tree per copper layer for fast neighbour queries in the clearance tests.
+ * Non-owning.
+ *
+ * Each item is given a sequence number when it is inserted and queries return items in
+ * insertion order, so a test which walks the query results reports its violations in the
+ * same order as one walking the board's item lists.
+ */
+template< class T >
+class DRC_RTREE
+{
+public:
+
+    DRC_RTREE()
+    {
+        for( PCB_LAYER_ID layer : LSET::AllCuMask().Seq() )
+            m_trees[layer].reset( new RTree<int, int, 2, double>() );
+    }
+
+    /**
+     * Function Insert()
+     * Inserts an item with the given bounding box on each copper layer of aLayers.
+     */
+    void Insert( T aItem, const EDA_RECT& aBBox, LSET aLayers )
+    {
+        const int index = (int) m_items.size();
+        const int mmin[2] = { aBBox.GetX(), aBBox.GetY() };
+        const int mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
+
+        m_items.push_back( aItem );
+
+        for( PCB_LAYER_ID layer : ( aLayers & LSET::AllCuMask() ).Seq() )
+            m_trees[layer]->Insert( mmin, mmax, index );
+    }
+
+    /**
+     * Function Query()
+     * Collects the items on any copper layer of aLayers whose bounding box intersects
+     * aBounds.  The result is free of duplicates and in insertion order.
+     * @param aFirst skips the items inserted before the aFirst'th one
+     */
+    void Query( const EDA_RECT& aBounds, LSET aLayers, std::vector<T>& aResult,
+                int aFirst = 0 ) const
+    {
+        const int mmin[2] = { aBounds.GetX(), aBounds.GetY() };
+        const int mmax[2] = { aBounds.GetRight(), aBounds.GetBottom() };
+
+        std::vector<int> found;
+
+        auto visitor = [&]( int aIndex ) -> bool
+        {
+            if( aIndex >= aFirst )
+                found.push_back( aIndex );
+
+            return true;
+        };
+
+        for( PCB_LAYER_ID layer : ( aLayers & LSET::AllCuMask() ).Seq() )
+            m_trees[layer]->Search( mmin, mmax, visitor );
+
+        std::sort( found.begin(), found.end() );
+        found.erase( std::unique( found.begin(), found.end() ), found.end() );
+
+        aResult.clear();
+        aResult.reserve( found.size() );
+
+        for( int index : found )
+            aResult.push_back( m_items[index] );
+    }
+
+    /**
+     * Function Items()
+     * Returns every item in insertion order.
+     */
+    const std::vector<T>& Items() const
+    {
+        return m_items;
+    }
+
+private:
+
+    std::array<std::unique_ptr<RTree<int, int, 2, double>>, PCB_LAYER_ID_COUNT> m_trees;
+    std::vector<T> m_items;
+};
+
+
+#endif /* DRC_RTREE_H_ */
@@ -37,8 +37,14 @@
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
 
-#include <thread>
+#include <algorithm>
 #include <mutex>
+#include <thread>
+
+
+// The hash recorded for the libraries which were not read entirely, which are then read
+// again by the next ReadFootprintFiles()
+static const long long INCOMPLETE_LIBRARY_HASH = 0;
 
 
 void FOOTPRINT_INFO_IMPL::load()
@@ -118,52 +124,99 @@ void FOOTPRINT_LIST_IMPL::loader_job()
 bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname,
                                               PROGRESS_REPORTER* aProgressReporter )
 {
-    long long int generatedTimestamp = aTable->GenerateTimestamp( aNickname );
+    std::vector<wxString> nicknames;
+
+    if( aNickname )
+        nicknames.push_back( *aNickname );
+    else
+        nicknames = aTable->GetLogicalLibs();
+
+    // The timestamp of the list is the sum of the content hashes of its libraries
+    long long int generatedTimestamp = 0;
+
+    m_libHashes.clear();
+
+    for( const wxString& nickname : nicknames )
+    {
+        long long hash = aTable->GenerateTimestamp( &nickname );
+
+        m_libHashes[nickname] = hash;
+        generatedTimestamp += hash;
+    }
 
     if( generatedTimestamp == m_list_timestamp )
         return true;
 
+    m_lib_table = aTable;
     m_progress_reporter = aProgressReporter;
     m_cancelled = false;
+    m_errors.clear();
 
-    FOOTPRINT_ASYNC_LOADER loader;
-
-    loader.SetList( this );
-    loader.Start( aTable, aNickname );
+    // Only the libraries whose contents changed since they were indexed are read again
+    bool stale = std::any_of( nicknames.begin(), nicknames.end(),
+                              [&]( const wxString& aNick )
+                              {
+                                  return !m_index.FindLibrary( aNick, m_libHashes[aNick] );
+                              } );
 
-    if( m_progress_reporter )
+    if( stale )
     {
-        m_progress_reporter->SetMaxProgress( m_queue_in.size() );
-        m_progress_reporter->Report( _( "Fetching Footprint Libraries" ) );
-    }
+        FOOTPRINT_ASYNC_LOADER loader;
 
-    while( !m_cancelled && (int)m_count_finished.load() < m_loader->m_total_libs )
-    {
-        if( m_progress_reporter && !m_progress_reporter->KeepRefreshing() )
-            m_cancelled = true;
+        loader.SetList( this );
+        loader.Start( aTable, aNickname );
 
-        wxMilliSleep( 20 );
-    }
+        if( m_progress_reporter )
+        {
+            m_progress_reporter->SetMaxProgress( m_queue_in.size() );
+            m_progress_reporter->Report( _( "Fetching Footprint Libraries" ) );
+        }
 
-    if( m_cancelled )
-    {
-        loader.Abort();
+        while( !m_cancelled && (int)m_count_finished.load() < m_loader->m_total_libs )
+        {
+            if( m_progress_reporter && !m_progress_reporter->KeepRefreshing() )
+                m_cancelled = true;
+
+            wxMilliSleep( 20 );
+        }
+
+        if( m_cancelled )
+        {
+            loader.Abort();
+        }
+        else
+        {
+            if( m_progress_reporter )
+            {
+                m_progress_reporter->AdvancePhase();
+                m_progress_reporter->SetMaxProgress( m_queue_out.size() );
+                m_progress_reporter->Report( _( "Loading Footprints" ) );
+            }
+
+            loader.Join();
+
+            if( m_progress_reporter )
+                m_progress_reporter->AdvancePhase();
+        }
     }
-    else
+
+    if( !aNickname )
     {
-        if( m_progress_reporter )
+        // Forget the libraries which left the table
+        std::vector<wxString> removed;
+
+        for( const auto& library : m_index.GetLibraries() )
         {
-            m_progress_reporter->AdvancePhase();
-            m_progress_reporter->SetMaxProgress( m_queue_out.size() );
-            m_progress_reporter->Report( _( "Loading Footprints" ) );
+            if( !m_libHashes.count( library.first ) )
+                removed.push_back( library.first );
         }
 
-        loader.Join();
-
-        if( m_progress_reporter )
-            m_progress_reporter->AdvancePhase();
+        for( const wxString& nickname : removed )
+            m_index.RemoveLibrary( nickname );
     }
 
+    rebuildList( nicknames );
+
     if( m_cancelled )
         m_list_timestamp = 0;       // God knows what we got before we were cancelled
     else
@@ -182,7 +235,6 @@ void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aN
     // Clear data before reading files
     m_count_finished.store( 0 );
     m_errors.clear();
-    m_list.clear();
     m_threads.clear();
     m_queue_in.clear();
     m_queue_out.clear();
@@ -192,7 +244,13 @@ void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aN
     else
     {
         for( auto const& nickname : aTable->GetLogicalLibs() )
-            m_queue_in.push( nickname );
+        {
+            // A library indexed with its current contents need not be read again
+            auto hash = m_libHashes.find( nickname );
+
+            if( hash == m_libHashes.end() || !m_index.FindLibrary( nickname, hash->second ) )
+                m_queue_in.push( nickname );
+        }
     }
 
     m_loader->m_total_libs = m_queue_in.size();
@@ -238,17 +296,38 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
 
     size_t total_count = m_queue_out.size();
 
-    LOCALE_IO toggle_locale;
+    // Parse the footprints in parallel.  The KiCad s-expression parser does not depend on the
+    // C locale, but the other footprint plugins still do.  If any of them are in use we must
+    // change the locale, which is GLOBAL.  It is only threadsafe to construct the LOCALE_IO
+    // before the threads are created, destroy it after they finish, and block the main (GUI)
+    // thread while they work.  Any deviation from this will cause nasal demons.
+    std::unique_ptr<LOCALE_IO> toggle_locale;
+    const wxString             sexprType = IO_MGR::ShowType( IO_MGR::KICAD_SEXP );
 
-    // Parse the footprints in parallel. WARNING! This requires changing the locale, which is
-    // GLOBAL. It is only threadsafe to construct the LOCALE_IO before the threads are created,
-    // destroy it after they finish, and block the main (GUI) thread while they work. Any deviation
-    // from this will cause nasal demons.
-    //
-    // TODO: blast LOCALE_IO into the sun
+    for( const wxString& nickname : m_lib_table->GetLogicalLibs() )
+    {
+        const FP_LIB_TABLE_ROW* row = nullptr;
 
-    SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>> queue_parsed;
-    std::vector<std::thread>                    threads;
+        try
+        {
+            row = m_lib_table->FindRow( nickname );
+        }
+        catch( const IO_ERROR& )
+        {
+            // Reported by the enumeration below.
+        }
+
+        if( !row || row->GetType() != sexprType )
+        {
+            toggle_locale = std::make_unique<LOCALE_IO>();
+            break;
+        }
+    }
+
+    typedef std::pair<wxString, LIB_INFO_INDEX::LIBRARY> PARSED_LIBRARY;
+
+    SYNC_QUEUE<PARSED_LIBRARY> queue_parsed;
+    std::vector<std::thread>   threads;
 
     for( size_t ii = 0; ii < std::thread::hardware_concurrency() + 1; ++ii )
     {
@@ -258,10 +337,12 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
             while( this->m_queue_out.pop( nickname ) && !m_cancelled )
             {
                 wxArrayString fpnames;
+                bool          complete = false;
 
                 try
                 {
                     m_lib_table->FootprintEnumerate( fpnames, nickname, false );
+                    complete = true;
                 }
                 catch( const IO_ERROR& ioe )
                 {
@@ -281,13 +362,28 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
                     }
                 }
 
+                LIB_INFO_INDEX::LIBRARY library;
+
                 for( unsigned jj = 0; jj < fpnames.size() && !m_cancelled; ++jj )
                 {
-                    wxString fpname = fpnames[jj];
-                    FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO_IMPL( this, nickname, fpname );
-                    queue_parsed.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
+                    FOOTPRINT_INFO_IMPL fpinfo( this, nickname, fpnames[jj] );
+
+                    library.m_Items.push_back( { fpinfo.GetFootprintName(),
+                                                 fpinfo.GetDescription(),
+                                                 fpinfo.GetKeywords(),
+                                                 fpinfo.GetPadCount(),
+                                                 fpinfo.GetUniquePadCount() } );
                 }
 
+                auto hash = m_libHashes.find( nickname );
+
+                if( complete && !m_cancelled && hash != m_libHashes.end() )
+                    library.m_Hash = hash->second;
+                else
+                    library.m_Hash = INCOMPLETE_LIBRARY_HASH;
+
+                queue_parsed.move_push( PARSED_LIBRARY( nickname, std::move( library ) ) );
+
                 if( m_progress_reporter )
                     m_progress_reporter->AdvanceProgress();
 
@@ -307,18 +403,43 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
     for( auto& thr : threads )
         thr.join();
 
-    std::unique_ptr<FOOTPRINT_INFO> fpi;
+    PARSED_LIBRARY parsed;
+
+    while( queue_parsed.pop( parsed ) )
+        m_index.SetLibrary( parsed.first, std::move( parsed.second ) );
 
-    while( queue_parsed.pop( fpi ) )
-        m_list.push_back( std::move( fpi ) );
+    return m_errors.empty();
+}
+
+
+void FOOTPRINT_LIST_IMPL::rebuildList( const std::vector<wxString>& aNicknames )
+{
+    const std::map<wxString, LIB_INFO_INDEX::LIBRARY>& libraries = m_index.GetLibraries();
+
+    m_list.clear();
+
+    for( const wxString& nickname : aNicknames )
+    {
+        auto library = libraries.find( nickname );
+
+        if( library == libraries.end() )
+            continue;
+
+        for( const LIB_INFO_INDEX::ITEM& item : library->second.m_Items )
+        {
+            m_list.push_back( std::make_unique<FOOTPRINT_INFO_IMPL>( nickname, item.m_Name,
+                                                                     item.m_Description,
+                                                                     item.m_Keywords, 0,
+                                                                     item.m_Count,
+                                                                     item.m_UniqueCount ) );
+        }
+    }
 
     std::sort( m_list.begin(), m_list.end(), []( std::unique_ptr<FOOTPRINT_INFO> const& lhs,
                                                  std::unique_ptr<FOOTPRINT_INFO> const& rhs ) -> bool
                                              {
                                                  return *lhs < *rhs;
                                              } );
-
-    return m_errors.empty();
 }
 
 
@@ -338,76 +459,22 @@ FOOTPRINT_LIST_IMPL::~FOOTPRINT_LIST_IMPL()
 }
 
 
-void FOOTPRINT_LIST_IMPL::WriteCacheToFile( wxTextFile* aCacheFile )
+void FOOTPRINT_LIST_IMPL::WriteCacheToFile( const wxString& aFilePath )
 {
-    if( aCacheFile->Exists() )
-    {
-        if( !aCacheFile->Open() )
-            return;
-
-        aCacheFile->Clear();
-    }
-    else
-    {
-        if( !aCacheFile->Create() )
-            return;
-    }
-
-    aCacheFile->AddLine( wxString::Format( "%lld", m_list_timestamp ) );
-
-    for( auto& fpinfo : m_list )
-    {
-        aCacheFile->AddLine( fpinfo->GetLibNickname() );
-        aCacheFile->AddLine( fpinfo->GetName() );
-        aCacheFile->AddLine( EscapeString( fpinfo->GetDescription(), CTX_DELIMITED_STR ) );
-        aCacheFile->AddLine( EscapeString( fpinfo->GetKeywords(), CTX_DELIMITED_STR ) );
-        aCacheFile->AddLine( wxString::Format( "%d", fpinfo->GetOrderNum() ) );
-        aCacheFile->AddLine( wxString::Format( "%u", fpinfo->GetPadCount() ) );
-        aCacheFile->AddLine( wxString::Format( "%u", fpinfo->GetUniquePadCount() ) );
-    }
-
-    aCacheFile->Write();
-    aCacheFile->Close();
+    m_index.Write( aFilePath );
 }
 
 
-void FOOTPRINT_LIST_IMPL::ReadCacheFromFile( wxTextFile* aCacheFile )
+void FOOTPRINT_LIST_IMPL::ReadCacheFromFile( const wxString& aFilePath )
 {
+    // The libraries of the index are checked one by one by ReadFootprintFiles()
     m_list_timestamp = 0;
-    m_list.clear();
+    m_index.Read( aFilePath );
 
-    try
-    {
-        if( aCacheFile->Exists() && aCacheFile->Open() )
-        {
-            aCacheFile->GetFirstLine().ToLongLong( &m_list_timestamp );
+    std::vector<wxString> nicknames;
 
-            while( aCacheFile->GetCurrentLine() + 6 < aCacheFile->GetLineCount() )
-            {
-                wxString libNickname = aCacheFile->GetNextLine();
-                wxString name = aCacheFile->GetNextLine();
-                wxString description = UnescapeString( aCacheFile->GetNextLine() );
-                wxString keywords = UnescapeString( aCacheFile->GetNextLine() );
-                int orderNum = wxAtoi( aCacheFile->GetNextLine() );
-                unsigned int padCount = (unsigned) wxAtoi( aCacheFile->GetNextLine() );
-                unsigned int uniquePadCount = (unsigned) wxAtoi( aCacheFile->GetNextLine() );
-
-                auto* fpinfo = new FOOTPRINT_INFO_IMPL( libNickname, name, description, keywords,
-                                                        orderNum, padCount, uniquePadCount );
-                m_list.emplace_back( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
-            }
-        }
-    }
-    catch( ... )
-    {
-        // whatever went wrong, invalidate the cache
-        m_list_timestamp = 0;
-    }
-
-    // Sanity check: an empty list is very unlikely to be correct.
-    if( m_list.size() == 0 )
-        m_list_timestamp = 0;
+    for( const auto& library : m_index.GetLibraries() )
+        nicknames.push_back( library.first );
 
-    if( aCacheFile->IsOpened() )
-        aCacheFile->Close();
+    rebuildList( nicknames );
 }
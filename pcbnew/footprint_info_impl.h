@@ -22,11 +22,13 @@
 
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
 #include <thread>
 #include <vector>
 
 #include <footprint_info.h>
+#include <lib_info_index.h>
 #include <sync_queue.h>
 
 class LOCALE_IO;
@@ -93,6 +95,14 @@ class FOOTPRINT_LIST_IMPL : public FOOTPRINT_LIST
     std::atomic_bool         m_cancelled;
     std::mutex               m_join;
 
+    LIB_INFO_INDEX                m_index;      ///< the libraries read so far
+    std::map<wxString, long long> m_libHashes;  ///< the hashes of the libraries being read
+
+    /**
+     * Rebuild the list from the index, with the libraries aNicknames.
+     */
+    void rebuildList( const std::vector<wxString>& aNicknames );
+
     /**
      * Call aFunc, pushing any IO_ERRORs and std::exceptions it throws onto m_errors.
      *
@@ -117,8 +127,8 @@ public:
     FOOTPRINT_LIST_IMPL();
     virtual ~FOOTPRINT_LIST_IMPL();
 
-    void WriteCacheToFile( wxTextFile* aFile ) override;
-    void ReadCacheFromFile( wxTextFile* aFile ) override;
+    void WriteCacheToFile( const wxString& aFilePath ) override;
+    void ReadCacheFromFile( const wxString& aFilePath ) override;
 
     bool ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname = nullptr,
                              PROGRESS_REPORTER* aProgressReporter = nullptr ) override;
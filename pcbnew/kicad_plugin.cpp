@@ -25,6 +25,7 @@
 #include <fctsys.h>
 #include <kicad_string.h>
 #include <common.h>
+#include <dir_watcher.h>
 #include <build_version.h>      // LEGACY_BOARD_FILE_VERSION
 #include <macros.h>
 #include <wildcards_and_files_ext.h>
@@ -114,10 +115,11 @@ class FP_CACHE
     wxString        m_lib_raw_path;     // For quick comparisons.
     MODULE_MAP      m_modules;          // Map of footprint file name per MODULE*.
 
-    bool            m_cache_dirty;      // Stored separately because it's expensive to check
-                                        // m_cache_timestamp against all the files.
-    long long       m_cache_timestamp;  // A hash of the timestamps for all the footprint
-                                        // files.
+    std::unique_ptr<DIR_WATCHER> m_watcher; // The changes of the footprint files since they
+                                            // were loaded.
+    std::map<wxString, wxString> m_failed;  // The footprint files which failed to parse, and
+                                            // their errors.  They are read again on each
+                                            // Update().
 
 public:
     FP_CACHE( PCB_IO* aOwner, const wxString& aLibraryPath );
@@ -143,6 +145,17 @@ public:
 
     void Remove( const wxString& aFootprintName );
 
+    /**
+     * Function Update
+     * re-reads the footprint files changed since they were loaded, and the ones which failed
+     * to parse, as they may have been read while being written, and forgets the removed ones.
+     * The footprints which fail to parse are dropped until they parse again; their new errors
+     * are thrown once the other files are read.
+     * @return bool - false if the changes of the library are unknown and it must be loaded
+     *                again.
+     */
+    bool Update();
+
     /**
      * Function GetTimestamp
      * Generate a timestamp representing all source files in the cache (including the
@@ -151,12 +164,6 @@ public:
      */
     static long long GetTimestamp( const wxString& aLibPath );
 
-    /**
-     * Function IsModified
-     * Return true if the cache is not up-to-date.
-     */
-    bool IsModified();
-
     /**
      * Function IsPath
      * checks if \a aPath is the same as the current cache path.
@@ -178,15 +185,11 @@ FP_CACHE::FP_CACHE( PCB_IO* aOwner, const wxString& aLibraryPath )
     m_owner = aOwner;
     m_lib_raw_path = aLibraryPath;
     m_lib_path.SetPath( aLibraryPath );
-    m_cache_timestamp = 0;
-    m_cache_dirty = true;
 }
 
 
 void FP_CACHE::Save( MODULE* aModule )
 {
-    m_cache_timestamp = 0;
-
     if( !m_lib_path.DirExists() && !m_lib_path.Mkdir() )
     {
         THROW_IO_ERROR( wxString::Format( _( "Cannot create footprint library path \"%s\"" ),
@@ -199,6 +202,13 @@ void FP_CACHE::Save( MODULE* aModule )
                                           m_lib_raw_path ) );
     }
 
+    // The saved files are re-read on the next update, as any other change of the library.
+    if( !m_watcher )
+    {
+        m_watcher.reset( new DIR_WATCHER( m_lib_raw_path,
+                                          wxT( "*." ) + KiCadFootprintFileExtension ) );
+    }
+
     for( MODULE_ITER it = m_modules.begin();  it != m_modules.end();  ++it )
     {
         if( aModule && aModule != it->second->GetModule() )
@@ -241,21 +251,16 @@ void FP_CACHE::Save( MODULE* aModule )
             THROW_IO_ERROR( msg );
         }
 #endif
-        m_cache_timestamp += fn.GetTimestamp();
     }
-
-    m_cache_timestamp += m_lib_path.GetModificationTime().GetValue().GetValue();
-
-    // If we've saved the full cache, we clear the dirty flag.
-    if( !aModule )
-        m_cache_dirty = false;
 }
 
 
 void FP_CACHE::Load()
 {
-    m_cache_dirty = false;
-    m_cache_timestamp = 0;
+    wxString fileSpec = wxT( "*." ) + KiCadFootprintFileExtension;
+
+    // Watch the library before reading it, so that no change is missed.
+    m_watcher.reset( new DIR_WATCHER( m_lib_raw_path, fileSpec ) );
 
     wxDir dir( m_lib_raw_path );
 
@@ -268,7 +273,6 @@ void FP_CACHE::Load()
     }
 
     wxString fullName;
-    wxString fileSpec = wxT( "*." ) + KiCadFootprintFileExtension;
 
     // wxFileName construction is egregiously slow.  Construct it once and just swap out
     // the filename thereafter.
@@ -285,7 +289,7 @@ void FP_CACHE::Load()
             // Queue I/O errors so only files that fail to parse don't get loaded.
             try
             {
-                FILE_LINE_READER    reader( fn.GetFullPath() );
+                MMAP_LINE_READER    reader( fn.GetFullPath() );
 
                 m_owner->m_parser->SetLineReader( &reader );
 
@@ -294,8 +298,6 @@ void FP_CACHE::Load()
 
                 footprint->SetFPID( LIB_ID( wxEmptyString, fpName ) );
                 m_modules.insert( fpName, new FP_CACHE_ITEM( footprint, fn ) );
-
-                m_cache_timestamp += fn.GetTimestamp();
             }
             catch( const IO_ERROR& ioe )
             {
@@ -303,6 +305,7 @@ void FP_CACHE::Load()
                     cacheError += "\n\n";
 
                 cacheError += ioe.What();
+                m_failed[fullName] = ioe.What();
             }
         } while( dir.GetNext( &fullName ) );
 
@@ -337,11 +340,68 @@ bool FP_CACHE::IsPath( const wxString& aPath ) const
 }
 
 
-bool FP_CACHE::IsModified()
+bool FP_CACHE::Update()
 {
-    m_cache_dirty = m_cache_dirty || GetTimestamp( m_lib_path.GetFullPath() ) != m_cache_timestamp;
+    std::set<wxString> changed;
+
+    if( !m_watcher || !m_watcher->TakeChanges( changed ) )
+        return false;
+
+    for( const std::pair<const wxString, wxString>& failed : m_failed )
+        changed.insert( failed.first );
+
+    if( changed.empty() )
+        return true;
+
+    WX_FILENAME fn( m_lib_raw_path, wxT( "dummyName" ) );
+    wxString    cacheError;
+
+    for( const wxString& fullName : changed )
+    {
+        fn.SetFullName( fullName );
+
+        wxString fpName = fn.GetName();
+
+        m_modules.erase( fpName );
 
-    return m_cache_dirty;
+        if( !wxFileExists( fn.GetFullPath() ) )
+        {
+            m_failed.erase( fullName );
+            continue;
+        }
+
+        try
+        {
+            MMAP_LINE_READER    reader( fn.GetFullPath() );
+
+            m_owner->m_parser->SetLineReader( &reader );
+
+            MODULE* footprint = (MODULE*) m_owner->m_parser->Parse();
+
+            footprint->SetFPID( LIB_ID( wxEmptyString, fpName ) );
+            m_modules.insert( fpName, new FP_CACHE_ITEM( footprint, fn ) );
+            m_failed.erase( fullName );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            wxString& error = m_failed[fullName];
+
+            // An error already thrown is not thrown again on each retry
+            if( error != ioe.What() )
+            {
+                if( !cacheError.IsEmpty() )
+                    cacheError += "\n\n";
+
+                cacheError += ioe.What();
+                error = ioe.What();
+            }
+        }
+    }
+
+    if( !cacheError.IsEmpty() )
+        THROW_IO_ERROR( cacheError );
+
+    return true;
 }
 
 
@@ -1839,6 +1899,10 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
                   FormatInternalUnits( aZone->GetThermalReliefGap() ).c_str(),
                   FormatInternalUnits( aZone->GetThermalReliefCopperBridge() ).c_str() );
 
+    // Lets the zone filler skip the zone as long as its inputs don't change
+    if( aZone->IsFilled() && aZone->GetFillInputHash() != 0 )
+        m_out->Print( 0, " (input_hash %llx)", (unsigned long long) aZone->GetFillInputHash() );
+
     if( aZone->GetCornerSmoothingType() != ZONE_SETTINGS::SMOOTHING_NONE )
     {
         m_out->Print( 0, " (smoothing" );
@@ -2037,7 +2101,7 @@ PCB_IO::~PCB_IO()
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
-    FILE_LINE_READER    reader( aFileName );
+    MMAP_LINE_READER    reader( aFileName );
 
     init( aProperties );
 
@@ -2090,7 +2154,7 @@ void PCB_IO::init( const PROPERTIES* aProperties )
 
 void PCB_IO::validateCache( const wxString& aLibraryPath, bool checkModified )
 {
-    if( !m_cache || !m_cache->IsPath( aLibraryPath ) || ( checkModified && m_cache->IsModified() ) )
+    if( !m_cache || !m_cache->IsPath( aLibraryPath ) || ( checkModified && !m_cache->Update() ) )
     {
         // a spectacular episode in memory management:
         delete m_cache;
@@ -2103,7 +2167,6 @@ void PCB_IO::validateCache( const wxString& aLibraryPath, bool checkModified )
 void PCB_IO::FootprintEnumerate( wxArrayString& aFootprintNames, const wxString& aLibPath,
                                  bool aBestEfforts, const PROPERTIES* aProperties )
 {
-    LOCALE_IO toggle;     // toggles on, then off, the C locale.
     wxDir     dir( aLibPath );
     wxString  errorMsg;
 
@@ -2134,8 +2197,6 @@ const MODULE* PCB_IO::getFootprint( const wxString& aLibraryPath,
                                     const PROPERTIES* aProperties,
                                     bool checkModified )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     try
@@ -33,6 +33,7 @@
 #include <pcb_edit_frame.h>
 #include <pcbnew.h>
 #include <pcbnew_id.h>
+#include <pcbnew_settings.h>
 #include <pgm_base.h>
 #include <tool/actions.h>
 #include <tool/conditional_menu.h>
@@ -241,6 +242,7 @@ void PCB_EDIT_FRAME::ReCreateMenuBar()
 
     editMenu->AddSeparator();
     editMenu->AddItem( PCB_ACTIONS::zoneFillAll,            SELECTION_CONDITIONS::ShowAlways );
+    editMenu->AddItem( PCB_ACTIONS::zoneRefillAll,          SELECTION_CONDITIONS::ShowAlways );
     editMenu->AddItem( PCB_ACTIONS::zoneUnfillAll,          SELECTION_CONDITIONS::ShowAlways );
 
     editMenu->AddSeparator();
@@ -470,8 +472,14 @@ void PCB_EDIT_FRAME::ReCreateMenuBar()
     inspectMenu->AddItem( ACTIONS::measureTool,              SELECTION_CONDITIONS::ShowAlways );
     inspectMenu->AddItem( PCB_ACTIONS::boardStatistics,      SELECTION_CONDITIONS::ShowAlways );
 
+    auto liveDrcCondition = [ this ]( const SELECTION &aSel )
+    {
+        return GetSettings()->m_DrcDialog.live_drc;
+    };
+
     inspectMenu->AddSeparator();
     inspectMenu->AddItem( PCB_ACTIONS::runDRC,               SELECTION_CONDITIONS::ShowAlways );
+    inspectMenu->AddCheckItem( PCB_ACTIONS::toggleLiveDRC,   liveDrcCondition );
 
     inspectMenu->Resolve();
 
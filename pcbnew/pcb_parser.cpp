@@ -27,7 +27,8 @@
  * @brief Pcbnew s-expression file format parser implementation.
  */
 
-#include <cerrno>
+#include <cmath>
+#include <cstdlib>
 #include <common.h>
 #include <confirm.h>
 #include <macros.h>
@@ -51,10 +52,85 @@
 #include <pcb_parser.h>
 #include <convert_basic_shapes_to_polygon.h>    // for RECT_CHAMFER_POSITIONS definition
 #include <template_fieldnames.h>
+#include <thread_pool.h>
+
+#include <mutex>
 
 using namespace PCB_KEYS_T;
 
 
+/**
+ * Thrown on a worker thread when a deferred item needs something only the main thread
+ * may do, such as prompting the user or adding a net to the board.
+ */
+struct DEFER_TO_MAIN_THREAD
+{
+};
+
+
+/**
+ * SPAN_LINE_READER
+ * reads lines from a span of memory owned by another LINE_READER (see
+ * LINE_READER::HoldsWholeSource()), so deferred board items can be parsed on worker
+ * threads without copying them.
+ */
+class SPAN_LINE_READER : public LINE_READER
+{
+    const char* m_ndx;
+    const char* m_end;
+
+public:
+    SPAN_LINE_READER( const wxString& aSource ) :
+        LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
+        m_ndx( nullptr ),
+        m_end( nullptr )
+    {
+        m_source = aSource;
+    }
+
+    void SetSpan( const char* aStart, const char* aEnd, int aLineNumber )
+    {
+        m_ndx = aStart;
+        m_end = aEnd;
+        m_lineNum = aLineNumber - 1;    // incremented by the first ReadLine()
+    }
+
+    const char* ReadLineNoCopy( unsigned* aLength ) override
+    {
+        const char* line = m_ndx;
+        const char* nl = (const char*) memchr( m_ndx, '\n', m_end - m_ndx );
+
+        m_length = nl ? nl - m_ndx + 1 : m_end - m_ndx;
+        m_ndx += m_length;
+        ++m_lineNum;
+
+        *aLength = m_length;
+        return m_length ? line : nullptr;
+    }
+
+    char* ReadLine() override
+    {
+        unsigned    len;
+        const char* line = ReadLineNoCopy( &len );
+
+        if( len + 1 > m_capacity )
+            expandCapacity( len + 1 );
+
+        if( len )
+            memcpy( m_line, line, len );
+
+        m_line[len] = 0;
+
+        return line ? m_line : nullptr;
+    }
+
+    bool HoldsWholeSource() const override
+    {
+        return true;
+    }
+};
+
+
 void PCB_PARSER::init()
 {
     m_showLegacyZoneWarning = true;
@@ -114,6 +190,177 @@ void PCB_PARSER::init()
 }
 
 
+void PCB_PARSER::copyParseState( const PCB_PARSER& aParser )
+{
+    m_board                 = aParser.m_board;
+    m_layerIndices          = aParser.m_layerIndices;
+    m_layerMasks            = aParser.m_layerMasks;
+    m_netCodes              = aParser.m_netCodes;
+    m_tooRecent             = aParser.m_tooRecent;
+    m_requiredVersion       = aParser.m_requiredVersion;
+    m_showLegacyZoneWarning = aParser.m_showLegacyZoneWarning;
+}
+
+
+BOARD_ITEM* PCB_PARSER::parseDeferredItem()
+{
+    NeedLEFT();
+
+    switch( NextTok() )
+    {
+    case T_module:  return parseMODULE();
+    case T_segment: return parseTRACK();
+    case T_arc:     return parseARC();
+    case T_via:     return parseVIA();
+    case T_zone:    return parseZONE_CONTAINER( m_board );
+    default:        Unexpected( CurText() );
+    }
+
+    return nullptr;
+}
+
+
+void PCB_PARSER::parseDeferredItems()
+{
+    struct RESULT
+    {
+        std::unique_ptr<BOARD_ITEM> m_item;
+        std::exception_ptr          m_error;
+        bool                        m_needsMainThread = false;
+    };
+
+    // Items are parsed in blocks, each with its own parser, to share the cost of setting one up
+    const size_t        blockSize = 256;
+    const size_t        count = m_deferredItems.size();
+    const wxString      source = CurSource();
+    std::vector<RESULT> results( count );
+    std::mutex          undefinedLayersLock;
+
+    auto parseBlock = [&]( size_t aBlock )
+    {
+        SPAN_LINE_READER reader( source );
+        PCB_PARSER       parser( &reader );
+        size_t           last = std::min( count, ( aBlock + 1 ) * blockSize );
+
+        parser.copyParseState( *this );
+        parser.m_isWorker = true;
+
+        for( size_t ii = aBlock * blockSize; ii < last; ++ii )
+        {
+            const DEFERRED_ITEM& deferred = m_deferredItems[ii];
+            RESULT&              result = results[ii];
+
+            reader.SetSpan( deferred.m_start, deferred.m_end, deferred.m_line );
+            parser.SetLineReader( &reader );
+
+            try
+            {
+                result.m_item.reset( parser.parseDeferredItem() );
+
+                // A footprint may raise the required version, which would change how
+                // later items are parsed.
+                if( parser.m_requiredVersion != m_requiredVersion )
+                {
+                    result.m_needsMainThread = true;
+                    parser.m_requiredVersion = m_requiredVersion;
+                    parser.m_tooRecent = m_tooRecent;
+                }
+            }
+            catch( const DEFER_TO_MAIN_THREAD& )
+            {
+                result.m_needsMainThread = true;
+            }
+            catch( ... )
+            {
+                result.m_error = std::current_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock( undefinedLayersLock );
+        m_undefinedLayers.insert( parser.m_undefinedLayers.begin(),
+                                  parser.m_undefinedLayers.end() );
+    };
+
+    // Every error is kept in its item's result, so the group is never cancelled
+    TASK_GROUP parseTasks( nullptr, false );
+
+    parseTasks.ParallelFor( ( count + blockSize - 1 ) / blockSize, parseBlock );
+    parseTasks.Wait();
+
+    // Merge in file order.  Items the workers could not handle are parsed here, on the main
+    // thread.  If doing so changes the parser state (e.g. a zone creates a missing net) then
+    // every later item is re-parsed here too, since the workers parsed them with the old state.
+    std::unique_ptr<SPAN_LINE_READER> serialReader;
+    std::unique_ptr<PCB_PARSER>       serialParser;
+    bool                              stateChanged = false;
+
+    for( size_t ii = 0; ii < count; ++ii )
+    {
+        RESULT&     result = results[ii];
+        BOARD_ITEM* item;
+
+        if( stateChanged || result.m_needsMainThread )
+        {
+            const DEFERRED_ITEM& deferred = m_deferredItems[ii];
+
+            if( !serialParser )
+            {
+                serialReader.reset( new SPAN_LINE_READER( source ) );
+                serialParser.reset( new PCB_PARSER( serialReader.get() ) );
+                serialParser->copyParseState( *this );
+            }
+
+            unsigned netCount = m_board->GetNetCount();
+
+            serialReader->SetSpan( deferred.m_start, deferred.m_end, deferred.m_line );
+            serialParser->SetLineReader( serialReader.get() );
+
+            item = serialParser->parseDeferredItem();
+
+            if( !stateChanged )
+            {
+                stateChanged = m_board->GetNetCount() != netCount
+                               || serialParser->m_netCodes != m_netCodes
+                               || serialParser->m_requiredVersion != m_requiredVersion;
+            }
+        }
+        else if( result.m_error )
+        {
+            std::rethrow_exception( result.m_error );
+        }
+        else
+        {
+            item = result.m_item.release();
+        }
+
+        switch( item->Type() )
+        {
+        case PCB_TRACE_T:
+        case PCB_ARC_T:
+        case PCB_VIA_T:
+            m_board->Add( item, ADD_MODE::INSERT );
+            break;
+
+        default:
+            m_board->Add( item, ADD_MODE::APPEND );
+            break;
+        }
+    }
+
+    if( serialParser )
+    {
+        m_netCodes              = serialParser->m_netCodes;
+        m_tooRecent             = serialParser->m_tooRecent;
+        m_requiredVersion       = serialParser->m_requiredVersion;
+        m_showLegacyZoneWarning = serialParser->m_showLegacyZoneWarning;
+        m_undefinedLayers.insert( serialParser->m_undefinedLayers.begin(),
+                                  serialParser->m_undefinedLayers.end() );
+    }
+
+    m_deferredItems.clear();
+}
+
+
 void PCB_PARSER::skipCurrent()
 {
     int curr_level = 0;
@@ -149,25 +396,25 @@ void PCB_PARSER::pushValueIntoMap( int aIndex, int aValue )
 
 double PCB_PARSER::parseDouble()
 {
-    char* tmp;
-
-    errno = 0;
+    double fval = 0.0;
 
-    double fval = strtod( CurText(), &tmp );
+    // Don't use strtod(): it honours the global C locale and would require a LOCALE_IO
+    // guard, which serializes loading across threads.
+    const char* tmp = ParseDoubleNoLocale( CurText(), &fval );
 
-    if( errno )
+    if( CurText() == tmp )
     {
         wxString error;
-        error.Printf( _( "Invalid floating point number in\nfile: \"%s\"\nline: %d\noffset: %d" ),
+        error.Printf( _( "Missing floating point number in\nfile: \"%s\"\nline: %d\noffset: %d" ),
                       GetChars( CurSource() ), CurLineNumber(), CurOffset() );
 
         THROW_IO_ERROR( error );
     }
 
-    if( CurText() == tmp )
+    if( !std::isfinite( fval ) )
     {
         wxString error;
-        error.Printf( _( "Missing floating point number in\nfile: \"%s\"\nline: %d\noffset: %d" ),
+        error.Printf( _( "Invalid floating point number in\nfile: \"%s\"\nline: %d\noffset: %d" ),
                       GetChars( CurSource() ), CurLineNumber(), CurOffset() );
 
         THROW_IO_ERROR( error );
@@ -469,7 +716,6 @@ BOARD_ITEM* PCB_PARSER::Parse()
 {
     T               token;
     BOARD_ITEM*     item;
-    LOCALE_IO       toggle;
 
     // MODULEs can be prefixed with an initial block of single line comments and these
     // are kept for Format() so they round trip in s-expression form.  BOARDs might
@@ -526,13 +772,67 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
 
     parseHeader();
 
+    // Modules, tracks, vias and zones make up the bulk of a board.  When the whole file is
+    // in memory they are only delimited here and parsed later on worker threads.
+    bool deferItems = m_multiThreaded && reader && reader->HoldsWholeSource()
+                      && THREAD_POOL::GetInstance().GetThreadCount() > 1;
+
+    m_deferredItems.clear();
+
     for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
     {
         if( token != T_LEFT )
             Expecting( T_LEFT );
 
+        // Start deferred items at the beginning of their line when possible so error
+        // offsets match a serial parse.
+        const char* itemStart = start;
+        int         itemLine = CurLineNumber();
+
+        for( const char* cc = start; cc < start + curOffset; ++cc )
+        {
+            if( !isspace( (unsigned char) *cc ) )
+            {
+                itemStart = start + curOffset;
+                break;
+            }
+        }
+
         token = NextTok();
 
+        if( deferItems )
+        {
+            switch( token )
+            {
+            case T_module:
+            case T_segment:
+            case T_arc:
+            case T_via:
+            case T_zone:
+                skipSexpression();
+                m_deferredItems.push_back( { itemStart, next, itemLine } );
+                continue;
+
+            case T_gr_arc:
+            case T_gr_circle:
+            case T_gr_curve:
+            case T_gr_line:
+            case T_gr_poly:
+            case T_gr_text:
+            case T_dimension:
+            case T_target:
+                // Graphics live in their own list and don't change the parser state, so
+                // there is no need to flush the deferred items before them.
+                break;
+
+            default:
+                // Sections such as nets or layers change how later items are parsed, so
+                // everything deferred so far must be parsed first.
+                parseDeferredItems();
+                break;
+            }
+        }
+
         switch( token )
         {
         case T_general:
@@ -610,6 +910,8 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
         }
     }
 
+    parseDeferredItems();
+
     if( m_undefinedLayers.size() > 0 )
     {
         bool deleteItems;
@@ -3769,6 +4071,9 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent )
 
                     if( token == T_segment )    // deprecated
                     {
+                        if( m_isWorker )
+                            throw DEFER_TO_MAIN_THREAD();
+
                         // SEGMENT fill mode no longer supported.  Make sure user is OK with converting them.
                         if( m_showLegacyZoneWarning )
                         {
@@ -3836,6 +4141,12 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent )
                     NeedRIGHT();
                     break;
 
+                case T_input_hash:
+                    NeedSYMBOLorNUMBER();
+                    zone->SetFillInputHash( std::strtoull( CurText(), nullptr, 16 ) );
+                    NeedRIGHT();
+                    break;
+
                 case T_smoothing:
                     switch( NextTok() )
                     {
@@ -3868,7 +4179,7 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent )
 
                 default:
                     Expecting( "mode, arc_segments, thermal_gap, thermal_bridge_width, "
-                               "hatch_thickness, hatch_gap, hatch_orientation, "
+                               "input_hash, hatch_thickness, hatch_gap, hatch_orientation, "
                                "hatch_smoothing_level, hatch_smoothing_value, smoothing, or radius" );
                 }
             }
@@ -4027,6 +4338,9 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent )
             zone->SetNetCode( net->GetNet() );
         else    // Not existing net: add a new net to keep trace of the zone netname
         {
+            if( m_isWorker )
+                throw DEFER_TO_MAIN_THREAD();
+
             int newnetcode = m_board->GetNetCount();
             net = new NETINFO_ITEM( m_board, netnameFromfile, newnetcode );
             m_board->Add( net );
@@ -32,11 +32,13 @@
 
 #include <convert_to_biu.h>                      // IU_PER_MM
 #include <hashtables.h>
+#include <kicad_string.h>                       // ParseLongNoLocale
 #include <layers_id_colors_and_visibility.h>     // PCB_LAYER_ID
 #include <math/util.h>                           // KiROUND, Clamp
 #include <pcb_lexer.h>
 
 #include <unordered_map>
+#include <vector>
 
 
 class ARC;
@@ -81,6 +83,18 @@ class PCB_PARSER : public PCB_LEXER
 
     bool                m_showLegacyZoneWarning;
 
+    /// A top level board item whose parsing has been deferred to a worker thread.
+    struct DEFERRED_ITEM
+    {
+        const char* m_start;    ///< start of the item's text in the reader's buffer
+        const char* m_end;      ///< one past the item's closing parenthesis
+        int         m_line;     ///< line number of m_start
+    };
+
+    std::vector<DEFERRED_ITEM> m_deferredItems;   ///< deferred items, in file order
+    bool                m_multiThreaded;    ///< true to parse board items in parallel
+    bool                m_isWorker;         ///< true when running on a worker thread
+
     ///> Converts net code using the mapping table if available,
     ///> otherwise returns unchanged net code if < 0 or if is is out of range
     inline int getNetCode( int aNetCode )
@@ -108,6 +122,29 @@ class PCB_PARSER : public PCB_LEXER
      */
     void init();
 
+    /**
+     * Function copyParseState
+     * copies everything needed to parse board items (board, layer maps, net code
+     * mapping and version) from @a aParser.
+     */
+    void copyParseState( const PCB_PARSER& aParser );
+
+    /**
+     * Function parseDeferredItems
+     * parses the items in m_deferredItems in the THREAD_POOL and adds them to the board
+     * in file order.  Items which cannot safely be parsed off the main thread (for instance
+     * because they need to ask the user something or create a net) are parsed on the main
+     * thread instead, so the resulting board is identical to a serial parse.
+     */
+    void parseDeferredItems();
+
+    /**
+     * Function parseDeferredItem
+     * parses one deferred top level item from the current LINE_READER, which must be
+     * positioned at its opening parenthesis.
+     */
+    BOARD_ITEM* parseDeferredItem();
+
     /**
      * Creates a mapping from the (short-lived) bug where layer names were translated
      * TODO: Remove this once we support custom layer names
@@ -234,7 +271,8 @@ class PCB_PARSER : public PCB_LEXER
     /**
      * Function parseDouble
      * parses the current token as an ASCII numeric string with possible leading
-     * whitespace into a double precision floating point number.
+     * whitespace into a double precision floating point number.  The global C locale
+     * is not used, so no #LOCALE_IO is required.
      *
      * @throw IO_ERROR if an error occurs attempting to convert the current token.
      * @return The result of the parsed token.
@@ -292,7 +330,9 @@ class PCB_PARSER : public PCB_LEXER
 
     inline int parseInt()
     {
-        return (int)strtol( CurText(), NULL, 10 );
+        long val = 0;
+        ParseLongNoLocale( CurText(), &val, 10 );
+        return (int) val;
     }
 
     inline int parseInt( const char* aExpected )
@@ -304,7 +344,10 @@ class PCB_PARSER : public PCB_LEXER
     inline long parseHex()
     {
         NextTok();
-        return strtol( CurText(), NULL, 16 );
+
+        long val = 0;
+        ParseLongNoLocale( CurText(), &val, 16 );
+        return val;
     }
 
     bool parseBool();
@@ -319,7 +362,9 @@ public:
 
     PCB_PARSER( LINE_READER* aReader = NULL ) :
         PCB_LEXER( aReader ),
-        m_board( 0 )
+        m_board( 0 ),
+        m_multiThreaded( true ),
+        m_isWorker( false )
     {
         init();
     }
@@ -345,6 +390,17 @@ public:
         m_board = aBoard;
     }
 
+    /**
+     * Function SetMultiThreaded
+     * enables or disables parsing of modules, tracks, vias and zones on worker threads.
+     * This only has an effect when the LINE_READER holds the whole source in memory.
+     * The resulting board is the same either way.
+     */
+    void SetMultiThreaded( bool aEnable )
+    {
+        m_multiThreaded = aEnable;
+    }
+
     BOARD_ITEM* Parse();
     /**
      * Function parseMODULE
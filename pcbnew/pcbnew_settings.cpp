@@ -178,6 +178,9 @@ PCBNEW_SETTINGS::PCBNEW_SETTINGS() : APP_SETTINGS_BASE( "pcbnew", pcbnewSchemaVe
     m_params.emplace_back( new PARAM<bool>( "drc_dialog.test_footprints",
             &m_DrcDialog.test_footprints, false ) );
 
+    m_params.emplace_back( new PARAM<bool>( "drc_dialog.live_drc",
+            &m_DrcDialog.live_drc, false ) );
+
     m_params.emplace_back( new PARAM<int>( "drc_dialog.severities",
             &m_DrcDialog.severities, RPT_SEVERITY_ERROR | RPT_SEVERITY_WARNING ) );
 
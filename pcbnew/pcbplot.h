@@ -38,6 +38,9 @@
 #include <settings/settings_manager.h>
 #include <wx/filename.h>
 
+#include <functional>
+#include <vector>
+
 class PLOTTER;
 class TEXTE_PCB;
 class D_PAD;
@@ -158,6 +161,34 @@ PLOTTER* StartPlotBoard( BOARD* aBoard,
                          const wxString& aFullFileName,
                          const wxString& aSheetDesc );
 
+/**
+ * A board layer to plot to its own file, with PlotBoardLayers()
+ */
+struct PLOT_LAYER_JOB
+{
+    PCB_LAYER_ID m_Layer;
+    wxString     m_FullPath;
+    bool         m_Created;     ///< set if the file was plotted
+};
+
+/**
+ * Function PlotBoardLayers
+ * plots each layer of aJobs to its file.
+ * The Gerber layers are plotted concurrently, except those whose plot changes the board
+ * settings or the geometry options: the solder masks with a minimum width are plotted once
+ * the others are done.
+ * @param aBoard = the board to plot
+ * @param aPlotOpts = the plot options
+ * @param aJobs = the layers to plot and their files
+ * @param aReport = if set, is called for each layer once it is plotted, in the order of aJobs,
+ *                  from the calling thread
+ * @param aConcurrent = false to plot the layers one after the other
+ */
+void PlotBoardLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                      std::vector<PLOT_LAYER_JOB>& aJobs,
+                      const std::function<void( const PLOT_LAYER_JOB& )>& aReport = nullptr,
+                      bool aConcurrent = true );
+
 /**
  * Function PlotOneBoardLayer
  * main function to plot one copper or technical layer.
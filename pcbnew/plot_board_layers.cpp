@@ -53,6 +53,7 @@
 #include <pcbnew.h>
 #include <pcbplot.h>
 #include <gbr_metadata.h>
+#include <thread_pool.h>
 
 /*
  * Plot a solder mask layer.  Solder mask layers have a minimum thickness value and cannot be
@@ -153,6 +154,75 @@ void PlotSilkScreen( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
     aPlotter->EndBlock( NULL );
 }
 
+/*
+ * PlotSolderMaskLayer() changes the max error of the board and the arc radius correction
+ * of the polygon conversions while it runs, which the other layers read: it must not run
+ * beside another plot.
+ */
+static bool plotChangesBoardSettings( BOARD* aBoard, PCB_LAYER_ID aLayer )
+{
+    return ( aLayer == F_Mask || aLayer == B_Mask )
+            && aBoard->GetDesignSettings().m_SolderMaskMinWidth > 0;
+}
+
+
+void PlotBoardLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                      std::vector<PLOT_LAYER_JOB>& aJobs,
+                      const std::function<void( const PLOT_LAYER_JOB& )>& aReport,
+                      bool aConcurrent )
+{
+    // The locale is global: switch it once for all the plots
+    LOCALE_IO toggle;
+
+    auto plotJob =
+            [&]( PLOT_LAYER_JOB& aJob )
+            {
+                PLOTTER* plotter = StartPlotBoard( aBoard, aPlotOpts, aJob.m_Layer,
+                                                   aJob.m_FullPath, wxEmptyString );
+
+                aJob.m_Created = plotter != nullptr;
+
+                if( plotter )
+                {
+                    PlotOneBoardLayer( aBoard, plotter, aJob.m_Layer, *aPlotOpts );
+                    plotter->EndPlot();
+                    delete plotter;
+                }
+            };
+
+    // The Gerber plotter keeps its whole state in its own instance, and the layers only read
+    // the board
+    std::vector<bool> concurrent( aJobs.size(), false );
+
+    if( aConcurrent && aPlotOpts->GetFormat() == PLOT_FORMAT::GERBER )
+    {
+        TASK_GROUP plotTasks( nullptr, false );
+
+        for( size_t ii = 0; ii < aJobs.size(); ++ii )
+        {
+            if( plotChangesBoardSettings( aBoard, aJobs[ii].m_Layer ) )
+                continue;
+
+            PLOT_LAYER_JOB& job = aJobs[ii];
+
+            concurrent[ii] = true;
+            plotTasks.Run( [&plotJob, &job]() { plotJob( job ); } );
+        }
+
+        plotTasks.Wait();
+    }
+
+    for( size_t ii = 0; ii < aJobs.size(); ++ii )
+    {
+        if( !concurrent[ii] )
+            plotJob( aJobs[ii] );
+
+        if( aReport )
+            aReport( aJobs[ii] );
+    }
+}
+
+
 void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
                         const PCB_PLOT_PARAMS& aPlotOpt )
 {
@@ -332,11 +402,16 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
     {
         aPlotter->StartBlock( NULL );
 
-        for( auto pad : module->Pads() )
+        for( D_PAD* boardPad : module->Pads() )
         {
-            if( (pad->GetLayerSet() & aLayerMask) == 0 )
+            if( ( boardPad->GetLayerSet() & aLayerMask ) == 0 )
                 continue;
 
+            // The size of the pad is changed to the plot size below: change a copy, so that
+            // the board is left untouched while other layers may be plotted from it
+            D_PAD  padCopy( *boardPad );
+            D_PAD* pad = &padCopy;
+
             wxSize margin;
             double width_adj = 0;
 
@@ -363,11 +438,6 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             extraSize.x += width_adj;
             extraSize.y += width_adj;
 
-            // Store these parameters that can be modified to plot inflated/deflated pads shape
-            wxSize deltaSize = pad->GetDelta(); // has meaning only for trapezoidal pads
-            PAD_SHAPE_T padShape = pad->GetShape();
-            double padCornerRadius = pad->GetRoundRectCornerRadius();
-
             if( pad->GetShape() == PAD_SHAPE_TRAPEZOID )
             {   // The easy way is to use BuildPadPolygon to calculate
                 // size and delta of the trapezoidal pad after offseting:
@@ -416,9 +486,7 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             if( pad->GetLayerSet()[F_Cu] )
                 color = color.LegacyMix( aPlotOpt.ColorSettings()->GetColor( LAYER_PAD_FR ) );
 
-            // Temporary set the pad size to the required plot size:
-            wxSize tmppadsize = pad->GetSize();
-
+            // Set the pad size to the required plot size:
             switch( pad->GetShape() )
             {
             case PAD_SHAPE_CIRCLE:
@@ -475,12 +543,6 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             }
                 break;
             }
-
-            // Restore the pad parameters modified by the plot code
-            pad->SetSize( tmppadsize );
-            pad->SetDelta( deltaSize );
-            pad->SetShape( padShape );
-            pad->SetRoundRectCornerRadius( padCornerRadius );
         }
 
         aPlotter->EndBlock( NULL );
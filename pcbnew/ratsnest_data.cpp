@@ -38,6 +38,7 @@ using namespace std::placeholders;
 
 #include <cassert>
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 static uint64_t getDistance( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& aNode2 )
@@ -49,143 +50,537 @@ static uint64_t getDistance( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& a
 }
 
 
-static bool sortWeight( const CN_EDGE& aEdge1, const CN_EDGE& aEdge2 )
-{
-    return aEdge1.GetWeight() < aEdge2.GetWeight();
-}
-
-
-static const std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
+static const std::vector<CN_EDGE> kruskalMST( std::vector<CN_EDGE>& aEdges,
         std::vector<CN_ANCHOR_PTR>& aNodes )
 {
     unsigned int    nodeNumber = aNodes.size();
-    unsigned int    mstExpectedSize = nodeNumber - 1;
-    unsigned int    mstSize = 0;
+    unsigned int    forestCount = nodeNumber;
     bool ratsnestLines = false;
 
     // The output
     std::vector<CN_EDGE> mst;
 
-    // Set tags for marking cycles
-    std::unordered_map<CN_ANCHOR_PTR, int> tags;
-    unsigned int tag = 0;
+    // The tags index the nodes until the connected items are known
+    for( unsigned int i = 0; i < nodeNumber; ++i )
+        aNodes[i]->SetTag( i );
+
+    // A flat copy of the edges, with the nodes replaced by their index
+    struct FLAT_EDGE
+    {
+        unsigned int m_source;
+        unsigned int m_target;
+        int          m_weight;
+        unsigned int m_edge;    // index in aEdges
+    };
+
+    std::vector<FLAT_EDGE> edges;
+    edges.reserve( aEdges.size() );
 
-    for( auto& node : aNodes )
+    for( unsigned int i = 0; i < aEdges.size(); ++i )
     {
-        node->SetTag( tag );
-        tags[node] = tag++;
+        const CN_EDGE& edge = aEdges[i];
+
+        edges.push_back( { (unsigned int) edge.GetSourceNode()->GetTag(),
+                           (unsigned int) edge.GetTargetNode()->GetTag(),
+                           edge.GetWeight(), i } );
     }
 
-    // Lists of nodes connected together (subtrees) to detect cycles in the graph
-    std::vector<std::list<int> > cycles( nodeNumber );
+    // Kruskal algorithm requires edges to be sorted by their weight.  The sort is stable so the
+    // choice between edges of equal weight does not depend on the sort implementation.
+    std::stable_sort( edges.begin(), edges.end(),
+                      []( const FLAT_EDGE& aEdge1, const FLAT_EDGE& aEdge2 )
+                      {
+                          return aEdge1.m_weight < aEdge2.m_weight;
+                      } );
 
-    for( unsigned int i = 0; i < nodeNumber; ++i )
-        cycles[i].push_back( i );
+    // Forests of nodes connected together, as a disjoint-set with path halving and union by
+    // size, to detect cycles in the graph
+    std::vector<unsigned int> parent( nodeNumber );
+    std::vector<unsigned int> size( nodeNumber, 1 );
 
-    // Kruskal algorithm requires edges to be sorted by their weight
-    aEdges.sort( sortWeight );
+    for( unsigned int i = 0; i < nodeNumber; ++i )
+        parent[i] = i;
 
-    while( mstSize < mstExpectedSize && !aEdges.empty() )
+    auto find = [&]( unsigned int aNode )
+                {
+                    while( parent[aNode] != aNode )
+                    {
+                        parent[aNode] = parent[parent[aNode]];
+                        aNode = parent[aNode];
+                    }
+
+                    return aNode;
+                };
+
+    // Once the connected items are processed, the forests are the connected groups of nodes
+    auto tagConnectedNodes = [&]()
+                             {
+                                 for( unsigned int i = 0; i < nodeNumber; ++i )
+                                     aNodes[i]->SetTag( find( i ) );
+                             };
+
+    for( const FLAT_EDGE& dt : edges )
     {
-        //printf("mstSize %d %d\n", mstSize, mstExpectedSize);
-        auto& dt = aEdges.front();
+        if( forestCount <= 1 )
+            break;
 
-        int srcTag  = tags[dt.GetSourceNode()];
-        int trgTag  = tags[dt.GetTargetNode()];
+        // Because edges are sorted by their weight, first we always process connected
+        // items (weight == 0). Once we stumble upon an edge with non-zero weight,
+        // it means that the rest of the lines are ratsnest.
+        if( !ratsnestLines && dt.m_weight != 0 )
+        {
+            ratsnestLines = true;
+            tagConnectedNodes();
+        }
+
+        unsigned int srcForest = find( dt.m_source );
+        unsigned int trgForest = find( dt.m_target );
 
         // Check if by adding this edge we are going to join two different forests
-        if( srcTag != trgTag )
-        {
-            // Because edges are sorted by their weight, first we always process connected
-            // items (weight == 0). Once we stumble upon an edge with non-zero weight,
-            // it means that the rest of the lines are ratsnest.
-            if( !ratsnestLines && dt.GetWeight() != 0 )
-                ratsnestLines = true;
-
-            // Update tags
-            if( ratsnestLines )
-            {
-                for( auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it )
-                {
-                    tags[aNodes[*it]] = srcTag;
-                }
+        if( srcForest == trgForest )
+            continue;
 
-                // Do a copy of edge, but make it RN_EDGE_MST. In contrary to RN_EDGE,
-                // RN_EDGE_MST saves both source and target node and does not require any other
-                // edges to exist for getting source/target nodes
-                CN_EDGE newEdge ( dt.GetSourceNode(), dt.GetTargetNode(), dt.GetWeight() );
+        if( size[srcForest] < size[trgForest] )
+            std::swap( srcForest, trgForest );
 
-                assert( newEdge.GetSourceNode()->GetTag() != newEdge.GetTargetNode()->GetTag() );
-                assert( newEdge.GetWeight() > 0 );
+        parent[trgForest] = srcForest;
+        size[srcForest] += size[trgForest];
+        --forestCount;
 
-                mst.push_back( newEdge );
-                ++mstSize;
-            }
-            else
-            {
-                // for( it = cycles[trgTag].begin(), itEnd = cycles[trgTag].end(); it != itEnd; ++it )
-                // for( auto it : cycles[trgTag] )
-                for( auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it )
-                {
-                    tags[aNodes[*it]] = srcTag;
-                    aNodes[*it]->SetTag( srcTag );
-                }
+        if( ratsnestLines )
+        {
+            const CN_EDGE& edge = aEdges[dt.m_edge];
 
-                // Processing a connection, decrease the expected size of the ratsnest MST
-                --mstExpectedSize;
-            }
+            // Do a copy of edge, but make it RN_EDGE_MST. In contrary to RN_EDGE,
+            // RN_EDGE_MST saves both source and target node and does not require any other
+            // edges to exist for getting source/target nodes
+            CN_EDGE newEdge( edge.GetSourceNode(), edge.GetTargetNode(), edge.GetWeight() );
 
-            // Move nodes that were marked with old tag to the list marked with the new tag
-            cycles[srcTag].splice( cycles[srcTag].end(), cycles[trgTag] );
-        }
+            assert( newEdge.GetSourceNode()->GetTag() != newEdge.GetTargetNode()->GetTag() );
+            assert( newEdge.GetWeight() > 0 );
 
-        // Remove the edge that was just processed
-        aEdges.erase( aEdges.begin() );
+            mst.push_back( newEdge );
+        }
     }
 
-    // Probably we have discarded some of edges, so reduce the size
-    mst.resize( mstSize );
+    if( !ratsnestLines )
+        tagConnectedNodes();
 
     return mst;
 }
 
 
+/**
+ * Orders positions by their y, then x coordinate.
+ */
+static bool comparePositions( const VECTOR2I& aPos1, const VECTOR2I& aPos2 )
+{
+    if( aPos1.y != aPos2.y )
+        return aPos1.y < aPos2.y;
+
+    return aPos1.x < aPos2.x;
+}
+
+
+/**
+ * Checks if all the positions listed in aSubset lie on a single line.  Requires the
+ * positions to be unique.
+ */
+static bool arePositionsColinear( const std::vector<VECTOR2I>& aPositions,
+                                  const std::vector<int>& aSubset )
+{
+    if( aSubset.size() <= 2 )
+        return true;
+
+    const VECTOR2I p0 = aPositions[aSubset[0]];
+    const VECTOR2I v0 = aPositions[aSubset[1]] - p0;
+
+    for( unsigned i = 2; i < aSubset.size(); i++ )
+    {
+        if( v0.Cross( aPositions[aSubset[i]] - p0 ) != 0 )
+            return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * Checks if aPoint lies strictly inside the circumcircle of the triangle aA, aB, aC.  Points
+ * which are cocircular within the rounding error are considered outside.
+ */
+static bool inCircumcircle( const VECTOR2I& aA, const VECTOR2I& aB, const VECTOR2I& aC,
+                            const VECTOR2I& aPoint )
+{
+    const double adx = (double) aA.x - aPoint.x;
+    const double ady = (double) aA.y - aPoint.y;
+    const double bdx = (double) aB.x - aPoint.x;
+    const double bdy = (double) aB.y - aPoint.y;
+    const double cdx = (double) aC.x - aPoint.x;
+    const double cdy = (double) aC.y - aPoint.y;
+
+    const double alift = adx * adx + ady * ady;
+    const double blift = bdx * bdx + bdy * bdy;
+    const double clift = cdx * cdx + cdy * cdy;
+
+    const double det = alift * ( bdx * cdy - bdy * cdx )
+                     + blift * ( cdx * ady - cdy * adx )
+                     + clift * ( adx * bdy - ady * bdx );
+
+    const double permanent = alift * ( std::abs( bdx * cdy ) + std::abs( bdy * cdx ) )
+                           + blift * ( std::abs( cdx * ady ) + std::abs( cdy * adx ) )
+                           + clift * ( std::abs( adx * bdy ) + std::abs( ady * bdx ) );
+
+    const double orientation = ( bdx - adx ) * ( cdy - ady ) - ( bdy - ady ) * ( cdx - adx );
+
+    if( orientation < 0 )
+        return -det > 1e-12 * permanent;
+    else
+        return det > 1e-12 * permanent;
+}
+
+
 class RN_NET::TRIANGULATOR_STATE
 {
 private:
     std::vector<CN_ANCHOR_PTR>  m_allNodes;
 
-    std::list<hed::EDGE_PTR> hedTriangulation( std::vector<hed::NODE_PTR>& aNodes )
+    ///> Unique anchor positions of the previous triangulation, in comparePositions() order
+    std::vector<VECTOR2I>               m_positions;
+
+    ///> Edges between m_positions, a superset of their Delaunay triangulation
+    std::vector<std::pair<int, int>>    m_edges;
+
+    ///> Number of positions added or removed by incremental updates since the last full
+    ///> triangulation
+    size_t                              m_updatedPositions = 0;
+
+    bool                                m_valid = false;
+
+    using EDGE_LIST = std::vector<std::pair<int, int>>;
+
+    /**
+     * Creates the hed nodes of the positions listed in aSubset, their id being their index in
+     * aPositions.
+     */
+    static std::vector<hed::NODE_PTR> makeNodes( const std::vector<VECTOR2I>& aPositions,
+                                                 const std::vector<int>& aSubset )
+    {
+        std::vector<hed::NODE_PTR> nodes;
+
+        nodes.reserve( aSubset.size() );
+
+        for( int index : aSubset )
+        {
+            auto node = std::make_shared<hed::NODE>( aPositions[index].x, aPositions[index].y );
+
+            node->SetId( index );
+            nodes.push_back( node );
+        }
+
+        return nodes;
+    }
+
+    /**
+     * Appends to aEdges the edges of the Delaunay triangulation of the positions listed in
+     * aSubset, which must be sorted in comparePositions() order.  Colinear positions are
+     * chained together as there is no triangulation for them.
+     */
+    static void triangulate( const std::vector<VECTOR2I>& aPositions,
+                             const std::vector<int>& aSubset, EDGE_LIST& aEdges )
     {
-        hed::TRIANGULATION triangulator;
-        triangulator.CreateDelaunay( aNodes.begin(), aNodes.end() );
-        std::list<hed::EDGE_PTR> edges;
-        triangulator.GetEdges( edges );
+        if( arePositionsColinear( aPositions, aSubset ) )
+        {
+            for( int i = 0; i < (int) aSubset.size() - 1; i++ )
+                aEdges.emplace_back( aSubset[i], aSubset[i + 1] );
+
+            return;
+        }
+
+        std::vector<hed::NODE_PTR> nodes = makeNodes( aPositions, aSubset );
+        std::list<hed::EDGE_PTR>   triangEdges;
+        hed::TRIANGULATION         triangulator;
 
-        return edges;
+        triangulator.CreateDelaunay( nodes.begin(), nodes.end() );
+        triangulator.GetEdges( triangEdges );
+
+        for( const auto& e : triangEdges )
+            aEdges.emplace_back( e->GetSourceNode()->Id(), e->GetTargetNode()->Id() );
     }
 
+    /**
+     * Collects the positions of aPositions lying in the box aMin, aMax.
+     */
+    static void positionsInBox( const std::vector<VECTOR2I>& aPositions, const VECTOR2I& aMin,
+                                const VECTOR2I& aMax, std::vector<int>& aResult )
+    {
+        aResult.clear();
+
+        auto it = std::lower_bound( aPositions.begin(), aPositions.end(),
+                                    VECTOR2I( aMin.x, aMin.y ), comparePositions );
+
+        for( ; it != aPositions.end() && it->y <= aMax.y; ++it )
+        {
+            if( it->x >= aMin.x && it->x <= aMax.x )
+                aResult.push_back( it - aPositions.begin() );
+        }
+    }
 
-    // Checks if all nodes in aNodes lie on a single line. Requires the nodes to
-    // have unique coordinates!
-    bool areNodesColinear( const std::vector<hed::NODE_PTR>& aNodes ) const
+    /**
+     * Finds the Delaunay neighbours of aPositions[aIndex] by triangulating growing windows
+     * around it, until the triangles around the position are closed and their circumcircles
+     * hold no position outside the window, which makes them triangles of the whole set.
+     * @return false if the window grew too large to be worth it.
+     */
+    static bool findNeighbours( const std::vector<VECTOR2I>& aPositions, int aIndex,
+                                std::vector<int>& aNeighbours )
     {
-        if ( aNodes.size() <= 2 )
-            return true;
+        const VECTOR2I     center = aPositions[aIndex];
+        const size_t       maxWindowCount = std::max<size_t>( aPositions.size() / 4, 64 );
+        std::vector<int>   window;
+        std::vector<int>   candidates;
+
+        // Start with a window holding a handful of neighbours
+        int64_t halfSize = 1 << 16;
+
+        for( ;; halfSize *= 2 )
+        {
+            positionsInBox( aPositions, clampedPoint( center, -halfSize ),
+                            clampedPoint( center, halfSize ), window );
 
-        const auto p0 = aNodes[0]->Pos();
-        const auto v0 = aNodes[1]->Pos() - p0;
+            if( window.size() > 16 || window.size() == aPositions.size() )
+                break;
+        }
 
-        for( unsigned i = 2; i < aNodes.size(); i++ )
+        for( ; window.size() <= maxWindowCount && window.size() < aPositions.size();
+               halfSize *= 2 )
         {
-            const auto v1 = aNodes[i]->Pos() - p0;
+            const VECTOR2I windowMin = clampedPoint( center, -halfSize );
+            const VECTOR2I windowMax = clampedPoint( center, halfSize );
+
+            positionsInBox( aPositions, windowMin, windowMax, window );
 
-            if( v0.Cross( v1 ) != 0 )
+            if( arePositionsColinear( aPositions, window ) )
+                continue;
+
+            std::vector<hed::NODE_PTR> nodes = makeNodes( aPositions, window );
+            hed::TRIANGULATION         triangulator;
+
+            triangulator.CreateDelaunay( nodes.begin(), nodes.end() );
+
+            bool   valid = true;
+            size_t triangleCount = 0;
+
+            aNeighbours.clear();
+
+            for( const hed::EDGE_PTR& leadingEdge : triangulator.GetLeadingEdges() )
             {
-                return false;
+                hed::EDGE_PTR e0 = leadingEdge;
+                hed::EDGE_PTR e1 = e0->GetNextEdgeInFace();
+                hed::EDGE_PTR e2 = e1->GetNextEdgeInFace();
+
+                int a = e0->GetSourceNode()->Id();
+                int b = e1->GetSourceNode()->Id();
+                int c = e2->GetSourceNode()->Id();
+
+                if( a != aIndex && b != aIndex && c != aIndex )
+                    continue;
+
+                triangleCount++;
+
+                for( int vertex : { a, b, c } )
+                {
+                    if( vertex != aIndex )
+                        aNeighbours.push_back( vertex );
+                }
+
+                // The circumcircle must not hold any position outside the window
+                const VECTOR2I& pa = aPositions[a];
+                const VECTOR2I& pb = aPositions[b];
+                const VECTOR2I& pc = aPositions[c];
+
+                VECTOR2D circumcenter;
+                double   radius;
+
+                if( !circumcircle( pa, pb, pc, circumcenter, radius ) )
+                {
+                    valid = false;
+                    break;
+                }
+
+                const VECTOR2D circleMin = circumcenter - VECTOR2D( radius, radius );
+                const VECTOR2D circleMax = circumcenter + VECTOR2D( radius, radius );
+
+                if( circleMin.x >= windowMin.x && circleMin.y >= windowMin.y
+                        && circleMax.x <= windowMax.x && circleMax.y <= windowMax.y )
+                {
+                    continue;
+                }
+
+                positionsInBox( aPositions, clampedPoint( circleMin ), clampedPoint( circleMax ),
+                                candidates );
+
+                for( int candidate : candidates )
+                {
+                    const VECTOR2I& pos = aPositions[candidate];
+
+                    if( pos.x >= windowMin.x && pos.y >= windowMin.y
+                            && pos.x <= windowMax.x && pos.y <= windowMax.y )
+                    {
+                        continue;
+                    }
+
+                    if( inCircumcircle( pa, pb, pc, pos ) )
+                    {
+                        valid = false;
+                        break;
+                    }
+                }
+
+                if( !valid )
+                    break;
+            }
+
+            std::sort( aNeighbours.begin(), aNeighbours.end() );
+            aNeighbours.erase( std::unique( aNeighbours.begin(), aNeighbours.end() ),
+                               aNeighbours.end() );
+
+            // Around a position inside the triangulation there are as many triangles as
+            // neighbours; fewer means the position is on the hull of the window.
+            if( valid && triangleCount > 0 && triangleCount == aNeighbours.size() )
+                return true;
+        }
+
+        return false;
+    }
+
+    static VECTOR2I clampedPoint( const VECTOR2I& aCenter, int64_t aOffset )
+    {
+        return clampedPoint( VECTOR2D( (double) aCenter.x + aOffset,
+                                       (double) aCenter.y + aOffset ) );
+    }
+
+    static VECTOR2I clampedPoint( const VECTOR2D& aPoint )
+    {
+        const double coordMin = std::numeric_limits<int>::min();
+        const double coordMax = std::numeric_limits<int>::max();
+
+        return VECTOR2I( (int) std::min( std::max( std::floor( aPoint.x ), coordMin ), coordMax ),
+                         (int) std::min( std::max( std::floor( aPoint.y ), coordMin ), coordMax ) );
+    }
+
+    static bool circumcircle( const VECTOR2I& aA, const VECTOR2I& aB, const VECTOR2I& aC,
+                              VECTOR2D& aCenter, double& aRadius )
+    {
+        const double bx = (double) aB.x - aA.x;
+        const double by = (double) aB.y - aA.y;
+        const double cx = (double) aC.x - aA.x;
+        const double cy = (double) aC.y - aA.y;
+        const double d = 2.0 * ( bx * cy - by * cx );
+
+        if( d == 0.0 )
+            return false;
+
+        const double b2 = bx * bx + by * by;
+        const double c2 = cx * cx + cy * cy;
+        const double ux = ( cy * b2 - by * c2 ) / d;
+        const double uy = ( bx * c2 - cx * b2 ) / d;
+
+        aCenter = VECTOR2D( aA.x + ux, aA.y + uy );
+
+        // Widened a little, so rounding cannot leave out a position on the circle
+        aRadius = std::sqrt( ux * ux + uy * uy ) * ( 1.0 + 1e-9 ) + 2.0;
+
+        return true;
+    }
+
+    /**
+     * Updates the previous triangulation for the positions added and removed since.
+     *
+     * Removing a position only adds Delaunay edges between its former neighbours, which are
+     * those of the Delaunay triangulation of the neighbours.  Adding a position only adds the
+     * edges to its own neighbours, found by findNeighbours().  The edges the added positions
+     * replace are kept: the edge list stays a superset of the triangulation, which is all
+     * the spanning tree needs.
+     * @return false if a full triangulation is needed.
+     */
+    bool updateEdges( const std::vector<VECTOR2I>& aPositions, EDGE_LIST& aEdges )
+    {
+        if( !m_valid )
+            return false;
+
+        std::vector<int> oldToNew( m_positions.size(), -1 );
+        std::vector<int> added;
+        size_t           removedCount = 0;
+
+        for( size_t i = 0, j = 0; i < m_positions.size() || j < aPositions.size(); )
+        {
+            if( j == aPositions.size()
+                    || ( i < m_positions.size()
+                         && comparePositions( m_positions[i], aPositions[j] ) ) )
+            {
+                removedCount++;
+                i++;
+            }
+            else if( i == m_positions.size() || comparePositions( aPositions[j], m_positions[i] ) )
+            {
+                added.push_back( j++ );
             }
+            else
+            {
+                oldToNew[i++] = j++;
+            }
+        }
+
+        const size_t changes = removedCount + added.size();
+
+        // Large edits are quicker to triangulate from scratch, and so is a net whose edge list
+        // has drifted too far from its triangulation
+        if( changes > 0
+                && ( changes * 32 > aPositions.size()
+                     || ( m_updatedPositions + changes ) * 8 > aPositions.size() ) )
+        {
+            return false;
+        }
+
+        std::vector<int> removedNeighbours;
+
+        for( const std::pair<int, int>& edge : m_edges )
+        {
+            int src = oldToNew[edge.first];
+            int dst = oldToNew[edge.second];
+
+            if( src >= 0 && dst >= 0 )
+                aEdges.emplace_back( src, dst );
+            else if( src >= 0 )
+                removedNeighbours.push_back( src );
+            else if( dst >= 0 )
+                removedNeighbours.push_back( dst );
         }
 
+        if( !removedNeighbours.empty() )
+        {
+            std::sort( removedNeighbours.begin(), removedNeighbours.end() );
+            removedNeighbours.erase( std::unique( removedNeighbours.begin(),
+                                                  removedNeighbours.end() ),
+                                     removedNeighbours.end() );
+
+            triangulate( aPositions, removedNeighbours, aEdges );
+        }
+
+        std::vector<int> neighbours;
+
+        for( int index : added )
+        {
+            if( !findNeighbours( aPositions, index, neighbours ) )
+                return false;
+
+            for( int neighbour : neighbours )
+                aEdges.emplace_back( index, neighbour );
+        }
+
+        m_updatedPositions += changes;
+
         return true;
     }
 
@@ -201,97 +596,77 @@ public:
         m_allNodes.push_back( aNode );
     }
 
-    const std::list<CN_EDGE> Triangulate()
+    const std::vector<CN_EDGE> Triangulate()
     {
-        std::list<CN_EDGE> mstEdges;
-        std::list<hed::EDGE_PTR> triangEdges;
-        std::vector<hed::NODE_PTR> triNodes;
+        std::vector<CN_EDGE> mstEdges;
+        std::vector<int> firstNodes;    // index in m_allNodes of the first node at each position
+        std::vector<VECTOR2I> positions;
 
         using ANCHOR_LIST = std::vector<CN_ANCHOR_PTR>;
         std::vector<ANCHOR_LIST> anchorChains;
 
-        triNodes.reserve( m_allNodes.size() );
-        anchorChains.resize( m_allNodes.size() );
-
         std::sort( m_allNodes.begin(), m_allNodes.end(),
                 [] ( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& aNode2 )
+                {
+                    return comparePositions( aNode1->Pos(), aNode2->Pos() );
+                } );
+
+        for( int id = 0; id < (int) m_allNodes.size(); id++ )
         {
-            if( aNode1->Pos().y < aNode2->Pos().y )
-                return true;
-            else if( aNode1->Pos().y == aNode2->Pos().y )
+            const CN_ANCHOR_PTR& n = m_allNodes[id];
+
+            if( positions.empty() || positions.back() != n->Pos() )
             {
-                return aNode1->Pos().x < aNode2->Pos().x;
+                positions.push_back( n->Pos() );
+                firstNodes.push_back( id );
+                anchorChains.emplace_back();
             }
 
-            return false;
+            anchorChains.back().push_back( n );
         }
-                );
 
-        CN_ANCHOR_PTR prev, last;
-        int id = 0;
+        if( positions.size() == 1 )
+            return mstEdges;
+
+        EDGE_LIST edges;
 
-        for( const auto& n : m_allNodes )
+        if( !updateEdges( positions, edges ) )
         {
-            if( !prev || prev->Pos() != n->Pos() )
-            {
-                auto tn = std::make_shared<hed::NODE> ( n->Pos().x, n->Pos().y );
+            // special case: all nodes are on the same line - there's no triangulation for such
+            // set. In this case, triangulate() chains the nodes together along the sort order.
+            std::vector<int> all( positions.size() );
 
-                tn->SetId( id );
-                triNodes.push_back( tn );
-            }
+            for( int i = 0; i < (int) all.size(); i++ )
+                all[i] = i;
 
-            id++;
-            prev = n;
+            edges.clear();
+            triangulate( positions, all, edges );
+            m_updatedPositions = 0;
         }
 
-        int prevId = 0;
-
-        for( const auto& n : triNodes )
+        for( std::pair<int, int>& edge : edges )
         {
-            for( int i = prevId; i < n->Id(); i++ )
-                anchorChains[prevId].push_back( m_allNodes[ i ] );
-
-            prevId = n->Id();
+            if( edge.first > edge.second )
+                std::swap( edge.first, edge.second );
         }
 
-        for( int i = prevId; i < id; i++ )
-            anchorChains[prevId].push_back( m_allNodes[ i ] );
+        std::sort( edges.begin(), edges.end() );
+        edges.erase( std::unique( edges.begin(), edges.end() ), edges.end() );
 
-        if( triNodes.size() == 1 )
-        {
-            return mstEdges;
-        }
-        else if( areNodesColinear( triNodes ) )
-        {
-            // special case: all nodes are on the same line - there's no
-            // triangulation for such set. In this case, we sort along any coordinate
-            // and chain the nodes together.
-            for(int i = 0; i < (int)triNodes.size() - 1; i++ )
-            {
-                auto src = m_allNodes[ triNodes[i]->Id() ];
-                auto dst = m_allNodes[ triNodes[i + 1]->Id() ];
-                mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
-            }
-        }
-        else
+        for( const std::pair<int, int>& edge : edges )
         {
-            hed::TRIANGULATION triangulator;
-            triangulator.CreateDelaunay( triNodes.begin(), triNodes.end() );
-            triangulator.GetEdges( triangEdges );
-
-            for( const auto& e : triangEdges )
-            {
-                auto    src = m_allNodes[ e->GetSourceNode()->Id() ];
-                auto    dst = m_allNodes[ e->GetTargetNode()->Id() ];
+            const auto& src = m_allNodes[ firstNodes[edge.first] ];
+            const auto& dst = m_allNodes[ firstNodes[edge.second] ];
 
-                mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
-            }
+            mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
         }
 
-        for( unsigned int i = 0; i < anchorChains.size(); i++ )
-        {
-            auto& chain = anchorChains[i];
+        m_positions = std::move( positions );
+        m_edges = std::move( edges );
+        m_valid = true;
 
+        for( auto& chain : anchorChains )
+        {
             if( chain.size() < 2 )
                 continue;
 
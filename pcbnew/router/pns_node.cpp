@@ -44,6 +44,40 @@ namespace PNS {
 static std::unordered_set<NODE*> allocNodes;
 #endif
 
+///> Past this many layers, a new branch gets the layers of its parent merged into one, so
+///> that the queries, which visit each layer, do not slow down with the depth of the branches
+static const size_t MAX_BRANCH_LAYERS = 8;
+
+
+/**
+ * BRANCH_LAYER
+ *
+ * Part of the changes of a branch wrs to the root. A layer shared by a branch and its
+ * children does not change anymore: the later changes of each of them go to a new layer.
+ */
+struct NODE::BRANCH_LAYER
+{
+    ///> items added in this layer
+    INDEX m_index;
+
+    ///> items of the root or of the layers below removed in this layer
+    std::unordered_set<ITEM*> m_removed;
+
+    ///> joints changed in this layer. They hide the joints with the same tag in the
+    ///> layers below and in the root.
+    JOINT_MAP m_joints;
+
+    ///> tags whose joints were all removed in this layer: the root's joints show again
+    std::unordered_set<JOINT::HASH_TAG, JOINT::JOINT_TAG_HASH> m_clearedTags;
+
+    bool IsEmpty() const
+    {
+        return m_index.Size() == 0 && m_removed.empty() && m_joints.empty()
+               && m_clearedTags.empty();
+    }
+};
+
+
 NODE::NODE()
 {
     wxLogTrace( "PNS", "NODE::create %p", this );
@@ -88,6 +122,18 @@ NODE::~NODE()
             delete item;
     }
 
+    // the layers shared with the parent hold no items of this node
+    for( const std::shared_ptr<BRANCH_LAYER>& layer : m_layers )
+    {
+        for( ITEM* item : layer->m_index )
+        {
+            if( item->BelongsTo( this ) )
+                delete item;
+        }
+    }
+
+    m_layers.clear();
+
     releaseGarbage();
     unlinkParent();
 
@@ -117,23 +163,135 @@ NODE* NODE::Branch()
     child->m_root = isRoot() ? this : m_root;
     child->m_maxClearance = m_maxClearance;
 
-    // Immmediate offspring of the root branch needs not copy anything. For the rest, deep-copy
-    // joints, overridden item maps and pointers to stored items.
-    if( !isRoot() )
+    // Immmediate offspring of the root branch needs not copy anything. The rest share the
+    // layers of their parent, which stop changing from now on, or get a merged copy of them.
+    // The layers are merged here rather than when they change, as no joint of the new branch
+    // can be referenced yet.
+    if( m_layers.size() >= MAX_BRANCH_LAYERS )
+    {
+        child->m_layers.push_back( mergeLayers() );
+    }
+    else if( !isRoot() )
     {
-        JOINT_MAP::iterator j;
+        child->m_layers = m_layers;
+
+        // An empty last layer is of no use to the child, and this node can still fill it
+        if( !child->m_layers.empty() && child->m_layers.back()->IsEmpty() )
+            child->m_layers.pop_back();
+    }
+
+    wxLogTrace( "PNS", "%d layers", (int) child->m_layers.size() );
 
+    return child;
+}
+
+
+template <class FUNC>
+void NODE::visitBranchItems( FUNC aFunc ) const
+{
+    if( isRoot() )
+    {
         for( ITEM* item : *m_index )
-            child->m_index->Add( item );
+            aFunc( item );
 
-        child->m_joints = m_joints;
-        child->m_override = m_override;
+        return;
+    }
+
+    for( const std::shared_ptr<BRANCH_LAYER>& layer : m_layers )
+    {
+        for( ITEM* item : layer->m_index )
+        {
+            if( !Overrides( item ) )
+                aFunc( item );
+        }
     }
+}
 
-    wxLogTrace( "PNS", "%d items, %d joints, %d overrides",
-            child->m_index->Size(), (int) child->m_joints.size(), (int) child->m_override.size() );
 
-    return child;
+template <class FUNC>
+void NODE::visitBranchJoints( FUNC aFunc ) const
+{
+    // The joints with a given tag come from the newest layer which changed them
+    std::unordered_set<JOINT::HASH_TAG, JOINT::JOINT_TAG_HASH> done;
+
+    for( auto layer = m_layers.rbegin(); layer != m_layers.rend(); ++layer )
+    {
+        for( TagJointPair& joint : ( *layer )->m_joints )
+        {
+            if( done.find( joint.first ) == done.end() )
+                aFunc( joint );
+        }
+
+        for( const TagJointPair& joint : ( *layer )->m_joints )
+            done.insert( joint.first );
+
+        done.insert( ( *layer )->m_clearedTags.begin(), ( *layer )->m_clearedTags.end() );
+    }
+}
+
+
+bool NODE::Overrides( ITEM* aItem ) const
+{
+    // An item is never added again once removed: it is hidden if any layer removed it
+    for( const std::shared_ptr<BRANCH_LAYER>& layer : m_layers )
+    {
+        if( layer->m_removed.find( aItem ) != layer->m_removed.end() )
+            return true;
+    }
+
+    return false;
+}
+
+
+INDEX& NODE::writableIndex()
+{
+    return isRoot() ? *m_index : writableLayer().m_index;
+}
+
+
+NODE::BRANCH_LAYER& NODE::writableLayer()
+{
+    assert( !isRoot() );
+
+    // The last layer may be shared with a branch of this node: it must not change then
+    if( m_layers.empty() || m_layers.back().use_count() > 1 )
+        m_layers.push_back( std::make_shared<BRANCH_LAYER>() );
+
+    return *m_layers.back();
+}
+
+
+std::shared_ptr<NODE::BRANCH_LAYER> NODE::mergeLayers()
+{
+    std::shared_ptr<BRANCH_LAYER> merged = std::make_shared<BRANCH_LAYER>();
+
+    visitBranchItems(
+            [&]( ITEM* aItem )
+            {
+                merged->m_index.Add( aItem );
+            } );
+
+    // The removed items of the layers below are left out of the merged index: only the
+    // removed items of the root remain to be hidden
+    for( const std::shared_ptr<BRANCH_LAYER>& layer : m_layers )
+    {
+        for( ITEM* item : layer->m_removed )
+        {
+            if( item->BelongsTo( m_root ) )
+                merged->m_removed.insert( item );
+        }
+    }
+
+    visitBranchJoints(
+            [&]( const TagJointPair& aJoint )
+            {
+                merged->m_joints.insert( aJoint );
+            } );
+
+    wxLogTrace( "PNS", "NODE::mergeLayers %p: %d layers, %d items", this, (int) m_layers.size(),
+            merged->m_index.Size() );
+
+    return merged;
 }
 
 
@@ -261,15 +419,15 @@ struct NODE::DEFAULT_OBSTACLE_VISITOR : public OBSTACLE_VISITOR
 
 int NODE::QueryColliding( const ITEM* aItem, OBSTACLE_VISITOR& aVisitor )
 {
-    aVisitor.SetWorld( this, NULL );
-    m_index->Query( aItem, m_maxClearance, aVisitor );
+    // first, look in the layers of the branch, newest first...
+    aVisitor.SetWorld( this, this );
 
-    // if we haven't found enough items, look in the root branch as well.
-    if( !isRoot() )
-    {
-        aVisitor.SetWorld( m_root, this );
-        m_root->m_index->Query( aItem, m_maxClearance, aVisitor );
-    }
+    for( auto layer = m_layers.rbegin(); layer != m_layers.rend(); ++layer )
+        ( *layer )->m_index.Query( aItem, m_maxClearance, aVisitor );
+
+    // ...then in the root branch
+    aVisitor.SetWorld( m_root, isRoot() ? NULL : this );
+    m_root->m_index->Query( aItem, m_maxClearance, aVisitor );
 
     return 0;
 }
@@ -285,15 +443,22 @@ int NODE::QueryColliding( const ITEM* aItem, NODE::OBSTACLES& aObstacles, int aK
 #endif
 
     visitor.SetCountLimit( aLimitCount );
-    visitor.SetWorld( this, NULL );
+    visitor.SetWorld( this, this );
     visitor.m_forceClearance = aForceClearance;
-    // first, look for colliding items in the local index
-    m_index->Query( aItem, m_maxClearance, visitor );
+
+    // first, look for colliding items in the layers of the branch, newest first
+    for( auto layer = m_layers.rbegin(); layer != m_layers.rend(); ++layer )
+    {
+        if( aLimitCount > 0 && visitor.m_matchCount >= aLimitCount )
+            break;
+
+        ( *layer )->m_index.Query( aItem, m_maxClearance, visitor );
+    }
 
     // if we haven't found enough items, look in the root branch as well.
-    if( !isRoot() && ( visitor.m_matchCount < aLimitCount || aLimitCount < 0 ) )
+    if( isRoot() || visitor.m_matchCount < aLimitCount || aLimitCount < 0 )
     {
-        visitor.SetWorld( m_root, this );
+        visitor.SetWorld( m_root, isRoot() ? NULL : this );
         m_root->m_index->Query( aItem, m_maxClearance, visitor );
     }
 
@@ -513,23 +678,30 @@ const ITEM_SET NODE::HitTest( const VECTOR2I& aPoint ) const
 
     // fixme: we treat a point as an infinitely small circle - this is inefficient.
     SHAPE_CIRCLE s( aPoint, 0 );
-    HIT_VISITOR visitor( items, aPoint );
+
+    if( isRoot() )
+    {
+        HIT_VISITOR visitor( items, aPoint );
+        visitor.SetWorld( this, NULL );
+
+        m_index->Query( &s, m_maxClearance, visitor );
+        return items;
+    }
+
+    // fixme: could be made cleaner
+    ITEM_SET items_branch;
+    HIT_VISITOR visitor( items_branch, aPoint );
     visitor.SetWorld( this, NULL );
 
-    m_index->Query( &s, m_maxClearance, visitor );
+    for( auto layer = m_layers.rbegin(); layer != m_layers.rend(); ++layer )
+        ( *layer )->m_index.Query( &s, m_maxClearance, visitor );
 
-    if( !isRoot() )    // fixme: could be made cleaner
-    {
-        ITEM_SET items_root;
-        visitor.SetWorld( m_root, NULL );
-        HIT_VISITOR  visitor_root( items_root, aPoint );
-        m_root->m_index->Query( &s, m_maxClearance, visitor_root );
+    m_root->m_index->Query( &s, m_maxClearance, visitor );
 
-        for( ITEM* item : items_root.Items() )
-        {
-            if( !Overrides( item ) )
-                items.Add( item );
-        }
+    for( ITEM* item : items_branch.Items() )
+    {
+        if( !Overrides( item ) )
+            items.Add( item );
     }
 
     return items;
@@ -541,7 +713,7 @@ void NODE::addSolid( SOLID* aSolid )
     if( aSolid->IsRoutable() )
         linkJoint( aSolid->Pos(), aSolid->Layers(), aSolid->Net(), aSolid );
 
-    m_index->Add( aSolid );
+    writableIndex().Add( aSolid );
 }
 
 void NODE::Add( std::unique_ptr< SOLID > aSolid )
@@ -553,7 +725,7 @@ void NODE::Add( std::unique_ptr< SOLID > aSolid )
 void NODE::addVia( VIA* aVia )
 {
     linkJoint( aVia->Pos(), aVia->Layers(), aVia->Net(), aVia );
-    m_index->Add( aVia );
+    writableIndex().Add( aVia );
 }
 
 void NODE::Add( std::unique_ptr< VIA > aVia )
@@ -614,7 +786,7 @@ void NODE::addSegment( SEGMENT* aSeg )
     linkJoint( aSeg->Seg().A, aSeg->Layers(), aSeg->Net(), aSeg );
     linkJoint( aSeg->Seg().B, aSeg->Layers(), aSeg->Net(), aSeg );
 
-    m_index->Add( aSeg );
+    writableIndex().Add( aSeg );
 }
 
 bool NODE::Add( std::unique_ptr< SEGMENT > aSegment, bool aAllowRedundant )
@@ -639,7 +811,7 @@ void NODE::addArc( ARC* aArc )
     linkJoint( aArc->Anchor( 0 ), aArc->Layers(), aArc->Net(), aArc );
     linkJoint( aArc->Anchor( 1 ), aArc->Layers(), aArc->Net(), aArc );
 
-    m_index->Add( aArc );
+    writableIndex().Add( aArc );
 }
 
 void NODE::Add( std::unique_ptr< ARC > aArc )
@@ -670,15 +842,24 @@ void NODE::Add( std::unique_ptr< ITEM > aItem, bool aAllowRedundant )
 
 void NODE::doRemove( ITEM* aItem )
 {
-    // case 1: removing an item that is stored in the root node from any branch:
-    // mark it as overridden, but do not remove
-    if( aItem->BelongsTo( m_root ) && !isRoot() )
-        m_override.insert( aItem );
-
-    // case 2: the item belongs to this branch or a parent, non-root branch,
-    // or the root itself and we are the root: remove from the index
-    else if( !aItem->BelongsTo( m_root ) || isRoot() )
+    // case 1: we are the root: remove from the index
+    if( isRoot() )
+    {
         m_index->Remove( aItem );
+    }
+    else
+    {
+        BRANCH_LAYER& layer = writableLayer();
+
+        // case 2: the item was added to the last layer of this branch: remove it from there
+        if( layer.m_index.Contains( aItem ) )
+            layer.m_index.Remove( aItem );
+
+        // case 3: the item is stored in the root node or in a layer shared with another
+        // branch: mark it as overridden, but do not remove
+        else
+            layer.m_removed.insert( aItem );
+    }
 
     // the item belongs to this particular branch: un-reference it
     if( aItem->BelongsTo( this ) )
@@ -715,13 +896,19 @@ void NODE::rebuildJoint( JOINT* aJoint, ITEM* aItem )
     tag.net = net;
     tag.pos = aJoint->Pos();
 
+    // a branch changes its own joints only, not the root's ones
+    if( !isRoot() )
+        copyJointsToLastLayer( tag, false );
+
+    JOINT_MAP& joints = isRoot() ? m_joints : m_layers.back()->m_joints;
+
     bool split;
     do
     {
         split = false;
-        auto range = m_joints.equal_range( tag );
+        auto range = joints.equal_range( tag );
 
-        if( range.first == m_joints.end() )
+        if( range.first == joints.end() )
             break;
 
         // find and remove all joints containing the via to be removed
@@ -730,13 +917,17 @@ void NODE::rebuildJoint( JOINT* aJoint, ITEM* aItem )
         {
             if( aItem->LayersOverlap( &f->second ) )
             {
-                m_joints.erase( f );
+                joints.erase( f );
                 split = true;
                 break;
             }
         }
     } while( split );
 
+    // no joint left: the layers below must not show theirs again
+    if( !isRoot() && joints.find( tag ) == joints.end() )
+        m_layers.back()->m_clearedTags.insert( tag );
+
     // and re-link them, using the former via's link list
     for(ITEM* link : links)
     {
@@ -1031,13 +1222,8 @@ JOINT* NODE::FindJoint( const VECTOR2I& aPos, int aLayer, int aNet )
     tag.net = aNet;
     tag.pos = aPos;
 
-    JOINT_MAP::iterator f = m_joints.find( tag ), end = m_joints.end();
-
-    if( f == end && !isRoot() )
-    {
-        end = m_root->m_joints.end();
-        f = m_root->m_joints.find( tag );    // m_root->FindJoint(aPos, aLayer, aNet);
-    }
+    JOINT_MAP& joints = jointsForTag( tag );
+    JOINT_MAP::iterator f = joints.find( tag ), end = joints.end();
 
     if( f == end )
         return NULL;
@@ -1068,20 +1254,15 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
     tag.pos = aPos;
     tag.net = aNet;
 
-    // try to find the joint in this node.
-    JOINT_MAP::iterator f = m_joints.find( tag );
+    // not in the last layer and we are not root? find in the layers below or in the root
+    // and copy results here.
+    if( !isRoot() )
+        copyJointsToLastLayer( tag, true );
 
+    JOINT_MAP& joints = isRoot() ? m_joints : m_layers.back()->m_joints;
+    JOINT_MAP::iterator f;
     std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range;
 
-    // not found and we are not root? find in the root and copy results here.
-    if( f == m_joints.end() && !isRoot() )
-    {
-        range = m_root->m_joints.equal_range( tag );
-
-        for( f = range.first; f != range.second; ++f )
-            m_joints.insert( *f );
-    }
-
     // now insert and combine overlapping joints
     JOINT jt( aPos, aLayers, aNet );
 
@@ -1090,9 +1271,9 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
     do
     {
         merged  = false;
-        range   = m_joints.equal_range( tag );
+        range   = joints.equal_range( tag );
 
-        if( range.first == m_joints.end() )
+        if( range.first == joints.end() )
             break;
 
         for( f = range.first; f != range.second; ++f )
@@ -1100,7 +1281,7 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
             if( aLayers.Overlaps( f->second.Layers() ) )
             {
                 jt.Merge( f->second );
-                m_joints.erase( f );
+                joints.erase( f );
                 merged = true;
                 break;
             }
@@ -1108,7 +1289,44 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
     }
     while( merged );
 
-    return m_joints.insert( TagJointPair( tag, jt ) )->second;
+    return joints.insert( TagJointPair( tag, jt ) )->second;
+}
+
+
+NODE::JOINT_MAP& NODE::jointsForTag( const JOINT::HASH_TAG& aTag ) const
+{
+    for( auto layer = m_layers.rbegin(); layer != m_layers.rend(); ++layer )
+    {
+        if( ( *layer )->m_joints.find( aTag ) != ( *layer )->m_joints.end() )
+            return ( *layer )->m_joints;
+
+        if( ( *layer )->m_clearedTags.find( aTag ) != ( *layer )->m_clearedTags.end() )
+            break;
+    }
+
+    return m_root->m_joints;
+}
+
+
+void NODE::copyJointsToLastLayer( const JOINT::HASH_TAG& aTag, bool aFromRoot )
+{
+    BRANCH_LAYER& layer = writableLayer();
+
+    if( layer.m_joints.find( aTag ) != layer.m_joints.end() )
+        return;
+
+    JOINT_MAP& joints = jointsForTag( aTag );
+
+    if( &joints == &m_root->m_joints && !aFromRoot )
+        return;
+
+    auto range = joints.equal_range( aTag );
+
+    for( auto f = range.first; f != range.second; ++f )
+        layer.m_joints.insert( *f );
+
+    if( range.first != range.second )
+        layer.m_clearedTags.erase( aTag );
 }
 
 
@@ -1224,17 +1442,25 @@ void NODE::GetUpdatedItems( ITEM_VECTOR& aRemoved, ITEM_VECTOR& aAdded )
     if( isRoot() )
         return;
 
-    if( m_override.size() )
-        aRemoved.reserve( m_override.size() );
-    
-    if( m_index->Size() )
-        aAdded.reserve( m_index->Size() );
+    // the items removed from the layers below are simply left out of aAdded
+    std::unordered_set<ITEM*> removed;
 
-    for( ITEM* item : m_override )
-        aRemoved.push_back( item );
+    for( const std::shared_ptr<BRANCH_LAYER>& layer : m_layers )
+    {
+        for( ITEM* item : layer->m_removed )
+        {
+            if( item->BelongsTo( m_root ) )
+                removed.insert( item );
+        }
+    }
+
+    aRemoved.insert( aRemoved.end(), removed.begin(), removed.end() );
 
-    for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
-        aAdded.push_back( *i );
+    visitBranchItems(
+            [&]( ITEM* aItem )
+            {
+                aAdded.push_back( aItem );
+            } );
 }
 
 void NODE::releaseChildren()
@@ -1270,10 +1496,14 @@ void NODE::Commit( NODE* aNode )
         if( aNode->isRoot() )
             return;
 
-        for( ITEM* item : aNode->m_override )
+        ITEM_VECTOR removed, added;
+
+        aNode->GetUpdatedItems( removed, added );
+
+        for( ITEM* item : removed )
             Remove( item );
 
-        for( auto i : *aNode->m_index )
+        for( auto i : added )
         {
             i->SetRank( -1 );
             i->Unmark();
@@ -1293,16 +1523,28 @@ void NODE::KillChildren()
 
 void NODE::AllItemsInNet( int aNet, std::set<ITEM*>& aItems )
 {
-    INDEX::NET_ITEMS_LIST* l_cur = m_index->GetItemsForNet( aNet );
-
-    if( l_cur )
+    if( isRoot() )
     {
-        for( ITEM*item : *l_cur )
-            aItems.insert( item );
-    }
+        INDEX::NET_ITEMS_LIST* l_cur = m_index->GetItemsForNet( aNet );
 
-    if( !isRoot() )
+        if( l_cur )
+        {
+            for( ITEM*item : *l_cur )
+                aItems.insert( item );
+        }
+    }
+    else
     {
+        for( const std::shared_ptr<BRANCH_LAYER>& layer : m_layers )
+        {
+            INDEX::NET_ITEMS_LIST* l_cur = layer->m_index.GetItemsForNet( aNet );
+
+            if( l_cur )
+                for( ITEM* item : *l_cur )
+                    if( !Overrides( item ) )
+                        aItems.insert( item );
+        }
+
         INDEX::NET_ITEMS_LIST* l_root = m_root->m_index->GetItemsForNet( aNet );
 
         if( l_root )
@@ -1315,11 +1557,12 @@ void NODE::AllItemsInNet( int aNet, std::set<ITEM*>& aItems )
 
 void NODE::ClearRanks( int aMarkerMask )
 {
-    for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
-    {
-        (*i)->SetRank( -1 );
-        (*i)->Mark( (*i)->Marker() & (~aMarkerMask) );
-    }
+    visitBranchItems(
+            [&]( ITEM* aItem )
+            {
+                aItem->SetRank( -1 );
+                aItem->Mark( aItem->Marker() & (~aMarkerMask) );
+            } );
 }
 
 
@@ -1327,11 +1570,12 @@ void NODE::RemoveByMarker( int aMarker )
 {
     std::list<ITEM*> garbage;
 
-    for( ITEM* item : *m_index )
-    {
-        if( item->Marker() & aMarker )
-            garbage.push_back( item );
-    }
+    visitBranchItems(
+            [&]( ITEM* aItem )
+            {
+                if( aItem->Marker() & aMarker )
+                    garbage.push_back( aItem );
+            } );
 
     for( ITEM* item : garbage )
         Remove( item );
@@ -1410,45 +1654,68 @@ int NODE::QueryJoints( const BOX2I& aBox,
 
     aJoints.clear();
 
-    for( auto j = m_joints.begin(); j != m_joints.end(); ++j )
+    auto visit = [&]( TagJointPair& aJoint )
     {
-        if ( aBox.Contains(j->second.Pos()) && j->second.LinkCount ( aKindMask ) )
+        if ( aBox.Contains( aJoint.second.Pos() ) && aJoint.second.LinkCount( aKindMask ) )
         {
-            aJoints.push_back( &j->second );
+            aJoints.push_back( &aJoint.second );
             n++;
-
         }
-    }
+    };
 
-    if ( isRoot() )
-        return n;
+    // the joints changed by a branch first, then all the root's ones
+    visitBranchJoints( visit );
 
-    for( auto j = m_root->m_joints.begin(); j != m_root->m_joints.end(); ++j )
-    {
-        if( ! Overrides( &j->second) )
-        {   if ( aBox.Contains(j->second.Pos()) && j->second.LinkCount ( aKindMask ) )
-            {
-                aJoints.push_back( &j->second );
-                n++;
-            }
-        }
-    }
+    for( TagJointPair& joint : m_root->m_joints )
+        visit( joint );
 
     return n;
+}
+
 
+int NODE::JointCount() const
+{
+    if( isRoot() )
+        return m_joints.size();
+
+    int n = 0;
+
+    visitBranchJoints(
+            [&]( TagJointPair& )
+            {
+                n++;
+            } );
 
+    return n;
 }
 
 
 ITEM *NODE::FindItemByParent( const BOARD_CONNECTED_ITEM* aParent )
 {
-    INDEX::NET_ITEMS_LIST* l_cur = m_index->GetItemsForNet( aParent->GetNetCode() );
+    if( isRoot() )
+    {
+        INDEX::NET_ITEMS_LIST* l_cur = m_index->GetItemsForNet( aParent->GetNetCode() );
+
+        if( l_cur )
+        {
+            for( ITEM* item : *l_cur )
+                if( item->Parent() == aParent )
+                    return item;
+        }
 
-    if( l_cur )
+        return NULL;
+    }
+
+    for( auto layer = m_layers.rbegin(); layer != m_layers.rend(); ++layer )
     {
-        for( ITEM* item : *l_cur )
-            if( item->Parent() == aParent )
-                return item;
+        INDEX::NET_ITEMS_LIST* l_cur = ( *layer )->m_index.GetItemsForNet( aParent->GetNetCode() );
+
+        if( l_cur )
+        {
+            for( ITEM* item : *l_cur )
+                if( item->Parent() == aParent && !Overrides( item ) )
+                    return item;
+        }
     }
 
     return NULL;
@@ -24,6 +24,7 @@
 
 #include <vector>
 #include <list>
+#include <memory>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -123,7 +124,7 @@ protected:
     ///> node we are searching in (either root or a branch)
     const NODE* m_node;
 
-    ///> node that overrides root entries
+    ///> node whose removed items are skipped
     const NODE* m_override;
 
     ///> additional clearance
@@ -178,11 +179,8 @@ public:
         return m_ruleResolver;
     }
 
-    ///> Returns the number of joints
-    int JointCount() const
-    {
-        return m_joints.size();
-    }
+    ///> Returns the number of joints of the root, or the number of joints changed by a branch
+    int JointCount() const;
 
     ///> Returns the number of nodes in the inheritance chain (wrs to the root node)
     int Depth() const
@@ -330,7 +328,8 @@ public:
      * Function Branch()
      *
      * Creates a lightweight copy (called branch) of self that tracks
-     * the changes (added/removed items) wrs to the root. Note that if there are
+     * the changes (added/removed items) wrs to the root. The branch shares the
+     * changes of its parent rather than copying them. Note that if there are
      * any branches in use, their parents must NOT be deleted.
      * @return the new branch
      */
@@ -430,14 +429,12 @@ public:
     }
 
     ///> checks if this branch contains an updated version of the m_item
-    ///> from the root branch.
-    bool Overrides( ITEM* aItem ) const
-    {
-        return m_override.find( aItem ) != m_override.end();
-    }
+    ///> from the root branch, or from one of the branches it was branched from.
+    bool Overrides( ITEM* aItem ) const;
 
 private:
     struct DEFAULT_OBSTACLE_VISITOR;
+    struct BRANCH_LAYER;
     typedef std::unordered_multimap<JOINT::HASH_TAG, JOINT, JOINT::JOINT_TAG_HASH> JOINT_MAP;
     typedef JOINT_MAP::value_type TagJointPair;
 
@@ -479,6 +476,30 @@ private:
         return m_parent == NULL;
     }
 
+    ///> returns the index taking the items added to this node
+    INDEX& writableIndex();
+
+    ///> returns the last layer of the branch, adding a new one if that one is shared
+    BRANCH_LAYER& writableLayer();
+
+    ///> returns a single layer holding the changes of all the layers of the branch
+    std::shared_ptr<BRANCH_LAYER> mergeLayers();
+
+    ///> returns the joint map holding the joints the branch sees with the tag aTag
+    JOINT_MAP& jointsForTag( const JOINT::HASH_TAG& aTag ) const;
+
+    ///> copies the joints with the tag aTag of the layers below (and of the root if
+    ///> aFromRoot) to the last layer, which is about to change them
+    void copyJointsToLastLayer( const JOINT::HASH_TAG& aTag, bool aFromRoot );
+
+    ///> calls aFunc( ITEM* ) for the items of the root, or for the items a branch added
+    template <class FUNC>
+    void visitBranchItems( FUNC aFunc ) const;
+
+    ///> calls aFunc( TagJointPair& ) for the joints changed by a branch
+    template <class FUNC>
+    void visitBranchJoints( FUNC aFunc ) const;
+
     SEGMENT* findRedundantSegment( const VECTOR2I& A, const VECTOR2I& B,
                                    const LAYER_RANGE & lr, int aNet );
     SEGMENT* findRedundantSegment( SEGMENT* aSeg );
@@ -491,7 +512,7 @@ private:
     void followLine( LINKED_ITEM* aCurrent, int aScanDirection, int& aPos, int aLimit, VECTOR2I* aCorners,
             LINKED_ITEM** aSegments, bool& aGuardHit, bool aStopAtLockedJoints );
 
-    ///> hash table with the joints, linking the items. Joints are hashed by
+    ///> hash table with the joints of the root, linking the items. Joints are hashed by
     ///> their position, layer set and net.
     JOINT_MAP m_joints;
 
@@ -504,8 +525,9 @@ private:
     ///> list of nodes branched from this one
     std::set<NODE*> m_children;
 
-    ///> hash of root's items that have been changed in this node
-    std::unordered_set<ITEM*> m_override;
+    ///> changes of a branch wrs to the root, oldest first. The layers are shared with
+    ///> the branches of this node.
+    std::vector<std::shared_ptr<BRANCH_LAYER>> m_layers;
 
     ///> worst case item-item clearance
     int m_maxClearance;
@@ -513,7 +535,7 @@ private:
     ///> Design rules resolver
     RULE_RESOLVER* m_ruleResolver;
 
-    ///> Geometric/Net index of the items
+    ///> Geometric/Net index of the items of the root
     INDEX* m_index;
 
     ///> depth of the node (number of parent nodes in the inheritance chain)
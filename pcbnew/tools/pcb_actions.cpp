@@ -170,6 +170,11 @@ TOOL_ACTION PCB_ACTIONS::runDRC( "pcbnew.DRCTool.runDRC",
         _( "Design Rules Checker" ), _( "Show the design rules checker window" ),
         erc_xpm );
 
+TOOL_ACTION PCB_ACTIONS::toggleLiveDRC( "pcbnew.DRCTool.toggleLiveDRC",
+        AS_GLOBAL, 0, "",
+        _( "Live DRC" ), _( "Recheck track clearances around each edit as it is made" ),
+        erc_xpm );
+
 
 // EDIT_TOOL
 //
@@ -1067,6 +1072,11 @@ TOOL_ACTION PCB_ACTIONS::zoneFillAll( "pcbnew.ZoneFiller.zoneFillAll",
         _( "Fill All" ), _( "Fill all zones" ),
         fill_zone_xpm );
 
+TOOL_ACTION PCB_ACTIONS::zoneRefillAll( "pcbnew.ZoneFiller.zoneRefillAll",
+        AS_GLOBAL, 0, "",
+        _( "Refill All" ), _( "Refill all zones, even those which did not change" ),
+        fill_zone_xpm );
+
 TOOL_ACTION PCB_ACTIONS::zoneUnfill( "pcbnew.ZoneFiller.zoneUnfill",
         AS_GLOBAL, 0, "",
         _( "Unfill" ), _( "Unfill zone(s)" ),
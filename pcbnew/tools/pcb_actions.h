@@ -278,6 +278,7 @@ public:
     // Zone actions
     static TOOL_ACTION zoneFill;
     static TOOL_ACTION zoneFillAll;
+    static TOOL_ACTION zoneRefillAll;       // refills the zones whose inputs did not change too
     static TOOL_ACTION zoneUnfill;
     static TOOL_ACTION zoneUnfillAll;
     static TOOL_ACTION zoneMerge;
@@ -311,6 +312,7 @@ public:
 
     static TOOL_ACTION listNets;
     static TOOL_ACTION runDRC;
+    static TOOL_ACTION toggleLiveDRC;
 
     static TOOL_ACTION editFootprintInFpEditor;
     static TOOL_ACTION showLayersManager;
@@ -72,6 +72,7 @@ public:
 
         Add( PCB_ACTIONS::zoneFill );
         Add( PCB_ACTIONS::zoneFillAll );
+        Add( PCB_ACTIONS::zoneRefillAll );
         Add( PCB_ACTIONS::zoneUnfill );
         Add( PCB_ACTIONS::zoneUnfillAll );
 
@@ -83,7 +83,7 @@ void ZONE_FILLER_TOOL::singleShotRefocus( wxIdleEvent& )
 }
 
 
-void ZONE_FILLER_TOOL::FillAllZones( wxWindow* aCaller )
+void ZONE_FILLER_TOOL::FillAllZones( wxWindow* aCaller, bool aForce )
 {
     std::vector<ZONE_CONTAINER*> toFill;
 
@@ -95,7 +95,7 @@ void ZONE_FILLER_TOOL::FillAllZones( wxWindow* aCaller )
     ZONE_FILLER filler( board(), &commit );
     filler.InstallNewProgressReporter( aCaller, _( "Fill All Zones" ),  4 );
 
-    if( filler.Fill( toFill ) )
+    if( filler.Fill( toFill, false, aForce ) )
         getEditFrame<PCB_EDIT_FRAME>()->m_ZoneFillsDirty = false;
 
     canvas()->Refresh();
@@ -128,7 +128,9 @@ int ZONE_FILLER_TOOL::ZoneFill( const TOOL_EVENT& aEvent )
 
     ZONE_FILLER filler( board(), &commit );
     filler.InstallNewProgressReporter( frame(), _( "Fill Zone" ), 4 );
-    filler.Fill( toFill );
+
+    // The zones were chosen by the user, so they are refilled even if nothing changed
+    filler.Fill( toFill, false, true );
 
     canvas()->Refresh();
     return 0;
@@ -142,6 +144,13 @@ int ZONE_FILLER_TOOL::ZoneFillAll( const TOOL_EVENT& aEvent )
 }
 
 
+int ZONE_FILLER_TOOL::ZoneRefillAll( const TOOL_EVENT& aEvent )
+{
+    FillAllZones( frame(), true );
+    return 0;
+}
+
+
 int ZONE_FILLER_TOOL::ZoneUnfill( const TOOL_EVENT& aEvent )
 {
     BOARD_COMMIT commit( this );
@@ -189,6 +198,7 @@ void ZONE_FILLER_TOOL::setTransitions()
     // Zone actions
     Go( &ZONE_FILLER_TOOL::ZoneFill, PCB_ACTIONS::zoneFill.MakeEvent() );
     Go( &ZONE_FILLER_TOOL::ZoneFillAll, PCB_ACTIONS::zoneFillAll.MakeEvent() );
+    Go( &ZONE_FILLER_TOOL::ZoneRefillAll, PCB_ACTIONS::zoneRefillAll.MakeEvent() );
     Go( &ZONE_FILLER_TOOL::ZoneUnfill, PCB_ACTIONS::zoneUnfill.MakeEvent() );
     Go( &ZONE_FILLER_TOOL::ZoneUnfillAll, PCB_ACTIONS::zoneUnfillAll.MakeEvent() );
 }
@@ -45,10 +45,11 @@ public:
     void Reset( RESET_REASON aReason ) override;
 
     void CheckAllZones( wxWindow* aCaller );
-    void FillAllZones( wxWindow* aCaller );
+    void FillAllZones( wxWindow* aCaller, bool aForce = false );
 
     int ZoneFill( const TOOL_EVENT& aEvent );
     int ZoneFillAll( const TOOL_EVENT& aEvent );
+    int ZoneRefillAll( const TOOL_EVENT& aEvent );
     int ZoneUnfill( const TOOL_EVENT& aEvent );
     int ZoneUnfillAll( const TOOL_EVENT& aEvent );
 
@@ -39,6 +39,59 @@
 #include <tools/global_edit_tool.h>
 #include <tracks_cleaner.h>
 
+#include <algorithm>
+#include <tuple>
+#include <unordered_map>
+
+#include <boost/functional/hash.hpp>
+
+
+/**
+ * The ends, width and layer of a track segment, the ends in a canonical order so a segment
+ * and its reverse have the same key.
+ */
+struct SEGMENT_KEY
+{
+    SEGMENT_KEY( const wxPoint& aA, const wxPoint& aB, int aWidth, PCB_LAYER_ID aLayer ) :
+            m_a( aA ),
+            m_b( aB ),
+            m_width( aWidth ),
+            m_layer( aLayer )
+    {
+        if( std::tie( m_b.x, m_b.y ) < std::tie( m_a.x, m_a.y ) )
+            std::swap( m_a, m_b );
+    }
+
+    bool operator==( const SEGMENT_KEY& aOther ) const
+    {
+        return m_a == aOther.m_a && m_b == aOther.m_b && m_width == aOther.m_width
+               && m_layer == aOther.m_layer;
+    }
+
+    wxPoint      m_a;
+    wxPoint      m_b;
+    int          m_width;
+    PCB_LAYER_ID m_layer;
+};
+
+
+struct SEGMENT_KEY_HASH
+{
+    size_t operator()( const SEGMENT_KEY& aKey ) const
+    {
+        size_t seed = 0;
+
+        boost::hash_combine( seed, aKey.m_a.x );
+        boost::hash_combine( seed, aKey.m_a.y );
+        boost::hash_combine( seed, aKey.m_b.x );
+        boost::hash_combine( seed, aKey.m_b.y );
+        boost::hash_combine( seed, aKey.m_width );
+        boost::hash_combine( seed, (int) aKey.m_layer );
+
+        return seed;
+    }
+};
+
 
 /* Install the cleanup dialog frame to know what should be cleaned
 */
@@ -169,9 +222,15 @@ bool TRACKS_CLEANER::cleanupVias()
             vias.push_back( via );
     }
 
-    for( auto via1_it = vias.begin(); via1_it != vias.end(); via1_it++ )
+    // Superimposed vias are found through their position rather than by comparing every pair
+    std::unordered_map<wxPoint, std::vector<size_t>> viasByPosition;
+
+    for( size_t ii = 0; ii < vias.size(); ++ii )
+        viasByPosition[ vias[ii]->GetPosition() ].push_back( ii );
+
+    for( size_t ii = 0; ii < vias.size(); ++ii )
     {
-        auto via1 = *via1_it;
+        VIA* via1 = vias[ii];
 
         if( via1->IsLocked() )
             continue;
@@ -201,11 +260,14 @@ bool TRACKS_CLEANER::cleanupVias()
             }
         }
 
-        for( auto via2_it = via1_it + 1; via2_it != vias.end(); via2_it++ )
+        const std::vector<size_t>& samePosition = viasByPosition[ via1->GetPosition() ];
+
+        for( auto it = std::upper_bound( samePosition.begin(), samePosition.end(), ii );
+             it != samePosition.end(); ++it )
         {
-            auto via2 = *via2_it;
+            VIA* via2 = vias[*it];
 
-            if( via1->GetPosition() != via2->GetPosition() || via2->IsLocked() )
+            if( via2->IsLocked() )
                 continue;
 
             if( via1->GetViaType() == via2->GetViaType() )
@@ -299,34 +361,38 @@ bool TRACKS_CLEANER::deleteDanglingTracks()
         // Ensure the connectivity is up to date, especially after removind a dangling segment
         m_brd->BuildConnectivity();
 
+        std::vector<TRACK*> dangling;
+
         for( TRACK* track : m_brd->Tracks() )
         {
-            bool flag_erase = false; // Start without a good reason to erase it
-
             // Tst if a track (or a via) endpoint is not connected to another track or to a zone.
             if( testTrackEndpointDangling( track ) )
-                flag_erase = true;
-
-            if( flag_erase )
             {
                 int code = track->IsTrack() ? DRCE_DANGLING_TRACK : DRCE_DANGLING_VIA;
                 DRC_ITEM* item = new DRC_ITEM();
                 item->SetData( m_units, code, track, track->GetPosition() );
                 m_itemsList->push_back( item );
 
-                if( !m_dryRun )
-                {
-                    m_brd->Remove( track );
-                    m_commit.Removed( track );
+                dangling.push_back( track );
+            }
+        }
 
-                    /* keep iterating, because a track connected to the deleted track
-                     * now perhaps is not connected and should be deleted */
-                    item_erased = true;
-                    modified = true;
-                }
-                // Fix me: In dry run we should disable the track to erase and retry with this disabled track
-                // However the connectivity algo does not handle disabled items.
+        // Fix me: In dry run we should disable the track to erase and retry with this disabled
+        // track.  However the connectivity algo does not handle disabled items.
+        if( !m_dryRun && !dangling.empty() )
+        {
+            // The tracks are removed once the list has been walked, which removing them would
+            // invalidate
+            for( TRACK* track : dangling )
+            {
+                m_brd->Remove( track );
+                m_commit.Removed( track );
             }
+
+            /* keep iterating, because a track connected to the deleted track
+             * now perhaps is not connected and should be deleted */
+            item_erased = true;
+            modified = true;
         }
     } while( item_erased ); // A segment was erased: test for some new dangling segments
 
@@ -392,33 +458,71 @@ bool TRACKS_CLEANER::cleanupSegments()
 
     std::set<BOARD_ITEM*> toRemove;
 
-    // Remove duplicate segments (2 superimposed identical segments):
-    for( auto it = m_brd->Tracks().begin(); it != m_brd->Tracks().end(); it++ )
+    // Remove duplicate segments (2 superimposed identical segments).
+    // A segment duplicates a track if both its ends are ends of the track: it is either the
+    // track itself, maybe reversed, or a null segment on one of the track's ends.  Indexing
+    // the tracks by their ends finds them without comparing every pair.
+    std::vector<TRACK*> tracks( m_brd->Tracks().begin(), m_brd->Tracks().end() );
+    std::unordered_map<SEGMENT_KEY, std::vector<size_t>, SEGMENT_KEY_HASH> tracksByEnds;
+
+    for( size_t ii = 0; ii < tracks.size(); ++ii )
     {
-        auto track1 = *it;
+        TRACK* track = tracks[ii];
+
+        tracksByEnds[ SEGMENT_KEY( track->GetStart(), track->GetEnd(), track->GetWidth(),
+                                   track->GetLayer() ) ].push_back( ii );
+    }
+
+    std::vector<size_t> duplicates;
+
+    for( size_t ii = 0; ii < tracks.size(); ++ii )
+    {
+        TRACK* track1 = tracks[ii];
 
         if( track1->Type() != PCB_TRACE_T || track1->HasFlag( IS_DELETED ) || track1->IsLocked() )
             continue;
 
-        for( auto it2 = it + 1; it2 != m_brd->Tracks().end(); it2++ )
+        // Collects the tracks following track1 in the list which have the given key
+        auto collect = [&]( const wxPoint& aA, const wxPoint& aB )
+                       {
+                           auto it = tracksByEnds.find( SEGMENT_KEY( aA, aB, track1->GetWidth(),
+                                                                     track1->GetLayer() ) );
+
+                           if( it == tracksByEnds.end() )
+                               return;
+
+                           const std::vector<size_t>& indices = it->second;
+
+                           duplicates.insert( duplicates.end(),
+                                              std::upper_bound( indices.begin(), indices.end(), ii ),
+                                              indices.end() );
+                       };
+
+        duplicates.clear();
+        collect( track1->GetStart(), track1->GetEnd() );
+
+        if( track1->GetStart() != track1->GetEnd() )
+        {
+            collect( track1->GetStart(), track1->GetStart() );
+            collect( track1->GetEnd(), track1->GetEnd() );
+        }
+
+        // Report them in list order, as a pairwise comparison would
+        std::sort( duplicates.begin(), duplicates.end() );
+
+        for( size_t index : duplicates )
         {
-            auto track2 = *it2;
+            TRACK* track2 = tracks[index];
 
             if( track2->HasFlag( IS_DELETED ) )
                 continue;
 
-            if( track1->IsPointOnEnds( track2->GetStart() )
-                    && track1->IsPointOnEnds( track2->GetEnd() )
-                    && track1->GetWidth() == track2->GetWidth()
-                    && track1->GetLayer() == track2->GetLayer() )
-            {
-                DRC_ITEM* item = new DRC_ITEM();
-                item->SetData( m_units, DRCE_DUPLICATE_TRACK, track2, track2->GetPosition() );
-                m_itemsList->push_back( item );
+            DRC_ITEM* item = new DRC_ITEM();
+            item->SetData( m_units, DRCE_DUPLICATE_TRACK, track2, track2->GetPosition() );
+            m_itemsList->push_back( item );
 
-                track2->SetFlags( IS_DELETED );
-                toRemove.insert( track2 );
-            }
+            track2->SetFlags( IS_DELETED );
+            toRemove.insert( track2 );
         }
     }
 
@@ -23,9 +23,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
-#include <thread>
 #include <algorithm>
-#include <future>
 
 #include <class_board.h>
 #include <class_zone.h>
@@ -36,6 +34,7 @@
 #include <class_pcb_target.h>
 #include <class_track.h>
 #include <connectivity/connectivity_data.h>
+#include <drc/drc_rtree.h>
 #include <board_commit.h>
 #include <widgets/progress_reporter.h>
 #include <geometry/shape_poly_set.h>
@@ -45,6 +44,10 @@
 #include <confirm.h>
 #include <convert_to_biu.h>
 #include <math/util.h>      // for KiROUND
+#include <thread_pool.h>
+
+#include <cmath>
+#include <cstdint>
 
 #include "zone_filler.h"
 
@@ -70,6 +73,40 @@ private:
 };
 
 
+/**
+ * The knockout candidates of a zone fill, indexed by copper layer.  Each item is inserted
+ * with a bounding box that contains every area the clearance tests below can accept, so the
+ * index is only a pre-filter and the item lists keep their board order.
+ */
+struct ZONE_FILLER::KNOCKOUT_INDEX
+{
+    DRC_RTREE<D_PAD*>           m_pads;
+    DRC_RTREE<TRACK*>           m_tracks;
+    DRC_RTREE<BOARD_ITEM*>      m_graphics;
+    DRC_RTREE<ZONE_CONTAINER*>  m_zones;
+};
+
+
+/**
+ * The knockout candidates of one zone: the indexed items whose bounding box intersects the
+ * zone's bounding box inflated by the biggest clearance.
+ */
+struct ZONE_FILLER::KNOCKOUT_CANDIDATES
+{
+    EDA_RECT                     m_bbox;
+    std::vector<D_PAD*>          m_pads;
+    std::vector<TRACK*>          m_tracks;
+    std::vector<BOARD_ITEM*>     m_graphics;
+    std::vector<ZONE_CONTAINER*> m_zones;
+};
+
+
+// a small extra clearance to be sure actual track clearance is not smaller
+// than requested clearance due to many approximations in calculations,
+// like arc to segment approx, rounding issues...
+// 2 microns are a good value
+static const int s_ExtraClearanceMargin = Millimeter2iu( 0.002 );
+
 static const double s_RoundPadThermalSpokeAngle = 450;
 static const bool s_DumpZonesWhenFilling = false;
 
@@ -98,7 +135,7 @@ void ZONE_FILLER::InstallNewProgressReporter( wxWindow* aParent, const wxString&
 }
 
 
-bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck )
+bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck, bool aForce )
 {
     std::vector<CN_ZONE_ISOLATED_ISLAND_LIST> toFill;
     auto connectivity = m_board->GetConnectivity();
@@ -119,12 +156,25 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
     m_boardOutline.RemoveAllContours();
     m_brdOutlinesValid = m_board->GetBoardPolygonOutlines( m_boardOutline );
 
+    // The knockout candidates are shared (read only) by all the fill threads
+    buildKnockoutIndex();
+
+    std::vector<uint64_t> inputHashes;
+
     for( auto zone : aZones )
     {
         // Keepout zones are not filled
         if( zone->GetIsKeepout() )
             continue;
 
+        // Zones whose inputs did not change since their last fill keep that fill
+        uint64_t inputHash = computeFillInputHash( zone, filledPolyWithOutline );
+
+        if( !aForce && zone->IsFilled() && zone->GetFillInputHash() == inputHash )
+            continue;
+
+        inputHashes.push_back( inputHash );
+
         if( m_commit )
             m_commit->Modify( zone );
 
@@ -140,54 +190,44 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         zone->UnFill();
     }
 
-    std::atomic<size_t> nextItem( 0 );
-    size_t              parallelThreadCount =
-            std::min<size_t>( std::thread::hardware_concurrency(), aZones.size() );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
-
-    auto fill_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
+    // Every zone is up to date
+    if( toFill.empty() )
     {
-        size_t num = 0;
+        m_knockoutIndex.reset();
+        return true;
+    }
 
-        for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
-        {
-            ZONE_CONTAINER* zone = toFill[i].m_zone;
-            zone->SetFilledPolysUseThickness( filledPolyWithOutline );
-            SHAPE_POLY_SET rawPolys, finalPolys;
-            fillSingleZone( zone, rawPolys, finalPolys );
+    TASK_GROUP fillTasks( m_progressReporter );
 
-            zone->SetRawPolysList( rawPolys );
-            zone->SetFilledPolysList( finalPolys );
-            zone->SetIsFilled( true );
+    fillTasks.ParallelFor( toFill.size(),
+            [&]( size_t i )
+            {
+                ZONE_CONTAINER* zone = toFill[i].m_zone;
+                zone->SetFilledPolysUseThickness( filledPolyWithOutline );
+                SHAPE_POLY_SET rawPolys, finalPolys;
+                fillSingleZone( zone, rawPolys, finalPolys );
 
-            if( m_progressReporter )
-                m_progressReporter->AdvanceProgress();
+                zone->SetRawPolysList( rawPolys );
+                zone->SetFilledPolysList( finalPolys );
+                zone->SetIsFilled( true );
+                zone->SetFillInputHash( inputHashes[i] );
 
-            num++;
-        }
+                if( m_progressReporter )
+                    m_progressReporter->AdvanceProgress();
+            } );
 
-        return num;
-    };
+    bool filled = fillTasks.Wait();
 
-    if( parallelThreadCount <= 1 )
-        fill_lambda( m_progressReporter );
-    else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, fill_lambda, m_progressReporter );
+    // The index holds pointers to the board items, which may be deleted after Fill()
+    m_knockoutIndex.reset();
 
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
+    if( !filled )
+    {
+        // Cancelled: the zones not filled yet were already emptied, so get them back
+        if( m_commit )
+            m_commit->Revert();
 
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
-        }
+        return false;
     }
 
     // Now update the connectivity to check for copper islands
@@ -275,44 +315,19 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
     }
 
 
-    nextItem = 0;
-
-    auto tri_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
-    {
-        size_t num = 0;
-
-        for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
-        {
-            toFill[i].m_zone->CacheTriangulation();
-            num++;
-
-            if( m_progressReporter )
-                m_progressReporter->AdvanceProgress();
-        }
-
-        return num;
-    };
-
-    if( parallelThreadCount <= 1 )
-        tri_lambda( m_progressReporter );
-    else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, tri_lambda, m_progressReporter );
+    // The polygons are not modified any more, the cancel button is ignored from here
+    TASK_GROUP triangulationTasks( m_progressReporter, false );
 
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
+    triangulationTasks.ParallelFor( toFill.size(),
+            [&]( size_t i )
             {
+                toFill[i].m_zone->CacheTriangulation();
+
                 if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
+                    m_progressReporter->AdvanceProgress();
+            } );
 
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
-        }
-    }
+    triangulationTasks.Wait();
 
     if( m_progressReporter )
     {
@@ -510,28 +525,404 @@ void ZONE_FILLER::knockoutThermalReliefs( const ZONE_CONTAINER* aZone, SHAPE_POL
 }
 
 
+void ZONE_FILLER::buildKnockoutIndex()
+{
+    m_knockoutIndex = std::make_unique<KNOCKOUT_INDEX>();
+
+    // Pads not on the zone's layer still knock out their hole (see setupDummyPadForHole()),
+    // whose clearance can be any netclass clearance.
+    int biggest_clearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
+
+    for( MODULE* module : m_board->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+        {
+            EDA_RECT bbox = pad->GetBoundingBox();
+            LSET     layers = pad->GetLayerSet();
+
+            if( pad->GetDrillSize().x != 0 || pad->GetDrillSize().y != 0 )
+            {
+                int radius = std::max( pad->GetDrillSize().x, pad->GetDrillSize().y ) / 2;
+                EDA_RECT hole( pad->GetPosition(), wxSize( 0, 0 ) );
+
+                hole.Inflate( radius );
+                bbox.Merge( hole );
+                bbox.Inflate( std::max( pad->GetClearance(), biggest_clearance ) );
+                layers = LSET::AllCuMask();
+            }
+            else
+            {
+                bbox.Inflate( pad->GetClearance() );
+            }
+
+            m_knockoutIndex->m_pads.Insert( pad, bbox, layers );
+        }
+    }
+
+    for( TRACK* track : m_board->Tracks() )
+        m_knockoutIndex->m_tracks.Insert( track, track->GetBoundingBox(), track->GetLayerSet() );
+
+    auto addGraphicItem = [&]( BOARD_ITEM* aItem )
+    {
+        // A item on the Edge_Cuts is always seen as on any layer:
+        LSET layers = aItem->IsOnLayer( Edge_Cuts ) ? LSET::AllCuMask() : aItem->GetLayerSet();
+
+        m_knockoutIndex->m_graphics.Insert( aItem, aItem->GetBoundingBox(), layers );
+    };
+
+    for( MODULE* module : m_board->Modules() )
+    {
+        addGraphicItem( &module->Reference() );
+        addGraphicItem( &module->Value() );
+
+        for( BOARD_ITEM* item : module->GraphicalItems() )
+            addGraphicItem( item );
+    }
+
+    for( BOARD_ITEM* item : m_board->Drawings() )
+        addGraphicItem( item );
+
+    for( ZONE_CONTAINER* zone : m_board->GetZoneList( true ) )
+        m_knockoutIndex->m_zones.Insert( zone, zone->GetBoundingBox(), zone->GetLayerSet() );
+}
+
+
+void ZONE_FILLER::collectKnockoutCandidates( const ZONE_CONTAINER* aZone,
+                                             KNOCKOUT_CANDIDATES& aCandidates ) const
+{
+    // items outside the zone bounding box are skipped
+    // the bounding box is the zone bounding box + the biggest clearance found in Netclass list
+    int biggest_clearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
+    biggest_clearance = std::max( biggest_clearance, aZone->GetClearance() );
+
+    aCandidates.m_bbox = aZone->GetBoundingBox();
+    aCandidates.m_bbox.Inflate( biggest_clearance + s_ExtraClearanceMargin );
+
+    // The index only holds copper layers, so zones on other layers still walk every item.
+    if( IsCopperLayer( aZone->GetLayer() ) )
+    {
+        const EDA_RECT& bbox = aCandidates.m_bbox;
+        LSET            zoneLayer( aZone->GetLayer() );
+
+        m_knockoutIndex->m_pads.Query( bbox, zoneLayer, aCandidates.m_pads );
+        m_knockoutIndex->m_tracks.Query( bbox, zoneLayer, aCandidates.m_tracks );
+        m_knockoutIndex->m_graphics.Query( bbox, zoneLayer, aCandidates.m_graphics );
+        m_knockoutIndex->m_zones.Query( bbox, zoneLayer, aCandidates.m_zones );
+    }
+    else
+    {
+        aCandidates.m_pads = m_knockoutIndex->m_pads.Items();
+        aCandidates.m_tracks = m_knockoutIndex->m_tracks.Items();
+        aCandidates.m_graphics = m_knockoutIndex->m_graphics.Items();
+        aCandidates.m_zones = m_knockoutIndex->m_zones.Items();
+    }
+}
+
+
+/**
+ * FILL_INPUT_HASHER
+ * hashes the fill inputs of a zone with 64 bit FNV-1a, over a fixed serialisation of the values
+ * (64 bit little endian integers, UTF-8 strings).  Every value is mixed in turn, so that the
+ * changes of several values do not cancel out, and the hash saved with a fill is the same for
+ * every build.  Only what the board file keeps is hashed, so the hash of a board read back
+ * from its file matches the saved one.
+ */
+class FILL_INPUT_HASHER
+{
+public:
+    FILL_INPUT_HASHER() :
+            m_hash( 0xcbf29ce484222325ULL )
+    {
+    }
+
+    void AddInt( long long aValue )
+    {
+        uint64_t value = static_cast<uint64_t>( aValue );
+
+        for( int ii = 0; ii < 8; ++ii )
+        {
+            m_hash ^= ( value >> ( 8 * ii ) ) & 0xFF;
+            m_hash *= 0x100000001b3ULL;
+        }
+    }
+
+    /**
+     * Adds a real (an angle or a ratio) rounded to 1e-4: the board file keeps 10 significant
+     * digits of them, so a value read back from the file may differ in its last bits.
+     */
+    void AddReal( double aValue )
+    {
+        AddInt( std::llround( aValue * 1e4 ) );
+    }
+
+    void AddText( const wxString& aText )
+    {
+        const wxScopedCharBuffer utf8 = aText.utf8_str();
+
+        AddInt( utf8.length() );
+
+        for( size_t ii = 0; ii < utf8.length(); ++ii )
+        {
+            m_hash ^= static_cast<unsigned char>( utf8.data()[ii] );
+            m_hash *= 0x100000001b3ULL;
+        }
+    }
+
+    void AddPoint( const VECTOR2I& aPoint )
+    {
+        AddInt( aPoint.x );
+        AddInt( aPoint.y );
+    }
+
+    void AddBox( const EDA_RECT& aBox )
+    {
+        AddInt( aBox.GetX() );
+        AddInt( aBox.GetY() );
+        AddInt( aBox.GetRight() );
+        AddInt( aBox.GetBottom() );
+    }
+
+    void AddPolySet( const SHAPE_POLY_SET& aPolySet )
+    {
+        AddInt( aPolySet.OutlineCount() );
+
+        for( int ii = 0; ii < aPolySet.OutlineCount(); ++ii )
+        {
+            AddInt( aPolySet.HoleCount( ii ) );
+
+            for( int jj = -1; jj < aPolySet.HoleCount( ii ); ++jj )
+            {
+                const SHAPE_LINE_CHAIN& chain = jj < 0 ? aPolySet.COutline( ii )
+                                                       : aPolySet.CHole( ii, jj );
+
+                AddInt( chain.PointCount() );
+
+                for( int kk = 0; kk < chain.PointCount(); ++kk )
+                    AddPoint( chain.CPoint( kk ) );
+            }
+        }
+    }
+
+    /**
+     * Adds the type, layers, net, extents and clearance of aItem, which every knockout
+     * candidate has.  Neither the UUID (footprint items get a new one on each load) nor the
+     * net code (renumbered on save) is kept by the board file, so the net is known by its name.
+     */
+    void AddItem( const BOARD_ITEM* aItem, int aClearance )
+    {
+        AddInt( aItem->Type() );
+        AddInt( static_cast<long long>( aItem->GetLayerSet().to_ullong() ) );
+        AddBox( aItem->GetBoundingBox() );
+        AddInt( aClearance );
+
+        if( aItem->IsConnected() )
+            AddText( static_cast<const BOARD_CONNECTED_ITEM*>( aItem )->GetNetname() );
+    }
+
+    /**
+     * Adds the hashes of a list of items in a sorted order, so that the order of the items
+     * in the board, which can change when the board is saved and read back, does not matter.
+     */
+    void AddUnordered( std::vector<uint64_t>& aHashes )
+    {
+        std::sort( aHashes.begin(), aHashes.end() );
+
+        AddInt( aHashes.size() );
+
+        for( uint64_t hash : aHashes )
+            AddInt( static_cast<long long>( hash ) );
+    }
+
+    ///> Returns the hash, never 0 which stands for unknown fill inputs
+    uint64_t Get() const
+    {
+        return m_hash ? m_hash : 1;
+    }
+
+private:
+    uint64_t m_hash;
+};
+
+
+// The outline of a zone, and what its knockout depends on
+static void hashZoneOutline( FILL_INPUT_HASHER& aHasher, const ZONE_CONTAINER* aZone )
+{
+    aHasher.AddItem( aZone, aZone->GetClearance() );
+    aHasher.AddPolySet( *aZone->Outline() );
+    aHasher.AddInt( aZone->GetPriority() );
+    aHasher.AddInt( aZone->GetIsKeepout() );
+    aHasher.AddInt( aZone->GetDoNotAllowCopperPour() );
+    aHasher.AddInt( aZone->GetZoneClearance() );
+    aHasher.AddInt( aZone->GetCornerSmoothingType() );
+    aHasher.AddInt( aZone->GetCornerRadius() );
+}
+
+
+uint64_t ZONE_FILLER::computeFillInputHash( const ZONE_CONTAINER* aZone,
+                                            bool aFilledPolysUseThickness ) const
+{
+    BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+    KNOCKOUT_CANDIDATES    candidates;
+    FILL_INPUT_HASHER      hasher;
+
+    collectKnockoutCandidates( aZone, candidates );
+
+    hashZoneOutline( hasher, aZone );
+    hasher.AddInt( aZone->GetMinThickness() );
+    hasher.AddInt( aFilledPolysUseThickness );
+    hasher.AddInt( static_cast<int>( aZone->GetFillMode() ) );
+    hasher.AddInt( static_cast<int>( aZone->GetPadConnection() ) );
+    hasher.AddInt( aZone->GetThermalReliefGap() );
+    hasher.AddInt( aZone->GetThermalReliefCopperBridge() );
+    hasher.AddInt( aZone->GetHatchFillTypeThickness() );
+    hasher.AddInt( aZone->GetHatchFillTypeGap() );
+    hasher.AddReal( aZone->GetHatchFillTypeOrientation() );
+    hasher.AddInt( aZone->GetHatchFillTypeSmoothingLevel() );
+    hasher.AddReal( aZone->GetHatchFillTypeSmoothingValue() );
+
+    hasher.AddInt( bds.m_MaxError );
+    hasher.AddInt( bds.m_CopperEdgeClearance );
+
+    // Each candidate is hashed on its own; the counts keep the lists apart
+    std::vector<uint64_t> itemHashes;
+
+    for( D_PAD* pad : candidates.m_pads )
+    {
+        FILL_INPUT_HASHER item;
+
+        item.AddItem( pad, pad->GetClearance() );
+        item.AddPoint( pad->GetPosition() );
+        item.AddInt( pad->GetShape() );
+        item.AddInt( pad->GetAnchorPadShape() );
+        item.AddInt( pad->GetAttribute() );
+        item.AddPoint( pad->GetSize() );
+        item.AddPoint( pad->GetOffset() );
+        item.AddPoint( pad->GetDelta() );
+        item.AddReal( pad->GetOrientation() );
+        item.AddInt( pad->GetDrillShape() );
+        item.AddPoint( pad->GetDrillSize() );
+        item.AddReal( pad->GetRoundRectRadiusRatio() );
+        item.AddReal( pad->GetChamferRectRatio() );
+        item.AddInt( pad->GetChamferPositions() );
+        item.AddPolySet( pad->GetCustomShapeAsPolygon() );
+        item.AddInt( static_cast<int>( aZone->GetPadConnection( pad ) ) );
+        item.AddInt( aZone->GetThermalReliefGap( pad ) );
+        item.AddInt( aZone->GetThermalReliefCopperBridge( pad ) );
+        itemHashes.push_back( item.Get() );
+    }
+
+    hasher.AddUnordered( itemHashes );
+    itemHashes.clear();
+
+    for( TRACK* track : candidates.m_tracks )
+    {
+        FILL_INPUT_HASHER item;
+
+        item.AddItem( track, track->GetClearance() );
+        item.AddPoint( track->GetStart() );
+        item.AddPoint( track->GetEnd() );
+        item.AddInt( track->GetWidth() );
+
+        if( track->Type() == PCB_ARC_T )
+            item.AddPoint( static_cast<ARC*>( track )->GetMid() );
+
+        if( track->Type() == PCB_VIA_T )
+        {
+            VIA* via = static_cast<VIA*>( track );
+
+            item.AddInt( static_cast<int>( via->GetViaType() ) );
+            item.AddInt( via->GetDrillValue() );
+        }
+
+        itemHashes.push_back( item.Get() );
+    }
+
+    hasher.AddUnordered( itemHashes );
+    itemHashes.clear();
+
+    for( BOARD_ITEM* graphic : candidates.m_graphics )
+    {
+        FILL_INPUT_HASHER item;
+
+        // Dimensions and targets are only known by their extents
+        item.AddItem( graphic, 0 );
+
+        if( DRAWSEGMENT* segment = dynamic_cast<DRAWSEGMENT*>( graphic ) )
+        {
+            item.AddInt( segment->GetShape() );
+            item.AddInt( segment->GetWidth() );
+            item.AddPoint( segment->GetStart() );
+            item.AddPoint( segment->GetEnd() );
+            item.AddPoint( segment->GetBezControl1() );
+            item.AddPoint( segment->GetBezControl2() );
+            item.AddReal( segment->GetAngle() );
+            item.AddPolySet( segment->GetPolyShape() );
+        }
+
+        if( EDA_TEXT* text = dynamic_cast<EDA_TEXT*>( graphic ) )
+        {
+            TEXTE_MODULE* moduleText = dynamic_cast<TEXTE_MODULE*>( graphic );
+
+            item.AddText( text->GetShownText() );
+            item.AddPoint( text->GetTextPos() );
+            item.AddInt( text->GetTextWidth() );
+            item.AddInt( text->GetTextHeight() );
+            item.AddInt( text->GetThickness() );
+            item.AddReal( moduleText ? moduleText->GetDrawRotation() : text->GetTextAngle() );
+            item.AddInt( text->IsItalic() );
+            item.AddInt( text->IsBold() );
+            item.AddInt( text->IsMirrored() );
+            item.AddInt( text->IsVisible() );
+            item.AddInt( text->GetHorizJustify() );
+            item.AddInt( text->GetVertJustify() );
+        }
+
+        itemHashes.push_back( item.Get() );
+    }
+
+    hasher.AddUnordered( itemHashes );
+    itemHashes.clear();
+
+    for( ZONE_CONTAINER* zone : candidates.m_zones )
+    {
+        if( zone == aZone )
+            continue;
+
+        FILL_INPUT_HASHER item;
+
+        hashZoneOutline( item, zone );
+        itemHashes.push_back( item.Get() );
+    }
+
+    hasher.AddUnordered( itemHashes );
+
+    // Copper outside the board outlines is removed
+    hasher.AddInt( m_brdOutlinesValid );
+
+    if( m_brdOutlinesValid )
+        hasher.AddPolySet( m_boardOutline );
+
+    return hasher.Get();
+}
+
+
 /**
  * Removes clearance from the shape for copper items which share the zone's layer but are
  * not connected to it.
  */
 void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aHoles )
 {
-    // a small extra clearance to be sure actual track clearance is not smaller
-    // than requested clearance due to many approximations in calculations,
-    // like arc to segment approx, rounding issues...
-    // 2 microns are a good value
-    int extra_margin = Millimeter2iu( 0.002 );
+    int extra_margin = s_ExtraClearanceMargin;
 
     int zone_clearance = aZone->GetClearance();
     int edgeClearance = m_board->GetDesignSettings().m_CopperEdgeClearance;
     int zone_to_edgecut_clearance = std::max( aZone->GetZoneClearance(), edgeClearance );
 
-    // items outside the zone bounding box are skipped
-    // the bounding box is the zone bounding box + the biggest clearance found in Netclass list
-    EDA_RECT zone_boundingbox = aZone->GetBoundingBox();
-    int biggest_clearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
-    biggest_clearance = std::max( biggest_clearance, zone_clearance ) + extra_margin;
-    zone_boundingbox.Inflate( biggest_clearance );
+    // Only the items near the zone are visited.  The index returns them in board order.
+    KNOCKOUT_CANDIDATES candidates;
+    collectKnockoutCandidates( aZone, candidates );
+
+    const EDA_RECT& zone_boundingbox = candidates.m_bbox;
 
     // Use a dummy pad to calculate hole clearance when a pad has a hole but is not on the
     // zone's copper layer.  The dummy pad has the size and shape of the original pad's hole.
@@ -542,48 +933,45 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
 
     // Add non-connected pad clearances
     //
-    for( auto module : m_board->Modules() )
+    for( D_PAD* pad : candidates.m_pads )
     {
-        for( auto pad : module->Pads() )
+        if( !pad->IsOnLayer( aZone->GetLayer() ) )
         {
-            if( !pad->IsOnLayer( aZone->GetLayer() ) )
-            {
-                if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
-                    continue;
+            if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
+                continue;
 
-                setupDummyPadForHole( pad, dummypad );
-                pad = &dummypad;
-            }
+            setupDummyPadForHole( pad, dummypad );
+            pad = &dummypad;
+        }
 
-            if( pad->GetNetCode() != aZone->GetNetCode() || pad->GetNetCode() <= 0
-                    || aZone->GetPadConnection( pad ) == ZONE_CONNECTION::NONE )
+        if( pad->GetNetCode() != aZone->GetNetCode() || pad->GetNetCode() <= 0
+                || aZone->GetPadConnection( pad ) == ZONE_CONNECTION::NONE )
+        {
+            // for pads having a netcode different from the zone, use the net clearance:
+            int gap = std::max( zone_clearance, pad->GetClearance() );
+
+            // for pads having the same netcode as the zone, the net clearance has no
+            // meaning (clearance between object of the same net is 0) and the
+            // zone_clearance can be set to 0 (In this case the netclass clearance is used)
+            // therefore use the antipad clearance (thermal clearance) or the
+            // zone_clearance if bigger.
+            if( pad->GetNetCode() > 0 && pad->GetNetCode() == aZone->GetNetCode() )
             {
-                // for pads having a netcode different from the zone, use the net clearance:
-                int gap = std::max( zone_clearance, pad->GetClearance() );
-
-                // for pads having the same netcode as the zone, the net clearance has no
-                // meaning (clearance between object of the same net is 0) and the
-                // zone_clearance can be set to 0 (In this case the netclass clearance is used)
-                // therefore use the antipad clearance (thermal clearance) or the
-                // zone_clearance if bigger.
-                if( pad->GetNetCode() > 0 && pad->GetNetCode() == aZone->GetNetCode() )
-                {
-                    int thermalGap = aZone->GetThermalReliefGap( pad );
-                    gap = std::max( zone_clearance, thermalGap );;
-                }
+                int thermalGap = aZone->GetThermalReliefGap( pad );
+                gap = std::max( zone_clearance, thermalGap );;
+            }
 
-                EDA_RECT item_boundingbox = pad->GetBoundingBox();
-                item_boundingbox.Inflate( pad->GetClearance() );
+            EDA_RECT item_boundingbox = pad->GetBoundingBox();
+            item_boundingbox.Inflate( pad->GetClearance() );
 
-                if( item_boundingbox.Intersects( zone_boundingbox ) )
-                    addKnockout( pad, gap, aHoles );
-            }
+            if( item_boundingbox.Intersects( zone_boundingbox ) )
+                addKnockout( pad, gap, aHoles );
         }
     }
 
     // Add non-connected track clearances
     //
-    for( auto track : m_board->Tracks() )
+    for( TRACK* track : candidates.m_tracks )
     {
         if( !track->IsOnLayer( aZone->GetLayer() ) )
             continue;
@@ -624,21 +1012,12 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
         addKnockout( aItem, gap, ignoreLineWidth, aHoles );
     };
 
-    for( auto module : m_board->Modules() )
-    {
-        doGraphicItem( &module->Reference() );
-        doGraphicItem( &module->Value() );
-
-        for( auto item : module->GraphicalItems() )
-            doGraphicItem( item );
-    }
-
-    for( auto item : m_board->Drawings() )
+    for( BOARD_ITEM* item : candidates.m_graphics )
         doGraphicItem( item );
 
     // Add zones outlines having an higher priority and keepout
     //
-    for( ZONE_CONTAINER* zone : m_board->GetZoneList( true ) )
+    for( ZONE_CONTAINER* zone : candidates.m_zones )
     {
 
         // If the zones share no common layers
@@ -675,8 +1054,6 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
 
         zone->TransformOutlinesShapeWithClearanceToPolygon( aHoles, minClearance, useNetClearance );
     }
-
-    aHoles.Simplify( SHAPE_POLY_SET::PM_FAST );
 }
 
 
@@ -739,8 +1116,11 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
 
     buildCopperItemClearances( aZone, clearanceHoles );
 
+    // The knockouts before their union, which is the bulk of the fill of a busy board
     if( s_DumpZonesWhenFilling )
-        dumper->Write( &aRawPolys, "clearance holes" );
+        dumper->Write( &clearanceHoles, "clearance holes" );
+
+    clearanceHoles.BatchUnion( SHAPE_POLY_SET::PM_FAST, PoolParallelFor );
 
     buildThermalSpokes( aZone, thermalSpokes );
 
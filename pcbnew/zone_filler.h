@@ -26,6 +26,7 @@
 #ifndef __ZONE_FILLER_H
 #define __ZONE_FILLER_H
 
+#include <memory>
 #include <vector>
 #include <class_zone.h>
 
@@ -43,10 +44,23 @@ public:
     ~ZONE_FILLER();
 
     void InstallNewProgressReporter( wxWindow* aParent, const wxString& aTitle, int aNumPhases );
-    bool Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck = false );
+
+    /**
+     * Function Fill
+     * fills aZones, except the zones whose fill inputs did not change since their last fill,
+     * unless aForce is set.
+     * @param aCheck = true to ask the user before changing out of date fills
+     * @param aForce = true to refill every zone of aZones
+     * @return bool - false if the fill was cancelled or the connectivity is busy
+     */
+    bool Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck = false,
+               bool aForce = false );
 
 private:
 
+    struct KNOCKOUT_INDEX;
+    struct KNOCKOUT_CANDIDATES;
+
     void addKnockout( D_PAD* aPad, int aGap, SHAPE_POLY_SET& aHoles );
 
     void addKnockout( BOARD_ITEM* aItem, int aGap, bool aIgnoreLineWidth, SHAPE_POLY_SET& aHoles );
@@ -55,6 +69,32 @@ private:
 
     void buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aHoles );
 
+    /**
+     * Function buildKnockoutIndex
+     * Indexes the board items which can knock out copper from a zone (pads and their holes,
+     * tracks, vias, graphic items and zones) by layer and bounding box.  The index is built
+     * once per Fill() call, only read by the fill threads, and released before Fill() returns.
+     */
+    void buildKnockoutIndex();
+
+    /**
+     * Function collectKnockoutCandidates
+     * Collects from the knockout index the items which can affect the fill of aZone.
+     */
+    void collectKnockoutCandidates( const ZONE_CONTAINER* aZone,
+                                    KNOCKOUT_CANDIDATES& aCandidates ) const;
+
+    /**
+     * Function computeFillInputHash
+     * Hashes everything the fill of aZone depends on: its outline and fill settings, the
+     * knockout candidates and the board outlines, in a fixed order and byte layout, so that
+     * the hash saved in the board file is the same for every build and after the board is
+     * read back.  A zone whose hash matches the one stored with its fill does not need to be
+     * refilled.
+     */
+    uint64_t computeFillInputHash( const ZONE_CONTAINER* aZone,
+                                   bool aFilledPolysUseThickness ) const;
+
     /**
      * Function computeRawFilledArea
      * Add non copper areas polygons (pads and tracks with clearance)
@@ -104,6 +144,7 @@ private:
     void addHatchFillTypeOnZone( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPolys );
 
     BOARD* m_board;
+    std::unique_ptr<KNOCKOUT_INDEX> m_knockoutIndex;
     SHAPE_POLY_SET m_boardOutline;      // The board outlines, if exists
     bool m_brdOutlinesValid;            // true if m_boardOutline can be calculated
                                         // false if not (not closed outlines for instance)
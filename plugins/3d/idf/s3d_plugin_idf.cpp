@@ -33,6 +33,7 @@
 #include <wx/string.h>
 
 #include "plugins/3d/3d_plugin.h"
+#include "plugins/3d/3d_plugin_locale.h"
 #include "plugins/3dapi/ifsg_all.h"
 #include "idf_parser.h"
 #include "vrml_layer.h"
@@ -72,21 +73,6 @@ static bool addSegment( VRML_LAYER& model, IDF_SEGMENT* seg, int icont, int iseg
 static SCENEGRAPH* vrmlToSG( VRML_LAYER& vpcb, int idxColor, SGNODE* aParent, double top, double bottom );
 
 
-class LOCALESWITCH
-{
-public:
-    LOCALESWITCH()
-    {
-        setlocale( LC_NUMERIC, "C" );
-    }
-
-    ~LOCALESWITCH()
-    {
-        setlocale( LC_NUMERIC, "" );
-    }
-};
-
-
 static SGNODE* getColor( IFSG_SHAPE& shape, int colorIdx )
 {
     IFSG_APPEARANCE material( shape );
@@ -605,7 +591,7 @@ static SCENEGRAPH* addOutline( IDF3_COMP_OUTLINE* outline, int idxColor, SGNODE*
 
 static SCENEGRAPH* loadIDFOutline( const wxString& aFileName )
 {
-    LOCALESWITCH switcher;
+    THREAD_C_LOCALE switcher;
     IDF3_BOARD brd( IDF3::CAD_ELEC );
     IDF3_COMP_OUTLINE* outline = NULL;
 
@@ -636,7 +622,7 @@ static SCENEGRAPH* loadIDFOutline( const wxString& aFileName )
 
 static SCENEGRAPH* loadIDFBoard( const wxString& aFileName )
 {
-    LOCALESWITCH switcher;
+    THREAD_C_LOCALE switcher;
     IDF3_BOARD brd( IDF3::CAD_ELEC );
 
     // note: if the IDF model is defective no outline substitutes shall be made
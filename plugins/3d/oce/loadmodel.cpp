@@ -22,11 +22,14 @@
  */
 
 #include <iostream>
+#include <atomic>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <cstring>
 #include <map>
+#include <mutex>
+#include <shared_mutex>
 #include <vector>
 #include <wx/string.h>
 #include <wx/wfstream.h>
@@ -387,8 +390,46 @@ void addItems( SGNODE* parent, std::vector< SGNODE* >* lp )
 }
 
 
+// OCE's translation parameters are process-wide statics, shared by its STEP and IGES readers.
+// They are set for STEP once, so that STEP models can be read by several threads at once, and
+// an IGES read changes them for its own duration, with no STEP read running.
+static std::once_flag          s_readersInit;
+static bool                    s_readersOk = false;
+static std::shared_timed_mutex s_parametersLock;
+
+// The application's list of documents is not safe to change from several threads at once
+static std::mutex              s_appLock;
+
+
+static bool initReaders()
+{
+    std::call_once( s_readersInit,
+            []()
+            {
+                // Creating the readers registers their parameters
+                STEPCAFControl_Reader stepReader;
+                IGESCAFControl_Reader igesReader;
+
+                // Enable user-defined shape precision, and set it to USER_PREC (default
+                // 0.0001 has too many triangles)
+                s_readersOk = Interface_Static::SetIVal( "read.precision.mode", 1 )
+                              && Interface_Static::SetRVal( "read.precision.val", USER_PREC );
+            } );
+
+    return s_readersOk;
+}
+
+
 bool readIGES( Handle(TDocStd_Document)& m_doc, const char* fname )
 {
+    std::unique_lock<std::shared_timed_mutex> lock( s_parametersLock );
+
+    // Back to the STEP parameters however the read ends
+    struct RESTORE_PRECISION_MODE
+    {
+        ~RESTORE_PRECISION_MODE() { Interface_Static::SetIVal( "read.precision.mode", 1 ); }
+    } restore;
+
     IGESCAFControl_Reader reader;
     IFSelect_ReturnStatus stat  = reader.ReadFile( fname );
     reader.PrintCheckLoad( Standard_False, IFSelect_ItemsByEntity );
@@ -418,20 +459,15 @@ bool readIGES( Handle(TDocStd_Document)& m_doc, const char* fname )
 
 bool readSTEP( Handle(TDocStd_Document)& m_doc, const char* fname )
 {
+    // The precision parameters were set by initReaders()
+    std::shared_lock<std::shared_timed_mutex> lock( s_parametersLock );
+
     STEPCAFControl_Reader reader;
     IFSelect_ReturnStatus stat  = reader.ReadFile( fname );
 
     if( stat != IFSelect_RetDone )
         return false;
 
-    // Enable user-defined shape precision
-    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
-        return false;
-
-    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
-    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
-        return false;
-
     // set other translation options
     reader.SetColorMode(true);  // use model colors
     reader.SetNameMode(false);  // don't use label names
@@ -455,8 +491,15 @@ SCENEGRAPH* LoadModel( char const* filename )
 {
     DATA data;
 
-    Handle(XCAFApp_Application) m_app = XCAFApp_Application::GetApplication();
-    m_app->NewDocument( "MDTV-XCAF", data.m_doc );
+    if( !initReaders() )
+        return NULL;
+
+    {
+        std::lock_guard<std::mutex> lock( s_appLock );
+        Handle(XCAFApp_Application) m_app = XCAFApp_Application::GetApplication();
+        m_app->NewDocument( "MDTV-XCAF", data.m_doc );
+    }
+
     FormatType modelFmt = fileType( filename );
 
     switch( modelFmt )
@@ -563,7 +606,7 @@ bool processSolid( const TopoDS_Shape& shape, DATA& data, SGNODE* parent,
 
     if( label.IsNull() )
     {
-        static int i = 0;
+        static std::atomic<int> i( 0 );
         std::ostringstream ostr;
         ostr << "KMISC_" << i++;
         partID = ostr.str();
@@ -153,6 +153,13 @@ bool CanRender( void )
 }
 
 
+bool IsReentrant( void )
+{
+    // the readers' shared parameters are set once and guarded, see loadmodel.cpp
+    return true;
+}
+
+
 SCENEGRAPH* Load( char const* aFileName )
 {
     if( NULL == aFileName )
@@ -28,6 +28,7 @@
 #include <iterator>
 #include <cctype>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <algorithm>
 #include <wx/log.h>
@@ -40,6 +41,7 @@ static std::set< std::string > badNames;
 typedef std::pair< std::string, WRL2NODES > NODEITEM;
 typedef std::map< std::string, WRL2NODES > NODEMAP;
 static NODEMAP nodenames;
+static std::once_flag tablesInit;
 
 
 WRL2NODE::WRL2NODE()
@@ -48,81 +50,79 @@ WRL2NODE::WRL2NODE()
     m_Parent = NULL;
     m_Type = WRL2_END;
 
-    if( badNames.empty() )
-    {
-        badNames.insert( "DEF" );
-        badNames.insert( "EXTERNPROTO" );
-        badNames.insert( "FALSE" );
-        badNames.insert( "IS" );
-        badNames.insert( "NULL" );
-        badNames.insert( "PROTO" );
-        badNames.insert( "ROUTE" );
-        badNames.insert( "TO" );
-        badNames.insert( "TRUE" );
-        badNames.insert( "USE" );
-        badNames.insert( "eventIn" );
-        badNames.insert( "eventOut" );
-        badNames.insert( "exposedField" );
-        badNames.insert( "field" );
-    }
-
-    if( nodenames.empty() )
-    {
-        nodenames.insert( NODEITEM( "Anchor", WRL2_ANCHOR ) );
-        nodenames.insert( NODEITEM( "Appearance", WRL2_APPEARANCE ) );
-        nodenames.insert( NODEITEM( "Audioclip", WRL2_AUDIOCLIP ) );
-        nodenames.insert( NODEITEM( "Background", WRL2_BACKGROUND ) );
-        nodenames.insert( NODEITEM( "Billboard", WRL2_BILLBOARD ) );
-        nodenames.insert( NODEITEM( "Box", WRL2_BOX ) );
-        nodenames.insert( NODEITEM( "Collision", WRL2_COLLISION ) );
-        nodenames.insert( NODEITEM( "Color", WRL2_COLOR ) );
-        nodenames.insert( NODEITEM( "ColorInterpolator", WRL2_COLORINTERPOLATOR ) );
-        nodenames.insert( NODEITEM( "Cone", WRL2_CONE ) );
-        nodenames.insert( NODEITEM( "Coordinate", WRL2_COORDINATE ) );
-        nodenames.insert( NODEITEM( "CoordinateInterpolator", WRL2_COORDINATEINTERPOLATOR ) );
-        nodenames.insert( NODEITEM( "Cylinder", WRL2_CYLINDER ) );
-        nodenames.insert( NODEITEM( "CylinderSensor", WRL2_CYLINDERSENSOR ) );
-        nodenames.insert( NODEITEM( "DirectionalLight", WRL2_DIRECTIONALLIGHT ) );
-        nodenames.insert( NODEITEM( "ElevationGrid", WRL2_ELEVATIONGRID ) );
-        nodenames.insert( NODEITEM( "Extrusion", WRL2_EXTRUSION ) );
-        nodenames.insert( NODEITEM( "Fog", WRL2_FOG ) );
-        nodenames.insert( NODEITEM( "FontStyle", WRL2_FONTSTYLE ) );
-        nodenames.insert( NODEITEM( "Group", WRL2_GROUP ) );
-        nodenames.insert( NODEITEM( "ImageTexture", WRL2_IMAGETEXTURE ) );
-        nodenames.insert( NODEITEM( "IndexedFaceSet", WRL2_INDEXEDFACESET ) );
-        nodenames.insert( NODEITEM( "IndexedLineSet", WRL2_INDEXEDLINESET ) );
-        nodenames.insert( NODEITEM( "Inline", WRL2_INLINE ) );
-        nodenames.insert( NODEITEM( "LOD", WRL2_LOD ) );
-        nodenames.insert( NODEITEM( "Material", WRL2_MATERIAL ) );
-        nodenames.insert( NODEITEM( "MovieTexture", WRL2_MOVIETEXTURE ) );
-        nodenames.insert( NODEITEM( "NavigationInfo", WRL2_NAVIGATIONINFO ) );
-        nodenames.insert( NODEITEM( "Normal", WRL2_NORMAL ) );
-        nodenames.insert( NODEITEM( "NormalInterpolator", WRL2_NORMALINTERPOLATOR ) );
-        nodenames.insert( NODEITEM( "OrientationInterpolator", WRL2_ORIENTATIONINTERPOLATOR ) );
-        nodenames.insert( NODEITEM( "PixelTexture", WRL2_PIXELTEXTURE ) );
-        nodenames.insert( NODEITEM( "PlaneSensor", WRL2_PLANESENSOR ) );
-        nodenames.insert( NODEITEM( "PointLight", WRL2_POINTLIGHT ) );
-        nodenames.insert( NODEITEM( "PointSet", WRL2_POINTSET ) );
-        nodenames.insert( NODEITEM( "PositionInterpolator", WRL2_POSITIONINTERPOLATOR ) );
-        nodenames.insert( NODEITEM( "ProximitySensor", WRL2_PROXIMITYSENSOR ) );
-        nodenames.insert( NODEITEM( "ScalarInterpolator", WRL2_SCALARINTERPOLATOR ) );
-        nodenames.insert( NODEITEM( "Script", WRL2_SCRIPT ) );
-        nodenames.insert( NODEITEM( "Shape", WRL2_SHAPE ) );
-        nodenames.insert( NODEITEM( "Sound", WRL2_SOUND ) );
-        nodenames.insert( NODEITEM( "Sphere", WRL2_SPHERE ) );
-        nodenames.insert( NODEITEM( "SphereSensor", WRL2_SPHERESENSOR ) );
-        nodenames.insert( NODEITEM( "SpotLight", WRL2_SPOTLIGHT ) );
-        nodenames.insert( NODEITEM( "Switch", WRL2_SWITCH ) );
-        nodenames.insert( NODEITEM( "Text", WRL2_TEXT ) );
-        nodenames.insert( NODEITEM( "TextureCoordinate", WRL2_TEXTURECOORDINATE ) );
-        nodenames.insert( NODEITEM( "TextureTransform", WRL2_TEXTURETRANSFORM ) );
-        nodenames.insert( NODEITEM( "TimeSensor", WRL2_TIMESENSOR ) );
-        nodenames.insert( NODEITEM( "TouchSensor", WRL2_TOUCHSENSOR ) );
-        nodenames.insert( NODEITEM( "Transform", WRL2_TRANSFORM ) );
-        nodenames.insert( NODEITEM( "ViewPoint", WRL2_VIEWPOINT ) );
-        nodenames.insert( NODEITEM( "VisibilitySensor", WRL2_VISIBILITYSENSOR ) );
-        nodenames.insert( NODEITEM( "WorldInfo", WRL2_WORLDINFO ) );
-    }
+    // The tables are filled once, as the models may be parsed by several threads
+    std::call_once( tablesInit,
+            []()
+            {
+                badNames.insert( "DEF" );
+                badNames.insert( "EXTERNPROTO" );
+                badNames.insert( "FALSE" );
+                badNames.insert( "IS" );
+                badNames.insert( "NULL" );
+                badNames.insert( "PROTO" );
+                badNames.insert( "ROUTE" );
+                badNames.insert( "TO" );
+                badNames.insert( "TRUE" );
+                badNames.insert( "USE" );
+                badNames.insert( "eventIn" );
+                badNames.insert( "eventOut" );
+                badNames.insert( "exposedField" );
+                badNames.insert( "field" );
+                nodenames.insert( NODEITEM( "Anchor", WRL2_ANCHOR ) );
+                nodenames.insert( NODEITEM( "Appearance", WRL2_APPEARANCE ) );
+                nodenames.insert( NODEITEM( "Audioclip", WRL2_AUDIOCLIP ) );
+                nodenames.insert( NODEITEM( "Background", WRL2_BACKGROUND ) );
+                nodenames.insert( NODEITEM( "Billboard", WRL2_BILLBOARD ) );
+                nodenames.insert( NODEITEM( "Box", WRL2_BOX ) );
+                nodenames.insert( NODEITEM( "Collision", WRL2_COLLISION ) );
+                nodenames.insert( NODEITEM( "Color", WRL2_COLOR ) );
+                nodenames.insert( NODEITEM( "ColorInterpolator", WRL2_COLORINTERPOLATOR ) );
+                nodenames.insert( NODEITEM( "Cone", WRL2_CONE ) );
+                nodenames.insert( NODEITEM( "Coordinate", WRL2_COORDINATE ) );
+                nodenames.insert( NODEITEM( "CoordinateInterpolator", WRL2_COORDINATEINTERPOLATOR ) );
+                nodenames.insert( NODEITEM( "Cylinder", WRL2_CYLINDER ) );
+                nodenames.insert( NODEITEM( "CylinderSensor", WRL2_CYLINDERSENSOR ) );
+                nodenames.insert( NODEITEM( "DirectionalLight", WRL2_DIRECTIONALLIGHT ) );
+                nodenames.insert( NODEITEM( "ElevationGrid", WRL2_ELEVATIONGRID ) );
+                nodenames.insert( NODEITEM( "Extrusion", WRL2_EXTRUSION ) );
+                nodenames.insert( NODEITEM( "Fog", WRL2_FOG ) );
+                nodenames.insert( NODEITEM( "FontStyle", WRL2_FONTSTYLE ) );
+                nodenames.insert( NODEITEM( "Group", WRL2_GROUP ) );
+                nodenames.insert( NODEITEM( "ImageTexture", WRL2_IMAGETEXTURE ) );
+                nodenames.insert( NODEITEM( "IndexedFaceSet", WRL2_INDEXEDFACESET ) );
+                nodenames.insert( NODEITEM( "IndexedLineSet", WRL2_INDEXEDLINESET ) );
+                nodenames.insert( NODEITEM( "Inline", WRL2_INLINE ) );
+                nodenames.insert( NODEITEM( "LOD", WRL2_LOD ) );
+                nodenames.insert( NODEITEM( "Material", WRL2_MATERIAL ) );
+                nodenames.insert( NODEITEM( "MovieTexture", WRL2_MOVIETEXTURE ) );
+                nodenames.insert( NODEITEM( "NavigationInfo", WRL2_NAVIGATIONINFO ) );
+                nodenames.insert( NODEITEM( "Normal", WRL2_NORMAL ) );
+                nodenames.insert( NODEITEM( "NormalInterpolator", WRL2_NORMALINTERPOLATOR ) );
+                nodenames.insert( NODEITEM( "OrientationInterpolator", WRL2_ORIENTATIONINTERPOLATOR ) );
+                nodenames.insert( NODEITEM( "PixelTexture", WRL2_PIXELTEXTURE ) );
+                nodenames.insert( NODEITEM( "PlaneSensor", WRL2_PLANESENSOR ) );
+                nodenames.insert( NODEITEM( "PointLight", WRL2_POINTLIGHT ) );
+                nodenames.insert( NODEITEM( "PointSet", WRL2_POINTSET ) );
+                nodenames.insert( NODEITEM( "PositionInterpolator", WRL2_POSITIONINTERPOLATOR ) );
+                nodenames.insert( NODEITEM( "ProximitySensor", WRL2_PROXIMITYSENSOR ) );
+                nodenames.insert( NODEITEM( "ScalarInterpolator", WRL2_SCALARINTERPOLATOR ) );
+                nodenames.insert( NODEITEM( "Script", WRL2_SCRIPT ) );
+                nodenames.insert( NODEITEM( "Shape", WRL2_SHAPE ) );
+                nodenames.insert( NODEITEM( "Sound", WRL2_SOUND ) );
+                nodenames.insert( NODEITEM( "Sphere", WRL2_SPHERE ) );
+                nodenames.insert( NODEITEM( "SphereSensor", WRL2_SPHERESENSOR ) );
+                nodenames.insert( NODEITEM( "SpotLight", WRL2_SPOTLIGHT ) );
+                nodenames.insert( NODEITEM( "Switch", WRL2_SWITCH ) );
+                nodenames.insert( NODEITEM( "Text", WRL2_TEXT ) );
+                nodenames.insert( NODEITEM( "TextureCoordinate", WRL2_TEXTURECOORDINATE ) );
+                nodenames.insert( NODEITEM( "TextureTransform", WRL2_TEXTURETRANSFORM ) );
+                nodenames.insert( NODEITEM( "TimeSensor", WRL2_TIMESENSOR ) );
+                nodenames.insert( NODEITEM( "TouchSensor", WRL2_TOUCHSENSOR ) );
+                nodenames.insert( NODEITEM( "Transform", WRL2_TRANSFORM ) );
+                nodenames.insert( NODEITEM( "ViewPoint", WRL2_VIEWPOINT ) );
+                nodenames.insert( NODEITEM( "VisibilitySensor", WRL2_VISIBILITYSENSOR ) );
+                nodenames.insert( NODEITEM( "WorldInfo", WRL2_WORLDINFO ) );
+            } );
 
     return;
 }
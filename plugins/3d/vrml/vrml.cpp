@@ -32,13 +32,13 @@
  */
 
 #include "plugins/3d/3d_plugin.h"
+#include "plugins/3d/3d_plugin_locale.h"
 #include "plugins/3dapi/ifsg_all.h"
 #include "richio.h"
 #include "vrml1_base.h"
 #include "vrml2_base.h"
 #include "wrlproc.h"
 #include "x3d.h"
-#include <clocale>
 #include <wx/filename.h>
 #include <wx/log.h>
 
@@ -156,23 +156,12 @@ bool CanRender( void )
 }
 
 
-class LOCALESWITCH
+bool IsReentrant( void )
 {
-    // Store the user locale name, to restore this locale later, in dtor
-    std::string m_locale;
-
-public:
-    LOCALESWITCH()
-    {
-        m_locale = setlocale( LC_NUMERIC, 0 );
-        setlocale( LC_NUMERIC, "C" );
-    }
-
-    ~LOCALESWITCH()
-    {
-        setlocale( LC_NUMERIC, m_locale.c_str() );
-    }
-};
+    // the locale is switched for the loading thread only, and the node name tables are
+    // filled once
+    return true;
+}
 
 
 SCENEGRAPH* LoadVRML( const wxString& aFileName, bool useInline )
@@ -285,7 +274,7 @@ SCENEGRAPH* Load( char const* aFileName )
     if( !wxFileName::FileExists( fname ) )
         return NULL;
 
-    LOCALESWITCH switcher;
+    THREAD_C_LOCALE switcher;
 
     SCENEGRAPH* scene = NULL;
     wxString ext = wxFileName( fname ).GetExt();
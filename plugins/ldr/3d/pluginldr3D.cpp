@@ -30,7 +30,7 @@
 
 #define PLUGIN_CLASS_3D "PLUGIN_3D"
 #define PLUGIN_3D_MAJOR 1
-#define PLUGIN_3D_MINOR 0
+#define PLUGIN_3D_MINOR 1
 #define PLUGIN_3D_PATCH 0
 #define PLUGIN_3D_REVISION 0
 
@@ -44,6 +44,7 @@ KICAD_PLUGIN_LDR_3D::KICAD_PLUGIN_LDR_3D()
     m_getFileFilter = NULL;
     m_canRender = NULL;
     m_load = NULL;
+    m_isReentrant = NULL;
 
     return;
 }
@@ -94,6 +95,9 @@ bool KICAD_PLUGIN_LDR_3D::Open( const wxString& aFullFileName )
     LINK_ITEM( m_canRender, PLUGIN_3D_CAN_RENDER, "CanRender" );
     LINK_ITEM( m_load, PLUGIN_3D_LOAD, "Load" );
 
+    // optional, from version 1.1 of the class
+    LINK_ITEM( m_isReentrant, PLUGIN_3D_IS_REENTRANT, "IsReentrant" );
+
     #ifdef DEBUG
         bool fail = false;
 
@@ -250,6 +254,7 @@ void KICAD_PLUGIN_LDR_3D::Close( void )
     m_getFileFilter = NULL;
     m_canRender = NULL;
     m_load = NULL;
+    m_isReentrant = NULL;
     close();
 
     return;
@@ -428,6 +433,9 @@ bool KICAD_PLUGIN_LDR_3D::CanRender( void )
 
 SCENEGRAPH* KICAD_PLUGIN_LDR_3D::Load( char const* aFileName )
 {
+    if( ok && m_load )
+        return m_load( aFileName );
+
     m_error.clear();
 
     if( !ok && !reopen() )
@@ -454,3 +462,9 @@ SCENEGRAPH* KICAD_PLUGIN_LDR_3D::Load( char const* aFileName )
 
     return m_load( aFileName );
 }
+
+
+bool KICAD_PLUGIN_LDR_3D::IsReentrant( void )
+{
+    return ok && m_isReentrant && m_isReentrant();
+}
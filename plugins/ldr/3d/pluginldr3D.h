@@ -47,6 +47,8 @@ typedef bool (*PLUGIN_3D_CAN_RENDER) ( void );
 
 typedef SCENEGRAPH* (*PLUGIN_3D_LOAD) ( char const* aFileName );
 
+typedef bool (*PLUGIN_3D_IS_REENTRANT) ( void );
+
 
 class KICAD_PLUGIN_LDR_3D : public KICAD_PLUGIN_LDR
 {
@@ -58,6 +60,7 @@ private:
     PLUGIN_3D_GET_FILE_FILTER       m_getFileFilter;
     PLUGIN_3D_CAN_RENDER            m_canRender;
     PLUGIN_3D_LOAD                  m_load;
+    PLUGIN_3D_IS_REENTRANT          m_isReentrant;  // optional
 
 public:
     KICAD_PLUGIN_LDR_3D();
@@ -84,7 +87,19 @@ public:
 
     bool CanRender( void );
 
+    /**
+     * Function Load
+     * calls the plugin's Load().  Once the plugin is open, nothing of the loader is
+     * changed, so that a reentrant plugin can load models on several threads at once.
+     */
     SCENEGRAPH* Load( char const* aFileName );
+
+    /**
+     * Function IsReentrant
+     * @return true if the plugin declares that its Load() may run on several threads at
+     * once; false if it does not, or if it is not open.
+     */
+    bool IsReentrant( void );
 };
 
 #endif  // PLUGINMGR3D_H
@@ -0,0 +1,171 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cmath>
+#include <random>
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+
+/**
+ * Returns a set of aCount overlapping squares and ring-shaped octagons, the kind of knockouts
+ * a zone fill unions
+ */
+static SHAPE_POLY_SET knockouts( int aCount )
+{
+    std::mt19937                       rng( 1 );
+    std::uniform_int_distribution<int> position( 0, 100000 );
+    std::uniform_int_distribution<int> size( 500, 3000 );
+
+    SHAPE_POLY_SET set;
+
+    for( int ii = 0; ii < aCount; ii++ )
+    {
+        const VECTOR2I center( position( rng ), position( rng ) );
+        const int      radius = size( rng );
+
+        if( ii % 2 )
+        {
+            set.NewOutline();
+            set.Append( center.x - radius, center.y - radius );
+            set.Append( center.x + radius, center.y - radius );
+            set.Append( center.x + radius, center.y + radius );
+            set.Append( center.x - radius, center.y + radius );
+            continue;
+        }
+
+        SHAPE_LINE_CHAIN outline, hole;
+
+        for( int corner = 0; corner < 8; corner++ )
+        {
+            const VECTOR2I offset = VECTOR2I( radius, 0 ).Rotate( corner * M_PI / 4 );
+
+            outline.Append( center + offset );
+            hole.Append( center + offset / 2 );
+        }
+
+        outline.SetClosed( true );
+        hole.SetClosed( true );
+        hole = hole.Reverse();
+
+        set.AddOutline( outline );
+        set.AddHole( hole );
+    }
+
+    return set;
+}
+
+
+/**
+ * Returns the area covered by aSet: its outlines less their holes
+ */
+static double area( const SHAPE_POLY_SET& aSet )
+{
+    double total = 0.0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ii++ )
+    {
+        total += std::abs( aSet.COutline( ii ).Area() );
+
+        for( int jj = 0; jj < aSet.HoleCount( ii ); jj++ )
+            total -= std::abs( aSet.CHole( ii, jj ).Area() );
+    }
+
+    return total;
+}
+
+
+/**
+ * Returns the area of the symmetric difference of aA and aB
+ */
+static double xorArea( const SHAPE_POLY_SET& aA, const SHAPE_POLY_SET& aB )
+{
+    SHAPE_POLY_SET aMinusB( aA );
+    SHAPE_POLY_SET bMinusA( aB );
+
+    aMinusB.BooleanSubtract( aB, SHAPE_POLY_SET::PM_FAST );
+    bMinusA.BooleanSubtract( aA, SHAPE_POLY_SET::PM_FAST );
+
+    return area( aMinusB ) + area( bMinusA );
+}
+
+
+BOOST_AUTO_TEST_SUITE( SPSBatchUnion )
+
+
+/**
+ * The batch union covers the area the serial union does, up to the rounding of the
+ * intersections of the tiles
+ */
+BOOST_AUTO_TEST_CASE( SameAsSimplify )
+{
+    for( int count : { 10, 200, 5000 } )
+    {
+        BOOST_TEST_CONTEXT( count << " knockouts" )
+        {
+            SHAPE_POLY_SET serial = knockouts( count );
+            SHAPE_POLY_SET batched = serial;
+
+            serial.Simplify( SHAPE_POLY_SET::PM_FAST );
+            batched.BatchUnion( SHAPE_POLY_SET::PM_FAST );
+
+            BOOST_CHECK_CLOSE( area( batched ), area( serial ), 1e-4 );
+            BOOST_CHECK_SMALL( xorArea( serial, batched ) / area( serial ), 1e-6 );
+        }
+    }
+}
+
+
+/**
+ * The tiles and merges go through the given PARALLEL_FOR
+ */
+BOOST_AUTO_TEST_CASE( ParallelFor )
+{
+    SHAPE_POLY_SET serial = knockouts( 5000 );
+    SHAPE_POLY_SET batched = serial;
+    size_t         calls = 0;
+
+    serial.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    batched.BatchUnion( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE,
+            [&]( size_t aCount, const std::function<void( size_t )>& aFunc )
+            {
+                for( size_t ii = 0; ii < aCount; ii++ )
+                {
+                    aFunc( ii );
+                    calls++;
+                }
+            } );
+
+    BOOST_CHECK_GT( calls, 0 );
+    BOOST_CHECK_SMALL( xorArea( serial, batched ) / area( serial ), 1e-6 );
+
+    // Strictly simple outlines have no self-intersections left
+    for( int ii = 0; ii < batched.OutlineCount(); ii++ )
+        BOOST_CHECK( !batched.COutline( ii ).SelfIntersecting() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
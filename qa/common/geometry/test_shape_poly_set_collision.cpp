@@ -193,4 +193,70 @@ BOOST_AUTO_TEST_CASE( CollideVertexWithClearance )
     }
 }
 
+/**
+ * This test checks that the acceleration cache gives the same answers as the plain tests, and
+ * that it follows the changes of the set.
+ */
+BOOST_AUTO_TEST_CASE( AccelerationCache )
+{
+    SHAPE_POLY_SET accelerated( common.holeyPolySet );
+    accelerated.EnableAccelerationCache();
+
+    BOOST_CHECK( accelerated.IsAccelerationCacheEnabled() );
+
+    for( const VECTOR2I& point : collidingPoints )
+    {
+        BOOST_CHECK( accelerated.Contains( point ) );
+        BOOST_CHECK( accelerated.Collide( point, 0 ) );
+    }
+
+    for( const VECTOR2I& point : nonCollidingPoints )
+    {
+        BOOST_CHECK( !accelerated.Contains( point ) );
+        BOOST_CHECK( !accelerated.Collide( point, 0 ) );
+    }
+
+    for( const VECTOR2I& point : common.holeyPoints )
+    {
+        BOOST_CHECK( accelerated.PointOnEdge( point ) );
+
+        SHAPE_POLY_SET::VERTEX_INDEX plainHit, acceleratedHit;
+
+        BOOST_CHECK( common.holeyPolySet.CollideEdge( point + VECTOR2I( 1, 1 ), plainHit, 2 ) );
+        BOOST_CHECK( accelerated.CollideEdge( point + VECTOR2I( 1, 1 ), acceleratedHit, 2 ) );
+        BOOST_CHECK_EQUAL( plainHit.m_polygon, acceleratedHit.m_polygon );
+        BOOST_CHECK_EQUAL( plainHit.m_contour, acceleratedHit.m_contour );
+        BOOST_CHECK_EQUAL( plainHit.m_vertex, acceleratedHit.m_vertex );
+    }
+
+    BOOST_CHECK( accelerated.Collide( VECTOR2I( -1, 10 ), 5 ) );
+    BOOST_CHECK( accelerated.Collide( VECTOR2I( 11, 11 ), 5 ) );
+    BOOST_CHECK( !accelerated.Collide( VECTOR2I( -10, 10 ), 5 ) );
+
+    BOOST_CHECK( accelerated.Collide( SEG( VECTOR2I( -10, 50 ), VECTOR2I( 10, 50 ) ) ) );
+    BOOST_CHECK( !accelerated.Collide( SEG( VECTOR2I( -10, 50 ), VECTOR2I( -10, 60 ) ) ) );
+
+    // The set moves out of the points: the index must follow
+    accelerated.Move( VECTOR2I( 1000, 1000 ) );
+
+    for( const VECTOR2I& point : collidingPoints )
+        BOOST_CHECK( !accelerated.Contains( point ) );
+
+    accelerated.Move( VECTOR2I( -1000, -1000 ) );
+
+    for( const VECTOR2I& point : collidingPoints )
+        BOOST_CHECK( accelerated.Contains( point ) );
+
+    // A change of one polygon outdates its triangulation only
+    accelerated.CacheTriangulation();
+    BOOST_CHECK( accelerated.IsTriangulationUpToDate() );
+
+    accelerated.SetVertex( 0, VECTOR2I( 110, 110 ) );
+    BOOST_CHECK( !accelerated.IsTriangulationUpToDate() );
+    BOOST_CHECK( accelerated.Contains( VECTOR2I( 105, 105 ) ) );
+
+    accelerated.CacheTriangulation();
+    BOOST_CHECK( accelerated.IsTriangulationUpToDate() );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
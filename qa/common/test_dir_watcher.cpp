@@ -0,0 +1,140 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for DIR_WATCHER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <chrono>
+#include <set>
+
+#include <wx/dir.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+// Code under test
+#include <dir_watcher.h>
+
+
+/**
+ * A directory in the temporary directory, removed at the end of the test
+ */
+struct DIR_WATCHER_FIXTURE
+{
+    DIR_WATCHER_FIXTURE() : m_dirPath( wxFileName::CreateTempFileName( "dirwatch" ) )
+    {
+        wxRemoveFile( m_dirPath );
+        wxMkdir( m_dirPath );
+    }
+
+    ~DIR_WATCHER_FIXTURE()
+    {
+        wxFileName::Rmdir( m_dirPath, wxPATH_RMDIR_RECURSIVE );
+    }
+
+    wxString path( const wxString& aFileName ) const
+    {
+        return m_dirPath + wxFileName::GetPathSeparator() + aFileName;
+    }
+
+    void write( const wxString& aFileName, const wxString& aContents ) const
+    {
+        wxFFile file( path( aFileName ), "wb" );
+        file.Write( aContents );
+        file.Close();
+    }
+
+    wxString m_dirPath;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DirWatcher, DIR_WATCHER_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( CreateAndRemove )
+{
+    write( "before.kicad_mod", "(module before)" );
+
+    // If the directory is polled, poll it on every call
+    DIR_WATCHER        watcher( m_dirPath, "*.kicad_mod", std::chrono::milliseconds( 0 ) );
+    std::set<wxString> changed;
+
+    BOOST_CHECK( watcher.TakeChanges( changed ) );
+    BOOST_CHECK( changed.empty() );
+
+    write( "R_0603.kicad_mod", "(module R_0603)" );
+    write( "notes.txt", "not a footprint" );
+
+    BOOST_CHECK( watcher.TakeChanges( changed ) );
+    BOOST_CHECK( changed == std::set<wxString>{ "R_0603.kicad_mod" } );
+
+    // The changes are taken once
+    changed.clear();
+    BOOST_CHECK( watcher.TakeChanges( changed ) );
+    BOOST_CHECK( changed.empty() );
+
+    wxRemoveFile( path( "before.kicad_mod" ) );
+
+    BOOST_CHECK( watcher.TakeChanges( changed ) );
+    BOOST_CHECK( changed == std::set<wxString>{ "before.kicad_mod" } );
+}
+
+
+BOOST_AUTO_TEST_CASE( Modify )
+{
+    write( "R_0603.kicad_mod", "(module R_0603)" );
+
+    DIR_WATCHER watcher( m_dirPath, "*.kicad_mod" );
+
+    // The polled timestamps may not see a change within the same second
+    if( !watcher.IsNotified() )
+        return;
+
+    write( "R_0603.kicad_mod", "(module R_0603 (layer F.Cu))" );
+
+    std::set<wxString> changed;
+
+    BOOST_CHECK( watcher.TakeChanges( changed ) );
+    BOOST_CHECK( changed == std::set<wxString>{ "R_0603.kicad_mod" } );
+}
+
+
+BOOST_AUTO_TEST_CASE( RemovedDirectory )
+{
+    DIR_WATCHER watcher( m_dirPath, "*.kicad_mod" );
+
+    if( !watcher.IsNotified() )
+        return;
+
+    wxFileName::Rmdir( m_dirPath, wxPATH_RMDIR_RECURSIVE );
+
+    std::set<wxString> changed;
+
+    BOOST_CHECK( !watcher.TakeChanges( changed ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -28,6 +28,9 @@
 
 #include <unit_test_utils/unit_test_utils.h>
 
+#include <cmath>
+#include <cstdlib>
+
 // Code under test
 #include <kicad_string.h>
 
@@ -107,4 +110,33 @@ BOOST_AUTO_TEST_CASE( NaturalNumberCompare )
     }
 }
 
+/**
+ * Test #ParseDoubleNoLocale against strtod(), which the test runner calls in the C locale.
+ */
+BOOST_AUTO_TEST_CASE( ParseDoubleNoLocaleMatchesStrtod )
+{
+    const std::vector<std::string> cases = {
+        "0", "-0", "1.5", "-2.54", "0.000123", "  42", "1e3", "1E-3", "9007199254740993",
+        "123456789012345678901234567890", "0.1000000000000000055511151231257827",
+        "1e22", "1e23", "1e308", "1e400", "-1e400",     // overflow
+        "2.2250738585072014e-308", "1e-310", "-4.9e-324", "1e-320",     // denormals
+        "1e-400", "-1e-400", "2.4e-324", "12345678901234567890123e-330",   // underflow
+    };
+
+    for( const std::string& c : cases )
+    {
+        double      value = 0.0;
+        char*       strtodEnd = nullptr;
+        double      expected = strtod( c.c_str(), &strtodEnd );
+        const char* end = ParseDoubleNoLocale( c.c_str(), &value );
+
+        BOOST_TEST_CONTEXT( c )
+        {
+            BOOST_CHECK_EQUAL( value, expected );
+            BOOST_CHECK_EQUAL( std::signbit( value ), std::signbit( expected ) );
+            BOOST_CHECK_EQUAL( end - c.c_str(), strtodEnd - c.c_str() );
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
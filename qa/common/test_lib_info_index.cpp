@@ -0,0 +1,181 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for LIB_INFO_INDEX
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <string>
+#include <vector>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+// Code under test
+#include <lib_info_index.h>
+
+
+/**
+ * An index file in the temporary directory, removed at the end of the test
+ */
+struct LIB_INFO_INDEX_FIXTURE
+{
+    LIB_INFO_INDEX_FIXTURE() : m_fileName( wxFileName::CreateTempFileName( "libindex" ) )
+    {
+        LIB_INFO_INDEX::LIBRARY resistors;
+        resistors.m_Hash = 0x123456789abcLL;
+        resistors.m_Items.push_back( { "R_0603", "Resistor SMD 0603", "resistor", 2, 2 } );
+        resistors.m_Items.push_back( { wxString::FromUTF8( "R_\xc2\xb5" ), "", "", 0, 0 } );
+
+        LIB_INFO_INDEX::LIBRARY connectors;
+        connectors.m_Hash = -42;
+        connectors.m_Items.push_back( { "Conn_01x40", "Pin header\nstraight", "conn", 41, 40 } );
+
+        m_index.SetLibrary( "Resistor_SMD", resistors );
+        m_index.SetLibrary( "Connector", connectors );
+        m_index.SetLibrary( "Empty", LIB_INFO_INDEX::LIBRARY{ 7, {} } );
+    }
+
+    ~LIB_INFO_INDEX_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    wxString       m_fileName;
+    LIB_INFO_INDEX m_index;
+};
+
+
+static void checkSameIndex( const LIB_INFO_INDEX& aExpected, const LIB_INFO_INDEX& aActual )
+{
+    BOOST_REQUIRE_EQUAL( aExpected.GetLibraries().size(), aActual.GetLibraries().size() );
+
+    for( const auto& expected : aExpected.GetLibraries() )
+    {
+        const LIB_INFO_INDEX::LIBRARY* actual = aActual.FindLibrary( expected.first,
+                                                                     expected.second.m_Hash );
+
+        BOOST_TEST_CONTEXT( expected.first )
+        {
+            BOOST_REQUIRE( actual );
+            BOOST_REQUIRE_EQUAL( expected.second.m_Items.size(), actual->m_Items.size() );
+
+            for( size_t ii = 0; ii < actual->m_Items.size(); ++ii )
+            {
+                const LIB_INFO_INDEX::ITEM& item = actual->m_Items[ii];
+
+                BOOST_CHECK( item.m_Name == expected.second.m_Items[ii].m_Name );
+                BOOST_CHECK( item.m_Description == expected.second.m_Items[ii].m_Description );
+                BOOST_CHECK( item.m_Keywords == expected.second.m_Items[ii].m_Keywords );
+                BOOST_CHECK_EQUAL( item.m_Count, expected.second.m_Items[ii].m_Count );
+                BOOST_CHECK_EQUAL( item.m_UniqueCount, expected.second.m_Items[ii].m_UniqueCount );
+            }
+        }
+    }
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( LibInfoIndex, LIB_INFO_INDEX_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    BOOST_REQUIRE( m_index.Write( m_fileName ) );
+
+    LIB_INFO_INDEX read;
+
+    BOOST_CHECK( read.Read( m_fileName ) );
+    checkSameIndex( m_index, read );
+}
+
+
+BOOST_AUTO_TEST_CASE( ChangedHash )
+{
+    BOOST_CHECK( m_index.FindLibrary( "Connector", -42 ) );
+    BOOST_CHECK( !m_index.FindLibrary( "Connector", -41 ) );
+    BOOST_CHECK( !m_index.FindLibrary( "Missing", -42 ) );
+
+    m_index.RemoveLibrary( "Connector" );
+    BOOST_CHECK( !m_index.FindLibrary( "Connector", -42 ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( MissingFile )
+{
+    wxRemoveFile( m_fileName );
+
+    BOOST_CHECK( !m_index.Read( m_fileName ) );
+    BOOST_CHECK( m_index.GetLibraries().empty() );
+}
+
+
+BOOST_AUTO_TEST_CASE( DamagedFile )
+{
+    BOOST_REQUIRE( m_index.Write( m_fileName ) );
+
+    wxFFile     file( m_fileName, "rb" );
+    size_t      size = (size_t) file.Length();
+    std::string contents( size, '\0' );
+
+    BOOST_REQUIRE_EQUAL( file.Read( &contents[0], size ), size );
+    file.Close();
+
+    // The truncated files, and the one with trailing data, are rejected
+    std::vector<size_t> lengths;
+
+    for( size_t length = 0; length < size; length += 7 )
+        lengths.push_back( length );
+
+    contents.push_back( 'x' );
+    lengths.push_back( contents.size() );
+
+    for( size_t length : lengths )
+    {
+        BOOST_TEST_CONTEXT( "Length " << length )
+        {
+            wxFFile damaged( m_fileName, "wb" );
+            damaged.Write( contents.data(), length );
+            damaged.Close();
+
+            LIB_INFO_INDEX read;
+
+            BOOST_CHECK( !read.Read( m_fileName ) );
+            BOOST_CHECK( read.GetLibraries().empty() );
+        }
+    }
+
+    // The text cache of the former versions is not an index
+    wxFFile text( m_fileName, "wb" );
+    text.Write( wxString( "1234567\nConnector\nConn_01x40\n" ) );
+    text.Close();
+
+    LIB_INFO_INDEX read;
+
+    BOOST_CHECK( !read.Read( m_fileName ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,122 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for THREAD_POOL and TASK_GROUP
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <thread_pool.h>
+
+#include <stdexcept>
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_AUTO_TEST_SUITE( ThreadPool )
+
+
+/**
+ * Every index of a parallel loop is visited exactly once
+ */
+BOOST_AUTO_TEST_CASE( ParallelForVisitsAll )
+{
+    for( size_t grain : { 1, 3, 8, 1000 } )
+    {
+        std::vector<std::atomic<int>> visits( 997 );
+        TASK_GROUP                    tasks;
+
+        for( std::atomic<int>& count : visits )
+            count = 0;
+
+        tasks.ParallelFor( visits.size(), [&]( size_t i ) { visits[i]++; }, grain );
+
+        BOOST_CHECK( tasks.Wait() );
+
+        for( std::atomic<int>& count : visits )
+            BOOST_CHECK_EQUAL( count.load(), 1 );
+    }
+}
+
+
+/**
+ * Parallel loops nested in the tasks of another one complete without deadlocking
+ */
+BOOST_AUTO_TEST_CASE( Nested )
+{
+    std::atomic<size_t> sum( 0 );
+    TASK_GROUP          outer;
+
+    outer.ParallelFor( 64,
+            [&]( size_t )
+            {
+                TASK_GROUP inner;
+                inner.ParallelFor( 100, [&]( size_t j ) { sum += j; } );
+                inner.Wait();
+            } );
+
+    BOOST_CHECK( outer.Wait() );
+    BOOST_CHECK_EQUAL( sum.load(), 64 * 4950 );
+}
+
+
+/**
+ * The first exception thrown by a task cancels the group and is rethrown by Wait()
+ */
+BOOST_AUTO_TEST_CASE( Exception )
+{
+    TASK_GROUP tasks;
+
+    tasks.ParallelFor( 100,
+            []( size_t i )
+            {
+                if( i == 50 )
+                    throw std::runtime_error( "task failed" );
+            } );
+
+    BOOST_CHECK_THROW( tasks.Wait(), std::runtime_error );
+    BOOST_CHECK( tasks.IsCancelled() );
+}
+
+
+/**
+ * The tasks of a cancelled group are skipped
+ */
+BOOST_AUTO_TEST_CASE( Cancel )
+{
+    std::atomic<int> count( 0 );
+    TASK_GROUP       tasks;
+
+    tasks.Cancel();
+    tasks.ParallelFor( 100, [&]( size_t ) { count++; } );
+    tasks.Run( [&]() { count++; } );
+
+    BOOST_CHECK( !tasks.Wait() );
+    BOOST_CHECK_EQUAL( count.load(), 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -53,6 +53,11 @@ struct BENCH_REPORT
      */
     unsigned charAcc;
 
+    /**
+     * Bytes handed out by the reader, used to report throughput
+     */
+    unsigned long long bytesRead;
+
     std::chrono::milliseconds benchDurMs;
 };
 
@@ -84,6 +89,7 @@ static void bench_fstream( const wxFileName& aFile, int aReps, BENCH_REPORT& rep
         {
             report.linesRead++;
             report.charAcc += (unsigned char) line[0];
+            report.bytesRead += line.size() + 1;
         }
 
         fstr.close();
@@ -106,6 +112,7 @@ static void bench_fstream_reuse( const wxFileName& aFile, int aReps, BENCH_REPOR
         {
             report.linesRead++;
             report.charAcc += (unsigned char) line[0];
+            report.bytesRead += line.size() + 1;
         }
         fstr.clear() ;
         fstr.seekg(0, std::ios::beg) ;
@@ -129,6 +136,7 @@ static void bench_line_reader( const wxFileName& aFile, int aReps, BENCH_REPORT&
         {
             report.linesRead++;
             report.charAcc += (unsigned char) fstr.Line()[0];
+            report.bytesRead += fstr.Length();
         }
     }
 }
@@ -149,6 +157,7 @@ static void bench_line_reader_reuse( const wxFileName& aFile, int aReps, BENCH_R
         {
             report.linesRead++;
             report.charAcc += (unsigned char) fstr.Line()[0];
+            report.bytesRead += fstr.Length();
         }
 
         fstr.Rewind();
@@ -156,6 +165,29 @@ static void bench_line_reader_reuse( const wxFileName& aFile, int aReps, BENCH_R
 }
 
 
+/**
+ * Benchmark using a given LINE_READER implementation through ReadLineNoCopy(),
+ * as DSNLEXER does.  The LINE_READER is recreated for each cycle.
+ */
+template<typename LR>
+static void bench_line_reader_nocopy( const wxFileName& aFile, int aReps, BENCH_REPORT& report )
+{
+    for( int i = 0; i < aReps; ++i)
+    {
+        LR          fstr( aFile.GetFullPath() );
+        unsigned    len;
+        const char* line;
+
+        while( ( line = fstr.ReadLineNoCopy( &len ) ) != nullptr )
+        {
+            report.linesRead++;
+            report.charAcc += (unsigned char) line[0];
+            report.bytesRead += len;
+        }
+    }
+}
+
+
 /**
  * Benchmark using STRING_LINE_READER on string data read into memory from a file
  * using std::ifstream, but read the data fresh from the file each time
@@ -173,6 +205,7 @@ static void bench_string_lr( const wxFileName& aFile, int aReps, BENCH_REPORT& r
         {
             report.linesRead++;
             report.charAcc += (unsigned char) fstr.Line()[0];
+            report.bytesRead += fstr.Length();
         }
     }
 }
@@ -198,6 +231,33 @@ static void bench_string_lr_reuse( const wxFileName& aFile, int aReps, BENCH_REP
         {
             report.linesRead++;
             report.charAcc += (unsigned char) fstr.Line()[0];
+            report.bytesRead += fstr.Length();
+        }
+    }
+}
+
+
+/**
+ * Benchmark using STRING_LINE_READER::ReadLineNoCopy() on string data read into memory
+ * from a file using std::ifstream.  The file is read only once.
+ */
+static void bench_string_lr_nocopy( const wxFileName& aFile, int aReps, BENCH_REPORT& report )
+{
+    std::ifstream ifs( aFile.GetFullPath().ToStdString() );
+    std::string content((std::istreambuf_iterator<char>(ifs)),
+        std::istreambuf_iterator<char>());
+
+    for( int i = 0; i < aReps; ++i)
+    {
+        STRING_LINE_READER fstr( content, aFile.GetFullPath() );
+        unsigned           len;
+        const char*        line;
+
+        while( ( line = fstr.ReadLineNoCopy( &len ) ) != nullptr )
+        {
+            report.linesRead++;
+            report.charAcc += (unsigned char) line[0];
+            report.bytesRead += len;
         }
     }
 }
@@ -221,6 +281,7 @@ static void bench_wxis( const wxFileName& aFile, int aReps, BENCH_REPORT& report
         {
             report.linesRead++;
             report.charAcc += (unsigned char) istr.Line()[0];
+            report.bytesRead += istr.Length();
         }
 
         fileStream.SeekI( 0 );
@@ -245,6 +306,7 @@ static void bench_wxis_reuse( const wxFileName& aFile, int aReps, BENCH_REPORT&
         {
             report.linesRead++;
             report.charAcc += (unsigned char) istr.Line()[0];
+            report.bytesRead += istr.Length();
         }
 
         fileStream.SeekI( 0 );
@@ -271,6 +333,7 @@ static void bench_wxbis( const wxFileName& aFile, int aReps, BENCH_REPORT& repor
         {
             report.linesRead++;
             report.charAcc += (unsigned char) istr.Line()[0];
+            report.bytesRead += istr.Length();
         }
 
         fileStream.SeekI( 0 );
@@ -297,6 +360,7 @@ static void bench_wxbis_reuse( const wxFileName& aFile, int aReps, BENCH_REPORT&
         {
             report.linesRead++;
             report.charAcc += (unsigned char) istr.Line()[0];
+            report.bytesRead += istr.Length();
         }
 
         fileStream.SeekI( 0 );
@@ -316,6 +380,10 @@ static std::vector<BENCHMARK> benchmarkList =
     { 'N', bench_line_reader_reuse<IFSTREAM_LINE_READER>, "std::ifstream L_R, reused" },
     { 's', bench_string_lr, "RichIO STRING_L_R"},
     { 'S', bench_string_lr_reuse, "RichIO STRING_L_R, reused"},
+    { 'z', bench_string_lr_nocopy, "RichIO STRING_L_R, no copy"},
+    { 'm', bench_line_reader<MMAP_LINE_READER>, "RichIO MMAP_L_R" },
+    { 'M', bench_line_reader_reuse<MMAP_LINE_READER>, "RichIO MMAP_L_R, reused" },
+    { 'Z', bench_line_reader_nocopy<MMAP_LINE_READER>, "RichIO MMAP_L_R, no copy" },
     { 'w', bench_wxis<wxFileInputStream>, "wxFileIStream" },
     { 'W', bench_wxis<wxFileInputStream>, "wxFileIStream, reused" },
     { 'g', bench_wxis<wxFFileInputStream>, "wxFFileIStream" },
@@ -413,8 +481,14 @@ int io_benchmark_func( int argc, char* argv[] )
 
         BENCH_REPORT report = executeBenchMark( bmark, reps, inFile );
 
-        os << wxString::Format( "%-30s %u lines, acc: %u in %u ms",
-                bmark.name, report.linesRead, report.charAcc, (int) report.benchDurMs.count() )
+        double mbPerSec = 0.0;
+
+        if( report.benchDurMs.count() > 0 )
+            mbPerSec = ( report.bytesRead / 1e6 ) / ( report.benchDurMs.count() / 1e3 );
+
+        os << wxString::Format( "%-30s %u lines, acc: %u in %u ms (%.1f MB/s)",
+                bmark.name, report.linesRead, report.charAcc, (int) report.benchDurMs.count(),
+                mbPerSec )
             << std::endl;;
     }
 
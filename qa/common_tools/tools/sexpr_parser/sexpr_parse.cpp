@@ -32,12 +32,15 @@
 #include <qa_utils/utility_registry.h>
 
 #include <common.h>
+#include <dsnlexer.h>
+#include <kicad_string.h>
 #include <profile.h>
 
 #include <wx/cmdline.h>
 
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 
 class QA_SEXPR_PARSER
@@ -64,6 +67,85 @@ public:
         return sexpr != nullptr;
     }
 
+    /**
+     * Time conversion of every numeric token in the stream, comparing the C library's
+     * strtod() (which needs the C locale to be set) with the locale-independent
+     * ParseDoubleNoLocale() used by the board and schematic parsers.
+     *
+     * @return false if the two methods disagree on any value.
+     */
+    bool BenchNumbers( std::istream& aStream )
+    {
+        const std::string sexpr_str( std::istreambuf_iterator<char>( aStream ), {} );
+
+        // Tokenise up front so only the number conversion itself is timed
+        std::vector<std::string> numbers;
+        DSNLEXER                 lexer( sexpr_str );
+        int                      tok;
+
+        while( ( tok = lexer.NextTok() ) != DSN_EOF )
+        {
+            if( tok == DSN_NUMBER )
+                numbers.push_back( lexer.CurText() );
+        }
+
+        const size_t tokenCount = numbers.size();
+        double       strtodSum = 0.0;
+        double       noLocaleSum = 0.0;
+        bool         ok = true;
+
+        PROF_COUNTER strtodTimer;
+
+        {
+            LOCALE_IO toggle;
+
+            for( const std::string& num : numbers )
+                strtodSum += strtod( num.c_str(), nullptr );
+        }
+
+        strtodTimer.Stop();
+
+        PROF_COUNTER noLocaleTimer;
+
+        for( const std::string& num : numbers )
+        {
+            double val = 0.0;
+            ParseDoubleNoLocale( num.c_str(), &val );
+            noLocaleSum += val;
+        }
+
+        noLocaleTimer.Stop();
+
+        {
+            // strtod() is the reference, so it must read '.' as the decimal separator
+            LOCALE_IO toggle;
+
+            // The out of range values are rare in files, but must still match
+            for( const char* edgeCase : { "1e400", "-1e400", "1e-310", "1e-400", "-1e-400" } )
+                numbers.push_back( edgeCase );
+
+            for( const std::string& num : numbers )
+            {
+                double val = 0.0;
+                ParseDoubleNoLocale( num.c_str(), &val );
+
+                if( val != strtod( num.c_str(), nullptr ) )
+                {
+                    std::cout << "Mismatch converting \"" << num << "\"" << std::endl;
+                    ok = false;
+                }
+            }
+        }
+
+        std::cout << tokenCount << " numeric tokens" << std::endl;
+        std::cout << "  strtod + LOCALE_IO:   " << strtodTimer.msecs() << "ms (sum "
+                  << strtodSum << ")" << std::endl;
+        std::cout << "  ParseDoubleNoLocale:  " << noLocaleTimer.msecs() << "ms (sum "
+                  << noLocaleSum << ")" << std::endl;
+
+        return ok;
+    }
+
 private:
     bool          m_verbose;
     SEXPR::PARSER m_parser;
@@ -84,6 +166,12 @@ static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
             "verbose",
             _( "print parsing information" ).mb_str(),
     },
+    {
+            wxCMD_LINE_SWITCH,
+            "n",
+            "numbers",
+            _( "benchmark number conversion instead of s-expression parsing" ).mb_str(),
+    },
     {
             wxCMD_LINE_PARAM,
             nullptr,
@@ -117,6 +205,7 @@ int sexpr_parser_func( int argc, char* argv[] )
 
     const auto file_count = cl_parser.GetParamCount();
     const bool verbose = cl_parser.Found( "verbose" );
+    const bool numbers = cl_parser.Found( "numbers" );
 
     QA_SEXPR_PARSER qa_parser( verbose );
 
@@ -126,7 +215,10 @@ int sexpr_parser_func( int argc, char* argv[] )
     {
         // Parse the file provided on stdin - used by AFL to drive the
         // program
-        qa_parser.Parse( std::cin );
+        if( numbers )
+            ok = qa_parser.BenchNumbers( std::cin );
+        else
+            qa_parser.Parse( std::cin );
     }
     else
     {
@@ -143,7 +235,10 @@ int sexpr_parser_func( int argc, char* argv[] )
             std::ifstream fin;
             fin.open( filename );
 
-            ok = ok && qa_parser.Parse( fin );
+            if( numbers )
+                ok = qa_parser.BenchNumbers( fin ) && ok;
+            else
+                ok = ok && qa_parser.Parse( fin );
         }
     }
 
@@ -0,0 +1,369 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the incremental updates of CONNECTION_GRAPH
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <map>
+#include <memory>
+#include <set>
+
+// Code under test
+#include <connection_graph.h>
+
+#include <bus_alias.h>
+#include <general.h>
+#include <sch_connection.h>
+#include <sch_line.h>
+#include <sch_screen.h>
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+#include <sch_text.h>
+
+
+/**
+ * A one sheet schematic, whose items are named by the test
+ */
+struct TEST_SCHEMATIC
+{
+    TEST_SCHEMATIC() :
+            m_root( new SCH_SHEET )
+    {
+        m_root->SetScreen( new SCH_SCREEN( nullptr ) );
+    }
+
+    ~TEST_SCHEMATIC()
+    {
+        delete m_root;
+    }
+
+    SCH_SCREEN* Screen()
+    {
+        return m_root->GetScreen();
+    }
+
+    void AddWire( const wxString& aName, const wxPoint& aStart, const wxPoint& aEnd,
+                  int aLayer = LAYER_WIRE )
+    {
+        SCH_LINE* wire = new SCH_LINE( aStart, aLayer );
+        wire->SetEndPoint( aEnd );
+        add( aName, wire );
+    }
+
+    void AddLabel( const wxString& aName, const wxPoint& aPos, const wxString& aText,
+                   bool aGlobal = false )
+    {
+        if( aGlobal )
+            add( aName, new SCH_GLOBALLABEL( aPos, aText ) );
+        else
+            add( aName, new SCH_LABEL( aPos, aText ) );
+    }
+
+    void SetBusAlias( const wxString& aName, const std::vector<wxString>& aMembers )
+    {
+        // The aliases are replaced, not edited, as by the bus alias dialog
+        std::shared_ptr<BUS_ALIAS> alias = std::make_shared<BUS_ALIAS>( Screen() );
+
+        alias->SetName( aName );
+
+        for( const wxString& member : aMembers )
+            alias->AddMember( member );
+
+        Screen()->ClearBusAliases();
+        Screen()->AddBusAlias( alias );
+    }
+
+    void Rename( const wxString& aName, const wxString& aText )
+    {
+        SCH_TEXT* label = static_cast<SCH_TEXT*>( m_items.at( aName ) );
+
+        label->SetText( aText );
+        label->SetConnectivityDirty();
+    }
+
+    void Remove( const wxString& aName )
+    {
+        SCH_ITEM* item = m_items.at( aName );
+
+        // The graph may still hold the removed items, as the undo list would
+        Screen()->Remove( item );
+        m_items.erase( aName );
+        m_removed.emplace_back( item );
+    }
+
+    void add( const wxString& aName, SCH_ITEM* aItem )
+    {
+        Screen()->Append( aItem );
+        m_items[aName] = aItem;
+    }
+
+    SCH_SHEET*                             m_root;
+    std::map<wxString, SCH_ITEM*>          m_items;
+    std::vector<std::unique_ptr<SCH_ITEM>> m_removed;
+};
+
+
+/**
+ * The connection of every item, by a description of the item, and the code of each net name
+ */
+struct CONNECTIONS
+{
+    std::map<wxString, wxString> m_itemNets;
+    std::map<wxString, int>      m_netCodes;
+};
+
+
+static wxString describe( SCH_ITEM* aItem )
+{
+    wxString desc = wxString::Format( "%d %d %d", (int) aItem->Type(), aItem->GetPosition().x,
+                                      aItem->GetPosition().y );
+
+    if( aItem->Type() == SCH_LINE_T )
+    {
+        SCH_LINE* line = static_cast<SCH_LINE*>( aItem );
+
+        desc << wxString::Format( " %d %d %d", line->GetEndPoint().x, line->GetEndPoint().y,
+                                  (int) line->GetLayer() );
+    }
+
+    if( SCH_TEXT* text = dynamic_cast<SCH_TEXT*>( aItem ) )
+        desc << " " << text->GetText();
+
+    return desc;
+}
+
+
+static CONNECTIONS connections( TEST_SCHEMATIC& aSchematic, const CONNECTION_GRAPH& aGraph )
+{
+    CONNECTIONS    result;
+    SCH_SHEET_PATH sheet = SCH_SHEET_LIST( aSchematic.m_root )[0];
+
+    for( SCH_ITEM* item : aSchematic.Screen()->Items() )
+    {
+        if( !item->IsConnectable() )
+            continue;
+
+        SCH_CONNECTION* connection = item->Connection( sheet );
+        wxString        net;
+
+        if( connection )
+        {
+            net = connection->Name();
+
+            for( const std::shared_ptr<SCH_CONNECTION>& member : connection->Members() )
+                net << " " << member->Name();
+        }
+
+        result.m_itemNets[ describe( item ) ] = net;
+    }
+
+    for( const auto& net : aGraph.GetNetMap() )
+        result.m_netCodes[ net.first.first ] = net.first.second;
+
+    return result;
+}
+
+
+/**
+ * Two copies of a schematic, with many unrelated nets so that an edit affects a small part of
+ * it.  Each edit is applied to both copies: the graph of the first one is updated
+ * incrementally, the graph of the second one is rebuilt from scratch.
+ */
+struct CONNECTION_GRAPH_FIXTURE
+{
+    CONNECTION_GRAPH_FIXTURE() :
+            m_incrementalGraph( nullptr )
+    {
+        for( TEST_SCHEMATIC* schematic : { &m_incremental, &m_full } )
+        {
+            // Net A: two wires and a local label, and a far wire joined by the same label
+            schematic->AddWire( "w1", wxPoint( 0, 0 ), wxPoint( 1000, 0 ) );
+            schematic->AddWire( "w2", wxPoint( 1000, 0 ), wxPoint( 2000, 0 ) );
+            schematic->AddLabel( "a1", wxPoint( 0, 0 ), "A" );
+            schematic->AddWire( "w6", wxPoint( 3000, 1000 ), wxPoint( 4000, 1000 ) );
+            schematic->AddLabel( "a2", wxPoint( 4000, 1000 ), "A" );
+
+            // Net B
+            schematic->AddWire( "w3", wxPoint( 0, 1000 ), wxPoint( 1000, 1000 ) );
+            schematic->AddLabel( "b", wxPoint( 0, 1000 ), "B" );
+
+            // Net CLK: two wires joined by a global label
+            schematic->AddWire( "w4", wxPoint( 0, 2000 ), wxPoint( 1000, 2000 ) );
+            schematic->AddLabel( "clk1", wxPoint( 0, 2000 ), "CLK", true );
+            schematic->AddWire( "w5", wxPoint( 3000, 0 ), wxPoint( 4000, 0 ) );
+            schematic->AddLabel( "clk2", wxPoint( 4000, 0 ), "CLK", true );
+
+            // A bus named by an alias
+            schematic->SetBusAlias( "DATA", { "D0", "D1" } );
+            schematic->AddWire( "bus", wxPoint( 0, 3000 ), wxPoint( 2000, 3000 ), LAYER_BUS );
+            schematic->AddLabel( "data", wxPoint( 0, 3000 ), "DATA" );
+
+            for( int ii = 0; ii < 40; ++ii )
+            {
+                wxString name = wxString::Format( "N%d", ii );
+                wxPoint  pos( 10000 + 2000 * ( ii % 8 ), 10000 + 2000 * ( ii / 8 ) );
+
+                schematic->AddWire( name, pos, pos + wxPoint( 1000, 0 ) );
+                schematic->AddLabel( name + "_label", pos, name );
+            }
+        }
+
+        g_RootSheet = m_incremental.m_root;
+        m_incrementalGraph.Recalculate( SCH_SHEET_LIST( m_incremental.m_root ), true );
+        m_previous = connections( m_incremental, m_incrementalGraph );
+        g_RootSheet = nullptr;
+    }
+
+    ~CONNECTION_GRAPH_FIXTURE()
+    {
+        m_incrementalGraph.Reset();
+        g_RootSheet = nullptr;
+    }
+
+    /**
+     * Updates both graphs after an edit, and checks that the incremental update gives the
+     * names of the full rebuild, with the same net codes up to a renumbering.  The names
+     * which were there before the edit keep their code.
+     */
+    void checkUpdate( const std::string& aEdit )
+    {
+        BOOST_TEST_CONTEXT( aEdit )
+        {
+            g_RootSheet = m_incremental.m_root;
+            m_incrementalGraph.Recalculate( SCH_SHEET_LIST( m_incremental.m_root ) );
+            CONNECTIONS incremental = connections( m_incremental, m_incrementalGraph );
+
+            g_RootSheet = m_full.m_root;
+            CONNECTION_GRAPH fullGraph( nullptr );
+            fullGraph.Recalculate( SCH_SHEET_LIST( m_full.m_root ), true );
+            CONNECTIONS full = connections( m_full, fullGraph );
+
+            g_RootSheet = nullptr;
+
+            BOOST_CHECK( incremental.m_itemNets == full.m_itemNets );
+
+            std::set<wxString> incrementalNames, fullNames;
+            std::set<int>      incrementalCodes, fullCodes;
+            std::map<int, int> codeMap;
+
+            for( const std::pair<const wxString, int>& net : incremental.m_netCodes )
+            {
+                incrementalNames.insert( net.first );
+                incrementalCodes.insert( net.second );
+
+                auto previous = m_previous.m_netCodes.find( net.first );
+
+                if( previous != m_previous.m_netCodes.end() )
+                    BOOST_CHECK_EQUAL( net.second, previous->second );
+            }
+
+            for( const std::pair<const wxString, int>& net : full.m_netCodes )
+            {
+                fullNames.insert( net.first );
+                fullCodes.insert( net.second );
+            }
+
+            BOOST_CHECK( incrementalNames == fullNames );
+
+            // One code per name in both
+            BOOST_CHECK_EQUAL( incrementalCodes.size(), incremental.m_netCodes.size() );
+            BOOST_CHECK_EQUAL( fullCodes.size(), full.m_netCodes.size() );
+
+            m_previous = incremental;
+        }
+    }
+
+    TEST_SCHEMATIC   m_incremental;
+    TEST_SCHEMATIC   m_full;
+    CONNECTION_GRAPH m_incrementalGraph;
+    CONNECTIONS      m_previous;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ConnectionGraph, CONNECTION_GRAPH_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( WireAddRemove )
+{
+    // Joins net A to net CLK
+    for( TEST_SCHEMATIC* schematic : { &m_incremental, &m_full } )
+        schematic->AddWire( "w7", wxPoint( 2000, 0 ), wxPoint( 3000, 0 ) );
+
+    checkUpdate( "Wire added" );
+
+    for( TEST_SCHEMATIC* schematic : { &m_incremental, &m_full } )
+        schematic->Remove( "w7" );
+
+    checkUpdate( "Wire removed" );
+
+    // Splits net A
+    for( TEST_SCHEMATIC* schematic : { &m_incremental, &m_full } )
+        schematic->Remove( "w1" );
+
+    checkUpdate( "Labelled wire removed" );
+}
+
+
+BOOST_AUTO_TEST_CASE( LabelRename )
+{
+    for( TEST_SCHEMATIC* schematic : { &m_incremental, &m_full } )
+        schematic->Rename( "b", "C" );
+
+    checkUpdate( "Label renamed to a new name" );
+
+    // Joins net B (now C) to net A
+    for( TEST_SCHEMATIC* schematic : { &m_incremental, &m_full } )
+        schematic->Rename( "b", "A" );
+
+    checkUpdate( "Label renamed to an existing name" );
+
+    // One of the two global labels of CLK
+    for( TEST_SCHEMATIC* schematic : { &m_incremental, &m_full } )
+        schematic->Rename( "clk2", "N3" );
+
+    checkUpdate( "Global label renamed" );
+}
+
+
+BOOST_AUTO_TEST_CASE( BusAliasChange )
+{
+    for( TEST_SCHEMATIC* schematic : { &m_incremental, &m_full } )
+        schematic->SetBusAlias( "DATA", { "D0", "D1", "D2" } );
+
+    checkUpdate( "Bus alias member added" );
+
+    for( TEST_SCHEMATIC* schematic : { &m_incremental, &m_full } )
+    {
+        schematic->SetBusAlias( "DATA", { "D0", "D1", "D2" } );
+        schematic->Rename( "a1", "D0" );
+    }
+
+    checkUpdate( "Bus alias replaced, and a label renamed to a member" );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,279 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file poly_union_benchmark.cpp
+ * Times SHAPE_POLY_SET::BatchUnion() against Simplify(), the serial union it replaces, and
+ * checks that they cover the same area.
+ *
+ * The workloads are the "clearance holes" of the zone dumps the zone filler writes to
+ * zones_dump.txt when s_DumpZonesWhenFilling is set, or synthetic pad and track knockouts
+ * when no dump is given.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+
+using UNION_DURATION = std::chrono::duration<double, std::milli>;
+
+
+struct WORKLOAD
+{
+    std::string    m_name;
+    SHAPE_POLY_SET m_polys;
+};
+
+
+/**
+ * Appends the polysets named aName of the dump aFileName to aWorkloads
+ * @return false if the file cannot be read
+ */
+static bool readDump( const std::string& aFileName, const std::string& aName,
+                      std::vector<WORKLOAD>& aWorkloads )
+{
+    std::ifstream file( aFileName );
+
+    if( !file )
+        return false;
+
+    std::stringstream dump;
+    dump << file.rdbuf();
+
+    const std::string text = dump.str();
+    const std::string header = "shape " + std::to_string( (int) SH_POLY_SET ) + " " + aName
+                               + " polyset";
+    int               index = 0;
+
+    for( size_t pos = text.find( header ); pos != std::string::npos;
+         pos = text.find( header, pos + header.size() ) )
+    {
+        if( pos > 0 && text[pos - 1] != '\n' )
+            continue;
+
+        WORKLOAD workload;
+        workload.m_name = aFileName + ":" + std::to_string( index++ );
+
+        dump.clear();
+        dump.seekg( pos + header.size() - std::string( "polyset" ).size() );
+
+        if( workload.m_polys.Parse( dump ) )
+            aWorkloads.push_back( std::move( workload ) );
+    }
+
+    return true;
+}
+
+
+/**
+ * Returns aCount knockouts of round pads, rectangular pads and track segments, spread over a
+ * 100mm square board
+ */
+static SHAPE_POLY_SET syntheticKnockouts( int aCount )
+{
+    std::mt19937                       rng( 1 );
+    std::uniform_int_distribution<int> position( 0, 100000000 );
+    std::uniform_int_distribution<int> size( 300000, 1500000 );
+    std::uniform_int_distribution<int> length( 0, 3000000 );
+
+    SHAPE_POLY_SET knockouts;
+
+    for( int ii = 0; ii < aCount; ii++ )
+    {
+        const VECTOR2I   center( position( rng ), position( rng ) );
+        const int        radius = size( rng );
+        SHAPE_LINE_CHAIN outline;
+
+        switch( ii % 3 )
+        {
+        case 0:     // round pad or via
+            for( int corner = 0; corner < 32; corner++ )
+                outline.Append( center + VECTOR2I( radius, 0 ).Rotate( corner * M_PI / 16 ) );
+
+            break;
+
+        case 1:     // rectangular pad
+            outline.Append( center + VECTOR2I( -radius, -radius / 2 ) );
+            outline.Append( center + VECTOR2I( radius, -radius / 2 ) );
+            outline.Append( center + VECTOR2I( radius, radius / 2 ) );
+            outline.Append( center + VECTOR2I( -radius, radius / 2 ) );
+            break;
+
+        default:    // track segment, without its round ends
+        {
+            const VECTOR2I end = center + VECTOR2I( length( rng ), length( rng ) + 1000 );
+            const VECTOR2I side = ( end - center ).Perpendicular().Resize( radius / 4 );
+
+            outline.Append( center + side );
+            outline.Append( end + side );
+            outline.Append( end - side );
+            outline.Append( center - side );
+            break;
+        }
+        }
+
+        outline.SetClosed( true );
+        knockouts.AddOutline( outline );
+    }
+
+    return knockouts;
+}
+
+
+/**
+ * Returns the area covered by aSet: its outlines less their holes
+ */
+static double area( const SHAPE_POLY_SET& aSet )
+{
+    double total = 0.0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ii++ )
+    {
+        total += std::abs( aSet.COutline( ii ).Area() );
+
+        for( int jj = 0; jj < aSet.HoleCount( ii ); jj++ )
+            total -= std::abs( aSet.CHole( ii, jj ).Area() );
+    }
+
+    return total;
+}
+
+
+/**
+ * Returns the best time of aRepeats runs of aUnion on copies of aPolys, and its result
+ */
+template <class UNION>
+static UNION_DURATION timeUnion( const SHAPE_POLY_SET& aPolys, int aRepeats, UNION aUnion,
+                                 SHAPE_POLY_SET& aResult )
+{
+    UNION_DURATION best = UNION_DURATION::max();
+
+    for( int ii = 0; ii < aRepeats; ii++ )
+    {
+        aResult = aPolys;
+
+        auto start = std::chrono::steady_clock::now();
+        aUnion( aResult );
+        best = std::min<UNION_DURATION>( best, std::chrono::steady_clock::now() - start );
+    }
+
+    return best;
+}
+
+
+static void usage( const char* aProgram )
+{
+    std::cerr << "Usage: " << aProgram << " [-r repeats] [-n knockouts] [zones_dump.txt...]\n"
+              << "Times the serial and batched unions of the clearance holes of the zone\n"
+              << "dumps, or of synthetic knockouts (default 20000) when no dump is given.\n";
+}
+
+
+int main( int argc, char** argv )
+{
+    int                      repeats = 3;
+    int                      knockoutCount = 20000;
+    std::vector<std::string> dumps;
+
+    for( int ii = 1; ii < argc; ii++ )
+    {
+        const std::string arg = argv[ii];
+
+        if( ( arg == "-r" || arg == "-n" ) && ii + 1 < argc )
+            ( arg == "-r" ? repeats : knockoutCount ) = std::max( atoi( argv[++ii] ), 1 );
+        else if( arg.empty() || arg[0] == '-' )
+        {
+            usage( argv[0] );
+            return arg == "-h" ? 0 : 1;
+        }
+        else
+            dumps.push_back( arg );
+    }
+
+    std::vector<WORKLOAD> workloads;
+
+    for( const std::string& dump : dumps )
+    {
+        if( !readDump( dump, "clearance holes", workloads ) )
+        {
+            std::cerr << "Cannot read " << dump << std::endl;
+            return 1;
+        }
+    }
+
+    if( dumps.empty() )
+        workloads.push_back( { "synthetic", syntheticKnockouts( knockoutCount ) } );
+
+    int ret = 0;
+
+    for( const WORKLOAD& workload : workloads )
+    {
+        SHAPE_POLY_SET serial, batched;
+
+        UNION_DURATION serialTime = timeUnion( workload.m_polys, repeats,
+                []( SHAPE_POLY_SET& aPolys )
+                {
+                    aPolys.Simplify( SHAPE_POLY_SET::PM_FAST );
+                }, serial );
+
+        UNION_DURATION batchedTime = timeUnion( workload.m_polys, repeats,
+                []( SHAPE_POLY_SET& aPolys )
+                {
+                    aPolys.BatchUnion( SHAPE_POLY_SET::PM_FAST );
+                }, batched );
+
+        // The area covered by one union and not the other, relative to the area of the union
+        SHAPE_POLY_SET serialOnly( serial ), batchedOnly( batched );
+        serialOnly.BooleanSubtract( batched, SHAPE_POLY_SET::PM_FAST );
+        batchedOnly.BooleanSubtract( serial, SHAPE_POLY_SET::PM_FAST );
+
+        const double serialArea = area( serial );
+        const double difference = serialArea > 0.0
+                                          ? ( area( serialOnly ) + area( batchedOnly ) ) / serialArea
+                                          : 0.0;
+
+        std::cout << workload.m_name << ": " << workload.m_polys.OutlineCount() << " polygons, "
+                  << "serial " << serialTime.count() << "ms, "
+                  << "batched " << batchedTime.count() << "ms, "
+                  << "speedup " << serialTime.count() / batchedTime.count() << ", "
+                  << "difference " << difference << std::endl;
+
+        if( difference > 1e-6 )
+        {
+            std::cerr << workload.m_name << ": the unions differ" << std::endl;
+            ret = 1;
+        }
+    }
+
+    return ret;
+}
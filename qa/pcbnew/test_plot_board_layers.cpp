@@ -0,0 +1,202 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for PlotBoardLayers()
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <vector>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/tokenzr.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <pcbplot.h>
+#include <settings/color_settings.h>
+
+
+/**
+ * A board whose solder masks have a minimum width, with pads closer than it, plotted to
+ * Gerber files in a temporary directory.
+ */
+struct PLOT_BOARD_FIXTURE
+{
+    PLOT_BOARD_FIXTURE() : m_dirPath( wxFileName::CreateTempFileName( "plotboard" ) )
+    {
+        wxRemoveFile( m_dirPath );
+        wxMkdir( m_dirPath );
+
+        BOARD_DESIGN_SETTINGS& settings = m_board.GetDesignSettings();
+
+        settings.m_SolderMaskMinWidth = Millimeter2iu( 0.25 );
+        settings.m_MaxError = Millimeter2iu( 0.01 );
+
+        for( int ii = 0; ii < 4; ++ii )
+        {
+            MODULE* module = new MODULE( &m_board );
+            wxPoint pos( Millimeter2iu( 5 * ii ), 0 );
+
+            // An SMD round rect and a through hole circle, 0.2 mm apart
+            addPad( module, pos, PAD_SHAPE_ROUNDRECT, PAD_ATTRIB_SMD, D_PAD::SMDMask() );
+            addPad( module, pos + wxPoint( Millimeter2iu( 1.2 ), 0 ), PAD_SHAPE_CIRCLE,
+                    PAD_ATTRIB_STANDARD, D_PAD::StandardMask() );
+
+            m_board.Add( module );
+
+            TRACK* track = new TRACK( &m_board );
+            track->SetStart( pos + wxPoint( Millimeter2iu( 1.2 ), 0 ) );
+            track->SetEnd( pos + wxPoint( Millimeter2iu( 3 ), Millimeter2iu( 3 ) ) );
+            track->SetWidth( Millimeter2iu( 0.25 ) );
+            track->SetLayer( ii % 2 ? B_Cu : F_Cu );
+            m_board.Add( track );
+
+            VIA* via = new VIA( &m_board );
+            via->SetPosition( pos + wxPoint( Millimeter2iu( 3 ), Millimeter2iu( 3 ) ) );
+            via->SetWidth( Millimeter2iu( 0.6 ) );
+            via->SetDrill( Millimeter2iu( 0.3 ) );
+            via->SetViaType( VIATYPE::THROUGH );
+            via->SetLayerPair( F_Cu, B_Cu );
+            m_board.Add( via );
+        }
+
+        m_plotOpts.SetFormat( PLOT_FORMAT::GERBER );
+        m_plotOpts.SetPlotViaOnMaskLayer( true );
+        m_plotOpts.SetColorSettings( &m_colors );
+    }
+
+    ~PLOT_BOARD_FIXTURE()
+    {
+        wxFileName::Rmdir( m_dirPath, wxPATH_RMDIR_RECURSIVE );
+    }
+
+    void addPad( MODULE* aModule, const wxPoint& aPos, PAD_SHAPE_T aShape, PAD_ATTR_T aAttribute,
+                 LSET aLayers )
+    {
+        D_PAD* pad = new D_PAD( aModule );
+
+        pad->SetShape( aShape );
+        pad->SetAttribute( aAttribute );
+        pad->SetLayerSet( aLayers );
+        pad->SetSize( wxSize( Millimeter2iu( 1 ), Millimeter2iu( 1 ) ) );
+        pad->SetRoundRectRadiusRatio( 0.25 );
+
+        if( aAttribute == PAD_ATTRIB_STANDARD )
+            pad->SetDrillSize( wxSize( Millimeter2iu( 0.5 ), Millimeter2iu( 0.5 ) ) );
+
+        pad->SetPosition( aPos );
+        pad->SetPos0( aPos );
+        aModule->Add( pad );
+    }
+
+    /**
+     * Plots the layers to files named after aPrefix, and returns their contents without
+     * the lines holding the creation date.
+     */
+    std::vector<wxString> plot( const wxString& aPrefix, bool aConcurrent )
+    {
+        std::vector<PLOT_LAYER_JOB> jobs;
+
+        for( PCB_LAYER_ID layer : { F_Cu, B_Cu, F_Mask, B_Mask, F_SilkS, B_SilkS, Edge_Cuts } )
+        {
+            wxFileName fn( m_dirPath, wxString::Format( "%s-%d", aPrefix, (int) layer ), "gbr" );
+            jobs.push_back( { layer, fn.GetFullPath(), false } );
+        }
+
+        PlotBoardLayers( &m_board, &m_plotOpts, jobs, nullptr, aConcurrent );
+
+        std::vector<wxString> contents;
+
+        for( const PLOT_LAYER_JOB& job : jobs )
+        {
+            BOOST_REQUIRE( job.m_Created );
+
+            wxFFile  file( job.m_FullPath, "rb" );
+            wxString text;
+
+            BOOST_REQUIRE( file.ReadAll( &text ) );
+
+            wxString           kept;
+            wxStringTokenizer  lines( text, "\n" );
+
+            while( lines.HasMoreTokens() )
+            {
+                wxString line = lines.GetNextToken();
+
+                if( !line.Contains( "CreationDate" ) && !line.StartsWith( "G04 Created by" ) )
+                    kept += line + "\n";
+            }
+
+            contents.push_back( kept );
+        }
+
+        return contents;
+    }
+
+    wxString        m_dirPath;
+    BOARD           m_board;
+    COLOR_SETTINGS  m_colors;
+    PCB_PLOT_PARAMS m_plotOpts;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PlotBoardLayers, PLOT_BOARD_FIXTURE )
+
+
+/**
+ * The layers plotted at once give the same files as the layers plotted one after the other,
+ * and leave the board settings unchanged
+ */
+BOOST_AUTO_TEST_CASE( ConcurrentMatchesSerial )
+{
+    std::vector<wxString> serial = plot( "serial", false );
+
+    BOOST_CHECK_EQUAL( m_board.GetDesignSettings().m_MaxError, Millimeter2iu( 0.01 ) );
+
+    // The races, if any, do not show on every run
+    for( int run = 0; run < 8; ++run )
+    {
+        std::vector<wxString> concurrent = plot( wxString::Format( "concurrent%d", run ), true );
+
+        BOOST_REQUIRE_EQUAL( serial.size(), concurrent.size() );
+
+        for( size_t ii = 0; ii < serial.size(); ++ii )
+        {
+            BOOST_TEST_CONTEXT( "Run " << run << ", layer " << ii )
+            {
+                BOOST_CHECK( serial[ii] == concurrent[ii] );
+            }
+        }
+
+        BOOST_CHECK_EQUAL( m_board.GetDesignSettings().m_MaxError, Millimeter2iu( 0.01 ) );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
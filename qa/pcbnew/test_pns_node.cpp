@@ -0,0 +1,537 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for PNS::NODE branches.
+ *
+ * A branch stores its changes in layers shared with its own branches, and merges them into
+ * one past 8 layers.  Whatever its layers, a branch must answer the queries as a branch of
+ * the root holding the same changes in one layer would, so the branches made by random
+ * add, remove, branch, commit and kill sequences are compared with such a replay.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <router/pns_joint.h>
+#include <router/pns_node.h>
+#include <router/pns_segment.h>
+#include <router/pns_via.h>
+
+
+/**
+ * Identifies an item of the test by its kind, net, layers and geometry, so that the items
+ * of two nodes can be compared.  The ends of a segment are sorted, as a reversed segment
+ * is redundant.
+ */
+struct ITEM_KEY
+{
+    int      m_kind;
+    int      m_net;
+    int      m_layer;
+    VECTOR2I m_a;
+    VECTOR2I m_b;
+
+    bool operator<( const ITEM_KEY& aOther ) const
+    {
+        return std::tie( m_kind, m_net, m_layer, m_a.x, m_a.y, m_b.x, m_b.y )
+               < std::tie( aOther.m_kind, aOther.m_net, aOther.m_layer, aOther.m_a.x,
+                           aOther.m_a.y, aOther.m_b.x, aOther.m_b.y );
+    }
+
+    bool operator==( const ITEM_KEY& aOther ) const
+    {
+        return !( *this < aOther ) && !( aOther < *this );
+    }
+};
+
+
+static ITEM_KEY itemKey( const PNS::ITEM* aItem )
+{
+    ITEM_KEY key;
+
+    key.m_kind = aItem->Kind();
+    key.m_net = aItem->Net();
+    key.m_layer = aItem->Layers().Start();
+
+    if( aItem->Kind() == PNS::ITEM::SEGMENT_T )
+    {
+        const SEG& seg = static_cast<const PNS::SEGMENT*>( aItem )->Seg();
+
+        key.m_a = seg.A;
+        key.m_b = seg.B;
+
+        if( std::tie( key.m_b.x, key.m_b.y ) < std::tie( key.m_a.x, key.m_a.y ) )
+            std::swap( key.m_a, key.m_b );
+    }
+    else
+    {
+        key.m_a = key.m_b = static_cast<const PNS::VIA*>( aItem )->Pos();
+    }
+
+    return key;
+}
+
+
+template <class ITEMS>
+static std::vector<ITEM_KEY> sortedKeys( const ITEMS& aItems )
+{
+    std::vector<ITEM_KEY> keys;
+
+    for( const PNS::ITEM* item : aItems )
+        keys.push_back( itemKey( item ) );
+
+    std::sort( keys.begin(), keys.end() );
+    return keys;
+}
+
+
+///> An added or removed item
+struct NODE_OP
+{
+    bool     m_add;
+    ITEM_KEY m_key;
+};
+
+
+/**
+ * A branch of the tested tree, with the changes made to it (and to the branches it was
+ * branched from) since the root, and the items it should see.
+ */
+struct BRANCH_STATE
+{
+    PNS::NODE*           m_node;
+    std::vector<NODE_OP> m_history;
+    std::set<ITEM_KEY>   m_keys;
+};
+
+
+struct PNS_NODE_FIXTURE
+{
+    static const int GRID = 1000000;
+    static const int GRID_SIZE = 4;
+
+    PNS_NODE_FIXTURE() :
+            m_rng( 0x5eed )
+    {
+    }
+
+    ~PNS_NODE_FIXTURE()
+    {
+        m_root.KillChildren();
+    }
+
+    VECTOR2I randomPoint()
+    {
+        return VECTOR2I( GRID * (int) ( m_rng() % GRID_SIZE ),
+                         GRID * (int) ( m_rng() % GRID_SIZE ) );
+    }
+
+    ///> Returns the key of a new random segment or via, not in aKeys
+    ITEM_KEY randomKey( const std::set<ITEM_KEY>& aKeys )
+    {
+        for( ;; )
+        {
+            ITEM_KEY key;
+
+            key.m_net = 1 + m_rng() % 2;
+            key.m_a = randomPoint();
+
+            if( m_rng() % 4 == 0 )
+            {
+                key.m_kind = PNS::ITEM::VIA_T;
+                key.m_layer = 0;
+                key.m_b = key.m_a;
+            }
+            else
+            {
+                key.m_kind = PNS::ITEM::SEGMENT_T;
+                key.m_layer = m_rng() % 2;
+                key.m_b = randomPoint();
+
+                if( key.m_a == key.m_b )
+                    continue;
+
+                if( std::tie( key.m_b.x, key.m_b.y ) < std::tie( key.m_a.x, key.m_a.y ) )
+                    std::swap( key.m_a, key.m_b );
+            }
+
+            if( !aKeys.count( key ) )
+                return key;
+        }
+    }
+
+    void addItem( PNS::NODE* aNode, const ITEM_KEY& aKey )
+    {
+        if( aKey.m_kind == PNS::ITEM::VIA_T )
+        {
+            aNode->Add( std::make_unique<PNS::VIA>( aKey.m_a, LAYER_RANGE( 0, 1 ), GRID / 2,
+                                                    GRID / 4, aKey.m_net ) );
+        }
+        else
+        {
+            std::unique_ptr<PNS::SEGMENT> segment =
+                    std::make_unique<PNS::SEGMENT>( SEG( aKey.m_a, aKey.m_b ), aKey.m_net );
+
+            segment->SetWidth( GRID / 5 );
+            segment->SetLayer( aKey.m_layer );
+
+            BOOST_REQUIRE( aNode->Add( std::move( segment ) ) );
+        }
+    }
+
+    void removeItem( PNS::NODE* aNode, const ITEM_KEY& aKey )
+    {
+        std::set<PNS::ITEM*> items;
+        aNode->AllItemsInNet( aKey.m_net, items );
+
+        for( PNS::ITEM* item : items )
+        {
+            if( itemKey( item ) == aKey )
+            {
+                aNode->Remove( item );
+                return;
+            }
+        }
+
+        BOOST_FAIL( "The item to remove is not in the node" );
+    }
+
+    void apply( BRANCH_STATE& aBranch, const NODE_OP& aOp )
+    {
+        if( aOp.m_add )
+        {
+            addItem( aBranch.m_node, aOp.m_key );
+            aBranch.m_keys.insert( aOp.m_key );
+        }
+        else
+        {
+            removeItem( aBranch.m_node, aOp.m_key );
+            aBranch.m_keys.erase( aOp.m_key );
+        }
+
+        aBranch.m_history.push_back( aOp );
+    }
+
+    ///> Adds or removes a random item of aBranch
+    void randomEdit( BRANCH_STATE& aBranch )
+    {
+        NODE_OP op;
+
+        op.m_add = aBranch.m_keys.empty() || m_rng() % 3 != 0;
+
+        if( op.m_add )
+        {
+            op.m_key = randomKey( aBranch.m_keys );
+        }
+        else
+        {
+            auto it = aBranch.m_keys.begin();
+            std::advance( it, m_rng() % aBranch.m_keys.size() );
+            op.m_key = *it;
+        }
+
+        apply( aBranch, op );
+    }
+
+    BRANCH_STATE branch( const BRANCH_STATE& aParent )
+    {
+        BRANCH_STATE child = aParent;
+
+        child.m_node = aParent.m_node->Branch();
+        return child;
+    }
+
+    std::set<ITEM_KEY> allKeys( PNS::NODE* aNode )
+    {
+        std::set<PNS::ITEM*> items;
+
+        aNode->AllItemsInNet( 1, items );
+        aNode->AllItemsInNet( 2, items );
+
+        std::vector<ITEM_KEY> keys = sortedKeys( items );
+
+        BOOST_CHECK( std::adjacent_find( keys.begin(), keys.end() ) == keys.end() );
+        return std::set<ITEM_KEY>( keys.begin(), keys.end() );
+    }
+
+    ///> Returns the position, net, layers and links of aJoint, or an empty tuple if null
+    static std::tuple<int, int, int, int, int, std::vector<ITEM_KEY>> jointKey(
+            const PNS::JOINT* aJoint )
+    {
+        if( !aJoint )
+            return std::make_tuple( 0, 0, -1, -1, -1, std::vector<ITEM_KEY>() );
+
+        std::vector<PNS::ITEM*> links;
+
+        for( PNS::ITEM* link : aJoint->LinkList() )
+            links.push_back( link );
+
+        return std::make_tuple( aJoint->Pos().x, aJoint->Pos().y, aJoint->Net(),
+                                aJoint->Layers().Start(), aJoint->Layers().End(),
+                                sortedKeys( links ) );
+    }
+
+    /**
+     * Checks that aNode and aReference see the same items (aKeys), the same colliding items,
+     * the same joints, and that their changes wrs to the root are the same.
+     */
+    void compareNodes( PNS::NODE* aNode, PNS::NODE* aReference, const std::set<ITEM_KEY>& aKeys )
+    {
+        BOOST_CHECK( allKeys( aNode ) == aKeys );
+        BOOST_CHECK( allKeys( aReference ) == aKeys );
+
+        if( aNode->GetParent() && aReference->GetParent() )
+        {
+            PNS::NODE::ITEM_VECTOR removed, added, refRemoved, refAdded;
+
+            aNode->GetUpdatedItems( removed, added );
+            aReference->GetUpdatedItems( refRemoved, refAdded );
+
+            BOOST_CHECK( sortedKeys( removed ) == sortedKeys( refRemoved ) );
+            BOOST_CHECK( sortedKeys( added ) == sortedKeys( refAdded ) );
+        }
+
+        // Probes of another net across the grid, on each layer
+        for( int ii = 0; ii < GRID_SIZE; ++ii )
+        {
+            for( int layer = 0; layer < 2; ++layer )
+            {
+                PNS::SEGMENT probe( SEG( VECTOR2I( -GRID, ii * GRID + GRID / 3 ),
+                                         VECTOR2I( GRID_SIZE * GRID, ii * GRID ) ), 3 );
+                probe.SetWidth( GRID / 5 );
+                probe.SetLayer( layer );
+
+                PNS::NODE::OBSTACLES    obstacles, refObstacles;
+                std::vector<PNS::ITEM*> items, refItems;
+
+                aNode->QueryColliding( &probe, obstacles );
+                aReference->QueryColliding( &probe, refObstacles );
+
+                for( const PNS::OBSTACLE& obstacle : obstacles )
+                    items.push_back( obstacle.m_item );
+
+                for( const PNS::OBSTACLE& obstacle : refObstacles )
+                    refItems.push_back( obstacle.m_item );
+
+                BOOST_CHECK( sortedKeys( items ) == sortedKeys( refItems ) );
+            }
+        }
+
+        for( int x = 0; x < GRID_SIZE; ++x )
+        {
+            for( int y = 0; y < GRID_SIZE; ++y )
+            {
+                for( int net = 1; net <= 2; ++net )
+                {
+                    for( int layer = 0; layer < 2; ++layer )
+                    {
+                        VECTOR2I pos( x * GRID, y * GRID );
+
+                        BOOST_CHECK( jointKey( aNode->FindJoint( pos, layer, net ) )
+                                     == jointKey( aReference->FindJoint( pos, layer, net ) ) );
+                    }
+                }
+            }
+        }
+
+        BOX2I                     box( VECTOR2I( -GRID, -GRID ),
+                                       VECTOR2I( ( GRID_SIZE + 1 ) * GRID,
+                                                 ( GRID_SIZE + 1 ) * GRID ) );
+        std::vector<PNS::JOINT*>  joints, refJoints;
+        std::vector<decltype( jointKey( nullptr ) )> keys, refKeys;
+
+        aNode->QueryJoints( box, joints );
+        aReference->QueryJoints( box, refJoints );
+
+        for( PNS::JOINT* joint : joints )
+            keys.push_back( jointKey( joint ) );
+
+        for( PNS::JOINT* joint : refJoints )
+            refKeys.push_back( jointKey( joint ) );
+
+        std::sort( keys.begin(), keys.end() );
+        std::sort( refKeys.begin(), refKeys.end() );
+        BOOST_CHECK( keys == refKeys );
+    }
+
+    ///> Compares aBranch with a branch of the root to which its history is applied at once
+    void checkBranch( const BRANCH_STATE& aBranch )
+    {
+        BRANCH_STATE replay;
+
+        replay.m_node = m_root.Branch();
+        replay.m_keys = m_rootKeys;
+
+        for( const NODE_OP& op : aBranch.m_history )
+            apply( replay, op );
+
+        compareNodes( aBranch.m_node, replay.m_node, aBranch.m_keys );
+
+        delete replay.m_node;
+    }
+
+    ///> Compares the root with a node to which its items are added from scratch
+    void checkRoot()
+    {
+        PNS::NODE scratch;
+
+        for( const ITEM_KEY& key : m_rootKeys )
+            addItem( &scratch, key );
+
+        compareNodes( &m_root, &scratch, m_rootKeys );
+    }
+
+    ///> Commits aBranch, which kills every branch, and starts a new branch of the root
+    void commit( std::vector<BRANCH_STATE>& aBranches, size_t aIndex )
+    {
+        m_root.Commit( aBranches[aIndex].m_node );
+        m_rootKeys = aBranches[aIndex].m_keys;
+        aBranches.clear();
+
+        BOOST_CHECK( !m_root.HasChildren() );
+        checkRoot();
+    }
+
+    BRANCH_STATE rootBranch()
+    {
+        BRANCH_STATE branch;
+
+        branch.m_node = m_root.Branch();
+        branch.m_keys = m_rootKeys;
+        return branch;
+    }
+
+    void fillRoot( int aCount )
+    {
+        BRANCH_STATE root;
+
+        root.m_node = &m_root;
+
+        for( int ii = 0; ii < aCount; ++ii )
+            randomEdit( root );
+
+        m_rootKeys = root.m_keys;
+        checkRoot();
+    }
+
+    PNS::NODE          m_root;
+    std::set<ITEM_KEY> m_rootKeys;
+    std::mt19937       m_rng;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PnsNode, PNS_NODE_FIXTURE )
+
+
+/**
+ * A chain of branches, each changing the items of the branch below, deeper than the layers
+ * a branch keeps before merging them
+ */
+BOOST_AUTO_TEST_CASE( DeepChain )
+{
+    fillRoot( 30 );
+
+    std::vector<BRANCH_STATE> chain = { rootBranch() };
+
+    for( int depth = 1; depth <= 30; ++depth )
+    {
+        for( int ii = 0; ii < 4; ++ii )
+            randomEdit( chain.back() );
+
+        chain.push_back( branch( chain.back() ) );
+        randomEdit( chain.back() );
+
+        BOOST_TEST_CONTEXT( "Depth " << depth )
+        {
+            for( const BRANCH_STATE& state : chain )
+                checkBranch( state );
+        }
+    }
+
+    BOOST_CHECK( chain.back().m_node->Depth() > 3 * 8 );
+
+    commit( chain, chain.size() - 1 );
+}
+
+
+/**
+ * Random edits, branches, commits and kills of the branches
+ */
+BOOST_AUTO_TEST_CASE( RandomReplay )
+{
+    fillRoot( 20 );
+
+    std::vector<BRANCH_STATE> branches = { rootBranch() };
+    int                       maxDepth = 0;
+
+    for( int step = 0; step < 1000; ++step )
+    {
+        BOOST_TEST_CONTEXT( "Step " << step )
+        {
+            // Mostly work on the newest branch, to make deep chains
+            size_t index = m_rng() % 10 ? branches.size() - 1 : m_rng() % branches.size();
+            int    action = m_rng() % 200;
+
+            if( action < 140 )
+            {
+                randomEdit( branches[index] );
+                checkBranch( branches[index] );
+            }
+            else if( action < 195 )
+            {
+                branches.push_back( branch( branches[index] ) );
+                maxDepth = std::max( maxDepth, branches.back().m_node->Depth() );
+            }
+            else if( action < 198 )
+            {
+                commit( branches, index );
+                branches.push_back( rootBranch() );
+            }
+            else
+            {
+                m_root.KillChildren();
+                branches = { rootBranch() };
+            }
+
+            // The branches of a changed branch keep its state as of their creation
+            if( step % 50 == 0 )
+            {
+                for( const BRANCH_STATE& state : branches )
+                    checkBranch( state );
+            }
+        }
+    }
+
+    BOOST_CHECK( maxDepth > 8 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,250 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for RN_NET, and the incremental update of its triangulation
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <connectivity/connectivity_algo.h>
+#include <connectivity/connectivity_data.h>
+
+// Code under test
+#include <ratsnest_data.h>
+
+
+/**
+ * A net of unconnected vias on a lattice, whose ratsnest is a spanning tree of the vias
+ */
+struct RATSNEST_FIXTURE
+{
+    RATSNEST_FIXTURE() :
+            m_rng( 1234 )
+    {
+        m_board.Add( new NETINFO_ITEM( &m_board, "N1", 1 ) );
+    }
+
+    /**
+     * Adds a via at a free position of the lattice.  The vias are smaller than the lattice
+     * pitch, so each one is a cluster of its own.
+     */
+    void addVia()
+    {
+        std::uniform_int_distribution<int> coord( 0, LATTICE_SIZE - 1 );
+        std::pair<int, int>                cell;
+
+        do
+        {
+            cell = { coord( m_rng ), coord( m_rng ) };
+        } while( m_vias.count( cell ) );
+
+        VIA* via = new VIA( &m_board );
+
+        via->SetPosition( wxPoint( cell.first * PITCH, cell.second * PITCH ) );
+        via->SetWidth( Millimeter2iu( 0.3 ) );
+        via->SetDrill( Millimeter2iu( 0.15 ) );
+        via->SetViaType( VIATYPE::THROUGH );
+        via->SetLayerPair( F_Cu, B_Cu );
+        via->SetNetCode( 1 );
+
+        m_board.Add( via );
+        m_vias[cell] = via;
+    }
+
+    void removeVia()
+    {
+        std::uniform_int_distribution<size_t> index( 0, m_vias.size() - 1 );
+        auto                                  it = std::next( m_vias.begin(), index( m_rng ) );
+
+        m_board.Remove( it->second );
+        m_removed.emplace_back( it->second );
+        m_vias.erase( it );
+    }
+
+    static double totalLength( RN_NET* aNet )
+    {
+        double length = 0.0;
+
+        for( const CN_EDGE& edge : aNet->GetUnconnected() )
+        {
+            const VECTOR2I d = edge.GetTargetPos() - edge.GetSourcePos();
+
+            length += std::hypot( (double) d.x, (double) d.y );
+        }
+
+        return length;
+    }
+
+    /**
+     * Updates the ratsnest of the board, whose triangulation is kept between updates, and
+     * checks it against the ratsnest of a connectivity built from scratch.  Spanning trees of
+     * a same set may differ between equal length edges, but their length is the same.
+     */
+    void checkRatsnest( const std::string& aEdit )
+    {
+        BOOST_TEST_CONTEXT( aEdit << ", " << m_vias.size() << " vias" )
+        {
+            std::shared_ptr<CONNECTIVITY_DATA> incremental = m_board.GetConnectivity();
+
+            incremental->RecalculateRatsnest();
+
+            CONNECTIVITY_DATA full;
+
+            full.Build( &m_board );
+            full.RecalculateRatsnest();
+
+            RN_NET* incrementalNet = incremental->GetRatsnestForNet( 1 );
+            RN_NET* fullNet = full.GetRatsnestForNet( 1 );
+
+            BOOST_REQUIRE( incrementalNet && fullNet );
+
+            BOOST_CHECK_EQUAL( incrementalNet->GetUnconnected().size(), m_vias.size() - 1 );
+            BOOST_CHECK_EQUAL( fullNet->GetUnconnected().size(), m_vias.size() - 1 );
+
+            // The edge weights are rounded distances, so the trees may pick different edges
+            // among those whose lengths round the same, less than 1 IU apart
+            BOOST_CHECK_SMALL( totalLength( incrementalNet ) - totalLength( fullNet ),
+                               (double) m_vias.size() );
+        }
+    }
+
+    static const int LATTICE_SIZE = 64;
+    static const int PITCH = 500000;    // 0.5 mm
+
+    ///> The vias removed from the board, deleted after it
+    std::vector<std::unique_ptr<VIA>>     m_removed;
+    BOARD                                 m_board;
+    std::mt19937                          m_rng;
+    std::map<std::pair<int, int>, VIA*>   m_vias;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( Ratsnest, RATSNEST_FIXTURE )
+
+
+/**
+ * Single vias added and removed are triangulated incrementally, until the updates add up to
+ * an eighth of the positions and the next update triangulates from scratch
+ */
+BOOST_AUTO_TEST_CASE( SmallEdits )
+{
+    for( int ii = 0; ii < 400; ++ii )
+        addVia();
+
+    checkRatsnest( "Initial" );
+
+    std::uniform_int_distribution<int> kind( 0, 2 );
+
+    // With 400 positions, a full triangulation follows every 50 added or removed positions
+    for( int step = 0; step < 200; ++step )
+    {
+        switch( kind( m_rng ) )
+        {
+        case 0:
+            addVia();
+            checkRatsnest( "Via added" );
+            break;
+
+        case 1:
+            removeVia();
+            checkRatsnest( "Via removed" );
+            break;
+
+        default:
+            removeVia();
+            addVia();
+            checkRatsnest( "Via moved" );
+            break;
+        }
+    }
+}
+
+
+/**
+ * Edits changing more than a 32nd of the positions at once are triangulated from scratch,
+ * and the updates following them are incremental again
+ */
+BOOST_AUTO_TEST_CASE( LargeEdits )
+{
+    for( int ii = 0; ii < 400; ++ii )
+        addVia();
+
+    checkRatsnest( "Initial" );
+
+    for( int step = 0; step < 10; ++step )
+    {
+        for( int ii = 0; ii < 20; ++ii )
+            removeVia();
+
+        checkRatsnest( "Vias removed" );
+
+        for( int ii = 0; ii < 20; ++ii )
+            addVia();
+
+        checkRatsnest( "Vias added" );
+
+        // 12 and 14 changed positions, just below and above the size threshold
+        for( int count : { 6, 7 } )
+        {
+            for( int ii = 0; ii < count; ++ii )
+            {
+                removeVia();
+                addVia();
+            }
+
+            checkRatsnest( "Vias moved" );
+        }
+    }
+}
+
+
+/**
+ * A net small enough that every edit exceeds the thresholds
+ */
+BOOST_AUTO_TEST_CASE( SmallNet )
+{
+    for( int ii = 0; ii < 12; ++ii )
+        addVia();
+
+    checkRatsnest( "Initial" );
+
+    for( int step = 0; step < 50; ++step )
+    {
+        removeVia();
+        addVia();
+        checkRatsnest( "Via moved" );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,239 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for ZONE_FILLER, and its skipping of the zones whose inputs did not change
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/filename.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <class_board.h>
+#include <class_edge_mod.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <zone_filler.h>
+
+
+/**
+ * A board with a copper zone crossed by two tracks of different widths, holding a footprint
+ * with a pad, a copper graphic and a copper text.  Only the last of three nets is used, so
+ * the nets are renumbered when the board is saved.
+ */
+struct ZONE_FILLER_FIXTURE
+{
+    ZONE_FILLER_FIXTURE()
+    {
+        m_zone = new ZONE_CONTAINER( &m_board );
+        m_zone->SetLayer( F_Cu );
+        m_zone->SetMinThickness( Millimeter2iu( 0.25 ) );
+        m_zone->SetZoneClearance( Millimeter2iu( 0.2 ) );
+        m_zone->AppendCorner( wxPoint( 0, 0 ), -1 );
+        m_zone->AppendCorner( wxPoint( Millimeter2iu( 20 ), 0 ), -1 );
+        m_zone->AppendCorner( wxPoint( Millimeter2iu( 20 ), Millimeter2iu( 20 ) ), -1 );
+        m_zone->AppendCorner( wxPoint( 0, Millimeter2iu( 20 ) ), -1 );
+        m_board.Add( m_zone );
+
+        m_thin = addTrack( Millimeter2iu( 5 ), Millimeter2iu( 0.25 ) );
+        m_wide = addTrack( Millimeter2iu( 12 ), Millimeter2iu( 1 ) );
+
+        for( int net = 1; net <= 3; ++net )
+            m_board.Add( new NETINFO_ITEM( &m_board, wxString::Format( "N%d", net ), net ) );
+
+        MODULE* module = new MODULE( &m_board );
+        m_board.Add( module );
+
+        D_PAD* pad = new D_PAD( module );
+        pad->SetShape( PAD_SHAPE_RECT );
+        pad->SetAttribute( PAD_ATTRIB_SMD );
+        pad->SetLayerSet( D_PAD::SMDMask() );
+        pad->SetSize( wxSize( Millimeter2iu( 1 ), Millimeter2iu( 1 ) ) );
+        pad->SetPos0( wxPoint( Millimeter2iu( 10 ), Millimeter2iu( 8.5 ) ) );
+        pad->SetPosition( wxPoint( Millimeter2iu( 10 ), Millimeter2iu( 8.5 ) ) );
+        module->Add( pad );
+        pad->SetNetCode( 3 );
+
+        EDGE_MODULE* edge = new EDGE_MODULE( module );
+        edge->SetLayer( F_Cu );
+        edge->SetWidth( Millimeter2iu( 0.2 ) );
+        edge->SetStart0( wxPoint( Millimeter2iu( 4 ), Millimeter2iu( 16 ) ) );
+        edge->SetEnd0( wxPoint( Millimeter2iu( 16 ), Millimeter2iu( 16 ) ) );
+        edge->SetDrawCoord();
+        module->Add( edge );
+
+        module->SetReference( "U1" );
+        module->Reference().SetLayer( F_Cu );
+        module->Reference().SetPos0( wxPoint( Millimeter2iu( 10 ), Millimeter2iu( 18 ) ) );
+
+        m_board.BuildConnectivity();
+    }
+
+    TRACK* addTrack( int aY, int aWidth )
+    {
+        TRACK* track = new TRACK( &m_board );
+
+        track->SetStart( wxPoint( Millimeter2iu( 2 ), aY ) );
+        track->SetEnd( wxPoint( Millimeter2iu( 18 ), aY ) );
+        track->SetWidth( aWidth );
+        track->SetLayer( F_Cu );
+        m_board.Add( track );
+
+        return track;
+    }
+
+    /**
+     * Fills the zone after an edit, checks it was refilled, and that its fill is the one a
+     * forced refill gives.
+     */
+    void checkRefilled( const std::string& aEdit )
+    {
+        BOOST_TEST_CONTEXT( aEdit )
+        {
+            m_board.BuildConnectivity();
+
+            uint64_t previousHash = m_zone->GetFillInputHash();
+            MD5_HASH previousFill = m_zone->GetFilledPolysList().GetHash();
+
+            BOOST_REQUIRE( ZONE_FILLER( &m_board ).Fill( { m_zone } ) );
+
+            BOOST_CHECK( m_zone->GetFillInputHash() != previousHash );
+            BOOST_CHECK( m_zone->GetFilledPolysList().GetHash() != previousFill );
+
+            MD5_HASH fill = m_zone->GetFilledPolysList().GetHash();
+
+            BOOST_REQUIRE( ZONE_FILLER( &m_board ).Fill( { m_zone }, false, true ) );
+            BOOST_CHECK( m_zone->GetFilledPolysList().GetHash() == fill );
+        }
+    }
+
+    BOARD           m_board;
+    ZONE_CONTAINER* m_zone;
+    TRACK*          m_thin;
+    TRACK*          m_wide;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ZoneFiller, ZONE_FILLER_FIXTURE )
+
+
+/**
+ * A zone whose inputs did not change keeps its fill, unless the refill is forced
+ */
+BOOST_AUTO_TEST_CASE( SkipUnchanged )
+{
+    BOOST_REQUIRE( ZONE_FILLER( &m_board ).Fill( { m_zone } ) );
+    BOOST_REQUIRE( m_zone->IsFilled() );
+
+    uint64_t inputHash = m_zone->GetFillInputHash();
+    BOOST_CHECK( inputHash != 0 );
+
+    // A skipped zone is not unfilled: a marker polygon added to its fill stays
+    SHAPE_POLY_SET marked = m_zone->GetFilledPolysList();
+    marked.NewOutline();
+    marked.Append( Millimeter2iu( 30 ), 0 );
+    marked.Append( Millimeter2iu( 31 ), 0 );
+    marked.Append( Millimeter2iu( 31 ), Millimeter2iu( 1 ) );
+    m_zone->SetFilledPolysList( marked );
+
+    BOOST_REQUIRE( ZONE_FILLER( &m_board ).Fill( { m_zone } ) );
+    BOOST_CHECK( m_zone->GetFillInputHash() == inputHash );
+    BOOST_CHECK( m_zone->GetFilledPolysList().GetHash() == marked.GetHash() );
+
+    BOOST_REQUIRE( ZONE_FILLER( &m_board ).Fill( { m_zone }, false, true ) );
+    BOOST_CHECK( m_zone->GetFillInputHash() == inputHash );
+    BOOST_CHECK( m_zone->GetFilledPolysList().GetHash() != marked.GetHash() );
+}
+
+
+/**
+ * The edits whose coordinate or property changes cancel out in a sum still refill the zone
+ */
+BOOST_AUTO_TEST_CASE( RefillAfterEdits )
+{
+    const int g = Millimeter2iu( 0.5 );
+
+    BOOST_REQUIRE( ZONE_FILLER( &m_board ).Fill( { m_zone } ) );
+
+    m_thin->Move( wxPoint( 2 * g, -g ) );
+    checkRefilled( "Track moved by (2g, -g)" );
+
+    m_zone->Outline()->SetVertex( 2, VECTOR2I( Millimeter2iu( 20 ) + 2 * g,
+                                               Millimeter2iu( 20 ) - g ) );
+    checkRefilled( "Zone corner moved by (2g, -g)" );
+
+    int thinWidth = m_thin->GetWidth();
+    m_thin->SetWidth( m_wide->GetWidth() );
+    m_wide->SetWidth( thinWidth );
+    checkRefilled( "Track widths swapped" );
+}
+
+
+/**
+ * A board read back from its file keeps the fills saved with it, although its footprint items
+ * get new UUIDs and its nets new codes
+ */
+BOOST_AUTO_TEST_CASE( SkipAfterReload )
+{
+    BOOST_REQUIRE( ZONE_FILLER( &m_board ).Fill( { m_zone } ) );
+
+    wxString path = wxFileName::CreateTempFileName( "zonefill" );
+
+    KI_TEST::DumpBoardToFile( m_board, path.ToStdString() );
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( path.ToStdString() );
+    wxRemoveFile( path );
+
+    BOOST_REQUIRE( board );
+    BOOST_REQUIRE_EQUAL( board->Zones().size(), 1 );
+    BOOST_REQUIRE_EQUAL( board->Modules().size(), 1 );
+
+    ZONE_CONTAINER* zone = board->Zones()[0];
+    D_PAD*          pad = board->Modules().front()->Pads().front();
+
+    BOOST_CHECK_EQUAL( pad->GetNetname(), "N3" );
+    BOOST_CHECK( pad->GetNetCode() != 3 );
+    BOOST_REQUIRE( zone->IsFilled() );
+    BOOST_CHECK( zone->GetFillInputHash() == m_zone->GetFillInputHash() );
+
+    // A skipped zone keeps a marker polygon added to its fill
+    SHAPE_POLY_SET marked = zone->GetFilledPolysList();
+    marked.NewOutline();
+    marked.Append( Millimeter2iu( 30 ), 0 );
+    marked.Append( Millimeter2iu( 31 ), 0 );
+    marked.Append( Millimeter2iu( 31 ), Millimeter2iu( 1 ) );
+    zone->SetFilledPolysList( marked );
+
+    board->BuildConnectivity();
+
+    BOOST_REQUIRE( ZONE_FILLER( board.get() ).Fill( { zone } ) );
+    BOOST_CHECK( zone->GetFillInputHash() == m_zone->GetFillInputHash() );
+    BOOST_CHECK( zone->GetFilledPolysList().GetHash() == marked.GetHash() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -204,6 +204,74 @@ private:
 };
 
 
+/**
+ * DRC provider running the track and via clearance tests of the #DRC tool
+ */
+class DRC_TRACK_CLEARANCE_PROVIDER : public DRC_PROVIDER
+{
+public:
+    DRC_TRACK_CLEARANCE_PROVIDER( MARKER_HANDLER aMarkerHandler, bool aUseIndex ) :
+            DRC_PROVIDER( aMarkerHandler ),
+            m_handler( aMarkerHandler ),
+            m_useIndex( aUseIndex )
+    {
+    }
+
+    bool RunDRC( EDA_UNITS aUnits, BOARD& aBoard ) const override
+    {
+        DRC drc;
+        drc.TestTrackClearances( &aBoard, aUnits, m_useIndex, m_handler );
+        return true;
+    }
+
+private:
+    MARKER_HANDLER m_handler;
+    bool           m_useIndex;
+};
+
+
+/**
+ * DRC runner to run the track clearance checks, either with the spatially indexed,
+ * multithreaded engine or with the serial sweep over every pair of items
+ */
+class DRC_TRACK_CLEARANCE_RUNNER : public DRC_RUNNER
+{
+public:
+    DRC_TRACK_CLEARANCE_RUNNER( const EXECUTION_CONTEXT& aCtx, bool aUseIndex,
+                                const BOARD_DESIGN_SETTINGS& aSettings ) :
+            DRC_RUNNER( aCtx ),
+            m_useIndex( aUseIndex ),
+            m_settings( aSettings )
+    {
+    }
+
+    virtual ~DRC_TRACK_CLEARANCE_RUNNER()
+    {
+    }
+
+private:
+    std::string getRunnerIntro() const override
+    {
+        return m_useIndex ? "Track clearance (indexed)" : "Track clearance (serial sweep)";
+    }
+
+    BOARD_DESIGN_SETTINGS getDesignSettings() const override
+    {
+        // Use the board's own rules
+        return m_settings;
+    }
+
+    std::unique_ptr<DRC_PROVIDER> createDrcProvider(
+            BOARD& aBoard, DRC_PROVIDER::MARKER_HANDLER aHandler ) override
+    {
+        return std::make_unique<DRC_TRACK_CLEARANCE_PROVIDER>( aHandler, m_useIndex );
+    }
+
+    bool                  m_useIndex;
+    BOARD_DESIGN_SETTINGS m_settings;
+};
+
+
 static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
     {
             wxCMD_LINE_SWITCH,
@@ -249,6 +317,19 @@ static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
             "courtyard-missing",
             _( "perform courtyard-missing checking" ).mb_str(),
     },
+    {
+            wxCMD_LINE_SWITCH,
+            "k",
+            "track-clearance",
+            _( "perform track clearance checking with the indexed engine" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "K",
+            "track-clearance-reference",
+            _( "also perform track clearance checking with the serial sweep, for comparison" )
+                    .mb_str(),
+    },
     {
             wxCMD_LINE_PARAM,
             nullptr,
@@ -322,6 +403,22 @@ int drc_main_func( int argc, char** argv )
         runner.Execute( *board );
     }
 
+    const bool reference = cl_parser.Found( "track-clearance-reference" );
+
+    if( all || reference || cl_parser.Found( "track-clearance" ) )
+    {
+        const BOARD_DESIGN_SETTINGS settings = board->GetDesignSettings();
+
+        DRC_TRACK_CLEARANCE_RUNNER runner( exec_context, true, settings );
+        runner.Execute( *board );
+
+        if( reference )
+        {
+            DRC_TRACK_CLEARANCE_RUNNER referenceRunner( exec_context, false, settings );
+            referenceRunner.Execute( *board );
+        }
+    }
+
     return KI_TEST::RET_CODES::OK;
 }
 
@@ -24,6 +24,8 @@
 #include <qa_utils/utility_registry.h>
 
 #include <cstdio>
+#include <memory>
+#include <sstream>
 #include <string>
 
 #include <common.h>
@@ -87,10 +89,86 @@ bool parse( std::istream& aStream, bool aVerbose )
 }
 
 
+/**
+ * Parse a PCB or footprint from a string, formatting the result back out
+ *
+ * @param aData the file contents
+ * @param aMultiThreaded allow the parser to use worker threads
+ * @param aOutput the formatted result, empty on failure
+ * @return the parse duration
+ */
+static PARSE_DURATION parseAndFormat( const std::string& aData, bool aMultiThreaded,
+                                      std::string& aOutput )
+{
+    STRING_LINE_READER reader( aData, "input" );
+    PCB_PARSER         parser( &reader );
+
+    parser.SetMultiThreaded( aMultiThreaded );
+
+    std::unique_ptr<BOARD_ITEM> item;
+    PARSE_DURATION              duration{};
+
+    aOutput.clear();
+
+    try
+    {
+        PROF_COUNTER timer;
+        item.reset( parser.Parse() );
+
+        duration = timer.SinceStart<PARSE_DURATION>();
+    }
+    catch( const IO_ERROR& parse_error )
+    {
+        std::cerr << parse_error.Problem() << std::endl;
+        std::cerr << parse_error.Where() << std::endl;
+        return duration;
+    }
+
+    PCB_IO io;
+    io.Format( item.get() );
+    aOutput = io.GetStringOutput( true );
+
+    return duration;
+}
+
+
+/**
+ * Parse the input serially and with worker threads, and check both give the same board
+ *
+ * @param aStream the input stream to read from
+ * @return true if both parses succeeded and formatted identically
+ */
+bool compare( std::istream& aStream )
+{
+    std::stringstream buffer;
+    buffer << aStream.rdbuf();
+
+    const std::string data = buffer.str();
+    std::string       serialOut;
+    std::string       parallelOut;
+
+    PARSE_DURATION serial = parseAndFormat( data, false, serialOut );
+    PARSE_DURATION parallel = parseAndFormat( data, true, parallelOut );
+
+    std::cout << "Serial:   " << serial.count() << "us" << std::endl;
+    std::cout << "Parallel: " << parallel.count() << "us" << std::endl;
+
+    if( serialOut.empty() || serialOut != parallelOut )
+    {
+        std::cerr << "Serial and parallel parses differ" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
 static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
     { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
             wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
     { wxCMD_LINE_SWITCH, "v", "verbose", _( "print parsing information" ).mb_str() },
+    { wxCMD_LINE_SWITCH, "c", "compare",
+            _( "time serial and multithreaded parsing and check the results match" ).mb_str() },
     { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input file" ).mb_str(), wxCMD_LINE_VAL_STRING,
             wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE },
     { wxCMD_LINE_NONE }
@@ -125,6 +203,7 @@ int pcb_parser_main_func( int argc, char** argv )
     }
 
     const bool verbose = cl_parser.Found( "verbose" );
+    const bool compareModes = cl_parser.Found( "compare" );
 
     bool ok = true;
 
@@ -136,7 +215,7 @@ int pcb_parser_main_func( int argc, char** argv )
         // program
         // while (__AFL_LOOP(2))
         {
-            ok = parse( std::cin, verbose );
+            ok = compareModes ? compare( std::cin ) : parse( std::cin, verbose );
         }
     }
     else
@@ -154,7 +233,7 @@ int pcb_parser_main_func( int argc, char** argv )
             std::ifstream fin;
             fin.open( filename );
 
-            ok = ok && parse( fin, verbose );
+            ok = ok && ( compareModes ? compare( fin ) : parse( fin, verbose ) );
         }
     }
 
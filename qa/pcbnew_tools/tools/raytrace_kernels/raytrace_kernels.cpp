@@ -0,0 +1,282 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <wx/cmdline.h>
+
+#include <3d_rendering/ctrack_ball.h>
+#include <3d_rendering/3d_render_raytracing/accelerators/cbvh_pbrt.h>
+#include <3d_rendering/3d_render_raytracing/accelerators/ccontainer.h>
+#include <3d_rendering/3d_render_raytracing/raypacket_kernels.h>
+#include <3d_rendering/3d_render_raytracing/shapes3D/ctriangle.h>
+#include <profile.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+using TRACE_DURATION = std::chrono::milliseconds;
+
+
+/**
+ * Fill aContainer with aCount random triangles in the cube seen by a camera of range 8
+ */
+static void buildScene( CCONTAINER& aContainer, int aCount )
+{
+    std::mt19937                          rng( 1 );
+    std::uniform_real_distribution<float> position( -4.0f, 4.0f );
+    std::uniform_real_distribution<float> offset( -0.5f, 0.5f );
+
+    for( int ii = 0; ii < aCount; ++ii )
+    {
+        const SFVEC3F center( position( rng ), position( rng ), position( rng ) );
+
+        aContainer.Add( new CTRIANGLE(
+                center + SFVEC3F( offset( rng ), offset( rng ), offset( rng ) ),
+                center + SFVEC3F( offset( rng ), offset( rng ), offset( rng ) ),
+                center + SFVEC3F( offset( rng ), offset( rng ), offset( rng ) ) ) );
+    }
+}
+
+
+/**
+ * Trace every packet of the camera's window, as C3D_RENDER_RAYTRACING does
+ *
+ * @param aHits filled with the hit information of each ray, packet after packet
+ */
+static void tracePackets( const CBVH_PBRT& aAccelerator, const CCAMERA& aCamera,
+                          const wxSize& aSize, std::vector<HITINFO_PACKET>& aHits )
+{
+    aHits.resize( ( aSize.x / RAYPACKET_DIM ) * ( aSize.y / RAYPACKET_DIM )
+                  * RAYPACKET_RAYS_PER_PACKET );
+
+    HITINFO_PACKET* hitPacket = aHits.data();
+
+    for( int y = 0; y + RAYPACKET_DIM <= aSize.y; y += RAYPACKET_DIM )
+    {
+        for( int x = 0; x + RAYPACKET_DIM <= aSize.x; x += RAYPACKET_DIM )
+        {
+            const RAYPACKET packet( aCamera, SFVEC2I( x, y ) );
+
+            for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+            {
+                hitPacket[i].m_HitInfo.m_tHit = std::numeric_limits<float>::infinity();
+                hitPacket[i].m_HitInfo.m_acc_node_info = 0;
+                hitPacket[i].m_hitresult = false;
+                hitPacket[i].m_HitInfo.m_HitNormal = SFVEC3F( 0.0f );
+                hitPacket[i].m_HitInfo.m_ShadowFactor = 1.0f;
+            }
+
+            aAccelerator.Intersect( packet, hitPacket );
+
+            hitPacket += RAYPACKET_RAYS_PER_PACKET;
+        }
+    }
+}
+
+
+/**
+ * Test packets of axis parallel rays against a box with the current kernels: rays starting
+ * on its faces, edges and corners, inside and outside it.  Half the rays keep an infinite
+ * inverse direction, whose slabs are NaN (0 * inf) for the rays lying in a face plane.
+ *
+ * @return the masks of the rays found, one per packet
+ */
+static std::vector<uint64_t> intersectAxisParallelRays()
+{
+    const float inf = std::numeric_limits<float>::infinity();
+    const float coords[] = { -2.0f, -1.0f, -0.5f, 0.0f, 0.5f, 1.0f, 2.0f };
+    const CBBOX bbox( SFVEC3F( -1.0f ), SFVEC3F( 1.0f ) );
+
+    std::mt19937                       rng( 1 );
+    std::uniform_int_distribution<int> coord( 0, 6 );
+    std::uniform_int_distribution<int> coin( 0, 1 );
+    std::uniform_int_distribution<int> axis( 0, 2 );
+    std::vector<uint64_t>              results;
+
+    for( int packet = 0; packet < 1000; ++packet )
+    {
+        RAYPACKET_SOA soa;
+        float         tHit[RAYPACKET_RAYS_PER_PACKET];
+
+        for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        {
+            const int rayAxis = axis( rng );
+
+            for( int ii = 0; ii < 3; ++ii )
+            {
+                const float dir = ( ii == rayAxis ) ? ( coin( rng ) ? 1.0f : -1.0f )
+                                                    : ( coin( rng ) ? 0.0f : -0.0f );
+                float       invDir = 1.0f / dir;
+
+                // As RAYPACKET stores them, or left infinite
+                if( std::isinf( invDir ) && coin( rng ) )
+                    invDir = std::copysign( 1e30f, invDir );
+
+                soa.m_Origin[ii][i] = coords[coord( rng )];
+                soa.m_Dir[ii][i] = dir;
+                soa.m_InvDir[ii][i] = invDir;
+            }
+
+            tHit[i] = coin( rng ) ? inf : 3.0f;
+        }
+
+        results.push_back( RAYPACKET_IntersectBBox( soa, bbox, tHit, ~(uint64_t) 0 ) );
+    }
+
+    return results;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "t", "triangles", _( "triangle count (default 100000)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "s", "size", _( "image width and height (default 1024)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum RAYTRACE_KERNELS_RET_CODES
+{
+    KERNELS_DIFFER = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int raytrace_kernels_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program traces the ray packets of an image of random triangles with "
+               "each set of ray packet kernels the processor runs, checks that they find "
+               "the same hits, also for axis parallel rays on the faces of a box, and prints "
+               "their times." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long triangleCount = 100000;
+    long imageSize = 1024;
+    cl_parser.Found( "triangles", &triangleCount );
+    cl_parser.Found( "size", &imageSize );
+
+    CCONTAINER container;
+    buildScene( container, (int) triangleCount );
+
+    const CBVH_PBRT accelerator( container );
+
+    const wxSize size( (int) imageSize, (int) imageSize );
+    CTRACK_BALL  camera( 8.0f );
+    camera.SetCurWindowSize( size );
+
+    const RAYPACKET_KERNELS defaultKernels = RAYPACKET_GetKernels();
+
+    const std::pair<RAYPACKET_KERNELS, const char*> kernelSets[] = {
+        { RAYPACKET_KERNELS::SCALAR, "scalar" },
+        { RAYPACKET_KERNELS::SSE2, "SSE2" },
+        { RAYPACKET_KERNELS::AVX, "AVX" },
+    };
+
+    std::vector<HITINFO_PACKET> reference;
+    std::vector<uint64_t>       referenceAxisParallel;
+    int                         ret = KI_TEST::RET_CODES::OK;
+
+    for( const auto& kernelSet : kernelSets )
+    {
+        if( RAYPACKET_SetKernels( kernelSet.first ) != kernelSet.first )
+        {
+            std::cout << kernelSet.second << ": not supported" << std::endl;
+            continue;
+        }
+
+        const std::vector<uint64_t> axisParallel = intersectAxisParallelRays();
+
+        if( !referenceAxisParallel.empty() && axisParallel != referenceAxisParallel )
+        {
+            std::cerr << kernelSet.second
+                      << ": the axis parallel rays differ from the scalar kernels" << std::endl;
+            ret = RAYTRACE_KERNELS_RET_CODES::KERNELS_DIFFER;
+        }
+
+        if( referenceAxisParallel.empty() )
+            referenceAxisParallel = axisParallel;
+
+        std::vector<HITINFO_PACKET> hits;
+
+        PROF_COUNTER timer;
+        tracePackets( accelerator, camera, size, hits );
+        TRACE_DURATION duration = timer.SinceStart<TRACE_DURATION>();
+
+        size_t hitCount = 0;
+        size_t differences = 0;
+
+        for( size_t ii = 0; ii < hits.size(); ++ii )
+        {
+            hitCount += hits[ii].m_hitresult;
+
+            if( !reference.empty()
+                    && ( hits[ii].m_hitresult != reference[ii].m_hitresult
+                         || hits[ii].m_HitInfo.m_tHit != reference[ii].m_HitInfo.m_tHit ) )
+            {
+                differences++;
+            }
+        }
+
+        std::cout << kernelSet.second << ": " << duration.count() << "ms, " << hitCount
+                  << " hits of " << hits.size() << " rays" << std::endl;
+
+        if( differences )
+        {
+            std::cerr << kernelSet.second << ": " << differences
+                      << " rays differ from the scalar kernels" << std::endl;
+            ret = RAYTRACE_KERNELS_RET_CODES::KERNELS_DIFFER;
+        }
+
+        if( reference.empty() )
+            reference = std::move( hits );
+    }
+
+    RAYPACKET_SetKernels( defaultKernels );
+
+    return ret;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "raytrace_kernels",
+        "Compare the ray packet kernels of the 3D viewer's raytracer",
+        raytrace_kernels_main_func,
+} );
@@ -0,0 +1,172 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <iostream>
+
+#include <wx/cmdline.h>
+#include <wx/image.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <3d_canvas/board_adapter.h>
+#include <3d_rendering/ctrack_ball.h>
+#include <3d_rendering/3d_render_raytracing/c3d_render_raytracing.h>
+#include <class_board.h>
+#include <profile.h>
+#include <reporter.h>
+#include <settings/color_settings.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+using RENDER_DURATION = std::chrono::milliseconds;
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_SWITCH, "v", "verbose", _( "print the progress of the render" ).mb_str() },
+    { wxCMD_LINE_OPTION, "o", "output", _( "PNG file to write (default render.png)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "", "width", _( "image width (default 1600)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "", "height", _( "image height (default 900)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "x", "rotate-x", _( "camera rotation around X in degrees" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE },
+    { wxCMD_LINE_OPTION, "z", "rotate-z", _( "camera rotation around Z in degrees" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE },
+    { wxCMD_LINE_OPTION, "", "zoom", _( "camera zoom factor (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE },
+    { wxCMD_LINE_SWITCH, "", "draft", _( "no shadows, reflections, refractions, "
+                                         "anti-aliasing or post processing" ).mb_str() },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input file" ).mb_str(), wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum RAYTRACE_RENDER_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    SAVE_FAILED,
+};
+
+
+int raytrace_render_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program renders a board with the 3D viewer's raytracer, without any "
+               "OpenGL context, and writes the image to a PNG file while it is rendered. "
+               "The 3D models are not rendered." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::string filename;
+
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return RAYTRACE_RENDER_RET_CODES::LOAD_FAILED;
+
+    wxString output = "render.png";
+    long     width = 1600;
+    long     height = 900;
+    double   rotateX = 0.0;
+    double   rotateZ = 0.0;
+    double   zoom = 1.0;
+
+    cl_parser.Found( "output", &output );
+    cl_parser.Found( "width", &width );
+    cl_parser.Found( "height", &height );
+    cl_parser.Found( "rotate-x", &rotateX );
+    cl_parser.Found( "rotate-z", &rotateZ );
+    cl_parser.Found( "zoom", &zoom );
+
+    if( !wxImage::FindHandler( wxBITMAP_TYPE_PNG ) )
+        wxImage::AddHandler( new wxPNGHandler );
+
+    COLOR_SETTINGS colors;
+    colors.ResetToDefaults();
+
+    // The settings of the 3D viewer by default
+    const bool draft = cl_parser.Found( "draft" );
+
+    BOARD_ADAPTER adapter;
+    adapter.SetBoard( board.get() );
+    adapter.SetColorSettings( &colors );
+    adapter.RenderEngineSet( RENDER_ENGINE::RAYTRACING );
+    adapter.SetFlag( FL_RENDER_RAYTRACING_SHADOWS, !draft );
+    adapter.SetFlag( FL_RENDER_RAYTRACING_REFRACTIONS, !draft );
+    adapter.SetFlag( FL_RENDER_RAYTRACING_REFLECTIONS, !draft );
+    adapter.SetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING, !draft );
+    adapter.SetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING, !draft );
+    adapter.SetFlag( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES, true );
+
+    CTRACK_BALL camera( RANGE_SCALE_3D );
+    camera.RotateX( glm::radians( (float) rotateX ) );
+    camera.RotateZ( glm::radians( (float) rotateZ ) );
+    camera.Zoom( (float) zoom );
+
+    C3D_RENDER_RAYTRACING renderer( adapter, camera );
+
+    REPORTER& reporter = cl_parser.Found( "verbose" ) ? STDOUT_REPORTER::GetInstance()
+                                                     : NULL_REPORTER::GetInstance();
+
+    wxImage      image;
+    PROF_COUNTER timer;
+
+    const bool saved = renderer.RenderOffscreen( wxSize( (int) width, (int) height ), image,
+                                                 &reporter, &reporter, output );
+
+    RENDER_DURATION duration = timer.SinceStart<RENDER_DURATION>();
+
+    std::cout << width << "x" << height << ": " << duration.count() << "ms" << std::endl;
+
+    if( !saved )
+    {
+        std::cerr << "Cannot write " << output << std::endl;
+        return RAYTRACE_RENDER_RET_CODES::SAVE_FAILED;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "raytrace_render",
+        "Render a board with the raytracer, without OpenGL",
+        raytrace_render_main_func,
+} );
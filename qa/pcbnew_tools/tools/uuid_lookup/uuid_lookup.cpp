@@ -0,0 +1,149 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <wx/cmdline.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <profile.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+using LOOKUP_DURATION = std::chrono::nanoseconds;
+
+
+/**
+ * Build a board of aModuleCount modules of 16 pads each, and 32 tracks per module
+ *
+ * @param aItems filled with every item the board's GetItem() should find
+ */
+static std::unique_ptr<BOARD> buildBoard( int aModuleCount, std::vector<BOARD_ITEM*>& aItems )
+{
+    std::unique_ptr<BOARD> board = std::make_unique<BOARD>();
+
+    aItems.clear();
+
+    for( int ii = 0; ii < aModuleCount; ++ii )
+    {
+        MODULE* module = new MODULE( board.get() );
+
+        for( int jj = 0; jj < 16; ++jj )
+        {
+            D_PAD* pad = new D_PAD( module );
+            module->Add( pad, ADD_MODE::APPEND );
+            aItems.push_back( pad );
+        }
+
+        board->Add( module, ADD_MODE::APPEND );
+        aItems.push_back( module );
+        aItems.push_back( &module->Reference() );
+        aItems.push_back( &module->Value() );
+
+        for( int jj = 0; jj < 32; ++jj )
+        {
+            TRACK* track = new TRACK( board.get() );
+            track->SetLayer( F_Cu );
+            board->Add( track, ADD_MODE::APPEND );
+            aItems.push_back( track );
+        }
+    }
+
+    return board;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "m", "modules",
+            _( "module count of the largest board (default 10000)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum UUID_LOOKUP_RET_CODES
+{
+    LOOKUP_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int uuid_lookup_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program times BOARD::GetItem() on synthetic boards of growing size. "
+               "The time per lookup should not depend on the board size." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long maxModules = 10000;
+    cl_parser.Found( "modules", &maxModules );
+
+    for( long moduleCount = 10; moduleCount <= maxModules; moduleCount *= 10 )
+    {
+        std::vector<BOARD_ITEM*> items;
+        std::unique_ptr<BOARD>   board = buildBoard( (int) moduleCount, items );
+
+        PROF_COUNTER timer;
+
+        for( BOARD_ITEM* item : items )
+        {
+            if( board->GetItem( item->m_Uuid ) != item )
+            {
+                std::cerr << "Item " << item->m_Uuid.AsString() << " not found" << std::endl;
+                return UUID_LOOKUP_RET_CODES::LOOKUP_FAILED;
+            }
+        }
+
+        LOOKUP_DURATION duration = timer.SinceStart<LOOKUP_DURATION>();
+
+        std::cout << items.size() << " items: "
+                  << duration.count() / (long long) items.size() << "ns per lookup"
+                  << std::endl;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "uuid_lookup",
+        "Time looking up board items by uuid",
+        uuid_lookup_main_func,
+} );
@@ -0,0 +1,170 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the subtraction of the board holes
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <pcb/oce_utils.h>
+
+#include <profile.h>
+
+#include <BRepAlgoAPI_Cut.hxx>
+#include <BRepBuilderAPI_Transform.hxx>
+#include <BRepCheck_Analyzer.hxx>
+#include <BRepGProp.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <GProp_GProps.hxx>
+#include <TopExp_Explorer.hxx>
+
+#include <cmath>
+
+
+static constexpr double BOARD_THICKNESS = 1.6;
+static constexpr double HOLE_RADIUS = 0.3;
+static constexpr double HOLE_PITCH = 1.0;
+
+
+/**
+ * Make the holes of a square grid of aCount vias, one pitch apart, the first one a pitch
+ * away from the origin, as PCBMODEL::AddPadHole() does
+ * @param aOverlapping adds a second hole overlapping every fifth via, as a slot would
+ */
+static std::vector<TopoDS_Shape> makeHoles( int aCount, bool aOverlapping )
+{
+    std::vector<TopoDS_Shape> holes;
+    const int                 columns = (int) std::ceil( std::sqrt( (double) aCount ) );
+
+    for( int i = 0; i < aCount; ++i )
+    {
+        const double x = HOLE_PITCH * ( 1 + i % columns );
+        const double y = HOLE_PITCH * ( 1 + i / columns );
+
+        for( int j = 0; j < ( aOverlapping && i % 5 == 0 ? 2 : 1 ); ++j )
+        {
+            TopoDS_Shape s = BRepPrimAPI_MakeCylinder( HOLE_RADIUS, BOARD_THICKNESS * 2.0 ).Shape();
+            gp_Trsf      shift;
+            shift.SetTranslation( gp_Vec( x + j * HOLE_RADIUS, y, -BOARD_THICKNESS * 0.5 ) );
+            holes.push_back( BRepBuilderAPI_Transform( s, shift ).Shape() );
+        }
+    }
+
+    return holes;
+}
+
+
+/**
+ * Make a board large enough for the holes of makeHoles( aCount )
+ */
+static TopoDS_Shape makeBoard( int aCount )
+{
+    const double side = HOLE_PITCH * ( std::ceil( std::sqrt( (double) aCount ) ) + 1 );
+
+    return BRepPrimAPI_MakeBox( side, side, BOARD_THICKNESS ).Shape();
+}
+
+
+static double volume( const TopoDS_Shape& aShape )
+{
+    GProp_GProps props;
+    BRepGProp::VolumeProperties( aShape, props );
+    return props.Mass();
+}
+
+
+static int solidCount( const TopoDS_Shape& aShape )
+{
+    int count = 0;
+
+    for( TopExp_Explorer topex( aShape, TopAbs_SOLID ); topex.More(); topex.Next() )
+        count++;
+
+    return count;
+}
+
+
+BOOST_AUTO_TEST_SUITE( OceUtils )
+
+
+/**
+ * Check that a single batched cut gives the board the cuts one after the other give it
+ */
+BOOST_AUTO_TEST_CASE( CutShapesMatchesSequentialCuts )
+{
+    const int                       count = 100;
+    const TopoDS_Shape              board = makeBoard( count );
+    const std::vector<TopoDS_Shape> holes = makeHoles( count, true );
+
+    TopoDS_Shape expected = board;
+
+    for( const auto& i : holes )
+        expected = BRepAlgoAPI_Cut( expected, i );
+
+    const TopoDS_Shape result = CutShapes( board, holes );
+
+    BOOST_CHECK( BRepCheck_Analyzer( result ).IsValid() );
+    BOOST_CHECK_EQUAL( solidCount( result ), 1 );
+    BOOST_CHECK_CLOSE( volume( result ), volume( expected ), 1e-6 );
+}
+
+
+BOOST_AUTO_TEST_CASE( CutShapesNoTools )
+{
+    const TopoDS_Shape board = makeBoard( 1 );
+
+    BOOST_CHECK( CutShapes( board, {} ).IsSame( board ) );
+}
+
+
+/**
+ * Timing mode, not run by default: times the cut of the holes of a board with 20000 vias.
+ * Run it with:
+ *     qa_kicad2step --run_test=OceUtils/CutShapesTiming --log_level=message
+ */
+BOOST_AUTO_TEST_CASE( CutShapesTiming, *boost::unit_test::disabled() )
+{
+    const int                       count = 20000;
+    const TopoDS_Shape              board = makeBoard( count );
+    const std::vector<TopoDS_Shape> holes = makeHoles( count, false );
+
+    PROF_COUNTER       timer;
+    const TopoDS_Shape result = CutShapes( board, holes );
+    timer.Stop();
+
+    BOOST_TEST_MESSAGE( "Cutting " << count << " holes took " << timer.msecs() << "ms" );
+
+    // The holes do not overlap here, so the volume left is known
+    const double expected = volume( board )
+                            - count * M_PI * HOLE_RADIUS * HOLE_RADIUS * BOARD_THICKNESS;
+
+    BOOST_CHECK_EQUAL( solidCount( result ), 1 );
+    BOOST_CHECK_CLOSE( volume( result ), expected, 1e-4 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -68,6 +68,7 @@
 #include <TopoDS_Face.hxx>
 #include <TopoDS_Compound.hxx>
 #include <TopoDS_Builder.hxx>
+#include <TopTools_ListOfShape.hxx>
 
 #include <Standard_Failure.hxx>
 
@@ -656,6 +657,60 @@ void PCBMODEL::SetPCBThickness( double aThickness )
 }
 
 
+// subtract the tool shapes from a shape in a single boolean operation
+TopoDS_Shape CutShapes( const TopoDS_Shape& aShape, const std::vector< TopoDS_Shape >& aTools )
+{
+    if( aTools.empty() )
+        return aShape;
+
+#if ( defined OCC_VERSION_HEX ) && ( OCC_VERSION_HEX >= 0x070000 )
+    // Each cut rebuilds the whole B-rep of the shape, so cutting thousands of holes one
+    // after the other takes hours: give all of them to one operation instead, which sorts
+    // them with a bounding box tree and intersects them in parallel
+    TopTools_ListOfShape arguments;
+    TopTools_ListOfShape tools;
+
+    arguments.Append( aShape );
+
+    for( const auto& i : aTools )
+        tools.Append( i );
+
+    try
+    {
+        BRepAlgoAPI_Cut cut;
+        cut.SetArguments( arguments );
+        cut.SetTools( tools );
+        cut.SetRunParallel( Standard_True );
+        cut.Build();
+
+        if( cut.IsDone() )
+            return cut.Shape();
+    }
+    catch( const Standard_Failure& e )
+    {
+#ifdef DEBUG
+        wxLogMessage( "Exception caught: %s", e.GetMessageString() );
+#endif /* DEBUG */
+    }
+
+    std::ostringstream ostr;
+#ifdef DEBUG
+    ostr << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
+#endif /* DEBUG */
+    ostr << "  * could not subtract the " << aTools.size() << " holes at once; "
+            "subtracting them one by one\n";
+    wxLogMessage( "%s", ostr.str().c_str() );
+#endif
+
+    TopoDS_Shape shape = aShape;
+
+    for( const auto& i : aTools )
+        shape = BRepAlgoAPI_Cut( shape, i );
+
+    return shape;
+}
+
+
 // create the PCB (board only) model using the current outlines and drill holes
 bool PCBMODEL::CreatePCB()
 {
@@ -807,8 +862,7 @@ bool PCBMODEL::CreatePCB()
     }
 
     // subtract cutouts (if any)
-    for( const auto& i : m_cutouts )
-        board = BRepAlgoAPI_Cut( board, i );
+    board = CutShapes( board, m_cutouts );
 
     // push the board to the data structure
     m_pcb_label = m_assy->AddComponent( m_assy_label, board );
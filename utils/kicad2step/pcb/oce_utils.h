@@ -149,4 +149,9 @@ public:
     bool WriteSTEP( const std::string& aFileName );
 };
 
+
+// subtract aTools (board cutouts and holes) from aShape; all of them are subtracted in a
+// single boolean operation when OpenCASCADE supports it, and one by one otherwise
+TopoDS_Shape CutShapes( const TopoDS_Shape& aShape, const std::vector< TopoDS_Shape >& aTools );
+
 #endif //OCE_VIS_OCE_UTILS_H